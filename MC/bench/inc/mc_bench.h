@@ -0,0 +1,143 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_bench.h                                                                             */
+/* \brief: master header file for /bench, timing and reporting utilities for benchmarks          */
+/*                                                                                               */
+/* \Expects: MC library linked properly                                                          */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#ifndef MC_BENCH_H
+#define MC_BENCH_H
+
+#include "mc_type.h"
+#include <stdio.h>              // printf
+#include <time.h>               // timespec_get
+#include <inttypes.h>           // PRIu64
+
+/* Include each Module after this point */
+#include "mc_stack.h"
+#include "mc_workdeque.h"
+#include "mc_spscring.h"
+#include "mc_mpmcqueue.h"
+#include "mc_arena.h"
+#include "mc_pool.h"
+#include "mc_hash.h"
+#include "mc_guid.h"
+#include "mc_guidmap.h"
+#include "mc_log.h"
+#include "mc_trace.h"
+#include "mc_perfcounters.h"
+#include "mc_histogram.h"
+#include "mc_platform.h"
+
+/**
+ * \brief The largest number of threads a multi-threaded benchmark sweeps up to.
+ */
+#define BENCH_MAX_THREADS 8
+
+/**
+ * \brief Used to start a benchmark for good formatting purposes
+ */
+#define BENCH_INIT() printf("Beginning Benchmark: %s\n", __FUNCTION__)
+
+/**
+ * \brief Used to end a benchmark for good formatting purposes
+ */
+#define BENCH_TEARDOWN() printf("%s finished.\n\n", __FUNCTION__)
+
+/**
+ * \brief Report 'ops' operations which took 'elapsed_ns' nanoseconds under the label 'name',
+ * followed by the performance counters per operation when the region was begun with MC_Bench_Start.
+ * elapsed_ns is evaluated once, before the counters are stopped, so it may read the clock inline.
+ */
+#define BENCH_REPORT(name, ops, elapsed_ns) \
+do { \
+    u64 bench_elapsed_ = (u64)(elapsed_ns); \
+    u64 bench_ops_ = (u64)(ops); \
+    MC_PerfSample bench_perf_sample_; \
+    u8 bench_perf_counted_ = MC_Bench_PerfStop(&bench_perf_sample_); \
+    printf("[BENCH]:[%s] - %" PRIu64 " ops in %.3f ms, %.2f ns/op, %.2f Mops/s.\n", \
+        (name), bench_ops_, (double)bench_elapsed_ / 1e6, \
+        (double)bench_elapsed_ / (double)(bench_ops_ ? bench_ops_ : 1), \
+        (double)bench_ops_ * 1e3 / (double)(bench_elapsed_ ? bench_elapsed_ : 1)); \
+    if (bench_perf_counted_) \
+    { \
+        MC_PerfCounters_PrintPerOp(&bench_perf_sample_, bench_ops_); \
+    } \
+} while (0)
+
+/**
+ * \brief Results of benchmarked code are folded in here so the optimizer cannot discard the work.
+ */
+static volatile u64 bench_sink;
+
+/**
+ * \brief Wall clock time in nanoseconds, only meaningful as a difference between two calls.
+ */
+static inline u64 MC_Bench_NowNs(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+
+    return (u64)ts.tv_sec * 1000000000ULL + (u64)ts.tv_nsec;
+}
+
+/**
+ * \brief Print the percentiles of the single operation latencies, in ns, recorded into latencies.
+ */
+static inline void MC_Bench_ReportLatency(const MC_Histogram *latencies)
+{
+    printf("  latency ns: p50 %" PRIu64 ", p90 %" PRIu64 ", p99 %" PRIu64 ", p99.9 %" PRIu64 ", max %" PRIu64 "\n",
+           MC_Histogram_Percentile(latencies, 50.0), MC_Histogram_Percentile(latencies, 90.0),
+           MC_Histogram_Percentile(latencies, 99.0), MC_Histogram_Percentile(latencies, 99.9),
+           MC_Histogram_Max(latencies));
+}
+
+/**
+ * \brief Counters of the regions begun by MC_Bench_Start, opened on first use, NULL where none are allowed.
+ */
+static MC_PerfCounters *bench_perf;
+static u8 bench_perf_opened;
+static u8 bench_perf_running;
+
+/**
+ * \brief Begin a measured region: start the performance counters, then read the wall clock.
+ * \returns u64: MC_Bench_NowNs, to subtract from once the region ends.
+ */
+static inline u64 MC_Bench_Start(void)
+{
+    if (!bench_perf_opened)
+    {
+        bench_perf_opened = true;
+        bench_perf = MC_PerfCounters_Open();
+
+        if (!(MC_PerfCounters_Available(bench_perf) & (1u << MC_PERF_CYCLES)))
+        {
+            printf("  hardware performance counters unavailable: perf_event_paranoid, or no PMU exposed\n");
+        }
+    }
+
+    bench_perf_running = MC_PerfCounters_Start(bench_perf);
+
+    return MC_Bench_NowNs();
+}
+
+/**
+ * \brief End the region begun by MC_Bench_Start, if one is running.
+ * \returns u8: true if sample holds the region's counts.
+ */
+static inline u8 MC_Bench_PerfStop(MC_PerfSample *sample)
+{
+    if (!bench_perf_running)
+    {
+        return false;
+    }
+
+    bench_perf_running = false;
+
+    return MC_PerfCounters_Stop(bench_perf, sample);
+}
+
+#endif
@@ -0,0 +1,96 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_bench_module_arena.c                                                                */
+/* \brief: Per request allocation benchmarks for mc_arena                                        */
+/*                                                                                               */
+/* \Expects: 1. All necessary mc definitions are defined and linked properly                     */
+/*                                                                                               */
+/*           Every simulated request builds a HashMap of keys and a Stack of pointers, then      */
+/*           throws both away. The heap run frees node by node, the Arena run does one Reset.    */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#include "mc_bench.h"
+
+/**
+ * \brief Number of simulated requests per run.
+ */
+#define BENCH_REQUESTS 20000
+
+/**
+ * \brief Number of keys inserted and pointers pushed by one request.
+ */
+#define BENCH_REQUEST_ITEMS 256
+
+/**
+ * \brief Number of buckets of the per request HashMap.
+ */
+#define BENCH_REQUEST_BUCKETS 128
+
+static u64 bench_fill(MC_HashMap *map, MC_Stack *stack)
+{
+    char key[32];
+    u64 checksum = 0;
+
+    for (u64 i = 0; i < BENCH_REQUEST_ITEMS; i++)
+    {
+        snprintf(key, sizeof(key), "request-item-%05" PRIu64, i);
+        MC_Hashmap_Insert(map, key, (void*)(uintptr_t)(i + 1), false);
+        MC_Stack_Push(stack, (void*)(uintptr_t)i, false);
+    }
+
+    checksum += (uintptr_t)MC_Hashmap_Search(map, "request-item-00042");
+    checksum += MC_Stack_Size(stack);
+
+    return checksum;
+}
+
+static void Bench_MC_Arena_Requests(void)
+{
+    BENCH_INIT();
+
+    u64 checksum = 0;
+    u64 start = MC_Bench_Start();
+
+    for (u64 r = 0; r < BENCH_REQUESTS; r++)
+    {
+        MC_HashMap *map = MC_Hashmap_Init(BENCH_REQUEST_BUCKETS);
+        MC_Stack *stack = MC_Stack_Init();
+
+        checksum += bench_fill(map, stack);
+
+        MC_Hashmap_Free(&map);
+        MC_Stack_Free(&stack);
+    }
+
+    BENCH_REPORT("heap HashMap + Stack, per request", BENCH_REQUESTS, MC_Bench_NowNs() - start);
+
+    MC_Arena *arena = MC_Arena_Init(0);
+    start = MC_Bench_Start();
+
+    for (u64 r = 0; r < BENCH_REQUESTS; r++)
+    {
+        MC_HashMap *map = MC_Hashmap_InitArena(arena, BENCH_REQUEST_BUCKETS);
+        MC_Stack *stack = MC_Stack_InitArena(arena);
+
+        checksum += bench_fill(map, stack);
+
+        MC_Arena_Reset(arena);
+    }
+
+    BENCH_REPORT("MC_Arena HashMap + Stack, per request", BENCH_REQUESTS, MC_Bench_NowNs() - start);
+
+    MC_Arena_Free(&arena);
+
+    bench_sink = checksum;
+
+    BENCH_TEARDOWN();
+}
+
+int main(void)
+{
+    Bench_MC_Arena_Requests();
+
+    return 0;
+}
@@ -0,0 +1,254 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_bench_module_guid.c                                                                 */
+/* \brief: Generation throughput benchmarks for mc_guid                                          */
+/*                                                                                               */
+/* \Expects: 1. All necessary mc definitions are defined and linked properly                     */
+/*                                                                                               */
+/*           Every thread generates Guids as fast as it can, each from its own keystream, through */
+/*           the heap API, by value, in batches and as version 7. Thread counts are swept up to  */
+/*           BENCH_MAX_THREADS, the rate should scale with the number of cores, except version 7 */
+/*           whose threads share one sequence.                                                   */
+/*           Formatting and parsing run on one thread against the snprintf and sscanf baselines. */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#include "mc_bench.h"
+#include <threads.h>    // thrd_create
+
+/**
+ * \brief Number of Guids generated per thread per run.
+ */
+#define BENCH_GUIDS_PER_THREAD 4000000ULL
+
+/**
+ * \brief Number of Guids per MC_GUID_GenerateBatch call.
+ */
+#define BENCH_BATCH 1024
+
+typedef enum
+{
+    BENCH_GUID_HEAP,    // MC_GUID_Generate and MC_GUID_Release
+    BENCH_GUID_INTO,    // MC_GUID_GenerateInto a local
+    BENCH_GUID_BATCH,   // MC_GUID_GenerateBatch into an array
+    BENCH_GUID_V7       // MC_GUID_GenerateV7, every thread on the one shared sequence
+} BenchGuidMode;
+
+typedef struct
+{
+    BenchGuidMode mode;
+    u64 checksum;
+    u64 failures;
+} BenchGuid;
+
+static int bench_guid_worker(void *arg)
+{
+    BenchGuid *bench = (BenchGuid*)arg;
+    MC_Guid batch[BENCH_BATCH];
+
+    if (bench->mode == BENCH_GUID_BATCH)
+    {
+        for (u64 i = 0; i < BENCH_GUIDS_PER_THREAD; i += BENCH_BATCH)
+        {
+            bench->failures += !MC_GUID_GenerateBatch(batch, BENCH_BATCH);
+            bench->checksum += batch[i / BENCH_BATCH % BENCH_BATCH].data1;
+        }
+
+        return 0;
+    }
+
+    for (u64 i = 0; i < BENCH_GUIDS_PER_THREAD; i++)
+    {
+        if (bench->mode == BENCH_GUID_INTO || bench->mode == BENCH_GUID_V7)
+        {
+            MC_Guid guid;
+
+            bench->failures += bench->mode == BENCH_GUID_V7 ? !MC_GUID_GenerateV7(&guid) : !MC_GUID_GenerateInto(&guid);
+            bench->checksum += guid.data1;
+
+            continue;
+        }
+
+        MC_Guid *guid = NULL;
+
+        if (!MC_GUID_Generate(&guid))
+        {
+            bench->failures++;
+            continue;
+        }
+
+        bench->checksum += guid->data1;
+        MC_GUID_Release(&guid);
+    }
+
+    return 0;
+}
+
+static void Bench_MC_Guid_Run(const char *name, BenchGuidMode mode)
+{
+    BenchGuid benches[BENCH_MAX_THREADS];
+    thrd_t threads[BENCH_MAX_THREADS];
+    char label[64];
+
+    for (u64 threadCount = 1; threadCount <= BENCH_MAX_THREADS; threadCount *= 2)
+    {
+        u64 failures = 0;
+        u64 start = MC_Bench_NowNs();
+
+        for (u64 t = 0; t < threadCount; t++)
+        {
+            benches[t] = (BenchGuid){ .mode = mode };
+            thrd_create(&threads[t], bench_guid_worker, &benches[t]);
+        }
+
+        for (u64 t = 0; t < threadCount; t++)
+        {
+            thrd_join(threads[t], NULL);
+            bench_sink += benches[t].checksum;
+            failures += benches[t].failures;
+        }
+
+        u64 elapsed = MC_Bench_NowNs() - start;
+        u64 guids = BENCH_GUIDS_PER_THREAD * threadCount;
+
+        snprintf(label, sizeof(label), "%s, %" PRIu64 " thread(s)", name, threadCount);
+        BENCH_REPORT(label, guids, elapsed);
+
+        if (failures)
+        {
+            printf("  %" PRIu64 " generate call(s) failed\n", failures);
+        }
+    }
+}
+
+static void Bench_MC_Guid_Generate(void)
+{
+    BENCH_INIT();
+
+    Bench_MC_Guid_Run("MC_GUID_Generate/Release", BENCH_GUID_HEAP);
+    Bench_MC_Guid_Run("MC_GUID_GenerateInto", BENCH_GUID_INTO);
+    Bench_MC_Guid_Run("MC_GUID_GenerateBatch", BENCH_GUID_BATCH);
+    Bench_MC_Guid_Run("MC_GUID_GenerateV7", BENCH_GUID_V7);
+
+    BENCH_TEARDOWN();
+}
+
+/**
+ * \brief Parse with sscanf, the baseline MC_GUID_Parse replaces.
+ */
+static u8 bench_guid_sscanf(const char *str, MC_Guid *guid)
+{
+    unsigned int data1, data2, data3, data4[8];
+
+    if (sscanf(str, "%8x-%4x-%4x-%2x%2x-%2x%2x%2x%2x%2x%2x", &data1, &data2, &data3,
+               &data4[0], &data4[1], &data4[2], &data4[3], &data4[4], &data4[5], &data4[6], &data4[7]) != 11)
+    {
+        return false;
+    }
+
+    guid->data1 = data1;
+    guid->data2 = (u16)data2;
+    guid->data3 = (u16)data3;
+
+    for (u64 i = 0; i < EIGHT_BYTES; i++)
+    {
+        guid->data4[i] = (u8)data4[i];
+    }
+
+    return true;
+}
+
+static void Bench_MC_Guid_Format(void)
+{
+    BENCH_INIT();
+
+    static MC_Guid guids[BENCH_BATCH];
+    static char strs[BENCH_BATCH * MC_GUID_SIZE];
+    u64 passes = BENCH_GUIDS_PER_THREAD / BENCH_BATCH / 4;
+    u64 ops = passes * BENCH_BATCH;
+    u64 failures = 0;
+
+    MC_GUID_GenerateBatch(guids, BENCH_BATCH);
+
+    u64 start = MC_Bench_NowNs();
+    for (u64 p = 0; p < passes; p++)
+    {
+        for (u64 i = 0; i < BENCH_BATCH; i++)
+        {
+            failures += !MC_GUID_Format_String(&guids[i], strs + i * MC_GUID_SIZE, MC_GUID_SIZE);
+        }
+        bench_sink += (u8)strs[p % (BENCH_BATCH * MC_GUID_SIZE)];
+    }
+    u64 elapsed = MC_Bench_NowNs() - start;
+    BENCH_REPORT("MC_GUID_Format_String (snprintf)", ops, elapsed);
+
+    start = MC_Bench_NowNs();
+    for (u64 p = 0; p < passes; p++)
+    {
+        for (u64 i = 0; i < BENCH_BATCH; i++)
+        {
+            failures += !MC_GUID_Format(&guids[i], strs + i * MC_GUID_SIZE, MC_GUID_SIZE);
+        }
+        bench_sink += (u8)strs[p % (BENCH_BATCH * MC_GUID_SIZE)];
+    }
+    elapsed = MC_Bench_NowNs() - start;
+    BENCH_REPORT("MC_GUID_Format", ops, elapsed);
+
+    start = MC_Bench_NowNs();
+    for (u64 p = 0; p < passes; p++)
+    {
+        failures += !MC_GUID_FormatN(guids, BENCH_BATCH, strs, sizeof(strs));
+        bench_sink += (u8)strs[p % (BENCH_BATCH * MC_GUID_SIZE)];
+    }
+    elapsed = MC_Bench_NowNs() - start;
+    BENCH_REPORT("MC_GUID_FormatN", ops, elapsed);
+
+    start = MC_Bench_NowNs();
+    for (u64 p = 0; p < passes; p++)
+    {
+        for (u64 i = 0; i < BENCH_BATCH; i++)
+        {
+            failures += !bench_guid_sscanf(strs + i * MC_GUID_SIZE, &guids[i]);
+        }
+        bench_sink += guids[p % BENCH_BATCH].data1;
+    }
+    elapsed = MC_Bench_NowNs() - start;
+    BENCH_REPORT("sscanf parse", ops, elapsed);
+
+    start = MC_Bench_NowNs();
+    for (u64 p = 0; p < passes; p++)
+    {
+        for (u64 i = 0; i < BENCH_BATCH; i++)
+        {
+            failures += !MC_GUID_Parse(strs + i * MC_GUID_SIZE, MC_GUID_SIZE, &guids[i]);
+        }
+        bench_sink += guids[p % BENCH_BATCH].data1;
+    }
+    elapsed = MC_Bench_NowNs() - start;
+    BENCH_REPORT("MC_GUID_Parse", ops, elapsed);
+
+    start = MC_Bench_NowNs();
+    for (u64 p = 0; p < passes; p++)
+    {
+        failures += !MC_GUID_ParseN(strs, BENCH_BATCH, guids);
+        bench_sink += guids[p % BENCH_BATCH].data1;
+    }
+    elapsed = MC_Bench_NowNs() - start;
+    BENCH_REPORT("MC_GUID_ParseN", ops, elapsed);
+
+    if (failures)
+    {
+        printf("  %" PRIu64 " format/parse call(s) failed\n", failures);
+    }
+
+    BENCH_TEARDOWN();
+}
+
+int main(void)
+{
+    Bench_MC_Guid_Generate();
+    Bench_MC_Guid_Format();
+
+    return 0;
+}
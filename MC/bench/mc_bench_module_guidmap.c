@@ -0,0 +1,149 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_bench_module_guidmap.c                                                              */
+/* \brief: Guid keyed lookup and sort benchmarks for mc_guidmap and mc_guid                      */
+/*                                                                                               */
+/* \Expects: 1. All necessary mc definitions are defined and linked properly                     */
+/*                                                                                               */
+/*           The same Guids are inserted and looked up through MC_GuidMap and through the string */
+/*           path, formatting every key with MC_GUID_Format_String into an MC_HashMap. Sorting   */
+/*           compares MC_GUID_Sort against qsort over MC_GUID_Compare. The percentiles of single */
+/*           MC_GuidMap searches are gathered into an MC_Histogram.                              */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#include "mc_bench.h"
+#include <stdlib.h>     // malloc, qsort
+#include <string.h>     // memcpy
+
+/**
+ * \brief Number of Guid keys per run.
+ */
+#define BENCH_KEYS 1000000ULL
+
+static int bench_guid_compare(const void *left, const void *right)
+{
+    return MC_GUID_Compare((const MC_Guid*)left, (const MC_Guid*)right);
+}
+
+static void Bench_MC_GuidMap_Lookup(MC_Guid *guids)
+{
+    BENCH_INIT();
+
+    char key[MC_GUID_SIZE];
+    u64 failures = 0;
+
+    MC_HashMap *strings = MC_Hashmap_Init(BENCH_KEYS);
+
+    u64 start = MC_Bench_Start();
+    for (u64 i = 0; i < BENCH_KEYS; i++)
+    {
+        MC_GUID_Format_String(&guids[i], key, MC_GUID_SIZE);
+        failures += !MC_Hashmap_Insert(strings, key, &guids[i], false);
+    }
+    u64 elapsed = MC_Bench_NowNs() - start;
+    BENCH_REPORT("MC_HashMap insert, formatted key", BENCH_KEYS, elapsed);
+
+    start = MC_Bench_Start();
+    for (u64 i = 0; i < BENCH_KEYS; i++)
+    {
+        MC_GUID_Format_String(&guids[i], key, MC_GUID_SIZE);
+        failures += MC_Hashmap_Search(strings, key) != &guids[i];
+    }
+    elapsed = MC_Bench_NowNs() - start;
+    BENCH_REPORT("MC_HashMap search, formatted key", BENCH_KEYS, elapsed);
+
+    MC_Hashmap_Free(&strings);
+
+    MC_GuidMap *map = MC_GuidMap_Init(BENCH_KEYS);
+
+    start = MC_Bench_Start();
+    for (u64 i = 0; i < BENCH_KEYS; i++)
+    {
+        failures += !MC_GuidMap_Insert(map, &guids[i], &guids[i], false);
+    }
+    elapsed = MC_Bench_NowNs() - start;
+    BENCH_REPORT("MC_GuidMap insert", BENCH_KEYS, elapsed);
+
+    start = MC_Bench_Start();
+    for (u64 i = 0; i < BENCH_KEYS; i++)
+    {
+        failures += MC_GuidMap_Search(map, &guids[i]) != &guids[i];
+    }
+    elapsed = MC_Bench_NowNs() - start;
+    BENCH_REPORT("MC_GuidMap search", BENCH_KEYS, elapsed);
+
+    MC_Histogram *latencies = MC_Histogram_Init(0);
+
+    for (u64 i = 0; latencies && i < BENCH_KEYS; i++)
+    {
+        u64 begin = MC_Bench_NowNs();
+        failures += MC_GuidMap_Search(map, &guids[i]) != &guids[i];
+        MC_Histogram_Record(latencies, MC_Bench_NowNs() - begin);
+    }
+
+    printf("[BENCH]:[MC_GuidMap search, each call timed, clock reads included]\n");
+    MC_Bench_ReportLatency(latencies);
+    MC_Histogram_Free(&latencies);
+
+    MC_GuidMap_Free(&map);
+
+    if (failures)
+    {
+        printf("  %" PRIu64 " insert/search call(s) failed\n", failures);
+    }
+
+    BENCH_TEARDOWN();
+}
+
+static void Bench_MC_Guid_Sort(const MC_Guid *guids)
+{
+    BENCH_INIT();
+
+    MC_Guid *copy = (MC_Guid*)malloc(BENCH_KEYS * sizeof(MC_Guid));
+
+    if (!copy)
+    {
+        return;
+    }
+
+    memcpy(copy, guids, BENCH_KEYS * sizeof(MC_Guid));
+
+    u64 start = MC_Bench_NowNs();
+    qsort(copy, BENCH_KEYS, sizeof(MC_Guid), bench_guid_compare);
+    u64 elapsed = MC_Bench_NowNs() - start;
+    BENCH_REPORT("qsort, MC_GUID_Compare", BENCH_KEYS, elapsed);
+    bench_sink += copy[0].data1;
+
+    memcpy(copy, guids, BENCH_KEYS * sizeof(MC_Guid));
+
+    start = MC_Bench_NowNs();
+    MC_GUID_Sort(copy, BENCH_KEYS);
+    elapsed = MC_Bench_NowNs() - start;
+    BENCH_REPORT("MC_GUID_Sort", BENCH_KEYS, elapsed);
+    bench_sink += copy[0].data1;
+
+    free(copy);
+
+    BENCH_TEARDOWN();
+}
+
+int main(void)
+{
+    MC_Guid *guids = (MC_Guid*)malloc(BENCH_KEYS * sizeof(MC_Guid));
+
+    if (!guids)
+    {
+        return 1;
+    }
+
+    MC_GUID_GenerateBatch(guids, BENCH_KEYS);
+
+    Bench_MC_GuidMap_Lookup(guids);
+    Bench_MC_Guid_Sort(guids);
+
+    free(guids);
+
+    return 0;
+}
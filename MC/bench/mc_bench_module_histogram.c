@@ -0,0 +1,161 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_bench_module_histogram.c                                                            */
+/* \brief: Benchmarks for mc_histogram: the cost of recording, reading and encoding              */
+/*                                                                                               */
+/* \Expects: 1. All necessary mc definitions are defined and linked properly                     */
+/*                                                                                               */
+/*           Recording is timed against the bare loop, into one Histogram and through a          */
+/*           Recorder from one and from several threads, to show it is cheap enough to record    */
+/*           every operation.                                                                    */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#include "mc_bench.h"
+#include <threads.h>    // thrd_create
+
+/**
+ * \brief Values each recording benchmark records per thread.
+ */
+#define BENCH_VALUES 10000000ULL
+
+/**
+ * \brief Threads recording into one Recorder at once.
+ */
+#define BENCH_HISTOGRAM_THREADS 4
+
+/**
+ * \brief Percentile queries timed.
+ */
+#define BENCH_QUERIES 10000ULL
+
+static MC_HistogramRecorder *bench_recorder;
+
+/**
+ * \brief A spread of latency-like values, a few ns to a few ms, cheaper to make than a clock read.
+ */
+static inline u64 bench_histogram_value(u64 i)
+{
+    return (i * 0x9E3779B97F4A7C15ULL) >> (42 + (i & 15));
+}
+
+static int bench_histogram_worker(void *arg)
+{
+    (void)arg;
+
+    for (u64 i = 0; i < BENCH_VALUES; i++)
+    {
+        MC_HistogramRecorder_Record(bench_recorder, bench_histogram_value(i));
+    }
+
+    return 0;
+}
+
+static void Bench_MC_Histogram_Record(void)
+{
+    BENCH_INIT();
+
+    MC_Histogram *histogram = MC_Histogram_Init(0);
+
+    u64 start = MC_Bench_Start();
+    for (u64 i = 0; i < BENCH_VALUES; i++)
+    {
+        bench_sink += bench_histogram_value(i);
+    }
+    BENCH_REPORT("bare loop", BENCH_VALUES, MC_Bench_NowNs() - start);
+
+    start = MC_Bench_Start();
+    for (u64 i = 0; i < BENCH_VALUES; i++)
+    {
+        MC_Histogram_Record(histogram, bench_histogram_value(i));
+    }
+    BENCH_REPORT("MC_Histogram_Record", BENCH_VALUES, MC_Bench_NowNs() - start);
+
+    bench_recorder = MC_HistogramRecorder_Init(0);
+
+    start = MC_Bench_Start();
+    bench_histogram_worker(NULL);
+    BENCH_REPORT("MC_HistogramRecorder_Record, 1 thread", BENCH_VALUES, MC_Bench_NowNs() - start);
+
+    thrd_t threads[BENCH_HISTOGRAM_THREADS];
+
+    start = MC_Bench_NowNs();
+    for (u64 t = 0; t < BENCH_HISTOGRAM_THREADS; t++)
+    {
+        thrd_create(&threads[t], bench_histogram_worker, NULL);
+    }
+
+    for (u64 t = 0; t < BENCH_HISTOGRAM_THREADS; t++)
+    {
+        thrd_join(threads[t], NULL);
+    }
+    BENCH_REPORT("MC_HistogramRecorder_Record, 4 threads", BENCH_HISTOGRAM_THREADS * BENCH_VALUES,
+                 MC_Bench_NowNs() - start);
+
+    MC_Histogram *snapshot = MC_Histogram_Init(0);
+
+    start = MC_Bench_NowNs();
+    MC_HistogramRecorder_Snapshot(bench_recorder, snapshot);
+    BENCH_REPORT("MC_HistogramRecorder_Snapshot, 5 threads", 1, MC_Bench_NowNs() - start);
+
+    MC_Bench_ReportLatency(snapshot);
+
+    MC_Histogram_Free(&snapshot);
+    MC_HistogramRecorder_Free(&bench_recorder);
+    MC_Histogram_Free(&histogram);
+
+    BENCH_TEARDOWN();
+}
+
+static void Bench_MC_Histogram_Read(void)
+{
+    BENCH_INIT();
+
+    MC_Histogram *histogram = MC_Histogram_Init(0);
+    u8 buffer[64 * 1024];
+
+    for (u64 i = 0; i < BENCH_VALUES; i++)
+    {
+        MC_Histogram_Record(histogram, bench_histogram_value(i));
+    }
+
+    u64 start = MC_Bench_Start();
+    for (u64 i = 0; i < BENCH_QUERIES; i++)
+    {
+        bench_sink += MC_Histogram_Percentile(histogram, (double)(i % 1000) / 10.0);
+    }
+    BENCH_REPORT("MC_Histogram_Percentile", BENCH_QUERIES, MC_Bench_NowNs() - start);
+
+    u64 size = 0;
+
+    start = MC_Bench_Start();
+    for (u64 i = 0; i < BENCH_QUERIES; i++)
+    {
+        size = MC_Histogram_Serialize(histogram, buffer, sizeof(buffer));
+    }
+    BENCH_REPORT("MC_Histogram_Serialize", BENCH_QUERIES, MC_Bench_NowNs() - start);
+
+    start = MC_Bench_Start();
+    for (u64 i = 0; i < BENCH_QUERIES; i++)
+    {
+        MC_Histogram *copy = MC_Histogram_Deserialize(buffer, size, NULL);
+        bench_sink += MC_Histogram_Count(copy);
+        MC_Histogram_Free(&copy);
+    }
+    BENCH_REPORT("MC_Histogram_Deserialize", BENCH_QUERIES, MC_Bench_NowNs() - start);
+
+    printf("  encoded %" PRIu64 " values in %" PRIu64 " bytes\n", MC_Histogram_Count(histogram), size);
+
+    MC_Histogram_Free(&histogram);
+
+    BENCH_TEARDOWN();
+}
+
+int main(void)
+{
+    Bench_MC_Histogram_Record();
+    Bench_MC_Histogram_Read();
+
+    return 0;
+}
@@ -0,0 +1,541 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_bench_module_log.c                                                                  */
+/* \brief: Caller side latency benchmarks for mc_log                                             */
+/*                                                                                               */
+/* \Expects: 1. All necessary mc definitions are defined and linked properly                     */
+/*                                                                                               */
+/*           Every log call is timed on its own, and the latencies the calling threads saw are   */
+/*           reported as percentiles, for the synchronous path, the asynchronous one with each   */
+/*           overflow policy and the binary one. Bursts of untimed calls give the asynchronous   */
+/*           and binary cost per call without the clock reads. Disabled statements in a hot loop */
+/*           are timed against the bare loop, filtered at runtime and compiled out.              */
+/*           Synchronous throughput is swept up to 64 threads against the stdio path it replaced.  */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+/* Debug statements are compiled out of this file, info and above stay */
+#undef MC_LOG_COMPILE_LEVEL
+#define MC_LOG_COMPILE_LEVEL 1
+
+#include "mc_bench.h"
+#include <threads.h>    // thrd_create
+#include <stdarg.h>     // va_start
+#include <time.h>       // time, strftime
+
+/**
+ * \brief Number of log calls per thread per run.
+ */
+#define BENCH_LINES_PER_THREAD 200000ULL
+
+/**
+ * \brief Number of threads logging at once in the multi-threaded runs.
+ */
+#define BENCH_LOG_THREADS 4
+
+/**
+ * \brief Iterations of the hot loops holding a disabled log statement.
+ */
+#define BENCH_DISABLED_ITERATIONS 100000000ULL
+
+/**
+ * \brief Binary log the benchmarks write, never decoded.
+ */
+#define BENCH_LOG_BINARY_FILE "last_run_output.mclog"
+
+/**
+ * \brief Lines logged per throughput run, shared between its threads, and the most threads swept.
+ */
+#define BENCH_SWEEP_LINES 256000ULL
+#define BENCH_SWEEP_MAX_THREADS 64
+
+/**
+ * \brief File the stdio baseline writes to.
+ */
+#define BENCH_LOG_STDIO_FILE "last_run_output.stdio.txt"
+
+/**
+ * \brief Files the mapped runs rotate through, small enough that a run rotates a few times.
+ */
+#define BENCH_LOG_MAPPED_FILE "last_run_output.mapped"
+#define BENCH_LOG_MAPPED_SIZE (4ULL * 1024 * 1024)
+
+/**
+ * \brief Calls per burst, half the default ring so a burst never waits on the writer.
+ */
+#define BENCH_LOG_BURST 500
+
+typedef enum
+{
+    BENCH_LOG_SYNC,     // MC_LOG_INFO straight to the file
+    BENCH_LOG_ASYNC,    // MC_LOG_INFO formatted into the rings
+    BENCH_LOG_BINARY    // MC_LOG_BINARY, raw arguments into the rings
+} BenchLogMode;
+
+static u64 bench_log_evaluations;
+
+/**
+ * \brief Stands in for an argument that is costly to compute, counting how often it is.
+ */
+static unsigned long long bench_log_argument(u64 value)
+{
+    bench_log_evaluations++;
+
+    return value * value;
+}
+
+typedef struct
+{
+    MC_HistogramRecorder *latencies;    // nanosecond timings of single calls, from every thread
+    u64 thread;
+    BenchLogMode mode;
+} BenchLog;
+
+static int bench_log_worker(void *arg)
+{
+    BenchLog *bench = (BenchLog*)arg;
+
+    for (u64 i = 0; i < BENCH_LINES_PER_THREAD; i++)
+    {
+        u64 start = MC_Bench_NowNs();
+
+        if (bench->mode == BENCH_LOG_BINARY)
+        {
+            MC_LOG_BINARY(MC_LOG_LEVEL_INFO, "thread %llu line %llu value %f", (unsigned long long)bench->thread, (unsigned long long)i, i * 0.5);
+        }
+        else
+        {
+            MC_LOG_INFO("thread %llu line %llu value %f", (unsigned long long)bench->thread, (unsigned long long)i, i * 0.5);
+        }
+
+        MC_HistogramRecorder_Record(bench->latencies, MC_Bench_NowNs() - start);
+    }
+
+    return 0;
+}
+
+/**
+ * \brief Open the log in mode.
+ */
+static int bench_log_open(BenchLogMode mode, MC_LogOverflow overflow)
+{
+    switch (mode)
+    {
+        case BENCH_LOG_ASYNC:  return MC_Log_InitAsync(0, overflow);
+        case BENCH_LOG_BINARY: return MC_Log_InitBinary(BENCH_LOG_BINARY_FILE, 0, overflow);
+        default:               return MC_Log_Init();
+    }
+}
+
+/**
+ * \brief Log from threadCount threads in mode and print the latency percentiles.
+ */
+static void Bench_MC_Log_Run(const char *name, u64 threadCount, BenchLogMode mode, MC_LogOverflow overflow)
+{
+    BenchLog benches[BENCH_LOG_THREADS];
+    thrd_t threads[BENCH_LOG_THREADS];
+    char label[96];
+    u64 total = BENCH_LINES_PER_THREAD * threadCount;
+    MC_HistogramRecorder *recorder = MC_HistogramRecorder_Init(0);
+    MC_Histogram *latencies = MC_Histogram_Init(0);
+
+    if (!recorder || !latencies || bench_log_open(mode, overflow) != 0)
+    {
+        MC_HistogramRecorder_Free(&recorder);
+        MC_Histogram_Free(&latencies);
+
+        return;
+    }
+
+    u64 start = MC_Bench_NowNs();
+
+    for (u64 t = 0; t < threadCount; t++)
+    {
+        benches[t] = (BenchLog){ .latencies = recorder, .thread = t, .mode = mode };
+        thrd_create(&threads[t], bench_log_worker, &benches[t]);
+    }
+
+    for (u64 t = 0; t < threadCount; t++)
+    {
+        thrd_join(threads[t], NULL);
+    }
+
+    u64 elapsed = MC_Bench_NowNs() - start;
+    u64 dropped = MC_Log_Dropped();
+
+    MC_Log_Close();
+
+    MC_HistogramRecorder_Snapshot(recorder, latencies);
+
+    snprintf(label, sizeof(label), "%s, %" PRIu64 " thread(s)", name, threadCount);
+    BENCH_REPORT(label, total, elapsed);
+    MC_Bench_ReportLatency(latencies);
+
+    if (mode != BENCH_LOG_SYNC)
+    {
+        printf("  dropped %" PRIu64 "\n", dropped);
+    }
+
+    MC_HistogramRecorder_Free(&recorder);
+    MC_Histogram_Free(&latencies);
+}
+
+static void Bench_MC_Log_Latency(void)
+{
+    BENCH_INIT();
+
+    for (u64 threadCount = 1; threadCount <= BENCH_LOG_THREADS; threadCount *= BENCH_LOG_THREADS)
+    {
+        Bench_MC_Log_Run("sync", threadCount, BENCH_LOG_SYNC, MC_LOG_OVERFLOW_BLOCK);
+        Bench_MC_Log_Run("async, block", threadCount, BENCH_LOG_ASYNC, MC_LOG_OVERFLOW_BLOCK);
+        Bench_MC_Log_Run("async, drop", threadCount, BENCH_LOG_ASYNC, MC_LOG_OVERFLOW_DROP);
+        Bench_MC_Log_Run("binary, block", threadCount, BENCH_LOG_BINARY, MC_LOG_OVERFLOW_BLOCK);
+    }
+
+    BENCH_TEARDOWN();
+}
+
+/**
+ * \brief Time bursts of untimed calls that fit a thread's ring, flushing between them, so neither the clock
+ * reads nor waiting on the writer are counted. Returns the nanoseconds spent inside the bursts.
+ */
+static u64 bench_log_bursts(BenchLogMode mode)
+{
+    u64 elapsed = 0;
+
+    for (u64 i = 0; i < BENCH_LINES_PER_THREAD; i += BENCH_LOG_BURST)
+    {
+        u64 start = MC_Bench_NowNs();
+
+        for (u64 j = i; j < i + BENCH_LOG_BURST; j++)
+        {
+            if (mode == BENCH_LOG_BINARY)
+            {
+                MC_LOG_BINARY(MC_LOG_LEVEL_INFO, "thread %llu line %llu value %f", 0ULL, (unsigned long long)j, j * 0.5);
+            }
+            else
+            {
+                MC_LOG_INFO("thread %llu line %llu value %f", 0ULL, (unsigned long long)j, j * 0.5);
+            }
+        }
+
+        elapsed += MC_Bench_NowNs() - start;
+        MC_Log_Flush();
+    }
+
+    return elapsed;
+}
+
+static void Bench_MC_Log_Burst(void)
+{
+    BENCH_INIT();
+
+    if (MC_Log_InitAsync(0, MC_LOG_OVERFLOW_BLOCK) == 0)
+    {
+        u64 elapsed = bench_log_bursts(BENCH_LOG_ASYNC);
+        BENCH_REPORT("async MC_LOG_INFO, bursts", BENCH_LINES_PER_THREAD, elapsed);
+        MC_Log_Close();
+    }
+
+    if (MC_Log_InitBinary(BENCH_LOG_BINARY_FILE, 0, MC_LOG_OVERFLOW_BLOCK) == 0)
+    {
+        u64 elapsed = bench_log_bursts(BENCH_LOG_BINARY);
+        BENCH_REPORT("MC_LOG_BINARY, bursts", BENCH_LINES_PER_THREAD, elapsed);
+        MC_Log_Close();
+    }
+
+    BENCH_TEARDOWN();
+}
+
+/**
+ * \brief Bursts like bench_log_bursts of one JSON line, built by MC_LOG_KV or by an MC_LOG_INFO format
+ * string printing the same members. The format does not escape message, the fields are clean.
+ */
+static u64 bench_log_kv_bursts(u8 structured, const char *message)
+{
+    u64 elapsed = 0;
+
+    for (u64 i = 0; i < BENCH_LINES_PER_THREAD; i += BENCH_LOG_BURST)
+    {
+        u64 start = MC_Bench_NowNs();
+
+        for (u64 j = i; j < i + BENCH_LOG_BURST; j++)
+        {
+            if (structured)
+            {
+                MC_LOG_KV(MC_LOG_LEVEL_INFO, "order", MC_KV_U64("id", j), MC_KV_I64("qty", -(i64)j), MC_KV_F64("price", j * 0.25),
+                          MC_KV_STR("symbol", "ACME"), MC_KV_STR("message", message), MC_KV_BOOL("ok", j & 1));
+            }
+            else
+            {
+                MC_LOG_INFO("\"event\":\"order\",\"id\":%llu,\"qty\":%lld,\"price\":%.9g,\"symbol\":\"%s\",\"message\":\"%s\",\"ok\":%s}",
+                            (unsigned long long)j, -(long long)j, j * 0.25, "ACME", message, j & 1 ? "true" : "false");
+            }
+        }
+
+        elapsed += MC_Bench_NowNs() - start;
+        MC_Log_Flush();
+    }
+
+    return elapsed;
+}
+
+static void Bench_MC_Log_KV(void)
+{
+    BENCH_INIT();
+
+    static const char *messages[] = { "", "a longer message of plain text, the kind a request handler would attach to an event" };
+    char label[96];
+
+    for (u64 m = 0; m < sizeof(messages) / sizeof(messages[0]); m++)
+    {
+        for (u8 structured = 0; structured < 2; structured++)
+        {
+            if (MC_Log_InitAsync(0, MC_LOG_OVERFLOW_BLOCK) != 0)
+            {
+                continue;
+            }
+
+            u64 elapsed = bench_log_kv_bursts(structured, messages[m]);
+
+            snprintf(label, sizeof(label), "%s, %s message", structured ? "MC_LOG_KV" : "printf JSON", m ? "long" : "empty");
+            BENCH_REPORT(label, BENCH_LINES_PER_THREAD, elapsed);
+            MC_Log_Close();
+        }
+    }
+
+    BENCH_TEARDOWN();
+}
+
+static FILE *bench_log_stdio_stream;
+
+/**
+ * \brief The synchronous path before lines were published whole: three stdio calls and a flush per line,
+ * each taking the stream's lock, with the date formatted every time.
+ */
+static void bench_log_stdio(LogLevel lvl, const char *format, ...)
+{
+    char time_str[20];
+    time_t now = time(NULL);
+    struct tm t = { 0 };
+
+    MC_LocalTime(&now, &t);
+    strftime(time_str, sizeof(time_str), "%Y-%m-%d %H:%M:%S", &t);
+
+    va_list args;
+    va_start(args, format);
+    fprintf(bench_log_stdio_stream, "[%s] [%s] ", time_str, lvl == MC_LOG_LEVEL_INFO ? "INFO" : "OTHER");
+    vfprintf(bench_log_stdio_stream, format, args);
+    fprintf(bench_log_stdio_stream, "\n");
+    va_end(args);
+    fflush(bench_log_stdio_stream);
+}
+
+typedef struct
+{
+    u64 lines;
+    u64 thread;
+    u8 stdio;
+} BenchLogSweep;
+
+static int bench_log_sweep_worker(void *arg)
+{
+    BenchLogSweep *bench = (BenchLogSweep*)arg;
+
+    for (u64 i = 0; i < bench->lines; i++)
+    {
+        if (bench->stdio)
+        {
+            bench_log_stdio(MC_LOG_LEVEL_INFO, "thread %llu line %llu value %f", (unsigned long long)bench->thread, (unsigned long long)i, i * 0.5);
+        }
+        else
+        {
+            MC_LOG_INFO("thread %llu line %llu value %f", (unsigned long long)bench->thread, (unsigned long long)i, i * 0.5);
+        }
+    }
+
+    return 0;
+}
+
+static void Bench_MC_Log_Throughput(void)
+{
+    BENCH_INIT();
+
+    static BenchLogSweep benches[BENCH_SWEEP_MAX_THREADS];
+    static thrd_t threads[BENCH_SWEEP_MAX_THREADS];
+    static const char *names[] = { "stdio baseline", "sync MC_LOG_INFO", "mapped MC_LOG_INFO" };
+    MC_LogRotation rotation = { BENCH_LOG_MAPPED_FILE, BENCH_LOG_MAPPED_SIZE, 0 };
+    char label[96];
+
+    for (u64 threadCount = 1; threadCount <= BENCH_SWEEP_MAX_THREADS; threadCount *= 4)
+    {
+        u64 lines = BENCH_SWEEP_LINES / threadCount;
+
+        for (u8 pass = 0; pass < 3; pass++)
+        {
+            u8 stdio = pass == 0;
+            int opened = stdio ? MC_FOpen(&bench_log_stdio_stream, BENCH_LOG_STDIO_FILE, "w") :
+                         pass == 1 ? MC_Log_Init() : MC_Log_InitMapped(&rotation);
+
+            if (opened != 0)
+            {
+                continue;
+            }
+
+            u64 start = MC_Bench_NowNs();
+
+            for (u64 t = 0; t < threadCount; t++)
+            {
+                benches[t] = (BenchLogSweep){ .lines = lines, .thread = t, .stdio = stdio };
+                thrd_create(&threads[t], bench_log_sweep_worker, &benches[t]);
+            }
+
+            for (u64 t = 0; t < threadCount; t++)
+            {
+                thrd_join(threads[t], NULL);
+            }
+
+            u64 elapsed = MC_Bench_NowNs() - start;
+            u64 total = lines * threadCount;
+
+            if (stdio)
+            {
+                fclose(bench_log_stdio_stream);
+            }
+            else
+            {
+                MC_Log_Close();
+            }
+
+            snprintf(label, sizeof(label), "%s, %" PRIu64 " thread(s)", names[pass], threadCount);
+            BENCH_REPORT(label, total, elapsed);
+        }
+    }
+
+    BENCH_TEARDOWN();
+}
+
+static void Bench_MC_Log_Disabled(void)
+{
+    BENCH_INIT();
+
+    if (MC_Log_Init() != 0)
+    {
+        return;
+    }
+
+    MC_Log_SetLevel(MC_LOG_LEVEL_WARNING);
+    bench_log_evaluations = 0;
+
+    u64 start = MC_Bench_NowNs();
+    for (u64 i = 0; i < BENCH_DISABLED_ITERATIONS; i++)
+    {
+        bench_sink += i;
+    }
+    u64 elapsed = MC_Bench_NowNs() - start;
+    BENCH_REPORT("bare loop", BENCH_DISABLED_ITERATIONS, elapsed);
+
+    start = MC_Bench_NowNs();
+    for (u64 i = 0; i < BENCH_DISABLED_ITERATIONS; i++)
+    {
+        bench_sink += i;
+        MC_LOG_INFO("value %llu", bench_log_argument(i));
+    }
+    elapsed = MC_Bench_NowNs() - start;
+    BENCH_REPORT("MC_LOG_INFO below the runtime threshold", BENCH_DISABLED_ITERATIONS, elapsed);
+
+    start = MC_Bench_NowNs();
+    for (u64 i = 0; i < BENCH_DISABLED_ITERATIONS; i++)
+    {
+        bench_sink += i;
+        MC_LOG_DEBUG("value %llu", bench_log_argument(i));
+    }
+    elapsed = MC_Bench_NowNs() - start;
+    BENCH_REPORT("MC_LOG_DEBUG compiled out", BENCH_DISABLED_ITERATIONS, elapsed);
+
+    printf("  arguments evaluated: %" PRIu64 "\n", bench_log_evaluations);
+
+    MC_Log_SetLevel(MC_LOG_LEVEL_DEBUG);
+    MC_Log_Close();
+
+    BENCH_TEARDOWN();
+}
+
+static void Bench_MC_Log_Limit(void)
+{
+    BENCH_INIT();
+
+    static MC_LogSite open = MC_LOG_SITE_INIT;
+    static MC_LogSite every = MC_LOG_SITE_INIT;
+    u64 allowed = 0;
+
+    if (MC_Log_Init() != 0)
+    {
+        return;
+    }
+
+    u64 start = MC_Bench_NowNs();
+    for (u64 i = 0; i < BENCH_DISABLED_ITERATIONS; i++)
+    {
+        bench_sink += i;
+    }
+    u64 elapsed = MC_Bench_NowNs() - start;
+    BENCH_REPORT("bare loop", BENCH_DISABLED_ITERATIONS, elapsed);
+
+    // the checks alone, on sites that let every call through: what a limited line pays on top of logging
+    start = MC_Bench_NowNs();
+    for (u64 i = 0; i < BENCH_DISABLED_ITERATIONS; i++)
+    {
+        bench_sink += i;
+        allowed += MC_Log_Limit(&open, UINT64_MAX / 2, UINT64_MAX / 2);
+    }
+    elapsed = MC_Bench_NowNs() - start;
+    BENCH_REPORT("MC_Log_Limit, not limiting", BENCH_DISABLED_ITERATIONS, elapsed);
+
+    start = MC_Bench_NowNs();
+    for (u64 i = 0; i < BENCH_DISABLED_ITERATIONS; i++)
+    {
+        bench_sink += i;
+        allowed += MC_Log_Sample(&every, 1);
+    }
+    elapsed = MC_Bench_NowNs() - start;
+    BENCH_REPORT("MC_Log_Sample, every call", BENCH_DISABLED_ITERATIONS, elapsed);
+
+    // a flood: the first lines are written, every other call is skipped and counted
+    start = MC_Bench_NowNs();
+    for (u64 i = 0; i < BENCH_DISABLED_ITERATIONS; i++)
+    {
+        bench_sink += i;
+        MC_LOG_LIMIT(MC_LOG_LEVEL_WARNING, 10, 10, "value %llu", bench_log_argument(i));
+    }
+    elapsed = MC_Bench_NowNs() - start;
+    BENCH_REPORT("MC_LOG_LIMIT, flooded", BENCH_DISABLED_ITERATIONS, elapsed);
+
+    start = MC_Bench_NowNs();
+    for (u64 i = 0; i < BENCH_DISABLED_ITERATIONS; i++)
+    {
+        bench_sink += i;
+        MC_LOG_SAMPLE(MC_LOG_LEVEL_WARNING, 1000000, "value %llu", bench_log_argument(i));
+    }
+    elapsed = MC_Bench_NowNs() - start;
+    BENCH_REPORT("MC_LOG_SAMPLE 1 in 1000000", BENCH_DISABLED_ITERATIONS, elapsed);
+
+    printf("  checks passed: %" PRIu64 "\n", allowed);
+
+    MC_Log_Close();
+
+    BENCH_TEARDOWN();
+}
+
+int main(void)
+{
+    Bench_MC_Log_Latency();
+    Bench_MC_Log_Throughput();
+    Bench_MC_Log_Burst();
+    Bench_MC_Log_KV();
+    Bench_MC_Log_Disabled();
+    Bench_MC_Log_Limit();
+
+    return 0;
+}
@@ -0,0 +1,188 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_bench_module_mpmcqueue.c                                                            */
+/* \brief: Throughput and latency benchmarks for mc_mpmcqueue                                    */
+/*                                                                                               */
+/* \Expects: 1. All necessary mc definitions are defined and linked properly                     */
+/*                                                                                               */
+/*           Producers stamp every message with the time it was enqueued, consumers sample the   */
+/*           time until it was dequeued. Producer and consumer counts are swept over 1, 2 and 4, */
+/*           reporting messages per second and the p50/p99 enqueue to dequeue latency.           */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#include "mc_bench.h"
+#include <stdlib.h>     // malloc, qsort
+#include <threads.h>    // thrd_create
+
+/**
+ * \brief Number of messages handed from all producers to all consumers per run.
+ */
+#define BENCH_MESSAGES 2000000ULL
+
+/**
+ * \brief Number of messages the queue buffers at most.
+ */
+#define BENCH_QUEUE_CAPACITY 1024
+
+/**
+ * \brief Every BENCH_LATENCY_STRIDE-th message a consumer receives is sampled for latency.
+ */
+#define BENCH_LATENCY_STRIDE 64
+
+/**
+ * \brief Largest producer or consumer count in the sweep.
+ */
+#define BENCH_MPMC_MAX_SIDE 4
+
+typedef struct
+{
+    u64 stamp;
+    u64 value;
+} BenchMessage;
+
+typedef struct
+{
+    MC_MpmcQueue *queue;
+    u64 count;          // messages a producer sends
+    u64 checksum;       // sum a consumer received
+    u64 *samples;       // latencies a consumer sampled
+    u64 sampleCount;
+} BenchMpmc;
+
+static int bench_producer(void *arg)
+{
+    BenchMpmc *bench = (BenchMpmc*)arg;
+
+    for (u64 i = 1; i <= bench->count; i++)
+    {
+        BenchMessage message = { .stamp = MC_Bench_NowNs(), .value = i };
+        MC_MpmcQueue_Enqueue(bench->queue, &message);
+    }
+
+    return 0;
+}
+
+static int bench_consumer(void *arg)
+{
+    BenchMpmc *bench = (BenchMpmc*)arg;
+    BenchMessage message;
+    u64 received = 0;
+
+    while (MC_MpmcQueue_Dequeue(bench->queue, &message))
+    {
+        bench->checksum += message.value;
+
+        if (received++ % BENCH_LATENCY_STRIDE == 0)
+        {
+            bench->samples[bench->sampleCount++] = MC_Bench_NowNs() - message.stamp;
+        }
+    }
+
+    return 0;
+}
+
+static int bench_compare_u64(const void *a, const void *b)
+{
+    u64 left = *(const u64*)a;
+    u64 right = *(const u64*)b;
+
+    return (left > right) - (left < right);
+}
+
+static void Bench_MC_MpmcQueue_Run(u64 producerCount, u64 consumerCount)
+{
+    MC_MpmcQueue *queue = MC_MpmcQueue_Init(BENCH_QUEUE_CAPACITY, sizeof(BenchMessage));
+    BenchMpmc producers[BENCH_MPMC_MAX_SIDE];
+    BenchMpmc consumers[BENCH_MPMC_MAX_SIDE];
+    thrd_t producerThreads[BENCH_MPMC_MAX_SIDE];
+    thrd_t consumerThreads[BENCH_MPMC_MAX_SIDE];
+    u64 *samples = (u64*)malloc((BENCH_MESSAGES / BENCH_LATENCY_STRIDE + BENCH_MPMC_MAX_SIDE) * sizeof(u64));
+    u64 sampleCount = 0;
+    u64 checksum = 0;
+
+    for (u64 i = 0; i < consumerCount; i++)
+    {
+        consumers[i] = (BenchMpmc){ .queue = queue };
+        consumers[i].samples = (u64*)malloc((BENCH_MESSAGES / BENCH_LATENCY_STRIDE + 1) * sizeof(u64));
+    }
+
+    u64 start = MC_Bench_NowNs();
+
+    for (u64 i = 0; i < consumerCount; i++)
+    {
+        thrd_create(&consumerThreads[i], bench_consumer, &consumers[i]);
+    }
+
+    for (u64 i = 0; i < producerCount; i++)
+    {
+        producers[i] = (BenchMpmc){ .queue = queue, .count = BENCH_MESSAGES / producerCount };
+        thrd_create(&producerThreads[i], bench_producer, &producers[i]);
+    }
+
+    for (u64 i = 0; i < producerCount; i++)
+    {
+        thrd_join(producerThreads[i], NULL);
+    }
+
+    MC_MpmcQueue_Close(queue);
+
+    for (u64 i = 0; i < consumerCount; i++)
+    {
+        thrd_join(consumerThreads[i], NULL);
+    }
+
+    u64 elapsed = MC_Bench_NowNs() - start;
+
+    for (u64 i = 0; i < consumerCount; i++)
+    {
+        for (u64 j = 0; j < consumers[i].sampleCount; j++)
+        {
+            samples[sampleCount++] = consumers[i].samples[j];
+        }
+
+        checksum += consumers[i].checksum;
+        free(consumers[i].samples);
+    }
+
+    qsort(samples, sampleCount, sizeof(u64), bench_compare_u64);
+
+    u64 p50 = sampleCount ? samples[sampleCount / 2] : 0;
+    u64 p99 = sampleCount ? samples[(sampleCount * 99) / 100] : 0;
+    char label[64];
+    snprintf(label, sizeof(label), "MC_MpmcQueue %" PRIu64 "P x %" PRIu64 "C", producerCount, consumerCount);
+
+    u64 messages = (BENCH_MESSAGES / producerCount) * producerCount;
+
+    BENCH_REPORT(label, messages, elapsed);
+    printf("[BENCH]:[%s] - latency p50 %" PRIu64 " ns, p99 %" PRIu64 " ns over %" PRIu64 " samples.\n",
+        label, p50, p99, sampleCount);
+
+    bench_sink = checksum;
+
+    free(samples);
+    MC_MpmcQueue_Free(&queue);
+}
+
+static void Bench_MC_MpmcQueue_Sweep(void)
+{
+    BENCH_INIT();
+
+    for (u64 producerCount = 1; producerCount <= BENCH_MPMC_MAX_SIDE; producerCount *= 2)
+    {
+        for (u64 consumerCount = 1; consumerCount <= BENCH_MPMC_MAX_SIDE; consumerCount *= 2)
+        {
+            Bench_MC_MpmcQueue_Run(producerCount, consumerCount);
+        }
+    }
+
+    BENCH_TEARDOWN();
+}
+
+int main(void)
+{
+    Bench_MC_MpmcQueue_Sweep();
+
+    return 0;
+}
@@ -0,0 +1,120 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_bench_module_pool.c                                                                 */
+/* \brief: Fixed size allocation benchmarks for mc_pool                                          */
+/*                                                                                               */
+/* \Expects: 1. All necessary mc definitions are defined and linked properly                     */
+/*                                                                                               */
+/*           Every thread repeatedly allocates a batch of node sized objects, touches them and   */
+/*           frees them again, through malloc/free and through an MC_Pool shared by all of the   */
+/*           threads. Thread counts are swept up to BENCH_MAX_THREADS.                           */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#include "mc_bench.h"
+#include <stdlib.h>     // malloc
+#include <threads.h>    // thrd_create
+
+/**
+ * \brief Number of alloc/free pairs per thread per run.
+ */
+#define BENCH_ALLOCS_PER_THREAD 4000000ULL
+
+/**
+ * \brief Number of objects a thread holds at once.
+ */
+#define BENCH_BATCH 512
+
+/**
+ * \brief Size of one object, that of a HashNode on 64 bit targets.
+ */
+#define BENCH_OBJECT_SIZE 32
+
+typedef struct
+{
+    MC_Pool *pool;      // NULL benchmarks malloc
+    u64 checksum;
+} BenchPool;
+
+static int bench_pool_worker(void *arg)
+{
+    BenchPool *bench = (BenchPool*)arg;
+    u64 *batch[BENCH_BATCH];
+
+    for (u64 round = 0; round < BENCH_ALLOCS_PER_THREAD / BENCH_BATCH; round++)
+    {
+        for (u64 i = 0; i < BENCH_BATCH; i++)
+        {
+            batch[i] = bench->pool ? (u64*)MC_Pool_Alloc(bench->pool) : (u64*)malloc(BENCH_OBJECT_SIZE);
+            batch[i][0] = i;
+        }
+
+        for (u64 i = 0; i < BENCH_BATCH; i++)
+        {
+            bench->checksum += batch[i][0];
+
+            if (bench->pool)
+            {
+                MC_Pool_Release(bench->pool, batch[i]);
+            }
+            else
+            {
+                free(batch[i]);
+            }
+        }
+    }
+
+    return 0;
+}
+
+static void Bench_MC_Pool_Run(const char *name, MC_Pool *pool, u64 threadCount)
+{
+    BenchPool benches[BENCH_MAX_THREADS];
+    thrd_t threads[BENCH_MAX_THREADS];
+    char label[64];
+
+    u64 start = MC_Bench_NowNs();
+
+    for (u64 t = 0; t < threadCount; t++)
+    {
+        benches[t] = (BenchPool){ .pool = pool };
+        thrd_create(&threads[t], bench_pool_worker, &benches[t]);
+    }
+
+    for (u64 t = 0; t < threadCount; t++)
+    {
+        thrd_join(threads[t], NULL);
+        bench_sink += benches[t].checksum;
+    }
+
+    u64 elapsed = MC_Bench_NowNs() - start;
+    u64 pairs = BENCH_ALLOCS_PER_THREAD / BENCH_BATCH * BENCH_BATCH * threadCount;
+
+    snprintf(label, sizeof(label), "%s, %" PRIu64 " thread(s)", name, threadCount);
+    BENCH_REPORT(label, pairs, elapsed);
+}
+
+static void Bench_MC_Pool_VersusMalloc(void)
+{
+    BENCH_INIT();
+
+    MC_Pool *pool = MC_Pool_Init(BENCH_OBJECT_SIZE, 4);
+
+    for (u64 threadCount = 1; threadCount <= BENCH_MAX_THREADS; threadCount *= 2)
+    {
+        Bench_MC_Pool_Run("malloc/free", NULL, threadCount);
+        Bench_MC_Pool_Run("MC_Pool Alloc/Release", pool, threadCount);
+    }
+
+    MC_Pool_Free(&pool);
+
+    BENCH_TEARDOWN();
+}
+
+int main(void)
+{
+    Bench_MC_Pool_VersusMalloc();
+
+    return 0;
+}
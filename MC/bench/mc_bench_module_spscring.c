@@ -0,0 +1,210 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_bench_module_spscring.c                                                             */
+/* \brief: Producer to consumer throughput benchmarks for mc_spscring                            */
+/*                                                                                               */
+/* \Expects: 1. All necessary mc definitions are defined and linked properly                     */
+/*                                                                                               */
+/*           One producer thread hands u64 messages to one consumer thread. The SpscRing is      */
+/*           measured per element, batched and zero-copy, against the previous practice of a     */
+/*           mutex protected MC_Stack. Results are reported in messages per second.              */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#include "mc_bench.h"
+#include <threads.h>    // thrd_create
+
+/**
+ * \brief Number of messages handed from the producer to the consumer per run.
+ */
+#define BENCH_MESSAGES 20000000ULL
+
+/**
+ * \brief Number of messages the ring and the locked Stack buffer at most.
+ */
+#define BENCH_RING_CAPACITY 4096
+
+/**
+ * \brief How the producer and consumer talk to the queue in a run.
+ */
+typedef enum
+{
+    BENCH_SPSC_LOCKED_STACK,
+    BENCH_SPSC_SINGLE,
+    BENCH_SPSC_BATCH,
+    BENCH_SPSC_ZERO_COPY
+} BenchSpscMode;
+
+typedef struct
+{
+    BenchSpscMode mode;
+    u64 batch;
+    MC_SpscRing *ring;
+    MC_Stack *stack;
+    mtx_t lock;
+} BenchSpsc;
+
+static int bench_producer(void *arg)
+{
+    BenchSpsc *bench = (BenchSpsc*)arg;
+    u64 batch[BENCH_RING_CAPACITY];
+    u64 next = 1;
+
+    while (next <= BENCH_MESSAGES)
+    {
+        u64 sent = 0;
+
+        switch (bench->mode)
+        {
+            case BENCH_SPSC_LOCKED_STACK:
+                mtx_lock(&bench->lock);
+                if (MC_Stack_Size(bench->stack) < BENCH_RING_CAPACITY)
+                {
+                    sent = MC_Stack_Push(bench->stack, (void*)(uintptr_t)next, false);
+                }
+                mtx_unlock(&bench->lock);
+                break;
+
+            case BENCH_SPSC_SINGLE:
+                sent = MC_SpscRing_Enqueue(bench->ring, &next);
+                break;
+
+            case BENCH_SPSC_BATCH:
+                for (u64 i = 0; i < bench->batch; i++)
+                {
+                    batch[i] = next + i;
+                }
+                sent = MC_SpscRing_EnqueueN(bench->ring, batch,
+                    bench->batch < BENCH_MESSAGES - next + 1 ? bench->batch : BENCH_MESSAGES - next + 1);
+                break;
+
+            case BENCH_SPSC_ZERO_COPY:
+            {
+                u64 granted = 0;
+                u64 *slots = (u64*)MC_SpscRing_Reserve(bench->ring,
+                    bench->batch < BENCH_MESSAGES - next + 1 ? bench->batch : BENCH_MESSAGES - next + 1, &granted);
+
+                for (u64 i = 0; i < granted; i++)
+                {
+                    slots[i] = next + i;
+                }
+
+                MC_SpscRing_Commit(bench->ring, granted);
+                sent = granted;
+                break;
+            }
+        }
+
+        if (sent == 0)
+        {
+            thrd_yield();
+        }
+
+        next += sent;
+    }
+
+    return 0;
+}
+
+static u64 bench_consume(BenchSpsc *bench)
+{
+    u64 batch[BENCH_RING_CAPACITY];
+    u64 received = 0;
+    u64 checksum = 0;
+
+    while (received < BENCH_MESSAGES)
+    {
+        u64 got = 0;
+
+        switch (bench->mode)
+        {
+            case BENCH_SPSC_LOCKED_STACK:
+            {
+                mtx_lock(&bench->lock);
+                void *value = MC_Stack_Pop(bench->stack);     // messages start at 1, so NULL means empty
+                mtx_unlock(&bench->lock);
+                got = value != NULL;
+                checksum += (uintptr_t)value;
+                break;
+            }
+
+            case BENCH_SPSC_SINGLE:
+                got = MC_SpscRing_Dequeue(bench->ring, batch);
+                checksum += got ? batch[0] : 0;
+                break;
+
+            case BENCH_SPSC_BATCH:
+                got = MC_SpscRing_DequeueN(bench->ring, batch, bench->batch);
+                for (u64 i = 0; i < got; i++)
+                {
+                    checksum += batch[i];
+                }
+                break;
+
+            case BENCH_SPSC_ZERO_COPY:
+            {
+                const u64 *ready = (const u64*)MC_SpscRing_Acquire(bench->ring, bench->batch, &got);
+                for (u64 i = 0; i < got; i++)
+                {
+                    checksum += ready[i];
+                }
+                MC_SpscRing_Release(bench->ring, got);
+                break;
+            }
+        }
+
+        if (got == 0)
+        {
+            thrd_yield();
+        }
+
+        received += got;
+    }
+
+    return checksum;
+}
+
+static void Bench_MC_SpscRing_Run(const char *label, BenchSpscMode mode, u64 batch)
+{
+    BenchSpsc bench = { .mode = mode, .batch = batch };
+    thrd_t producer;
+
+    bench.ring = MC_SpscRing_Init(BENCH_RING_CAPACITY, sizeof(u64));
+    bench.stack = MC_Stack_Init();
+    mtx_init(&bench.lock, mtx_plain);
+
+    u64 start = MC_Bench_NowNs();
+
+    thrd_create(&producer, bench_producer, &bench);
+    bench_sink = bench_consume(&bench);
+    thrd_join(producer, NULL);
+
+    u64 elapsed = MC_Bench_NowNs() - start;
+
+    BENCH_REPORT(label, BENCH_MESSAGES, elapsed);
+
+    MC_SpscRing_Free(&bench.ring);
+    MC_Stack_Free(&bench.stack);
+    mtx_destroy(&bench.lock);
+}
+
+static void Bench_MC_SpscRing_Throughput(void)
+{
+    BENCH_INIT();
+
+    Bench_MC_SpscRing_Run("locked MC_Stack, 1 per call", BENCH_SPSC_LOCKED_STACK, 1);
+    Bench_MC_SpscRing_Run("MC_SpscRing Enqueue/Dequeue", BENCH_SPSC_SINGLE, 1);
+    Bench_MC_SpscRing_Run("MC_SpscRing EnqueueN/DequeueN x16", BENCH_SPSC_BATCH, 16);
+    Bench_MC_SpscRing_Run("MC_SpscRing EnqueueN/DequeueN x256", BENCH_SPSC_BATCH, 256);
+    Bench_MC_SpscRing_Run("MC_SpscRing Reserve/Acquire x256", BENCH_SPSC_ZERO_COPY, 256);
+
+    BENCH_TEARDOWN();
+}
+
+int main(void)
+{
+    Bench_MC_SpscRing_Throughput();
+
+    return 0;
+}
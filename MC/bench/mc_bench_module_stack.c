@@ -0,0 +1,198 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_bench_module_stack.c                                                                */
+/* \brief: Benchmarks for mc_stack: pointer, typed and small buffer optimized Stacks             */
+/*                                                                                               */
+/* \Expects: 1. All necessary mc definitions are defined and linked properly                     */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#include "mc_bench.h"
+#include <stdlib.h>     // malloc
+
+/**
+ * \brief Number of short-lived Stacks created by the lifecycle benchmark.
+ */
+#define BENCH_LIFECYCLES 1000000
+
+/**
+ * \brief Elements pushed onto each short-lived Stack, typical of a parser or evaluator Stack.
+ */
+#define BENCH_LIFECYCLE_DEPTH 12
+
+/**
+ * \brief Inline slots of the small buffer optimized Stack.
+ */
+#define BENCH_INLINE_SLOTS 16
+
+/**
+ * \brief Number of DFS frames pushed and popped by the frame benchmark.
+ */
+#define BENCH_FRAMES 10000000
+
+/**
+ * \brief Frames are pushed in runs of this many by the bulk variant of the frame benchmark.
+ */
+#define BENCH_FRAME_RUN 64
+
+/**
+ * \brief A small DFS frame, the kind of struct that previously needed a malloc per push.
+ */
+typedef struct
+{
+    u64 node;
+    u32 depth;
+    u32 edge;
+} Frame;
+
+static void Bench_MC_Stack_ShortLived(void)
+{
+    BENCH_INIT();
+
+    u64 start, checksum = 0, allocations = 0;
+    const u64 ops = (u64)BENCH_LIFECYCLES;
+
+    /* Pointer Stack: one header plus one node per push */
+    start = MC_Bench_Start();
+    for (u64 i = 0; i < BENCH_LIFECYCLES; i++)
+    {
+        MC_Stack *stack = MC_Stack_Init();
+
+        for (uintptr_t j = 1; j <= BENCH_LIFECYCLE_DEPTH; j++)
+        {
+            MC_Stack_Push(stack, (void*)j, false);
+        }
+
+        while (!MC_Stack_IsEmpty(stack))
+        {
+            checksum += (uintptr_t)MC_Stack_Pop(stack);
+        }
+
+        MC_Stack_Free(&stack);
+    }
+    BENCH_REPORT("pointer MC_Stack lifecycle", ops, MC_Bench_NowNs() - start);
+    printf("\tallocations per lifecycle: %d\n", 1 + BENCH_LIFECYCLE_DEPTH);
+
+    /* Typed Stack: one header plus one element buffer */
+    start = MC_Bench_Start();
+    for (u64 i = 0; i < BENCH_LIFECYCLES; i++)
+    {
+        MC_Stack *stack = MC_Stack_InitTyped(sizeof(u64));
+
+        for (u64 j = 1; j <= BENCH_LIFECYCLE_DEPTH; j++)
+        {
+            MC_Stack_Push(stack, &j, false);
+        }
+
+        while (!MC_Stack_IsEmpty(stack))
+        {
+            checksum += *(u64*)MC_Stack_Pop(stack);
+        }
+
+        MC_Stack_Free(&stack);
+    }
+    BENCH_REPORT("typed MC_Stack lifecycle", ops, MC_Bench_NowNs() - start);
+    printf("\tallocations per lifecycle: 2\n");
+
+    /* Small Stack: lives on this frame, never allocates while within its inline slots */
+    start = MC_Bench_Start();
+    for (u64 i = 0; i < BENCH_LIFECYCLES; i++)
+    {
+        MC_SMALL_STACK(stack, u64, BENCH_INLINE_SLOTS);
+
+        for (u64 j = 1; j <= BENCH_LIFECYCLE_DEPTH; j++)
+        {
+            MC_SmallStack_Push(&stack, &j);
+        }
+
+        allocations += !MC_SmallStack_IsInline(&stack);
+
+        while (!MC_SmallStack_IsEmpty(&stack))
+        {
+            checksum += *(u64*)MC_SmallStack_Pop(&stack);
+        }
+
+        MC_SmallStack_Free(&stack);
+    }
+    BENCH_REPORT("MC_SmallStack lifecycle", ops, MC_Bench_NowNs() - start);
+    printf("\tallocations per lifecycle: %.2f\n", (double)allocations / (double)ops);
+
+    bench_sink = checksum;
+
+    BENCH_TEARDOWN();
+}
+
+static void Bench_MC_Stack_Frames(void)
+{
+    BENCH_INIT();
+
+    u64 start, checksum = 0;
+    Frame run[BENCH_FRAME_RUN];
+
+    /* Pointer Stack: each frame is its own heap allocation, plus its node */
+    MC_Stack *pointers = MC_Stack_Init();
+
+    start = MC_Bench_Start();
+    for (u64 i = 0; i < BENCH_FRAMES; i++)
+    {
+        Frame *frame = (Frame*)malloc(sizeof(Frame));
+        frame->node = i;
+        MC_Stack_Push(pointers, frame, true);
+
+        if (i & 1)
+        {
+            frame = (Frame*)MC_Stack_Pop(pointers);
+            checksum += frame->node;
+            free(frame);
+        }
+    }
+    BENCH_REPORT("pointer MC_Stack, malloc per frame", BENCH_FRAMES, MC_Bench_NowNs() - start);
+
+    MC_Stack_Free(&pointers);
+
+    /* Typed Stack: frames are copied by value */
+    MC_Stack *typed = MC_Stack_InitTyped(sizeof(Frame));
+
+    start = MC_Bench_Start();
+    for (u64 i = 0; i < BENCH_FRAMES; i++)
+    {
+        Frame frame = { i, 0, 0 };
+        MC_Stack_Push(typed, &frame, false);
+
+        if (i & 1)
+        {
+            checksum += ((Frame*)MC_Stack_Pop(typed))->node;
+        }
+    }
+    BENCH_REPORT("typed MC_Stack, by value", BENCH_FRAMES, MC_Bench_NowNs() - start);
+
+    /* Typed Stack, bulk: whole runs of frames per call */
+    start = MC_Bench_Start();
+    for (u64 i = 0; i < BENCH_FRAMES; i += BENCH_FRAME_RUN)
+    {
+        for (u64 j = 0; j < BENCH_FRAME_RUN; j++)
+        {
+            run[j].node = i + j;
+        }
+
+        MC_Stack_PushN(typed, run, BENCH_FRAME_RUN);
+        MC_Stack_PopN(typed, run, BENCH_FRAME_RUN / 2);
+        checksum += run[0].node;
+    }
+    BENCH_REPORT("typed MC_Stack, PushN/PopN", BENCH_FRAMES, MC_Bench_NowNs() - start);
+
+    MC_Stack_Free(&typed);
+
+    bench_sink = checksum;
+
+    BENCH_TEARDOWN();
+}
+
+int main(void)
+{
+    Bench_MC_Stack_ShortLived();
+    Bench_MC_Stack_Frames();
+
+    return 0;
+}
@@ -0,0 +1,137 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_bench_module_trace.c                                                                */
+/* \brief: Benchmarks for mc_trace: the cost of a span with and without a session                */
+/*                                                                                               */
+/* \Expects: 1. All necessary mc definitions are defined and linked properly                     */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#include "mc_bench.h"
+
+/**
+ * \brief Number of spans each benchmark records.
+ */
+#define BENCH_SPANS 1000000
+
+/**
+ * \brief Keys in the map searched by the module span benchmark.
+ */
+#define BENCH_KEYS 1024
+
+static void Bench_MC_Trace_Scope(void)
+{
+    BENCH_INIT();
+
+    u64 start = MC_Bench_NowNs();
+    for (u64 i = 0; i < BENCH_SPANS; i++)
+    {
+        bench_sink += i;
+    }
+    BENCH_REPORT("bare loop", BENCH_SPANS, MC_Bench_NowNs() - start);
+
+    // no session: one relaxed load and a branch
+    start = MC_Bench_NowNs();
+    for (u64 i = 0; i < BENCH_SPANS; i++)
+    {
+        MC_TRACE_SCOPE("span")
+        {
+            bench_sink += i;
+        }
+    }
+    BENCH_REPORT("MC_TRACE_SCOPE, no session", BENCH_SPANS, MC_Bench_NowNs() - start);
+
+    if (MC_Trace_Start(2 * BENCH_SPANS) != 0)
+    {
+        return;
+    }
+
+    start = MC_Bench_NowNs();
+    for (u64 i = 0; i < BENCH_SPANS; i++)
+    {
+        MC_TRACE_SCOPE("span")
+        {
+            bench_sink += i;
+        }
+    }
+    BENCH_REPORT("MC_TRACE_SCOPE, recording", BENCH_SPANS, MC_Bench_NowNs() - start);
+
+    // the buffer is full now, every begin is dropped
+    start = MC_Bench_NowNs();
+    for (u64 i = 0; i < BENCH_SPANS; i++)
+    {
+        MC_TRACE_SCOPE("span")
+        {
+            bench_sink += i;
+        }
+    }
+    BENCH_REPORT("MC_TRACE_SCOPE, buffer full", BENCH_SPANS, MC_Bench_NowNs() - start);
+
+    MC_Trace_Stop();
+
+    start = MC_Bench_NowNs();
+    MC_Trace_Write(NULL);
+    BENCH_REPORT("MC_Trace_Write, per event", 2 * BENCH_SPANS, MC_Bench_NowNs() - start);
+
+    printf("  dropped: %" PRIu64 "\n", MC_Trace_Dropped());
+
+    BENCH_TEARDOWN();
+}
+
+static void Bench_MC_Trace_Modules(void)
+{
+    BENCH_INIT();
+
+    char key[32];
+    MC_HashMap *map = MC_Hashmap_Init(BENCH_KEYS);
+
+    printf("  module spans %s\n", MC_Trace_IsEnabled() ? "built in (MC_TRACING)" : "compiled out");
+
+    for (u64 i = 0; i < BENCH_KEYS; i++)
+    {
+        snprintf(key, sizeof(key), "key %" PRIu64, i);
+        MC_Hashmap_Insert(map, key, (void*)(uintptr_t)(i + 1), false);
+    }
+
+    u64 start = MC_Bench_Start();
+    for (u64 i = 0; i < BENCH_SPANS; i++)
+    {
+        bench_sink += (uintptr_t)MC_Hashmap_Search(map, "key 511");
+    }
+    BENCH_REPORT("MC_Hashmap_Search, no session", BENCH_SPANS, MC_Bench_NowNs() - start);
+
+    if (MC_Trace_Start(2 * BENCH_SPANS) == 0)
+    {
+        start = MC_Bench_Start();
+        for (u64 i = 0; i < BENCH_SPANS; i++)
+        {
+            bench_sink += (uintptr_t)MC_Hashmap_Search(map, "key 511");
+        }
+        BENCH_REPORT("MC_Hashmap_Search, recording", BENCH_SPANS, MC_Bench_NowNs() - start);
+
+        MC_Trace_Stop();
+
+        MC_Histogram *spans = MC_Histogram_Init(0);
+
+        if (MC_Trace_Histogram("MC_Hashmap_Search", spans))
+        {
+            printf("[BENCH]:[MC_Hashmap_Search spans, recorded durations]\n");
+            MC_Bench_ReportLatency(spans);
+        }
+
+        MC_Histogram_Free(&spans);
+    }
+
+    MC_Hashmap_Free(&map);
+
+    BENCH_TEARDOWN();
+}
+
+int main(void)
+{
+    Bench_MC_Trace_Scope();
+    Bench_MC_Trace_Modules();
+
+    return 0;
+}
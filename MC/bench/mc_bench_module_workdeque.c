@@ -0,0 +1,345 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_bench_module_workdeque.c                                                            */
+/* \brief: Fork/join benchmarks for mc_workdeque: parallel fib and parallel tree sum             */
+/*                                                                                               */
+/* \Expects: 1. All necessary mc definitions are defined and linked properly                     */
+/*                                                                                               */
+/*           Every task spawns its children onto the running worker's WorkDeque and idle         */
+/*           workers steal from random victims. Results are compared to a sequential run,        */
+/*           and to a baseline where all workers share a single mutex protected MC_Stack.        */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#include "mc_bench.h"
+#include <stdlib.h>     // malloc
+#include <stdatomic.h>  // atomic_*
+#include <threads.h>    // thrd_create
+
+/**
+ * \brief fib(BENCH_FIB_N) is computed by the fib benchmark.
+ */
+#define BENCH_FIB_N 36
+
+/**
+ * \brief Below this n a fib task is computed sequentially instead of forking.
+ */
+#define BENCH_FIB_CUTOFF 16
+
+/**
+ * \brief Depth of the complete binary tree summed by the tree benchmark.
+ */
+#define BENCH_TREE_DEPTH 21
+
+/**
+ * \brief Subtrees of at most this depth are summed sequentially instead of forking.
+ */
+#define BENCH_TREE_CUTOFF 8
+
+/**
+ * \brief Kind of fork/join workload being scheduled.
+ */
+typedef enum
+{
+    BENCH_WORK_FIB,
+    BENCH_WORK_TREE
+} BenchWork;
+
+/**
+ * \brief Complete binary tree node, a tree task is a pointer to one of these.
+ */
+typedef struct TreeNode
+{
+    u64 value;
+    u32 depth;
+    struct TreeNode *left;
+    struct TreeNode *right;
+} TreeNode;
+
+/**
+ * \brief Shared state of one scheduler run.
+ */
+typedef struct
+{
+    BenchWork work;
+    u32 threads;
+    u8 useLockedStack;              // \brief Baseline: all workers share one mutex protected MC_Stack
+    MC_WorkDeque *deques[BENCH_MAX_THREADS];
+    MC_Stack *shared;
+    mtx_t sharedLock;
+    atomic_int_fast64_t pending;    // \brief Tasks spawned but not yet finished, 0 terminates the run
+    atomic_uint_fast64_t result;
+} Scheduler;
+
+typedef struct
+{
+    Scheduler *scheduler;
+    u32 id;
+} Worker;
+
+static u64 fib_sequential(u64 n)
+{
+    return n < 2 ? n : fib_sequential(n - 1) + fib_sequential(n - 2);
+}
+
+static u64 tree_sequential(const TreeNode *node)
+{
+    return node ? node->value + tree_sequential(node->left) + tree_sequential(node->right) : 0;
+}
+
+static TreeNode* tree_build(TreeNode *nodes, u64 *next, u32 depth)
+{
+    TreeNode *node = &nodes[(*next)++];
+    node->value = *next;
+    node->depth = depth;
+    node->left = depth > 1 ? tree_build(nodes, next, depth - 1) : NULL;
+    node->right = depth > 1 ? tree_build(nodes, next, depth - 1) : NULL;
+
+    return node;
+}
+
+/**
+ * \brief fib tasks are encoded directly in the task pointer as n + 1, so spawning never allocates.
+ */
+static void* fib_task(u64 n)
+{
+    return (void*)(uintptr_t)(n + 1);
+}
+
+static void scheduler_spawn(Scheduler *scheduler, u32 id, void *task)
+{
+    if (scheduler->useLockedStack)
+    {
+        mtx_lock(&scheduler->sharedLock);
+        MC_Stack_Push(scheduler->shared, task, false);
+        mtx_unlock(&scheduler->sharedLock);
+    }
+    else
+    {
+        MC_WorkDeque_Push(scheduler->deques[id], task);
+    }
+}
+
+static void* scheduler_next(Scheduler *scheduler, u32 id, u64 *rng)
+{
+    if (scheduler->useLockedStack)
+    {
+        mtx_lock(&scheduler->sharedLock);
+        void *task = MC_Stack_Pop(scheduler->shared);
+        mtx_unlock(&scheduler->sharedLock);
+
+        return task;
+    }
+
+    void *task = MC_WorkDeque_Pop(scheduler->deques[id]);
+
+    for (u32 attempt = 0; !task && attempt < scheduler->threads; attempt++)
+    {
+        *rng ^= *rng << 13; *rng ^= *rng >> 7; *rng ^= *rng << 17;   // xorshift victim selection
+        u32 victim = (u32)(*rng % scheduler->threads);
+
+        if (victim != id)
+        {
+            task = MC_WorkDeque_Steal(scheduler->deques[victim]);
+        }
+    }
+
+    return task;
+}
+
+/**
+ * \brief Run one task: fork its children, or compute a leaf and retire it.
+ * \details Forking two children and retiring the parent nets one extra pending task.
+ */
+static u64 scheduler_run(Scheduler *scheduler, u32 id, void *task)
+{
+    if (scheduler->work == BENCH_WORK_FIB)
+    {
+        u64 n = (u64)(uintptr_t)task - 1;
+
+        if (n < BENCH_FIB_CUTOFF)
+        {
+            atomic_fetch_sub_explicit(&scheduler->pending, 1, memory_order_release);
+
+            return fib_sequential(n);
+        }
+
+        atomic_fetch_add_explicit(&scheduler->pending, 1, memory_order_relaxed);
+        scheduler_spawn(scheduler, id, fib_task(n - 2));
+        scheduler_spawn(scheduler, id, fib_task(n - 1));
+
+        return 0;
+    }
+
+    TreeNode *node = (TreeNode*)task;
+
+    if (node->depth <= BENCH_TREE_CUTOFF)
+    {
+        atomic_fetch_sub_explicit(&scheduler->pending, 1, memory_order_release);
+
+        return tree_sequential(node);
+    }
+
+    i64 children = (node->left != NULL) + (node->right != NULL);
+
+    atomic_fetch_add_explicit(&scheduler->pending, children - 1, memory_order_release);
+
+    if (node->right)
+    {
+        scheduler_spawn(scheduler, id, node->right);
+    }
+
+    if (node->left)
+    {
+        scheduler_spawn(scheduler, id, node->left);
+    }
+
+    return node->value;
+}
+
+static int scheduler_worker(void *arg)
+{
+    Worker *worker = (Worker*)arg;
+    Scheduler *scheduler = worker->scheduler;
+    u64 rng = 0x9E3779B97F4A7C15ULL * (worker->id + 1);
+    u64 local = 0;
+
+    while (atomic_load_explicit(&scheduler->pending, memory_order_acquire) > 0)
+    {
+        void *task = scheduler_next(scheduler, worker->id, &rng);
+
+        if (task)
+        {
+            local += scheduler_run(scheduler, worker->id, task);
+        }
+        else
+        {
+            thrd_yield();
+        }
+    }
+
+    atomic_fetch_add_explicit(&scheduler->result, local, memory_order_relaxed);
+
+    return 0;
+}
+
+/**
+ * \brief Run root to completion on 'threads' workers, returning the reduced result.
+ */
+static u64 scheduler_execute(BenchWork work, void *root, u32 threads, u8 useLockedStack, u64 *elapsed_ns)
+{
+    Scheduler scheduler = { .work = work, .threads = threads, .useLockedStack = useLockedStack };
+    Worker workers[BENCH_MAX_THREADS];
+    thrd_t handles[BENCH_MAX_THREADS];
+
+    atomic_init(&scheduler.pending, 1);
+    atomic_init(&scheduler.result, 0);
+    mtx_init(&scheduler.sharedLock, mtx_plain);
+    scheduler.shared = MC_Stack_Init();
+
+    for (u32 i = 0; i < threads; i++)
+    {
+        scheduler.deques[i] = MC_WorkDeque_Init(1024);
+        workers[i].scheduler = &scheduler;
+        workers[i].id = i;
+    }
+
+    scheduler_spawn(&scheduler, 0, root);
+
+    u64 start = MC_Bench_NowNs();
+
+    for (u32 i = 1; i < threads; i++)
+    {
+        thrd_create(&handles[i], scheduler_worker, &workers[i]);
+    }
+
+    scheduler_worker(&workers[0]);
+
+    for (u32 i = 1; i < threads; i++)
+    {
+        thrd_join(handles[i], NULL);
+    }
+
+    *elapsed_ns = MC_Bench_NowNs() - start;
+
+    for (u32 i = 0; i < threads; i++)
+    {
+        MC_WorkDeque_Free(&scheduler.deques[i]);
+    }
+
+    MC_Stack_Free(&scheduler.shared);
+    mtx_destroy(&scheduler.sharedLock);
+
+    return atomic_load(&scheduler.result);
+}
+
+static void Bench_MC_WorkDeque_Run(BenchWork work, void *root, u64 expected, u64 sequential_ns)
+{
+    char label[64];
+
+    for (u8 locked = 0; locked <= 1; locked++)
+    {
+        for (u32 threads = 1; threads <= BENCH_MAX_THREADS; threads *= 2)
+        {
+            u64 elapsed = 0;
+            u64 result = scheduler_execute(work, root, threads, locked, &elapsed);
+
+            snprintf(label, sizeof(label), "%s %u thread(s)", locked ? "locked MC_Stack" : "MC_WorkDeque", threads);
+            printf("[BENCH]:[%s] - %.3f ms, speedup x%.2f vs sequential%s.\n", label, (double)elapsed / 1e6,
+                (double)sequential_ns / (double)(elapsed ? elapsed : 1), result == expected ? "" : " - WRONG RESULT");
+        }
+    }
+}
+
+static void Bench_MC_WorkDeque_Fib(void)
+{
+    BENCH_INIT();
+
+    u64 start = MC_Bench_NowNs();
+    u64 expected = fib_sequential(BENCH_FIB_N);
+    u64 sequential = MC_Bench_NowNs() - start;
+
+    printf("[BENCH]:[sequential fib(%d)] - %.3f ms.\n", BENCH_FIB_N, (double)sequential / 1e6);
+
+    /* The leaves only sum fib(n < cutoff), which adds up to fib(N) exactly. */
+    Bench_MC_WorkDeque_Run(BENCH_WORK_FIB, fib_task(BENCH_FIB_N), expected, sequential);
+
+    BENCH_TEARDOWN();
+}
+
+static void Bench_MC_WorkDeque_TreeSum(void)
+{
+    BENCH_INIT();
+
+    u64 count = (1ULL << BENCH_TREE_DEPTH) - 1;
+    u64 next = 0;
+    TreeNode *nodes = (TreeNode*)malloc(count * sizeof(TreeNode));
+
+    if (!nodes)
+    {
+        return;
+    }
+
+    TreeNode *root = tree_build(nodes, &next, BENCH_TREE_DEPTH);
+
+    u64 start = MC_Bench_NowNs();
+    u64 expected = tree_sequential(root);
+    u64 sequential = MC_Bench_NowNs() - start;
+
+    printf("[BENCH]:[sequential tree sum, %" PRIu64 " nodes] - %.3f ms.\n", count, (double)sequential / 1e6);
+
+    Bench_MC_WorkDeque_Run(BENCH_WORK_TREE, root, expected, sequential);
+
+    free(nodes);
+
+    BENCH_TEARDOWN();
+}
+
+int main(void)
+{
+    Bench_MC_WorkDeque_Fib();
+    Bench_MC_WorkDeque_TreeSum();
+
+    return 0;
+}
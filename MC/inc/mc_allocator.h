@@ -0,0 +1,123 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_allocator.h                                                                         */
+/* \brief: Provide a pluggable allocator interface used by every MC container                    */
+/*                                                                                               */
+/* \Expects: mc_type.h is linked properly and defines types needed                               */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#ifndef MC_ALLOCATOR_H
+#define MC_ALLOCATOR_H
+
+#include "mc_type.h"
+
+/**
+ * \brief Allocations at least this large are placed on their own pages by the NUMA allocator.
+ */
+#define MC_ALLOCATOR_PAGE_THRESHOLD (64 * 1024)
+
+/**
+ * \brief Allocations at least this large are placed on 2 MiB pages by the huge page allocator.
+ */
+#define MC_ALLOCATOR_HUGE_THRESHOLD (1024 * 1024)
+
+/**
+ * \brief Hint: Fill in an MC_Allocator and hand it to MC_Allocator_SetGlobal or an InitEx constructor.
+ * \details Allocator is a table of functions plus a user context which every MC module allocates
+ * through. Sizes are passed back on realloc and free so that sized allocators do not need a
+ * header per allocation. Every allocation must be aligned to at least 16 bytes.
+ * realloc may be NULL, it is then emulated with alloc, memcpy and free.
+ * free may be NULL for allocators which reclaim their memory in bulk, like an MC_Arena.
+ */
+typedef struct MC_Allocator
+{
+    void* (*alloc)(void *ctx, u64 size);                                    // \brief Allocate size bytes, NULL on failure
+    void* (*realloc)(void *ctx, void *memory, u64 old_size, u64 new_size);  // \brief Resize, keeping min(old_size, new_size) bytes
+    void  (*free)(void *ctx, void *memory, u64 size);                       // \brief Release an allocation of size bytes
+    void *ctx;                                                              // \brief Passed as the first argument of every call
+} MC_Allocator;
+
+/**
+ * \brief Get the built in allocator, backed by malloc, realloc and free.
+ * \returns const MC_Allocator*: The default allocator, valid for the process lifetime.
+ */
+const MC_Allocator* MC_Allocator_Default(void);
+
+/**
+ * \brief Replace the allocator MC uses whenever no allocator is given explicitly.
+ * \details Call it at startup, before any container exists: memory is always freed through the
+ * allocator that was global when the container was created, so containers created earlier keep
+ * working, but Guids from MC_GUID_Generate must be released under the same global allocator.
+ * \param allocator: Pointer to the allocator to use from now on, must outlive its use. NULL restores the default.
+ */
+void MC_Allocator_SetGlobal(const MC_Allocator *allocator);
+
+/**
+ * \brief Get the allocator MC uses whenever no allocator is given explicitly.
+ * \returns const MC_Allocator*: The global allocator, never NULL.
+ */
+const MC_Allocator* MC_Allocator_GetGlobal(void);
+
+/**
+ * \brief Get the state of whether or not the allocator is the built in malloc based one.
+ * \param allocator: Pointer to the allocator to inspect
+ * \returns u8: true if allocator is NULL or behaves like MC_Allocator_Default.
+ */
+u8 MC_Allocator_IsDefault(const MC_Allocator *allocator);
+
+/**
+ * \brief Allocate size bytes through allocator.
+ * \param allocator: Pointer to the allocator to use, NULL for the global one
+ * \param size: The number of bytes to allocate
+ * \returns void*: Pointer to uninitialized memory, NULL on failure.
+ */
+void* MC_Allocator_Alloc(const MC_Allocator *allocator, u64 size);
+
+/**
+ * \brief Resize an allocation made through allocator.
+ * \param allocator: Pointer to the allocator memory came from, NULL for the global one
+ * \param memory: Pointer to the allocation, NULL behaves like MC_Allocator_Alloc
+ * \param old_size: The size memory was allocated with
+ * \param new_size: The size wanted
+ * \returns void*: Pointer to the resized allocation, NULL on failure in which case memory is untouched.
+ */
+void* MC_Allocator_Realloc(const MC_Allocator *allocator, void *memory, u64 old_size, u64 new_size);
+
+/**
+ * \brief Release an allocation made through allocator.
+ * \param allocator: Pointer to the allocator memory came from, NULL for the global one
+ * \param memory: Pointer to the allocation, NULL is ignored
+ * \param size: The size memory was allocated with
+ */
+void MC_Allocator_Free(const MC_Allocator *allocator, void *memory, u64 size);
+
+/**
+ * \brief Copy a null terminated string through allocator, release it with a size of strlen + 1.
+ * \param allocator: Pointer to the allocator to use, NULL for the global one
+ * \param str: Null terminated string to copy
+ * \returns char*: Pointer to the copy, NULL on failure.
+ */
+char* MC_Allocator_StrDup(const MC_Allocator *allocator, const char *str);
+
+/**
+ * \brief Get an allocator which places large allocations on memory local to one NUMA node.
+ * \details Allocations of at least MC_ALLOCATOR_PAGE_THRESHOLD bytes get pages of their own bound
+ * to node (mbind on Linux, VirtualAllocExNuma on Windows), smaller ones come from malloc. Where
+ * NUMA placement is unavailable the pages are still allocated, just without a preferred node.
+ * \param node: The NUMA node to prefer
+ * \returns MC_Allocator: The allocator, copy it anywhere.
+ */
+MC_Allocator MC_Allocator_Numa(u32 node);
+
+/**
+ * \brief Get an allocator which places large allocations on 2 MiB pages to reduce TLB misses.
+ * \details Allocations of at least MC_ALLOCATOR_HUGE_THRESHOLD bytes are rounded up to whole huge
+ * pages. Explicit huge pages are tried first (MAP_HUGETLB, MEM_LARGE_PAGES), then 2 MiB aligned
+ * regular pages with a transparent huge page hint. Smaller ones come from malloc.
+ * \returns MC_Allocator: The allocator, copy it anywhere.
+ */
+MC_Allocator MC_Allocator_HugePage(void);
+
+#endif
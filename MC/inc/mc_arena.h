@@ -0,0 +1,150 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_arena.h                                                                             */
+/* \brief: Provide a bump pointer region allocator                                               */
+/*                                                                                               */
+/* \Expects: mc_type.h is linked properly and defines types needed                               */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#ifndef MC_ARENA_H
+#define MC_ARENA_H
+
+#include "mc_type.h"
+#include "mc_allocator.h"
+#include "mc_memtrack.h"
+
+/**
+ * \brief The alignment MC_Arena_Alloc uses, enough for any fundamental type.
+ */
+#define MC_ARENA_DEFAULT_ALIGNMENT 16
+
+/**
+ * \brief Hint: Use the MC_Arena_<action> interface to interact with the Arena pointer.
+ * \details Arena hands out memory by bumping a pointer through large chunks, and chains a new chunk
+ * when the current one is exhausted. Individual allocations are never freed: the whole Arena is
+ * emptied at once by Reset, or back to a savepoint by Rewind. Chunks are kept for reuse until
+ * the Arena itself is freed, so a Reset, fill, Reset cycle stops calling malloc after warming up.
+ * An Arena is not thread safe, use one per thread or per request.
+ */
+typedef struct MC_Arena MC_Arena;
+
+/**
+ * \brief A savepoint of an Arena, taken by MC_Arena_Mark and restored by MC_Arena_Rewind.
+ * \details Public only so that it can be held by value, treat the fields as opaque.
+ */
+typedef struct MC_ArenaMark
+{
+    void *chunk;    // \brief The chunk that was current when the mark was taken
+    u64 used;       // \brief The number of bytes of that chunk in use at the time
+} MC_ArenaMark;
+
+/**
+ * \brief Allocates memory for a new Arena, along with its first chunk.
+ * \param chunk_size: The number of bytes per chunk, 0 picks a default. Larger allocations get a chunk of their own.
+ * \returns MC_Arena*: the pointer to a new allocated Arena, NULL on failure.
+ */
+MC_Arena* MC_Arena_Init(u64 chunk_size);
+
+/**
+ * \brief Allocates memory for a new Arena whose chunks come from allocator.
+ * \param chunk_size: The number of bytes per chunk, 0 picks a default
+ * \param allocator: Pointer to the allocator to take chunks from, NULL for the global one. It is copied.
+ * \returns MC_Arena*: the pointer to a new allocated Arena, NULL on failure.
+ */
+MC_Arena* MC_Arena_InitEx(u64 chunk_size, const MC_Allocator *allocator);
+
+/**
+ * \brief Allocate size bytes from the Arena, aligned to MC_ARENA_DEFAULT_ALIGNMENT.
+ * \param arena: Pointer to the Arena to allocate from
+ * \param size: The number of bytes to allocate
+ * \returns void*: Pointer to uninitialized memory owned by the Arena, NULL on failure.
+ */
+void* MC_Arena_Alloc(MC_Arena *arena, u64 size);
+
+/**
+ * \brief Allocate size bytes from the Arena, aligned to alignment.
+ * \param arena: Pointer to the Arena to allocate from
+ * \param size: The number of bytes to allocate
+ * \param alignment: The required alignment, a power of two
+ * \returns void*: Pointer to uninitialized memory owned by the Arena, NULL on failure.
+ */
+void* MC_Arena_AllocAligned(MC_Arena *arena, u64 size, u64 alignment);
+
+/**
+ * \brief Allocate size zeroed bytes from the Arena, aligned to MC_ARENA_DEFAULT_ALIGNMENT.
+ * \param arena: Pointer to the Arena to allocate from
+ * \param size: The number of bytes to allocate
+ * \returns void*: Pointer to zeroed memory owned by the Arena, NULL on failure.
+ */
+void* MC_Arena_AllocZero(MC_Arena *arena, u64 size);
+
+/**
+ * \brief Copy a null terminated string into the Arena.
+ * \param arena: Pointer to the Arena to allocate from
+ * \param str: Null terminated string to copy
+ * \returns char*: Pointer to the copy owned by the Arena, NULL on failure.
+ */
+char* MC_Arena_StrDup(MC_Arena *arena, const char *str);
+
+/**
+ * \brief Take a savepoint of the Arena.
+ * \param arena: Pointer to the Arena to mark
+ * \returns MC_ArenaMark: The savepoint, pass it to MC_Arena_Rewind to release everything allocated since.
+ */
+MC_ArenaMark MC_Arena_Mark(const MC_Arena *arena);
+
+/**
+ * \brief Release everything allocated since mark was taken, in O(chunks allocated since).
+ * \details mark must come from this Arena, and must not be older than the last Reset or an
+ * earlier Rewind past it.
+ * \param arena: Pointer to the Arena to rewind
+ * \param mark: A savepoint returned by MC_Arena_Mark
+ */
+void MC_Arena_Rewind(MC_Arena *arena, MC_ArenaMark mark);
+
+/**
+ * \brief Release every allocation at once. The chunks are kept for reuse.
+ * \param arena: Pointer to the Arena to reset
+ */
+void MC_Arena_Reset(MC_Arena *arena);
+
+/**
+ * \brief Get the number of bytes handed out since the last Reset, including alignment padding.
+ * \param arena: Pointer to the Arena to inspect
+ * \returns u64: The bytes in use.
+ */
+u64 MC_Arena_Used(const MC_Arena *arena);
+
+/**
+ * \brief Get the number of bytes the Arena holds from the system across all of its chunks.
+ * \param arena: Pointer to the Arena to inspect
+ * \returns u64: The bytes reserved.
+ */
+u64 MC_Arena_Reserved(const MC_Arena *arena);
+
+/**
+ * \brief Get the memory counters of the Arena, covering its header and every chunk held, spare ones included.
+ * \param arena: Pointer to the Arena to inspect
+ * \param stats: Pointer to the counters to fill, zeroed when tracking is disabled
+ * \returns u8: true/false corresponding to success fail, false when MC is built without MC_ALLOC_TRACKING.
+ */
+u8 MC_Arena_MemStats(const MC_Arena *arena, MC_MemStats *stats);
+
+/**
+ * \brief Get an MC_Allocator which allocates from the Arena, to pass to any InitEx constructor.
+ * \details Its free does nothing, the memory is reclaimed by Reset, Rewind or Free of the Arena.
+ * Its realloc grows the most recent allocation in place when it still fits in the chunk.
+ * \param arena: Pointer to the Arena to allocate from, must outlive every use of the allocator
+ * \returns MC_Allocator: The allocator, copy it anywhere.
+ */
+MC_Allocator MC_Arena_AsAllocator(MC_Arena *arena);
+
+/**
+ * \brief Free the Arena and every chunk, invalidating all memory allocated from it.
+ * \param arena: Double Pointer to the Arena to free, set to NULL after freeing
+ */
+void MC_Arena_Free(MC_Arena **arena);
+
+#endif
@@ -12,6 +12,7 @@
 #define MC_GUID_H
 
 #include "mc_type.h"
+#include "mc_arena.h"
 
 /**
  * \brief Magic constant to represent the number for 8 bytes.
@@ -27,24 +28,95 @@
 
 /**
  * \brief Hint: Use the MC_GUID_<action> interface to interact with the GUID objects.
- * \details GUID Data type represents a globally unique identifier, as a string.
+ * \details GUID Data type represents a globally unique identifier of 16 bytes, typically
+ * represented in the format xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx.
+ * It is public so that it can be held by value, in arrays or inside other structures, without
+ * any allocation: see MC_GUID_GenerateInto and MC_GUID_GenerateBatch.
  */
-typedef struct MC_Guid MC_Guid;
+typedef struct MC_Guid
+{
+    u32 data1;                  // 4 bytes
+    u16 data2;                  // 2 bytes
+    u16 data3;                  // 2 bytes
+    u8  data4[EIGHT_BYTES];     // 8 bytes
+} MC_Guid;
 
 /**
- * \brief Generate a GUID object that is consistent with the windows standard implementation
- *        This Guid will need to be Released when finished.
+ * \brief Generate a random (RFC 4122 version 4) GUID object. This Guid will need to be Released when finished.
+ * \details The 122 random bits come from a ChaCha20 keystream kept per thread and seeded once from
+ *          the operating system (getrandom, getentropy or BCryptGenRandom), so a call costs no
+ *          system call and no lock. The generator is reseeded in the child after a fork.
  * \param guid: Double Pointer to the MC_Guid type struct that is to be altered
  * \returns u8: true/false corresponding to success fail.
  */
 u8 MC_GUID_Generate(MC_Guid **guid);
 
+/**
+ * \brief Generate a GUID object allocated through allocator.
+ *        This Guid will need to be Released with MC_GUID_ReleaseEx and the same allocator.
+ * \param guid: Double Pointer to the MC_Guid type struct that is to be altered
+ * \param allocator: Pointer to the allocator to use, NULL for the global one
+ * \returns u8: true/false corresponding to success fail.
+ */
+u8 MC_GUID_GenerateEx(MC_Guid **guid, const MC_Allocator *allocator);
+
+/**
+ * \brief Generate a GUID into a Guid the caller owns, nothing is allocated and nothing needs releasing.
+ * \param out: Pointer to the MC_Guid to fill
+ * \returns u8: true/false corresponding to success fail.
+ */
+u8 MC_GUID_GenerateInto(MC_Guid *out);
+
+/**
+ * \brief Generate count GUIDs into a caller array in one pass.
+ * \details Whole ChaCha20 blocks are written straight into the array, four Guids each, and the
+ *          version bits are then stamped in a second branch free loop.
+ * \param out: Pointer to the first of count MC_Guids to fill
+ * \param count: The number of Guids to generate, may be 0
+ * \returns u8: true/false corresponding to success fail.
+ */
+u8 MC_GUID_GenerateBatch(MC_Guid *out, u64 count);
+
+/**
+ * \brief Generate a time ordered RFC 9562 version 7 GUID: 48 bit unix millisecond timestamp, 16 bit counter, random tail.
+ * \details Strictly increasing within a process across all threads, also when the clock goes backwards,
+ *          so consecutive keys land next to each other in B-tree and LSM indexes.
+ * \param out: Pointer to the MC_Guid to fill
+ * \returns u8: true/false corresponding to success fail.
+ */
+u8 MC_GUID_GenerateV7(MC_Guid *out);
+
+/**
+ * \brief Generate a version 7 GUID for a caller supplied timestamp, in the same sequence as MC_GUID_GenerateV7.
+ * \details The timestamp is a lower bound, a value at or below the last one handed out continues that sequence.
+ * \param out: Pointer to the MC_Guid to fill
+ * \param unix_ms: Milliseconds since the unix epoch, only the low 48 bits are used
+ * \returns u8: true/false corresponding to success fail.
+ */
+u8 MC_GUID_GenerateV7At(MC_Guid *out, u64 unix_ms);
+
+/**
+ * \brief Generate a GUID object inside a caller supplied Arena, costing a pointer bump instead of a malloc.
+ *        This Guid must NOT be Released, it is reclaimed when the Arena is Reset, Rewound or Freed.
+ * \param arena: Pointer to the Arena to allocate from
+ * \param guid: Double Pointer to the MC_Guid type struct that is to be altered
+ * \returns u8: true/false corresponding to success fail.
+ */
+u8 MC_GUID_GenerateArena(MC_Arena *arena, MC_Guid **guid);
+
 /**
  * \brief Release/Free the memory of a dynamically allocated MC_Guid.
  * \param guid: Double Pointer to the MC_Guid to release, Set to NULL after function
  */
 void MC_GUID_Release(MC_Guid **guid);
 
+/**
+ * \brief Release/Free the memory of an MC_Guid made by MC_GUID_GenerateEx.
+ * \param guid: Double Pointer to the MC_Guid to release, Set to NULL after function
+ * \param allocator: Pointer to the allocator the Guid came from, NULL for the global one
+ */
+void MC_GUID_ReleaseEx(MC_Guid **guid, const MC_Allocator *allocator);
+
 /**
  * \brief Format a generated GUID into a typical formatted string xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx.
  * \param guid: Pointer to the MC_Guid to receive a formatted string version of
@@ -54,5 +126,77 @@ void MC_GUID_Release(MC_Guid **guid);
  */
 u8 MC_GUID_Format_String(const MC_Guid *guid, char *guid_str, u64 guid_str_size);
 
+/**
+ * \brief Format a GUID into the same uppercase string as MC_GUID_Format_String, without going through snprintf.
+ * \details A nibble lookup table, or SSSE3 shuffles when the processor supports them, detected once at runtime.
+ * \param guid: Pointer to the MC_Guid to format
+ * \param guid_str: Buffer receiving the 36 characters and a null terminator
+ * \param guid_str_size: The size of guid_str, at least MC_GUID_SIZE
+ * \returns u8: true/false corresponding to success fail.
+ */
+u8 MC_GUID_Format(const MC_Guid *guid, char *guid_str, u64 guid_str_size);
+
+/**
+ * \brief Format count GUIDs into consecutive null terminated strings, MC_GUID_SIZE bytes apart.
+ * \details Two Guids are formatted per step when AVX2 is available.
+ * \param guids: Pointer to the first of count MC_Guids
+ * \param count: The number of Guids to format, may be 0
+ * \param guid_strs: Buffer receiving the strings, string i starts at guid_strs + i * MC_GUID_SIZE
+ * \param guid_strs_size: The size of guid_strs, at least count * MC_GUID_SIZE
+ * \returns u8: true/false corresponding to success fail.
+ */
+u8 MC_GUID_FormatN(const MC_Guid *guids, u64 count, char *guid_strs, u64 guid_strs_size);
+
+/**
+ * \brief Parse a string xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx back into a GUID, hex digits of either case.
+ * \param guid_str: The string to parse, only its first 36 characters are read
+ * \param guid_str_size: The number of readable characters at guid_str, at least 36
+ * \param guid: Pointer to the MC_Guid to fill, left untouched on failure
+ * \returns u8: true/false corresponding to success fail.
+ */
+u8 MC_GUID_Parse(const char *guid_str, u64 guid_str_size, MC_Guid *guid);
+
+/**
+ * \brief Parse count strings laid out as MC_GUID_FormatN writes them, MC_GUID_SIZE bytes apart.
+ * \param guid_strs: Pointer to the first string
+ * \param count: The number of strings to parse, may be 0
+ * \param guids: Pointer to the first of count MC_Guids to fill
+ * \returns u8: true/false corresponding to success fail, stops at the first string that is not a Guid.
+ */
+u8 MC_GUID_ParseN(const char *guid_strs, u64 count, MC_Guid *guids);
+
+/**
+ * \brief Order two GUIDs the way their strings order, so version 7 Guids compare by time.
+ * \param left: Pointer to the first MC_Guid, NULL orders first
+ * \param right: Pointer to the second MC_Guid, NULL orders first
+ * \returns int: negative, 0 or positive as left is below, equal to or above right.
+ */
+int MC_GUID_Compare(const MC_Guid *left, const MC_Guid *right);
+
+/**
+ * \brief Compare two GUIDs for equality as two 64 bit loads.
+ * \param left: Pointer to the first MC_Guid
+ * \param right: Pointer to the second MC_Guid
+ * \returns u8: true if both hold the same 16 bytes, or both are NULL.
+ */
+u8 MC_GUID_Equal(const MC_Guid *left, const MC_Guid *right);
+
+/**
+ * \brief Hash a GUID with one multiply per half, the bits of a generated Guid are mostly random already.
+ * \param guid: Pointer to the MC_Guid to hash
+ * \returns u64: The hash, 0 for NULL.
+ */
+u64 MC_GUID_Hash(const MC_Guid *guid);
+
+/**
+ * \brief Sort an array of GUIDs into MC_GUID_Compare order with an LSD radix sort, one byte per pass.
+ * \details Passes where every Guid holds the same byte are skipped. Uses count Guids of scratch memory
+ *          from the global allocator, short arrays are insertion sorted in place instead.
+ * \param guids: Pointer to the first of count MC_Guids
+ * \param count: The number of Guids, may be 0
+ * \returns u8: true/false corresponding to success fail, false if the scratch memory could not be allocated.
+ */
+u8 MC_GUID_Sort(MC_Guid *guids, u64 count);
+
 
 #endif
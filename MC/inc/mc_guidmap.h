@@ -0,0 +1,92 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_guidmap.h                                                                           */
+/* \brief: Provide a hash map keyed by MC_Guid                                                   */
+/*                                                                                               */
+/* \Expects: mc_type.h and mc_guid.h are linked properly and define types needed                 */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#ifndef MC_GUIDMAP_H
+#define MC_GUIDMAP_H
+
+#include "mc_type.h"
+#include "mc_guid.h"
+#include "mc_allocator.h"
+#include "mc_memtrack.h"
+
+/**
+ * \brief Hint: Use the MC_GuidMap_<action> interface to interact with the GuidMap pointer.
+ * \details GuidMap Data type represents a key/value combination keyed by MC_Guid. Keys are stored
+ * inline in one open addressed table, so a lookup hashes 16 bytes and compares two 64 bit words per
+ * probe, where MC_HashMap needs the Guid formatted to a string, hashed per character and compared
+ * with strncmp down a chain of separately allocated nodes. The table doubles when it is 3/4 full.
+ */
+typedef struct MC_GuidMap MC_GuidMap;
+
+/**
+ * \brief Allocates memory for a new GuidMap, sized to hold size entries before it has to grow.
+ * \param size: expected number of entries, 0 for a small default
+ * \returns MC_GuidMap*: the pointer to a new allocated GuidMap, NULL on failure.
+ */
+MC_GuidMap* MC_GuidMap_Init(u64 size);
+
+/**
+ * \brief Create a new GuidMap whose map and table come from allocator.
+ * \details The allocator is copied into the GuidMap, its context must outlive the GuidMap.
+ * MC_GuidMap_Init is MC_GuidMap_InitEx with the global allocator.
+ * \param size: expected number of entries, 0 for a small default
+ * \param allocator: Pointer to the allocator to use, NULL for the global one
+ * \returns MC_GuidMap*: the pointer to a new allocated GuidMap, NULL on failure.
+ */
+MC_GuidMap* MC_GuidMap_InitEx(u64 size, const MC_Allocator *allocator);
+
+/**
+ * \brief Add an element into the GuidMap collection. If the Key already exists, update the value.
+ * \param map: Pointer to the GuidMap to insert into
+ * \param key: Pointer to the Guid to use as Key, it is copied into the map
+ * \param value: Pointer to data as value for key/val pair
+ * \param dynamic: true/false, if the value to be inserted was dynamically allocated
+ * \returns u8: true/false corresponding to success fail.
+ */
+u8 MC_GuidMap_Insert(MC_GuidMap *map, const MC_Guid *key, void *value, const u8 dynamic);
+
+/**
+ * \brief Look for an existing key/value pair in the GuidMap.
+ * \param map: Pointer to the GuidMap to search from
+ * \param key: Pointer to the Guid to search for
+ * \returns void*: A pointer to the existing value if key is found, NULL if it doesn't exist.
+ */
+void* MC_GuidMap_Search(const MC_GuidMap *map, const MC_Guid *key);
+
+/**
+ * \brief Remove an element in the GuidMap if the key exists.
+ * \param map: Pointer to the GuidMap to remove from
+ * \param key: Pointer to the Guid of the key/val pair to be removed
+ * \returns u8: true/false corresponding to success fail.
+ */
+u8 MC_GuidMap_RemoveAt(MC_GuidMap *map, const MC_Guid *key);
+
+/**
+ * \brief Get the number of key/value pairs in the GuidMap.
+ * \param map: Pointer to the GuidMap
+ * \returns u64: The number of entries, 0 for NULL.
+ */
+u64 MC_GuidMap_Count(const MC_GuidMap *map);
+
+/**
+ * \brief Free the dynamic memory associated with this GuidMap object.
+ * \param map: Double Pointer to the GuidMap to free, Set to NULL after function
+ */
+void MC_GuidMap_Free(MC_GuidMap **map);
+
+/**
+ * \brief Get the memory counters of the GuidMap, covering its header and table.
+ * \param map: Pointer to the map to inspect
+ * \param stats: Pointer to the counters to fill, zeroed when tracking is disabled
+ * \returns u8: true/false corresponding to success fail, false when MC is built without MC_ALLOC_TRACKING.
+ */
+u8 MC_GuidMap_MemStats(const MC_GuidMap *map, MC_MemStats *stats);
+
+#endif
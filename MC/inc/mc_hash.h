@@ -12,6 +12,9 @@
 #define MC_HASH_H
 
 #include "mc_type.h"
+#include "mc_arena.h"
+#include "mc_allocator.h"
+#include "mc_memtrack.h"
 
 /**
  * \brief Hint: Use the hashmap_<action> interface to interact with the HashMap pointer.
@@ -26,6 +29,28 @@ typedef struct MC_HashMap MC_HashMap;
  */
 MC_HashMap* MC_Hashmap_Init(u64 size);
 
+/**
+ * \brief Create a new HashMap whose map, buckets, nodes and key copies all come from allocator.
+ * \details The allocator is copied into the HashMap, its context must outlive the HashMap.
+ * MC_Hashmap_Init is MC_Hashmap_InitEx with the global allocator. On the default allocator
+ * nodes come from a Pool shared by all such HashMaps instead.
+ * \param size: desired size
+ * \param allocator: Pointer to the allocator to use, NULL for the global one
+ * \returns MC_HashMap*: the pointer to a new allocated HashMap, NULL on failure.
+ */
+MC_HashMap* MC_Hashmap_InitEx(u64 size, const MC_Allocator *allocator);
+
+/**
+ * \brief Create a new HashMap whose map, buckets, nodes and key copies all live in a caller supplied Arena.
+ * \details Inserting then costs a pointer bump instead of two heap allocations. Removed nodes are
+ * not reused, their memory is reclaimed when the Arena is Reset or Rewound. MC_Hashmap_Free still
+ * frees dynamic values but leaves the Arena memory alone. The HashMap must not outlive the Arena.
+ * \param arena: Pointer to the Arena to allocate from
+ * \param size: desired size
+ * \returns MC_HashMap*: the pointer to a new HashMap inside the Arena, NULL on failure.
+ */
+MC_HashMap* MC_Hashmap_InitArena(MC_Arena *arena, u64 size);
+
 /**
  * \brief Add an element into the HashMap collection. If the Key already exists, update the value.
  * \param map: Pointer to the HashMap to insert into
@@ -59,6 +84,14 @@ u8 MC_Hashmap_RemoveAt(MC_HashMap *map, const char *key);
  */
 void MC_Hashmap_Free(MC_HashMap **map);
 
+/**
+ * \brief Get the memory counters of the hashmap, covering its header, buckets, nodes and keys.
+ * \param map: Pointer to the map to inspect
+ * \param stats: Pointer to the counters to fill, zeroed when tracking is disabled
+ * \returns u8: true/false corresponding to success fail, false when MC is built without MC_ALLOC_TRACKING.
+ */
+u8 MC_Hashmap_MemStats(const MC_HashMap *map, MC_MemStats *stats);
+
 /**
  * \brief Print the contents of the hashmap using printf
  * \param map: Pointer to the HashMap to print
@@ -0,0 +1,196 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_histogram.h                                                                         */
+/* \brief: Provide a log-linear histogram for latency percentiles                                */
+/*                                                                                               */
+/* \Expects: mc_allocator.h and mc_memtrack.h are linked properly and define types needed        */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#ifndef MC_HISTOGRAM_H
+#define MC_HISTOGRAM_H
+
+#include "mc_type.h"
+#include "mc_allocator.h"
+#include "mc_memtrack.h"
+
+/**
+ * \brief Hint: Record a value per operation, nanoseconds for a latency, then ask for percentiles.
+ * \details Buckets are log-linear, like HdrHistogram: values below 2^bits have a bucket each, and every
+ * power of two above that is split into 2^(bits - 1) equal buckets, so a value is reported at most one
+ * part in 2^(bits - 1) above what was recorded, whatever its magnitude. Every u64 can be recorded.
+ *
+ * Recording finds the bucket with one bit scan and a shift, O(1) with no allocation. A Histogram is
+ * recorded into by one thread at a time, while any thread may read it; MC_HistogramRecorder gives
+ * every recording thread a Histogram of its own and merges them on demand.
+ */
+typedef struct MC_Histogram MC_Histogram;
+
+typedef struct MC_HistogramRecorder MC_HistogramRecorder;
+
+/**
+ * \brief Bits of precision MC_Histogram_Init uses when given 0, at most 1 part in 128 above the recorded value.
+ */
+#define MC_HISTOGRAM_DEFAULT_BITS 8
+
+/**
+ * \brief Most bits of precision a Histogram can have.
+ */
+#define MC_HISTOGRAM_MAX_BITS 14
+
+/**
+ * \brief Create a Histogram.
+ * \param sub_bucket_bits: Precision between 1 and MC_HISTOGRAM_MAX_BITS, 0 for MC_HISTOGRAM_DEFAULT_BITS
+ * \returns MC_Histogram*: the pointer to a new allocated Histogram, NULL on failure.
+ */
+MC_Histogram* MC_Histogram_Init(u8 sub_bucket_bits);
+
+/**
+ * \brief Create a Histogram drawing its memory from allocator.
+ * \param sub_bucket_bits: Precision between 1 and MC_HISTOGRAM_MAX_BITS, 0 for MC_HISTOGRAM_DEFAULT_BITS
+ * \param allocator: The allocator to use, NULL for the global one
+ * \returns MC_Histogram*: the pointer to a new allocated Histogram, NULL on failure.
+ */
+MC_Histogram* MC_Histogram_InitEx(u8 sub_bucket_bits, const MC_Allocator *allocator);
+
+/**
+ * \brief Record one value.
+ * \param histogram: The Histogram to record into, only ever from one thread at a time
+ * \param value: The value to record
+ */
+void MC_Histogram_Record(MC_Histogram *histogram, u64 value);
+
+/**
+ * \brief Record a value count times.
+ * \param histogram: The Histogram to record into, only ever from one thread at a time
+ * \param value: The value to record
+ * \param count: How many times it was seen
+ */
+void MC_Histogram_RecordN(MC_Histogram *histogram, u64 value, u64 count);
+
+/**
+ * \brief Forget every recorded value.
+ * \param histogram: The Histogram to clear
+ */
+void MC_Histogram_Reset(MC_Histogram *histogram);
+
+/**
+ * \brief Add the values of one Histogram to another.
+ * \details Histograms of equal precision add bucket by bucket, otherwise every bucket of from is
+ * recorded into into at the highest value it stands for.
+ * \param into: The Histogram to add to
+ * \param from: The Histogram to add, which may be recorded into meanwhile
+ * \returns u8: true/false corresponding to success fail
+ */
+u8 MC_Histogram_Merge(MC_Histogram *into, const MC_Histogram *from);
+
+/**
+ * \brief Get the number of values recorded.
+ * \param histogram: The Histogram to inspect
+ * \returns u64: The number of values, 0 for NULL.
+ */
+u64 MC_Histogram_Count(const MC_Histogram *histogram);
+
+/**
+ * \brief Get the smallest value recorded.
+ * \param histogram: The Histogram to inspect
+ * \returns u64: The exact smallest value, 0 when empty.
+ */
+u64 MC_Histogram_Min(const MC_Histogram *histogram);
+
+/**
+ * \brief Get the largest value recorded.
+ * \param histogram: The Histogram to inspect
+ * \returns u64: The exact largest value, 0 when empty.
+ */
+u64 MC_Histogram_Max(const MC_Histogram *histogram);
+
+/**
+ * \brief Get the mean of the recorded values, taking each at the middle of its bucket.
+ * \param histogram: The Histogram to inspect
+ * \returns double: The mean, 0 when empty.
+ */
+double MC_Histogram_Mean(const MC_Histogram *histogram);
+
+/**
+ * \brief Get the value below or at which percentile percent of the recorded values lie.
+ * \details The result is the highest value of the bucket the percentile falls in, capped at the largest
+ * value recorded, so it is never below the true percentile.
+ * \param histogram: The Histogram to inspect
+ * \param percentile: Between 0 and 100, e.g. 99.9
+ * \returns u64: The value, 0 when empty.
+ */
+u64 MC_Histogram_Percentile(const MC_Histogram *histogram, double percentile);
+
+/**
+ * \brief Encode a Histogram into a portable byte string: a header, then only the buckets that hold values.
+ * \param histogram: The Histogram to encode
+ * \param buffer: Where to write, may be NULL to size the encoding first
+ * \param size: Bytes available at buffer
+ * \returns u64: Bytes the encoding takes, written only when it is no more than size; 0 for a NULL Histogram.
+ */
+u64 MC_Histogram_Serialize(const MC_Histogram *histogram, u8 *buffer, u64 size);
+
+/**
+ * \brief Decode a Histogram written by MC_Histogram_Serialize.
+ * \param buffer: The encoding
+ * \param size: Its length in bytes
+ * \param allocator: The allocator to use, NULL for the global one
+ * \returns MC_Histogram*: the pointer to a new allocated Histogram, NULL if the encoding is malformed.
+ */
+MC_Histogram* MC_Histogram_Deserialize(const u8 *buffer, u64 size, const MC_Allocator *allocator);
+
+/**
+ * \brief Write the cumulative distribution in the HdrHistogram percentile format, one line per bucket holding values.
+ * \param histogram: The Histogram to write
+ * \param path: The file to write, NULL for stdout
+ * \returns int: 0 on success, -1 if the file cannot be written.
+ */
+int MC_Histogram_WriteCdf(const MC_Histogram *histogram, const char *path);
+
+/**
+ * \brief Get the bytes held by a Histogram.
+ * \param histogram: The Histogram to inspect
+ * \param stats: Pointer to the counters to fill
+ * \returns u8: true/false corresponding to success fail, false when tracking is disabled.
+ */
+u8 MC_Histogram_MemStats(const MC_Histogram *histogram, MC_MemStats *stats);
+
+/**
+ * \brief Free the dynamic memory associated with this Histogram object.
+ * \param histogram: Pointer to the Histogram, set to NULL
+ */
+void MC_Histogram_Free(MC_Histogram **histogram);
+
+/**
+ * \brief Create a Recorder, which keeps a Histogram per recording thread.
+ * \param sub_bucket_bits: Precision of every thread's Histogram, 0 for MC_HISTOGRAM_DEFAULT_BITS
+ * \returns MC_HistogramRecorder*: the pointer to a new allocated Recorder, NULL on failure.
+ */
+MC_HistogramRecorder* MC_HistogramRecorder_Init(u8 sub_bucket_bits);
+
+/**
+ * \brief Record one value into the calling thread's Histogram, lock-free.
+ * \details A thread's first value creates its Histogram, after that recording finds it through a small
+ * per-thread cache and costs what MC_Histogram_Record does.
+ * \param recorder: The Recorder to record into, from any number of threads
+ * \param value: The value to record
+ */
+void MC_HistogramRecorder_Record(MC_HistogramRecorder *recorder, u64 value);
+
+/**
+ * \brief Merge every thread's Histogram into one, while they may still be recorded into.
+ * \param recorder: The Recorder to read
+ * \param into: The Histogram to add the values to
+ * \returns u8: true/false corresponding to success fail
+ */
+u8 MC_HistogramRecorder_Snapshot(const MC_HistogramRecorder *recorder, MC_Histogram *into);
+
+/**
+ * \brief Free a Recorder and its Histograms. No thread may be recording into it.
+ * \param recorder: Pointer to the Recorder, set to NULL
+ */
+void MC_HistogramRecorder_Free(MC_HistogramRecorder **recorder);
+
+#endif
@@ -11,39 +11,225 @@
 #ifndef MC_LOG_H
 #define MC_LOG_H
 
+#include "mc_type.h"
 #include <stdio.h>  // file ops
 #include <stdlib.h> // exit failure
+#include <stdatomic.h>  // atomic_load_explicit
+
+/**
+ * \brief Lowest level whose macros are compiled in: 0 DEBUG, 1 INFO, 2 WARNING, 3 ERROR, 4 none.
+ * \details Macros below it expand to nothing, their arguments are never compiled, let alone evaluated.
+ * Set it with the CMake cache variable of the same name, or define it before including mc_log.h.
+ */
+#ifndef MC_LOG_COMPILE_LEVEL
+#define MC_LOG_COMPILE_LEVEL 0
+#endif
+
+/**
+ * \brief Enumeration for log levels
+ */
+typedef enum 
+{
+    MC_LOG_LEVEL_DEBUG,                // \brief Debugging level
+    MC_LOG_LEVEL_INFO,                 // \brief Informational level
+    MC_LOG_LEVEL_WARNING,              // \brief Warning level
+    MC_LOG_LEVEL_ERROR,                // \brief Error level
+    MC_LOG_LEVEL_OFF                   // \brief Threshold only, above every level so nothing is logged
+} LogLevel;
+
+/**
+ * \brief The runtime threshold, lines below it are skipped. Change it through MC_Log_SetLevel.
+ * \details exposed to the MC library so the macros can test it inline, before any argument is evaluated
+ */
+extern atomic_int mc_log_threshold;
+
+/**
+ * \brief Whether a line of level lvl would be logged right now, one relaxed load.
+ * Use it to guard work that only exists to feed a log statement.
+ */
+#define MC_LOG_ENABLED(lvl) ((int)(lvl) >= atomic_load_explicit(&mc_log_threshold, memory_order_relaxed))
+
+/**
+ * \brief Log at level lvl only when MC_LOG_ENABLED, the arguments are evaluated only then.
+ */
+#define MC_LOG_AT(lvl, format, ...)                                 \
+    do                                                              \
+    {                                                               \
+        if (MC_LOG_ENABLED(lvl))                                    \
+        {                                                           \
+            MC_Log_Message((lvl), format, ##__VA_ARGS__);           \
+        }                                                           \
+    } while (0)
 
 /**
  * \brief Use the Logger to make a DEBUG statement
  */
-#define MC_LOG_DEBUG(format, ...)   MC_Log_Message(MC_LOG_LEVEL_DEBUG, format, ##__VA_ARGS__)
+#if MC_LOG_COMPILE_LEVEL <= 0
+#define MC_LOG_DEBUG(format, ...)   MC_LOG_AT(MC_LOG_LEVEL_DEBUG, format, ##__VA_ARGS__)
+#else
+#define MC_LOG_DEBUG(format, ...)   ((void)0)
+#endif
 
 /**
  * \brief Use the Logger to make an INFO statement
  */
-#define MC_LOG_INFO(format, ...)    MC_Log_Message(MC_LOG_LEVEL_INFO, format, ##__VA_ARGS__)
+#if MC_LOG_COMPILE_LEVEL <= 1
+#define MC_LOG_INFO(format, ...)    MC_LOG_AT(MC_LOG_LEVEL_INFO, format, ##__VA_ARGS__)
+#else
+#define MC_LOG_INFO(format, ...)    ((void)0)
+#endif
 
 /**
  * \brief Use the Logger to make a WARNING statement
  */
-#define MC_LOG_WARNING(format, ...) MC_Log_Message(MC_LOG_LEVEL_WARNING, format, ##__VA_ARGS__)
+#if MC_LOG_COMPILE_LEVEL <= 2
+#define MC_LOG_WARNING(format, ...) MC_LOG_AT(MC_LOG_LEVEL_WARNING, format, ##__VA_ARGS__)
+#else
+#define MC_LOG_WARNING(format, ...) ((void)0)
+#endif
 
 /**
  * \brief Use the Logger to make an ERROR statement
  */
-#define MC_LOG_ERROR(format, ...)   MC_Log_Message(MC_LOG_LEVEL_ERROR, format, ##__VA_ARGS__)
+#if MC_LOG_COMPILE_LEVEL <= 3
+#define MC_LOG_ERROR(format, ...)   MC_LOG_AT(MC_LOG_LEVEL_ERROR, format, ##__VA_ARGS__)
+#else
+#define MC_LOG_ERROR(format, ...)   ((void)0)
+#endif
 
 /**
- * \brief Enumeration for log levels
+ * \brief Log in binary when the log was opened by MC_Log_InitBinary, as MC_LOG_AT otherwise.
+ * \details The site registers format once, on its first call, and from then on a call copies only the
+ * format id, a time stamp counter reading and the raw arguments; MC_Log_Decode does the formatting.
+ * format must be a string literal, %n and wide characters are logged as text, strings are cut short to
+ * fit a record. Compiled out below MC_LOG_COMPILE_LEVEL like the level macros.
  */
-typedef enum 
+#define MC_LOG_BINARY(lvl, format, ...)                                     \
+    do                                                                      \
+    {                                                                       \
+        static atomic_uint mc_log_site_;                                    \
+        if ((int)(lvl) >= MC_LOG_COMPILE_LEVEL && MC_LOG_ENABLED(lvl))      \
+        {                                                                   \
+            MC_Log_Binary(&mc_log_site_, (lvl), format, ##__VA_ARGS__);     \
+        }                                                                   \
+    } while (0)
+
+/**
+ * \brief State of one MC_LOG_LIMIT or MC_LOG_SAMPLE call site, a static the macro declares.
+ */
+typedef struct MC_LogSite
 {
-    MC_LOG_LEVEL_DEBUG,                // \brief Debugging level
-    MC_LOG_LEVEL_INFO,                 // \brief Informational level
-    MC_LOG_LEVEL_WARNING,              // \brief Warning level
-    MC_LOG_LEVEL_ERROR                 // \brief Error level
-} LogLevel;
+    atomic_uint_fast64_t state;        // \brief Limit: ns at which the site's bucket runs empty. Sample: calls so far
+    atomic_uint_fast64_t suppressed;   // \brief Lines skipped since the last report of them
+    atomic_uint_fast64_t reported;     // \brief ns of the site's last report, its own lines report once a second
+    atomic_uchar listed;               // \brief On the list of sites the reports walk
+    struct MC_LogSite *next;           // \brief Next is a single linked list of every site that ever skipped a line
+    const char *file;                  // \brief Where the site is, for the report
+    int line;
+} MC_LogSite;
+
+#define MC_LOG_SITE_INIT { .file = __FILE__, .line = __LINE__ }
+
+/**
+ * \brief Log at level lvl at most per_second times a second on average, and burst times at once, from this
+ * call site. Skipped lines cost a clock read and an atomic add, nothing is formatted or evaluated, and are
+ * reported as "N line(s) suppressed at file:line": by the site's next line at most once a second, by the
+ * asynchronous writer every second and by MC_Log_Close.
+ */
+#define MC_LOG_LIMIT(lvl, per_second, burst, format, ...)                                  \
+    do                                                                                      \
+    {                                                                                       \
+        static MC_LogSite mc_log_limit_ = MC_LOG_SITE_INIT;                                 \
+        if ((int)(lvl) >= MC_LOG_COMPILE_LEVEL && MC_LOG_ENABLED(lvl) &&                   \
+            MC_Log_Limit(&mc_log_limit_, (per_second), (burst)))                            \
+        {                                                                                   \
+            MC_Log_Message((lvl), format, ##__VA_ARGS__);                                   \
+        }                                                                                   \
+    } while (0)
+
+/**
+ * \brief Log at level lvl one call in every n from this call site, the first included. Skipped lines are
+ * reported like those of MC_LOG_LIMIT.
+ */
+#define MC_LOG_SAMPLE(lvl, n, format, ...)                                                  \
+    do                                                                                      \
+    {                                                                                       \
+        static MC_LogSite mc_log_sample_ = MC_LOG_SITE_INIT;                                \
+        if ((int)(lvl) >= MC_LOG_COMPILE_LEVEL && MC_LOG_ENABLED(lvl) &&                   \
+            MC_Log_Sample(&mc_log_sample_, (n)))                                            \
+        {                                                                                   \
+            MC_Log_Message((lvl), format, ##__VA_ARGS__);                                   \
+        }                                                                                   \
+    } while (0)
+
+/**
+ * \brief Type of an MC_KV value
+ */
+typedef enum MC_KvType
+{
+    MC_KV_TYPE_U64,                    // \brief Unsigned integer
+    MC_KV_TYPE_I64,                    // \brief Signed integer
+    MC_KV_TYPE_F64,                    // \brief Floating point, NaN and infinities are written as null
+    MC_KV_TYPE_STR,                    // \brief Null terminated string, escaped, NULL is written as null
+    MC_KV_TYPE_BOOL                    // \brief true or false
+} MC_KvType;
+
+/**
+ * \brief One field of a structured line, build it with the MC_KV_ macros
+ */
+typedef struct MC_KV
+{
+    const char *key;                   // \brief Name of the field, escaped like a string value
+    MC_KvType type;                    // \brief Which member of value is set
+    union
+    {
+        u64 u;
+        i64 i;
+        double f;
+        const char *s;
+    } value;                           // \brief The value, by type
+} MC_KV;
+
+#define MC_KV_U64(key, v)   ((MC_KV){ (key), MC_KV_TYPE_U64, { .u = (u64)(v) } })
+#define MC_KV_I64(key, v)   ((MC_KV){ (key), MC_KV_TYPE_I64, { .i = (i64)(v) } })
+#define MC_KV_F64(key, v)   ((MC_KV){ (key), MC_KV_TYPE_F64, { .f = (double)(v) } })
+#define MC_KV_STR(key, v)   ((MC_KV){ (key), MC_KV_TYPE_STR, { .s = (v) } })
+#define MC_KV_BOOL(key, v)  ((MC_KV){ (key), MC_KV_TYPE_BOOL, { .u = (v) ? 1u : 0u } })
+
+/**
+ * \brief Log a JSON line, {"time":...,"level":...,"event":event,key:value,...}, for the MC_KV fields given.
+ * \details The fields are written straight into the line, no format string is parsed. The arguments are only
+ * evaluated when MC_LOG_ENABLED, and the statement is compiled out below MC_LOG_COMPILE_LEVEL.
+ */
+#define MC_LOG_KV(lvl, event, ...)                                                                  \
+    do                                                                                              \
+    {                                                                                               \
+        if ((int)(lvl) >= MC_LOG_COMPILE_LEVEL && MC_LOG_ENABLED(lvl))                              \
+        {                                                                                           \
+            const MC_KV mc_log_kv_[] = { MC_KV_BOOL(NULL, 0), ##__VA_ARGS__ };                      \
+            MC_Log_KV((lvl), (event), mc_log_kv_ + 1, sizeof(mc_log_kv_) / sizeof(mc_log_kv_[0]) - 1); \
+        }                                                                                           \
+    } while (0)
+
+/**
+ * \brief What an asynchronous log call does when its thread's ring is full
+ */
+typedef enum MC_LogOverflow
+{
+    MC_LOG_OVERFLOW_BLOCK,             // \brief Wait for the writer to make room, no line is lost
+    MC_LOG_OVERFLOW_DROP,              // \brief Discard the line, counted by MC_Log_Dropped
+    MC_LOG_OVERFLOW_COUNT              // \brief Discard the line, and have the writer log how many were lost
+} MC_LogOverflow;
+
+/**
+ * \brief Where and when MC_Log_InitMapped starts a new file
+ */
+typedef struct MC_LogRotation
+{
+    const char *path;                  // \brief Base path, files are "<path>.0", "<path>.1", ... NULL for last_run_output.txt
+    u64 file_size;                     // \brief Bytes mapped per file, 0 for 64 MiB, at least 128 KiB
+    u64 rotate_seconds;                // \brief Start a new file after this many seconds, 0 to rotate by size only
+} MC_LogRotation;
 
 /**
  * \brief Open the LOG_OUTPUT_FILE for write mode
@@ -52,10 +238,68 @@ typedef enum
 int MC_Log_Init();
 
 /**
- * \brief Close the LOG_OUTPUT_FILE
+ * \brief Open the LOG_OUTPUT_FILE and log asynchronously: callers format lines into a ring of their own
+ * and a background writer thread gathers them into large writes. A log already opened by MC_Log_Init
+ * is kept, with the lines written so far.
+ * \details Lines of one thread keep their order, lines of different threads may interleave out of
+ * timestamp order. A formatted line longer than a ring record, about 250 characters, is cut short.
+ * \param ring_capacity: Lines each thread can have waiting, rounded up to a power of two, 0 for 1024
+ * \param overflow: What a call does when its thread's ring is full
+ * \returns int: errorcode -1 if unable to make the log file or start the writer, or already asynchronous
+ */
+int MC_Log_InitAsync(u64 ring_capacity, MC_LogOverflow overflow);
+
+/**
+ * \brief Log into memory mapped, preallocated files: a line is copied into the mapping and the file is
+ * switched for the next one when it is full or rotate_seconds have passed. Closed files are cut to their length.
+ * \details A fatal signal (SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT) has the lines already copied written to
+ * disk, and in asynchronous mode the lines still in the rings copied first, before the previous handler runs.
+ * Call MC_Log_InitAsync afterwards to log asynchronously into the same files.
+ * \param rotation: Paths, file size and rotation period, NULL for the defaults
+ * \returns int: errorcode -1 if the first file cannot be mapped, or a log is already open
+ */
+int MC_Log_InitMapped(const MC_LogRotation *rotation);
+
+/**
+ * \brief Log asynchronously like MC_Log_InitAsync, into a binary file MC_Log_Decode turns back into text.
+ * \details MC_LOG_BINARY statements write raw arguments, every other statement a preformatted message.
+ * The file can only be decoded on a machine of the same byte order.
+ * \param path: The binary file, NULL for last_run_output.mclog
+ * \param ring_capacity: Entries each thread can have waiting, rounded up to a power of two, 0 for 1024
+ * \param overflow: What a call does when its thread's ring is full
+ * \returns int: errorcode -1 if unable to make the log file or start the writer, or a log is already open
+ */
+int MC_Log_InitBinary(const char *path, u64 ring_capacity, MC_LogOverflow overflow);
+
+/**
+ * \brief Wait until every line logged before the call is in the LOG_OUTPUT_FILE. Nothing to do when synchronous.
+ */
+void MC_Log_Flush();
+
+/**
+ * \brief Get the number of lines discarded because a ring was full, since MC_Log_InitAsync.
+ * \returns u64: The number of dropped lines.
+ */
+u64 MC_Log_Dropped();
+
+/**
+ * \brief Close the LOG_OUTPUT_FILE. In asynchronous mode every waiting line is written first and the
+ * writer thread stops. No thread may still be logging while it runs.
  */
 void MC_Log_Close();
 
+/**
+ * \brief Set the runtime threshold, lines of a lower level are skipped from then on.
+ * \param lvl: The lowest level to log, MC_LOG_LEVEL_OFF to log nothing. MC_LOG_LEVEL_DEBUG by default
+ */
+void MC_Log_SetLevel(LogLevel lvl);
+
+/**
+ * \brief Get the runtime threshold.
+ * \returns LogLevel: The lowest level being logged.
+ */
+LogLevel MC_Log_GetLevel();
+
 /**
  * \brief Log a message with a specific log level
  *
@@ -64,4 +308,54 @@ void MC_Log_Close();
  */
 void MC_Log_Message(LogLevel lvl, const char *fmt, ...);
 
+/**
+ * \brief Log a structured line through MC_LOG_KV, use the macro rather than calling it directly
+ * \details Lines are never cut short when synchronous. In the rings the fields that do not fit a record are
+ * left out and "truncated":true is added. In a binary log the line is stored as it is and gets its time and
+ * level back from MC_Log_Decode.
+ *
+ * \param lvl: LogLevel
+ * \param event: Name of the event
+ * \param fields: The fields, in the order they are written
+ * \param count: Number of fields
+ */
+void MC_Log_KV(LogLevel lvl, const char *event, const MC_KV *fields, u64 count);
+
+/**
+ * \brief Take a line for an MC_LOG_LIMIT site, use the macro rather than calling it directly
+ *
+ * \param site: The call site's state
+ * \param per_second: Lines allowed a second on average, 0 allows none
+ * \param burst: Lines allowed at once after a quiet period, at least 1
+ * \returns u8: true/false, true when the line is to be logged
+ */
+u8 MC_Log_Limit(MC_LogSite *site, u64 per_second, u64 burst);
+
+/**
+ * \brief Count a call of an MC_LOG_SAMPLE site, use the macro rather than calling it directly
+ *
+ * \param site: The call site's state
+ * \param n: One call in n is logged, 0 and 1 log every call
+ * \returns u8: true/false, true when the line is to be logged
+ */
+u8 MC_Log_Sample(MC_LogSite *site, u64 n);
+
+/**
+ * \brief Log a message through a MC_LOG_BINARY site, use the macro rather than calling it directly
+ *
+ * \param site: Format id of the call site, 0 until its first call
+ * \param lvl: LogLevel
+ * \param fmt: Format string for printing, the same one on every call through site
+ */
+void MC_Log_Binary(atomic_uint *site, LogLevel lvl, const char *fmt, ...);
+
+/**
+ * \brief Turn a binary log back into the lines the text modes would have written
+ *
+ * \param binary_path: File written by MC_Log_InitBinary
+ * \param out: Stream the lines are written to
+ * \returns int: errorcode -1 if the file cannot be read, is not a binary log or is cut short
+ */
+int MC_Log_Decode(const char *binary_path, FILE *out);
+
 #endif
@@ -0,0 +1,118 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_memtrack.h                                                                          */
+/* \brief: Provide opt in accounting of every allocation made by MC                              */
+/*                                                                                               */
+/* \Expects: mc_type.h is linked properly and defines types needed                               */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#ifndef MC_MEMTRACK_H
+#define MC_MEMTRACK_H
+
+#include "mc_type.h"
+
+/**
+ * \brief Hint: Build with MC_ALLOC_TRACKING defined (the CMake option of the same name) to turn tracking on.
+ * \details Every MC module reports what it allocates and frees through MC_MEMTRACK_ALLOC and
+ * MC_MEMTRACK_FREE. Without MC_ALLOC_TRACKING both expand to nothing, the per instance counters
+ * are compiled out of the containers, and the query functions report zeros.
+ *
+ * Containers count the bytes they ask for, while MC_Pool and MC_Arena count what they hold from
+ * the system, so memory served by a Pool or an Arena shows up under both modules.
+ */
+typedef enum MC_MemModule
+{
+    MC_MEM_MODULE_HASH,
+    MC_MEM_MODULE_STACK,
+    MC_MEM_MODULE_GUID,
+    MC_MEM_MODULE_ARENA,
+    MC_MEM_MODULE_POOL,
+    MC_MEM_MODULE_WORKDEQUE,
+    MC_MEM_MODULE_SPSCRING,
+    MC_MEM_MODULE_MPMCQUEUE,
+    MC_MEM_MODULE_GUIDMAP,
+    MC_MEM_MODULE_HISTOGRAM,
+    MC_MEM_MODULE_COUNT,
+    MC_MEM_MODULE_NONE          // \brief Counts the instance only, for memory kept for the process lifetime
+} MC_MemModule;
+
+/**
+ * \brief Counters of one module or one container instance.
+ */
+typedef struct MC_MemStats
+{
+    u64 liveBytes;      // \brief Bytes allocated and not yet freed
+    u64 peakBytes;      // \brief Highest liveBytes seen
+    u64 allocCount;     // \brief Number of allocations
+    u64 freeCount;      // \brief Number of frees
+} MC_MemStats;
+
+#if defined(MC_ALLOC_TRACKING)
+#define MC_MEMTRACK_ALLOC(module, instance, size) MC_MemTrack_Alloc((module), (instance), (size))
+#define MC_MEMTRACK_FREE(module, instance, size) MC_MemTrack_Free((module), (instance), (size))
+#else
+#define MC_MEMTRACK_ALLOC(module, instance, size) ((void)0)
+#define MC_MEMTRACK_FREE(module, instance, size) ((void)0)
+#endif
+
+/**
+ * \brief Get the state of whether or not MC was built with MC_ALLOC_TRACKING.
+ * \returns u8: true if tracking is compiled in.
+ */
+u8 MC_MemTrack_IsEnabled(void);
+
+/**
+ * \brief Record an allocation, normally through MC_MEMTRACK_ALLOC.
+ * \details Module counters are batched per thread and published every few operations, when a
+ * thread exits, or on MC_MemTrack_Flush. Instance counters are updated in place, under whatever
+ * exclusion the container already requires.
+ * \param module: The module the allocation belongs to, MC_MEM_MODULE_NONE to count only the instance
+ * \param instance: Pointer to the counters of the owning container, NULL for none
+ * \param size: The number of bytes allocated
+ */
+void MC_MemTrack_Alloc(MC_MemModule module, MC_MemStats *instance, u64 size);
+
+/**
+ * \brief Record a free, normally through MC_MEMTRACK_FREE.
+ * \param module: The module the allocation belongs to, MC_MEM_MODULE_NONE to count only the instance
+ * \param instance: Pointer to the counters of the owning container, NULL for none
+ * \param size: The number of bytes freed
+ */
+void MC_MemTrack_Free(MC_MemModule module, MC_MemStats *instance, u64 size);
+
+/**
+ * \brief Publish the calling thread's batched counts to the module counters.
+ */
+void MC_MemTrack_Flush(void);
+
+/**
+ * \brief Get the counters of one module, after flushing the calling thread.
+ * \details Other running threads may still hold up to a batch of unpublished counts, and peakBytes
+ * is sampled when batches are published, so it can miss a short spike smaller than a batch.
+ * \param module: The module to inspect
+ * \param stats: Pointer to the counters to fill, zeroed when tracking is disabled
+ * \returns u8: true/false corresponding to success fail, false when tracking is disabled.
+ */
+u8 MC_MemTrack_Module(MC_MemModule module, MC_MemStats *stats);
+
+/**
+ * \brief Get the printable name of a module.
+ * \param module: The module to name
+ * \returns const char*: The name, "unknown" for an out of range value.
+ */
+const char* MC_MemTrack_ModuleName(MC_MemModule module);
+
+/**
+ * \brief Print the counters of every module to stdout.
+ */
+void MC_MemTrack_PrintSummary(void);
+
+/**
+ * \brief Print every module still holding memory to stdout, meant to be called at shutdown.
+ * \returns u64: The total number of bytes still live across modules, 0 when nothing leaked.
+ */
+u64 MC_MemTrack_ReportLeaks(void);
+
+#endif
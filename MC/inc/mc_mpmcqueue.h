@@ -0,0 +1,102 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_mpmcqueue.h                                                                         */
+/* \brief: Provide a bounded multi producer, multi consumer queue                                */
+/*                                                                                               */
+/* \Expects: mc_type.h is linked properly and defines types needed                               */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#ifndef MC_MPMCQUEUE_H
+#define MC_MPMCQUEUE_H
+
+#include "mc_type.h"
+
+/**
+ * \brief Hint: Use the MC_MpmcQueue_<action> interface to interact with the MpmcQueue pointer.
+ * \details MpmcQueue is a bounded first in, first out queue of fixed size elements, copied by value,
+ * which any number of threads may enqueue into and dequeue from at the same time. Every slot
+ * carries a sequence number so producers and consumers only contend on the slot they claim,
+ * there is no global lock. The Try variants never block, the plain variants sleep on a futex
+ * while the queue is full or empty.
+ */
+typedef struct MC_MpmcQueue MC_MpmcQueue;
+
+/**
+ * \brief Allocates memory for a new MpmcQueue.
+ * \param capacity: number of elements the MpmcQueue can hold, rounded up to a power of two, at least 2
+ * \param elem_size: The size in bytes of every element, must be non-zero
+ * \returns MC_MpmcQueue*: the pointer to a new allocated MpmcQueue, NULL on failure.
+ */
+MC_MpmcQueue* MC_MpmcQueue_Init(u64 capacity, u64 elem_size);
+
+/**
+ * \brief Copy one element into the MpmcQueue if there is room, without blocking.
+ * \param queue: Pointer to the MpmcQueue to enqueue into
+ * \param value: Pointer to the element to copy
+ * \returns u8: true/false corresponding to success fail, false when full or closed
+ */
+u8 MC_MpmcQueue_TryEnqueue(MC_MpmcQueue* queue, const void* value);
+
+/**
+ * \brief Copy the oldest element out of the MpmcQueue if there is one, without blocking.
+ * \param queue: Pointer to the MpmcQueue to dequeue from
+ * \param out: Pointer to storage for one element
+ * \returns u8: true/false corresponding to success fail, false when empty
+ */
+u8 MC_MpmcQueue_TryDequeue(MC_MpmcQueue* queue, void* out);
+
+/**
+ * \brief Copy one element into the MpmcQueue, sleeping while it is full.
+ * \param queue: Pointer to the MpmcQueue to enqueue into
+ * \param value: Pointer to the element to copy
+ * \returns u8: true/false corresponding to success fail, false once the MpmcQueue is closed
+ */
+u8 MC_MpmcQueue_Enqueue(MC_MpmcQueue* queue, const void* value);
+
+/**
+ * \brief Copy the oldest element out of the MpmcQueue, sleeping while it is empty.
+ * \param queue: Pointer to the MpmcQueue to dequeue from
+ * \param out: Pointer to storage for one element
+ * \returns u8: true/false corresponding to success fail, false once the MpmcQueue is closed and drained
+ */
+u8 MC_MpmcQueue_Dequeue(MC_MpmcQueue* queue, void* out);
+
+/**
+ * \brief Close the MpmcQueue: further enqueues fail, and sleeping threads are woken up.
+ * \details Elements already in the MpmcQueue can still be dequeued, so consumers drain it and
+ * then see Dequeue return false.
+ * \param queue: Pointer to the MpmcQueue to close
+ */
+void MC_MpmcQueue_Close(MC_MpmcQueue* queue);
+
+/**
+ * \brief Get the state of whether or not the MpmcQueue is Empty or not.
+ * \param queue: Pointer to the MpmcQueue to determine if empty
+ * \returns u8: State of true/false to Is it empty, a snapshot while other threads are active.
+ */
+u8 MC_MpmcQueue_IsEmpty(const MC_MpmcQueue* queue);
+
+/**
+ * \brief Get the current number of elements in the MpmcQueue.
+ * \param queue: Pointer to the MpmcQueue to determine the size
+ * \returns u64: The MpmcQueue size, a snapshot while other threads are active.
+ */
+u64 MC_MpmcQueue_Size(const MC_MpmcQueue* queue);
+
+/**
+ * \brief Get the number of elements the MpmcQueue can hold.
+ * \param queue: Pointer to the MpmcQueue to determine the capacity
+ * \returns u64: The MpmcQueue capacity.
+ */
+u64 MC_MpmcQueue_Capacity(const MC_MpmcQueue* queue);
+
+/**
+ * \brief Free the dynamic memory associated with this MpmcQueue object.
+ * \details No other thread may be using the MpmcQueue at this point.
+ * \param queue: Double Pointer to the MpmcQueue to free, set to NULL after freeing
+ */
+void MC_MpmcQueue_Free(MC_MpmcQueue** queue);
+
+#endif
@@ -0,0 +1,105 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_perfcounters.h                                                                      */
+/* \brief: Provide hardware performance counters read around regions of code                     */
+/*                                                                                               */
+/* \Expects: mc_type.h is linked properly and defines types needed                               */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#ifndef MC_PERFCOUNTERS_H
+#define MC_PERFCOUNTERS_H
+
+#include "mc_type.h"
+
+/**
+ * \brief Hint: Open once, then Start and Stop around the region to measure, dividing by its operations.
+ * \details The counters are one perf_event_open group on Linux, so they are scheduled onto the PMU together
+ * and their ratios, such as instructions per cycle, come from the same stretch of time. They count the
+ * thread that opened them, in user space only.
+ *
+ * Counters the kernel refuses, because of perf_event_paranoid, a virtual machine without a PMU, or
+ * an event the CPU lacks, are left out and missing from MC_PerfSample.available. When none can be
+ * opened, or off Linux, Open returns NULL and every other function accepts NULL and measures nothing.
+ */
+typedef enum MC_PerfEvent
+{
+    MC_PERF_CYCLES,
+    MC_PERF_INSTRUCTIONS,
+    MC_PERF_CACHE_MISSES,
+    MC_PERF_BRANCH_MISSES,
+    MC_PERF_PAGE_FAULTS,
+    MC_PERF_CONTEXT_SWITCHES,
+    MC_PERF_EVENT_COUNT
+} MC_PerfEvent;
+
+/**
+ * \brief Counts of one measured region.
+ */
+typedef struct MC_PerfSample
+{
+    u64 values[MC_PERF_EVENT_COUNT];    // \brief Indexed by MC_PerfEvent, 0 for counters not available
+    u32 available;                      // \brief Bit (1 << event) set for every counter in values
+    u8 multiplexed;                     // \brief The group shared the PMU with others, values are scaled estimates
+} MC_PerfSample;
+
+typedef struct MC_PerfCounters MC_PerfCounters;
+
+/**
+ * \brief Open every counter the kernel allows for the calling thread, stopped.
+ * \returns MC_PerfCounters*: The counters, NULL if none can be opened.
+ */
+MC_PerfCounters* MC_PerfCounters_Open(void);
+
+/**
+ * \brief Get which counters were opened.
+ * \param counters: The counters to inspect, may be NULL
+ * \returns u32: Bit (1 << event) set for every open counter, 0 for NULL.
+ */
+u32 MC_PerfCounters_Available(const MC_PerfCounters *counters);
+
+/**
+ * \brief Zero the counters and start counting.
+ * \param counters: The counters to start, may be NULL
+ * \returns u8: true/false corresponding to success fail
+ */
+u8 MC_PerfCounters_Start(MC_PerfCounters *counters);
+
+/**
+ * \brief Read the counts since MC_PerfCounters_Start, leaving the counters running.
+ * \param counters: The counters to read, may be NULL
+ * \param sample: Pointer to the counts to fill, zeroed on failure
+ * \returns u8: true/false corresponding to success fail, false if the group was never scheduled.
+ */
+u8 MC_PerfCounters_Read(MC_PerfCounters *counters, MC_PerfSample *sample);
+
+/**
+ * \brief Stop counting and read the counts since MC_PerfCounters_Start.
+ * \param counters: The counters to stop, may be NULL
+ * \param sample: Pointer to the counts to fill, zeroed on failure, may be NULL
+ * \returns u8: true/false corresponding to success fail
+ */
+u8 MC_PerfCounters_Stop(MC_PerfCounters *counters, MC_PerfSample *sample);
+
+/**
+ * \brief Close the counters and set the pointer to NULL.
+ * \param counters: Pointer to the counters, may point to NULL
+ */
+void MC_PerfCounters_Close(MC_PerfCounters **counters);
+
+/**
+ * \brief Get the printable name of an event.
+ * \param event: The event to name
+ * \returns const char*: The name, "unknown" for an out of range value.
+ */
+const char* MC_PerfCounters_EventName(MC_PerfEvent event);
+
+/**
+ * \brief Print the available counts of a sample per operation to stdout, with instructions per cycle when both are counted.
+ * \param sample: The counts to print, nothing is printed when none are available
+ * \param ops: The number of operations the region performed
+ */
+void MC_PerfCounters_PrintPerOp(const MC_PerfSample *sample, u64 ops);
+
+#endif
@@ -0,0 +1,43 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_platform.h                                                                          */
+/* \brief: Provide the C runtime calls whose safe forms differ between Windows and POSIX         */
+/*                                                                                               */
+/* \Expects: No expectations are made prior to type definitions in this file                     */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#ifndef MC_PLATFORM_H
+#define MC_PLATFORM_H
+
+#include "mc_type.h"
+#include <stdio.h>      // FILE
+#include <time.h>       // time_t, struct tm
+
+/**
+ * \brief Open a file, fopen_s on Windows and fopen elsewhere.
+ * \param stream: Set to the opened file, NULL on failure
+ * \param path: The file to open
+ * \param mode: As for fopen
+ * \returns int: 0 on success, the errno value otherwise.
+ */
+int MC_FOpen(FILE **stream, const char *path, const char *mode);
+
+/**
+ * \brief Convert a calendar time to local time without sharing a static buffer between threads,
+ * localtime_s on Windows and localtime_r elsewhere.
+ * \param time: The calendar time to convert
+ * \param result: The broken down local time
+ * \returns u8: true/false corresponding to success fail
+ */
+u8 MC_LocalTime(const time_t *time, struct tm *result);
+
+/**
+ * \brief Copy a string into memory from malloc, _strdup on Windows and strdup elsewhere.
+ * \param str: The string to copy
+ * \returns char*: The copy, to release with free, NULL on failure.
+ */
+char* MC_StrDup(const char *str);
+
+#endif
@@ -0,0 +1,103 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_pool.h                                                                              */
+/* \brief: Provide a fixed size object pool allocator                                            */
+/*                                                                                               */
+/* \Expects: mc_type.h is linked properly and defines types needed                               */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#ifndef MC_POOL_H
+#define MC_POOL_H
+
+#include "mc_type.h"
+#include "mc_memtrack.h"
+
+/**
+ * \brief The number of bytes of one slab, objects too large to fit 8 per slab get larger slabs.
+ */
+#define MC_POOL_SLAB_SIZE 4096
+
+/**
+ * \brief Hint: Use the MC_Pool_<action> interface to interact with the Pool pointer.
+ * \details Pool hands out objects of one fixed size, carved out of page sized slabs. Free objects
+ * are threaded onto an intrusive free list inside the objects themselves, so the Pool needs no
+ * bookkeeping memory per object. Every thread keeps a small magazine of free objects per Pool,
+ * so Alloc and Release only take the Pool lock when a magazine runs empty or full. Slabs which
+ * become completely free are returned to the system once more than a threshold of them pile up.
+ * Alloc and Release may be called from any thread, and an object may be released by another
+ * thread than the one which allocated it.
+ */
+typedef struct MC_Pool MC_Pool;
+
+/**
+ * \brief Allocates memory for a new Pool. No slab is allocated until the first Alloc.
+ * \param object_size: The size in bytes of every object, must be non-zero. Objects are 16 byte aligned.
+ * \param max_empty_slabs: How many completely free slabs to keep around before returning them to the system
+ * \returns MC_Pool*: the pointer to a new allocated Pool, NULL on failure.
+ */
+MC_Pool* MC_Pool_Init(u64 object_size, u64 max_empty_slabs);
+
+/**
+ * \brief Allocates memory for a new Pool kept for the process lifetime, such as one shared by every container
+ * of a module. Its memory is left out of the MC_MEM_MODULE_POOL counters, so MC_MemTrack_ReportLeaks covers
+ * only what a program can free, while MC_Pool_MemStats still counts its slabs.
+ * \param object_size: The size in bytes of every object, must be non-zero. Objects are 16 byte aligned.
+ * \param max_empty_slabs: How many completely free slabs to keep around before returning them to the system
+ * \returns MC_Pool*: the pointer to a new allocated Pool, NULL on failure.
+ */
+MC_Pool* MC_Pool_InitShared(u64 object_size, u64 max_empty_slabs);
+
+/**
+ * \brief Allocate one object from the Pool.
+ * \param pool: Pointer to the Pool to allocate from
+ * \returns void*: Pointer to an uninitialized object, NULL on failure.
+ */
+void* MC_Pool_Alloc(MC_Pool *pool);
+
+/**
+ * \brief Give one object back to the Pool.
+ * \param pool: Pointer to the Pool the object was allocated from
+ * \param object: Pointer returned by MC_Pool_Alloc on the same Pool, NULL is ignored
+ */
+void MC_Pool_Release(MC_Pool *pool, void *object);
+
+/**
+ * \brief Return every object cached in the calling thread's magazine to the Pool.
+ * \details Happens automatically when a thread exits, call it directly before a thread goes idle
+ * for a long time so its cached objects can be reused by others or released.
+ * \param pool: Pointer to the Pool to flush the calling thread's magazine into
+ */
+void MC_Pool_Flush(MC_Pool *pool);
+
+/**
+ * \brief Get the size in bytes of the objects this Pool hands out, after rounding.
+ * \param pool: Pointer to the Pool to inspect
+ * \returns u64: The object size.
+ */
+u64 MC_Pool_ObjectSize(const MC_Pool *pool);
+
+/**
+ * \brief Get the number of slabs the Pool currently holds from the system.
+ * \param pool: Pointer to the Pool to inspect
+ * \returns u64: The slab count, a snapshot while other threads are active.
+ */
+u64 MC_Pool_SlabCount(MC_Pool *pool);
+
+/**
+ * \brief Get the memory counters of the Pool, covering the slabs it holds from the system.
+ * \param pool: Pointer to the Pool to inspect
+ * \param stats: Pointer to the counters to fill, zeroed when tracking is disabled
+ * \returns u8: true/false corresponding to success fail, false when MC is built without MC_ALLOC_TRACKING.
+ */
+u8 MC_Pool_MemStats(MC_Pool *pool, MC_MemStats *stats);
+
+/**
+ * \brief Free the Pool, every slab and every magazine, invalidating all objects allocated from it.
+ * \details No other thread may be using the Pool at this point.
+ * \param pool: Double Pointer to the Pool to free, set to NULL after freeing
+ */
+void MC_Pool_Free(MC_Pool **pool);
+
+#endif
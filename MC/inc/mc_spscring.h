@@ -0,0 +1,129 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_spscring.h                                                                          */
+/* \brief: Provide a lock-free single producer, single consumer ring buffer                      */
+/*                                                                                               */
+/* \Expects: mc_type.h is linked properly and defines types needed                               */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#ifndef MC_SPSCRING_H
+#define MC_SPSCRING_H
+
+#include "mc_type.h"
+
+/**
+ * \brief Hint: Use the MC_SpscRing_<action> interface to interact with the SpscRing pointer.
+ * \details SpscRing is a bounded first in, first out queue of fixed size elements, copied by value.
+ * Exactly one thread may act as the producer (Enqueue, EnqueueN, Reserve, Commit) and exactly
+ * one other thread as the consumer (Dequeue, DequeueN, Acquire, Release), without any locking.
+ */
+typedef struct MC_SpscRing MC_SpscRing;
+
+/**
+ * \brief Allocates memory for a new SpscRing.
+ * \param capacity: number of elements the SpscRing can hold, rounded up to a power of two
+ * \param elem_size: The size in bytes of every element, must be non-zero
+ * \returns MC_SpscRing*: the pointer to a new allocated SpscRing, NULL on failure.
+ */
+MC_SpscRing* MC_SpscRing_Init(u64 capacity, u64 elem_size);
+
+/**
+ * \brief Copy one element into the SpscRing. Producer only.
+ * \param ring: Pointer to the SpscRing to enqueue into
+ * \param value: Pointer to the element to copy
+ * \returns u8: true/false corresponding to success fail, false when the SpscRing is full
+ */
+u8 MC_SpscRing_Enqueue(MC_SpscRing* ring, const void* value);
+
+/**
+ * \brief Copy up to count contiguous elements into the SpscRing, publishing them all at once. Producer only.
+ * \param ring: Pointer to the SpscRing to enqueue into
+ * \param values: Pointer to count contiguous elements
+ * \param count: The number of elements to enqueue
+ * \returns u64: The number of elements enqueued, less than count when the SpscRing fills up.
+ */
+u64 MC_SpscRing_EnqueueN(MC_SpscRing* ring, const void* values, u64 count);
+
+/**
+ * \brief Copy the oldest element out of the SpscRing. Consumer only.
+ * \param ring: Pointer to the SpscRing to dequeue from
+ * \param out: Pointer to storage for one element
+ * \returns u8: true/false corresponding to success fail, false when the SpscRing is empty
+ */
+u8 MC_SpscRing_Dequeue(MC_SpscRing* ring, void* out);
+
+/**
+ * \brief Copy up to count of the oldest elements out of the SpscRing, in order. Consumer only.
+ * \param ring: Pointer to the SpscRing to dequeue from
+ * \param out: Pointer to storage for count elements
+ * \param count: The maximum number of elements to dequeue
+ * \returns u64: The number of elements dequeued.
+ */
+u64 MC_SpscRing_DequeueN(MC_SpscRing* ring, void* out, u64 count);
+
+/**
+ * \brief Zero-copy enqueue: get direct access to up to count free slots. Producer only.
+ * \details The slots are contiguous, so fewer than count may be granted near the end of the ring.
+ * Write the elements in place and then publish them with MC_SpscRing_Commit.
+ * \param ring: Pointer to the SpscRing to reserve from
+ * \param count: The number of slots wanted
+ * \param granted: Receives the number of contiguous slots available at the returned pointer
+ * \returns void*: Pointer to the first reserved slot, NULL if the SpscRing is full.
+ */
+void* MC_SpscRing_Reserve(MC_SpscRing* ring, u64 count, u64* granted);
+
+/**
+ * \brief Publish count slots previously handed out by MC_SpscRing_Reserve. Producer only.
+ * \param ring: Pointer to the SpscRing to commit into
+ * \param count: The number of slots written, at most the number granted
+ */
+void MC_SpscRing_Commit(MC_SpscRing* ring, u64 count);
+
+/**
+ * \brief Zero-copy dequeue: get direct access to up to count of the oldest elements. Consumer only.
+ * \details The elements are contiguous, so fewer than count may be granted near the end of the ring.
+ * Read the elements in place and then hand the slots back with MC_SpscRing_Release.
+ * \param ring: Pointer to the SpscRing to acquire from
+ * \param count: The number of elements wanted
+ * \param granted: Receives the number of contiguous elements available at the returned pointer
+ * \returns const void*: Pointer to the oldest element, NULL if the SpscRing is empty.
+ */
+const void* MC_SpscRing_Acquire(MC_SpscRing* ring, u64 count, u64* granted);
+
+/**
+ * \brief Hand back count slots previously handed out by MC_SpscRing_Acquire. Consumer only.
+ * \param ring: Pointer to the SpscRing to release into
+ * \param count: The number of elements consumed, at most the number granted
+ */
+void MC_SpscRing_Release(MC_SpscRing* ring, u64 count);
+
+/**
+ * \brief Get the state of whether or not the SpscRing is Empty or not.
+ * \param ring: Pointer to the SpscRing to determine if empty
+ * \returns u8: State of true/false to Is it empty, a snapshot while the other side is active.
+ */
+u8 MC_SpscRing_IsEmpty(const MC_SpscRing* ring);
+
+/**
+ * \brief Get the current number of elements in the SpscRing.
+ * \param ring: Pointer to the SpscRing to determine the size
+ * \returns u64: The SpscRing size, a snapshot while the other side is active.
+ */
+u64 MC_SpscRing_Size(const MC_SpscRing* ring);
+
+/**
+ * \brief Get the number of elements the SpscRing can hold.
+ * \param ring: Pointer to the SpscRing to determine the capacity
+ * \returns u64: The SpscRing capacity.
+ */
+u64 MC_SpscRing_Capacity(const MC_SpscRing* ring);
+
+/**
+ * \brief Free the dynamic memory associated with this SpscRing object.
+ * \param ring: Double Pointer to the SpscRing to free, set to NULL after freeing
+ */
+void MC_SpscRing_Free(MC_SpscRing** ring);
+
+#endif
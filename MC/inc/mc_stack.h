@@ -12,6 +12,8 @@
 #define MC_STACK_H
 
 #include "mc_type.h"
+#include "mc_arena.h"
+#include "mc_memtrack.h"
 
 /**
  * \brief Hint: Use the stack_<action> interface to interact with the Stack pointer.
@@ -26,21 +28,99 @@ typedef struct MC_Stack MC_Stack;
 MC_Stack* MC_Stack_Init();
 
 /**
- * \brief Add an element into the Stack collection. If the Key already exists, update the value.
+ * \brief Allocates memory for a new Stack through allocator, which also provides its nodes.
+ * \details With an allocator whose free is NULL, popped nodes are recycled by later pushes instead.
+ * \param allocator: Pointer to the allocator to use, NULL for the global one. It is copied.
+ * \returns MC_Stack*: the pointer to a new allocated Stack, NULL on failure.
+ */
+MC_Stack* MC_Stack_InitEx(const MC_Allocator* allocator);
+
+/**
+ * \brief Allocates memory for a new typed Stack, which stores elements by value in contiguous memory.
+ * \details Push copies elem_size bytes from the value pointer into the Stack, so no per element
+ * allocation is made. Pop and Peek return a pointer into the Stack storage which remains valid
+ * until the next Push, PushN, Reserve or Free.
+ * \param elem_size: The size in bytes of every element held by this Stack, must be non-zero
+ * \returns MC_Stack*: the pointer to a new allocated Stack, NULL on failure.
+ */
+MC_Stack* MC_Stack_InitTyped(u64 elem_size);
+
+/**
+ * \brief Allocates memory for a new typed Stack through allocator, which also provides its element storage.
+ * \param elem_size: The size in bytes of every element held by this Stack, must be non-zero
+ * \param allocator: Pointer to the allocator to use, NULL for the global one. It is copied.
+ * \returns MC_Stack*: the pointer to a new allocated Stack, NULL on failure.
+ */
+MC_Stack* MC_Stack_InitTypedEx(u64 elem_size, const MC_Allocator* allocator);
+
+/**
+ * \brief Create a new pointer Stack whose header and nodes live in a caller supplied Arena.
+ * \details Popped nodes are recycled by later pushes instead of being freed. MC_Stack_Free still
+ * frees dynamic values but leaves the Arena memory alone. The Stack must not outlive the Arena.
+ * \param arena: Pointer to the Arena to allocate from
+ * \returns MC_Stack*: the pointer to a new Stack inside the Arena, NULL on failure.
+ */
+MC_Stack* MC_Stack_InitArena(MC_Arena* arena);
+
+/**
+ * \brief Create a new typed Stack whose header and element storage live in a caller supplied Arena.
+ * \details Growing copies the elements into a new Arena block, the old one is reclaimed when the
+ * Arena is Reset or Rewound, so Reserve the expected capacity up front where possible.
+ * \param arena: Pointer to the Arena to allocate from
+ * \param elem_size: The size in bytes of every element held by this Stack, must be non-zero
+ * \returns MC_Stack*: the pointer to a new typed Stack inside the Arena, NULL on failure.
+ */
+MC_Stack* MC_Stack_InitTypedArena(MC_Arena* arena, u64 elem_size);
+
+/**
+ * \brief Ensure a typed Stack can hold at least capacity elements without reallocating.
+ * \param stack: Pointer to the typed Stack to grow
+ * \param capacity: The total number of elements the Stack should be able to hold
+ * \returns u8: true/false corresponding to success fail, always false for a pointer Stack.
+ */
+u8 MC_Stack_Reserve(MC_Stack* stack, u64 capacity);
+
+/**
+ * \brief Add an element into the Stack collection.
  * \param stack: Pointer to the Stack to push onto
- * \param value: Pointer to data as value
- * \param dynamic: true/false, if the value to be inserted was dynamically allocated
+ * \param value: Pointer to data as value, for a typed Stack elem_size bytes are copied from it
+ * \param dynamic: true/false, if the value to be inserted was dynamically allocated. Ignored by a typed Stack.
  * \returns u8: true/false corresponding to success fail
  */
 u8 MC_Stack_Push(MC_Stack* stack, void* value, u8 dynamic);
 
+/**
+ * \brief Add count elements into the Stack collection in one run, values[count - 1] ends up on top.
+ * \details A typed Stack copies the whole run with a single memcpy. A pointer Stack treats values
+ * as an array of void* and pushes each of them as non dynamic.
+ * \param stack: Pointer to the Stack to push onto
+ * \param values: Pointer to count contiguous elements
+ * \param count: The number of elements to push
+ * \returns u8: true/false corresponding to success fail, nothing is pushed on failure
+ */
+u8 MC_Stack_PushN(MC_Stack* stack, const void* values, u64 count);
+
 /**
  * \brief Remove the top element in the Stack if the Stack is non-empty.
+ * \details Ownership of a dynamic value is handed back to the caller, who becomes responsible for freeing it.
+ * For a typed Stack the returned pointer refers to Stack storage and is valid until the next Push.
  * \param stack: Pointer to the Stack to remove from
  * \returns void*: A pointer to the existing value if top of stack was popped, NULL otherwise.
  */
 void* MC_Stack_Pop(MC_Stack* stack);
 
+/**
+ * \brief Remove up to count elements from the top of the Stack in one run.
+ * \details out receives the popped run in push order, so out[0] is the deepest popped element and
+ * the previous top ends up last. This mirrors PushN, so a PushN followed by a PopN round-trips.
+ * A pointer Stack writes void* values into out and hands ownership of dynamic values to the caller.
+ * \param stack: Pointer to the Stack to remove from
+ * \param out: Pointer to storage for count elements, may be NULL to discard the elements
+ * \param count: The maximum number of elements to pop
+ * \returns u64: The number of elements actually popped.
+ */
+u64 MC_Stack_PopN(MC_Stack* stack, void* out, u64 count);
+
 /**
  * \brief Look at the top element in the Stack if the Stack is non-empty.
  * \param stack: Pointer to the Stack to peek from
@@ -62,6 +142,14 @@ u8 MC_Stack_IsEmpty(const MC_Stack* stack);
  */
 u64 MC_Stack_Size(const MC_Stack* stack);
 
+/**
+ * \brief Get the memory counters of the Stack, covering its header, nodes in use and element storage.
+ * \param stack: Pointer to the Stack to inspect
+ * \param stats: Pointer to the counters to fill, zeroed when tracking is disabled
+ * \returns u8: true/false corresponding to success fail, false when MC is built without MC_ALLOC_TRACKING.
+ */
+u8 MC_Stack_MemStats(const MC_Stack* stack, MC_MemStats* stats);
+
 /**
  * \brief Free the dynamic memory associated with this Stack object.
  * \param stack: Double Pointer to the Stack to free, we use a double 
@@ -69,4 +157,113 @@ u64 MC_Stack_Size(const MC_Stack* stack);
  */
 void MC_Stack_Free(MC_Stack** stack);
 
+/* ***********************************/
+/* Small buffer optimized Stack      */
+/* ***********************************/
+
+/**
+ * \brief Hint: Use the MC_SmallStack_<action> interface, or MC_SMALL_STACK to declare one.
+ * \details SmallStack is a typed Stack whose header and first elements live in caller provided
+ * memory, usually the caller's own stack frame. Nothing is allocated until more than the inline
+ * count of elements is pushed, at which point the elements spill into a heap buffer.
+ * The struct is public only so that it can be declared by value, use the interface to access it.
+ */
+typedef struct MC_SmallStack
+{
+    u8* items;              // \brief Current storage, inlineItems until the first spill
+    u8* inlineItems;        // \brief Caller provided storage for the first inlineCapacity elements
+    u64 size;               // \brief Number of elements currently held
+    u64 capacity;           // \brief Number of elements items can hold
+    u64 inlineCapacity;     // \brief Number of elements inlineItems can hold
+    u64 elemSize;           // \brief Size of one element in bytes
+    const MC_Allocator* allocator;  // \brief The global allocator at Init, a spill is allocated and freed through it
+} MC_SmallStack;
+
+/**
+ * \brief Declare a SmallStack 'name' of 'type' elements with 'count' inline slots in the current scope.
+ * \details The inline slots are declared alongside it, so it must not outlive the enclosing block.
+ * Call MC_SmallStack_Free before leaving the scope in case the SmallStack spilled.
+ */
+#define MC_SMALL_STACK(name, type, count) \
+    _Alignas(type) u8 name##_inline[sizeof(type) * (count)]; \
+    MC_SmallStack name; \
+    MC_SmallStack_Init(&name, name##_inline, (count), sizeof(type))
+
+/**
+ * \brief Initialize a SmallStack over caller provided inline storage. Does not allocate.
+ * \param stack: Pointer to the SmallStack to initialize
+ * \param inline_items: Storage for inline_count elements, suitably aligned for the element type
+ * \param inline_count: The number of elements inline_items can hold, may be 0
+ * \param elem_size: The size in bytes of every element, must be non-zero
+ * \returns u8: true/false corresponding to success fail
+ */
+u8 MC_SmallStack_Init(MC_SmallStack* stack, void* inline_items, u64 inline_count, u64 elem_size);
+
+/**
+ * \brief Copy one element of elem_size bytes onto the SmallStack, spilling to the heap if the inline slots are full.
+ * \param stack: Pointer to the SmallStack to push onto
+ * \param value: Pointer to the element to copy
+ * \returns u8: true/false corresponding to success fail
+ */
+u8 MC_SmallStack_Push(MC_SmallStack* stack, const void* value);
+
+/**
+ * \brief Copy count contiguous elements onto the SmallStack in one run, values[count - 1] ends up on top.
+ * \param stack: Pointer to the SmallStack to push onto
+ * \param values: Pointer to count contiguous elements
+ * \param count: The number of elements to push
+ * \returns u8: true/false corresponding to success fail, nothing is pushed on failure
+ */
+u8 MC_SmallStack_PushN(MC_SmallStack* stack, const void* values, u64 count);
+
+/**
+ * \brief Remove the top element of the SmallStack.
+ * \param stack: Pointer to the SmallStack to remove from
+ * \returns void*: Pointer to the popped element inside SmallStack storage, valid until the next Push. NULL if empty.
+ */
+void* MC_SmallStack_Pop(MC_SmallStack* stack);
+
+/**
+ * \brief Remove up to count elements from the top of the SmallStack, in the same order as MC_Stack_PopN.
+ * \param stack: Pointer to the SmallStack to remove from
+ * \param out: Pointer to storage for count elements, may be NULL to discard the elements
+ * \param count: The maximum number of elements to pop
+ * \returns u64: The number of elements actually popped.
+ */
+u64 MC_SmallStack_PopN(MC_SmallStack* stack, void* out, u64 count);
+
+/**
+ * \brief Look at the top element of the SmallStack.
+ * \param stack: Pointer to the SmallStack to peek from
+ * \returns void*: Pointer to the top element inside SmallStack storage, NULL if empty.
+ */
+void* MC_SmallStack_Peek(const MC_SmallStack* stack);
+
+/**
+ * \brief Get the state of whether or not the SmallStack is Empty or not.
+ * \param stack: Pointer to the SmallStack to determine if empty
+ * \returns u8: State of true/false to Is it empty.
+ */
+u8 MC_SmallStack_IsEmpty(const MC_SmallStack* stack);
+
+/**
+ * \brief Get the state of whether or not the SmallStack still lives entirely in its inline storage.
+ * \param stack: Pointer to the SmallStack to inspect
+ * \returns u8: true if the SmallStack never spilled to the heap since Init or Free.
+ */
+u8 MC_SmallStack_IsInline(const MC_SmallStack* stack);
+
+/**
+ * \brief Get the current size of the SmallStack.
+ * \param stack: Pointer to the SmallStack to determine the size
+ * \returns u64: The SmallStack size.
+ */
+u64 MC_SmallStack_Size(const MC_SmallStack* stack);
+
+/**
+ * \brief Release any heap storage the SmallStack spilled into, and empty it back onto its inline storage.
+ * \param stack: Pointer to the SmallStack to free, it remains usable afterwards
+ */
+void MC_SmallStack_Free(MC_SmallStack* stack);
+
 #endif
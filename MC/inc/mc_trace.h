@@ -0,0 +1,142 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_trace.h                                                                             */
+/* \brief: Provide scoped tracing spans written as Chrome trace events                           */
+/*                                                                                               */
+/* \Expects: mc_type.h is linked properly and defines types needed                               */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#ifndef MC_TRACE_H
+#define MC_TRACE_H
+
+#include "mc_type.h"
+#include "mc_histogram.h"
+#include <stdatomic.h>  // atomic_uchar
+
+/**
+ * \brief Hint: Call MC_Trace_Start, run the code of interest, call MC_Trace_Stop and MC_Trace_Write, then
+ * open the file in chrome://tracing or ui.perfetto.dev.
+ * \details Every thread records into a buffer of its own, created on its first event and never shared,
+ * so recording takes no lock and no atomic read-modify-write. Events carry the time stamp counter on
+ * x86 and the wall clock elsewhere, and are converted to microseconds only when written.
+ *
+ * A full buffer drops the events that follow, see MC_Trace_Dropped. Names are kept by pointer, so
+ * they must be string literals or otherwise outlive MC_Trace_Write.
+ *
+ * MC's own modules carry spans built in only with MC_TRACING defined (the CMake option of the same
+ * name): hash inserts, searches and removals, stack growth, and the log's writes, flushes and close.
+ */
+
+/**
+ * \brief Set while a session is recording, read by the macros before calling into the module.
+ */
+extern atomic_uchar mc_trace_enabled;
+
+/**
+ * \brief Spans the calling thread began in the current session and has not ended, read by MC_TRACE_END.
+ */
+extern _Thread_local u32 mc_trace_open_spans;
+
+#define MC_TRACE_ENABLED() atomic_load_explicit(&mc_trace_enabled, memory_order_relaxed)
+
+/**
+ * \brief MC_TRACE_END calls into the module only while the thread has a span open, so a span begun before
+ * MC_Trace_Stop is still closed and an end whose begin was skipped records nothing.
+ */
+#define MC_TRACE_BEGIN(name) do { if (MC_TRACE_ENABLED()) MC_Trace_Begin(name); } while (0)
+#define MC_TRACE_END(name) do { if (mc_trace_open_spans) MC_Trace_End(name); } while (0)
+#define MC_TRACE_INSTANT(name) do { if (MC_TRACE_ENABLED()) MC_Trace_Instant(name); } while (0)
+#define MC_TRACE_COUNTER(name, value) do { if (MC_TRACE_ENABLED()) MC_Trace_Counter((name), (value)); } while (0)
+
+/**
+ * \brief Trace the block that follows as one span: MC_TRACE_SCOPE("parse") { ... }
+ * \details The end is recorded when the block finishes normally, so leaving it with return, break or goto
+ * leaves the span open. Only a span whose begin was recorded gets an end.
+ */
+#define MC_TRACE_SCOPE(name)                                                                            \
+    for (u8 mc_trace_scope_ = (u8)((MC_TRACE_ENABLED() && MC_Trace_Begin(name)) + 1); mc_trace_scope_;  \
+         mc_trace_scope_ = (u8)(mc_trace_scope_ == 2 ? (MC_Trace_End(name), 0) : 0))
+
+#if defined(MC_TRACING)
+#define MC_TRACE_MODULE_BEGIN(name) MC_TRACE_BEGIN(name)
+#define MC_TRACE_MODULE_END(name) MC_TRACE_END(name)
+#else
+#define MC_TRACE_MODULE_BEGIN(name) ((void)0)
+#define MC_TRACE_MODULE_END(name) ((void)0)
+#endif
+
+/**
+ * \brief Get the state of whether or not MC was built with MC_TRACING, which puts spans in its modules.
+ * \returns u8: true if the module spans are compiled in.
+ */
+u8 MC_Trace_IsEnabled(void);
+
+/**
+ * \brief Start a recording session, discarding the events of the previous one.
+ * \details No thread may be recording, nor ending a span of the previous session, while this runs, the
+ * buffers of the previous session are freed.
+ * \param events_per_thread: Events each thread's buffer holds, 0 for the default of 65536
+ * \returns int: 0 on success, -1 if a session is already recording or events_per_thread is too large.
+ */
+int MC_Trace_Start(u64 events_per_thread);
+
+/**
+ * \brief Stop recording. MC_TRACE_SCOPE and MC_Trace_End still record the end of spans already begun.
+ */
+void MC_Trace_Stop(void);
+
+/**
+ * \brief Write the session's events to a Chrome trace event JSON file.
+ * \details Timestamps are microseconds since MC_Trace_Start. Threads still recording may add events
+ * while this runs, what they add after their count is read is left out.
+ * \param path: The file to write, NULL for last_run_trace.json
+ * \returns int: 0 on success, -1 if no session was started or the file cannot be written.
+ */
+int MC_Trace_Write(const char *path);
+
+/**
+ * \brief Add the durations of a session's spans of one name, in ns, to a Histogram.
+ * \details Spans are matched begin to end per thread, by name. A span still open, or nested deeper than
+ * 64 spans, is left out.
+ * \param name: The span name to gather, compared by content
+ * \param into: The Histogram to record the durations into
+ * \returns u64: The number of spans recorded, 0 if no session was started.
+ */
+u64 MC_Trace_Histogram(const char *name, MC_Histogram *into);
+
+/**
+ * \brief Get the number of events dropped by full buffers in this session.
+ * \returns u64: The number of events dropped.
+ */
+u64 MC_Trace_Dropped(void);
+
+/**
+ * \brief Record the beginning of a span on the calling thread, normally through MC_TRACE_BEGIN or MC_TRACE_SCOPE.
+ * \param name: The span's name
+ * \returns u8: true if the event was recorded.
+ */
+u8 MC_Trace_Begin(const char *name);
+
+/**
+ * \brief Record the end of the calling thread's innermost span, even after MC_Trace_Stop. Nothing is
+ * recorded unless that span's begin was, and by the same name.
+ * \param name: The span's name
+ */
+void MC_Trace_End(const char *name);
+
+/**
+ * \brief Record a point in time on the calling thread.
+ * \param name: The event's name
+ */
+void MC_Trace_Instant(const char *name);
+
+/**
+ * \brief Record the value of a counter, drawn as a graph over time.
+ * \param name: The counter's name
+ * \param value: The counter's value from now on
+ */
+void MC_Trace_Counter(const char *name, i64 value);
+
+#endif
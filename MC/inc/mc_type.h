@@ -78,6 +78,12 @@
  */
 #define I64_MAX INT64_MAX
 
+/**
+ * \brief represents the size in bytes of one cache line on the targeted x86-64 and ARM64 cores.
+ * Data written by different threads is padded to this size to avoid false sharing.
+ */
+#define MC_CACHE_LINE_SIZE 64
+
 /* ***********************************/
 /* Bit Masking and handling          */
 /* ***********************************/
@@ -0,0 +1,79 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_workdeque.h                                                                         */
+/* \brief: Provide a work-stealing deque (Chase-Lev) for task schedulers                         */
+/*                                                                                               */
+/* \Expects: mc_type.h is linked properly and defines types needed                               */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#ifndef MC_WORKDEQUE_H
+#define MC_WORKDEQUE_H
+
+#include "mc_type.h"
+
+/**
+ * \brief Hint: Use the MC_WorkDeque_<action> interface to interact with the WorkDeque pointer.
+ * \details WorkDeque behaves like an MC_Stack for the single thread that owns it: Push and Pop work
+ * on the top in last in, first out fashion. Any other thread may concurrently Steal the oldest
+ * element from the bottom. All operations are lock-free, and the storage is a circular array
+ * which the owner doubles whenever it fills up.
+ */
+typedef struct MC_WorkDeque MC_WorkDeque;
+
+/**
+ * \brief Allocates memory for a new WorkDeque.
+ * \param capacity: initial number of elements, rounded up to a power of two
+ * \returns MC_WorkDeque*: the pointer to a new allocated WorkDeque, NULL on failure.
+ */
+MC_WorkDeque* MC_WorkDeque_Init(u64 capacity);
+
+/**
+ * \brief Add an element onto the top of the WorkDeque. Owner thread only.
+ * \param deque: Pointer to the WorkDeque to push onto
+ * \param value: Pointer to data as value, must not be NULL
+ * \returns u8: true/false corresponding to success fail
+ */
+u8 MC_WorkDeque_Push(MC_WorkDeque* deque, void* value);
+
+/**
+ * \brief Remove the newest element from the top of the WorkDeque. Owner thread only.
+ * \param deque: Pointer to the WorkDeque to remove from
+ * \returns void*: The popped value, NULL if the WorkDeque is empty or a thief took the last element.
+ */
+void* MC_WorkDeque_Pop(MC_WorkDeque* deque);
+
+/**
+ * \brief Remove the oldest element from the bottom of the WorkDeque. Safe from any thread.
+ * \details Returns NULL both when the WorkDeque is empty and when another thread won the race
+ * for the same element, a scheduler should then simply try again or pick another victim.
+ * \param deque: Pointer to the WorkDeque to steal from
+ * \returns void*: The stolen value, NULL if nothing was stolen.
+ */
+void* MC_WorkDeque_Steal(MC_WorkDeque* deque);
+
+/**
+ * \brief Get the state of whether or not the WorkDeque is Empty or not.
+ * \details Only a snapshot when other threads are stealing concurrently.
+ * \param deque: Pointer to the WorkDeque to determine if empty
+ * \returns u8: State of true/false to Is it empty.
+ */
+u8 MC_WorkDeque_IsEmpty(const MC_WorkDeque* deque);
+
+/**
+ * \brief Get the current size of the WorkDeque.
+ * \details Only a snapshot when other threads are stealing concurrently.
+ * \param deque: Pointer to the WorkDeque to determine the size
+ * \returns u64: The WorkDeque size.
+ */
+u64 MC_WorkDeque_Size(const MC_WorkDeque* deque);
+
+/**
+ * \brief Free the dynamic memory associated with this WorkDeque object.
+ * \details No other thread may be stealing from the WorkDeque at this point.
+ * \param deque: Double Pointer to the WorkDeque to free, set to NULL after freeing
+ */
+void MC_WorkDeque_Free(MC_WorkDeque** deque);
+
+#endif
@@ -0,0 +1,349 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_allocator.c                                                                         */
+/* \brief: Provide a pluggable allocator interface used by every MC container                    */
+/*                                                                                               */
+/* \Expects: mc_allocator.h is linked properly and defines interface                             */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#include "mc_allocator.h"
+#include <stdlib.h>     // malloc
+#include <string.h>     // memcpy, strlen
+#include <stdatomic.h>  // atomic_load
+
+#if defined(__linux__)
+#include <unistd.h>             // syscall
+#include <sys/mman.h>           // mmap, madvise
+#include <sys/syscall.h>        // SYS_mbind
+#include <linux/mempolicy.h>    // MPOL_PREFERRED
+#elif defined(_WIN32)
+#include <windows.h>            // VirtualAlloc, VirtualAllocExNuma
+#endif
+
+/**
+ * \brief Granularity of regular pages.
+ */
+#define ALLOCATOR_PAGE_SIZE 4096ULL
+
+/**
+ * \brief Granularity of huge pages.
+ */
+#define ALLOCATOR_HUGE_PAGE_SIZE (2ULL * 1024 * 1024)
+
+static void* internal_allocator_malloc(void *ctx, u64 size)
+{
+    (void)ctx;
+
+    return malloc(size ? size : 1);
+}
+
+static void* internal_allocator_realloc(void *ctx, void *memory, u64 old_size, u64 new_size)
+{
+    (void)ctx;
+    (void)old_size;
+
+    return realloc(memory, new_size ? new_size : 1);
+}
+
+static void internal_allocator_free(void *ctx, void *memory, u64 size)
+{
+    (void)ctx;
+    (void)size;
+
+    free(memory);
+}
+
+static const MC_Allocator allocator_default =
+{
+    internal_allocator_malloc,
+    internal_allocator_realloc,
+    internal_allocator_free,
+    NULL
+};
+
+/**
+ * \brief The global allocator, NULL stands for allocator_default.
+ */
+static _Atomic(const MC_Allocator*) allocator_global;
+
+/**
+ * \brief Round size up to a multiple of page, 0 on overflow.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static u64 internal_allocator_round(u64 size, u64 page)
+{
+    if (size > U64_MAX - (page - 1))
+    {
+        return 0;
+    }
+
+    return (size + page - 1) & ~(page - 1);
+}
+
+/**
+ * \brief Map size bytes of fresh, zeroed pages straight from the system.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static void* internal_allocator_map(u64 size)
+{
+#if defined(__linux__)
+    void *memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    return memory == MAP_FAILED ? NULL : memory;
+#elif defined(_WIN32)
+    return VirtualAlloc(NULL, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+    return malloc(size);
+#endif
+}
+
+/**
+ * \brief Give pages obtained by internal_allocator_map or internal_allocator_map_huge back to the system.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static void internal_allocator_unmap(void *memory, u64 size)
+{
+#if defined(__linux__)
+    munmap(memory, size);
+#elif defined(_WIN32)
+    (void)size;
+    VirtualFree(memory, 0, MEM_RELEASE);
+#else
+    (void)size;
+    free(memory);
+#endif
+}
+
+/**
+ * \brief Map size bytes, a multiple of ALLOCATOR_HUGE_PAGE_SIZE, backed by huge pages where the system allows.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * Explicit huge pages need to be reserved by the administrator, so when there are none the range
+ * is mapped from regular pages aligned to 2 MiB and the kernel is asked to back it with
+ * transparent huge pages.
+ */
+static void* internal_allocator_map_huge(u64 size)
+{
+#if defined(__linux__)
+    void *memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+
+    if (memory != MAP_FAILED)
+    {
+        return memory;
+    }
+
+    u8 *raw = (u8*)internal_allocator_map(size + ALLOCATOR_HUGE_PAGE_SIZE);
+
+    if (!raw)
+    {
+        return NULL;
+    }
+
+    u8 *aligned = (u8*)(((uintptr_t)raw + ALLOCATOR_HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(ALLOCATOR_HUGE_PAGE_SIZE - 1));
+    u64 head = (u64)(aligned - raw);
+
+    if (head)
+    {
+        munmap(raw, head);
+    }
+
+    munmap(aligned + size, ALLOCATOR_HUGE_PAGE_SIZE - head);
+
+#if defined(MADV_HUGEPAGE)
+    madvise(aligned, size, MADV_HUGEPAGE);
+#endif
+
+    return aligned;
+#elif defined(_WIN32)
+    SIZE_T large = GetLargePageMinimum();
+
+    if (large)
+    {
+        u64 rounded = internal_allocator_round(size, large);
+        void *memory = rounded ? VirtualAlloc(NULL, rounded, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE) : NULL;
+
+        if (memory)
+        {
+            return memory;
+        }
+    }
+
+    return internal_allocator_map(size);
+#else
+    return internal_allocator_map(size);
+#endif
+}
+
+static void* internal_allocator_huge_alloc(void *ctx, u64 size)
+{
+    if (size < MC_ALLOCATOR_HUGE_THRESHOLD)
+    {
+        return internal_allocator_malloc(ctx, size);
+    }
+
+    u64 rounded = internal_allocator_round(size, ALLOCATOR_HUGE_PAGE_SIZE);
+
+    return rounded ? internal_allocator_map_huge(rounded) : NULL;
+}
+
+static void internal_allocator_huge_free(void *ctx, void *memory, u64 size)
+{
+    if (size < MC_ALLOCATOR_HUGE_THRESHOLD)
+    {
+        internal_allocator_free(ctx, memory, size);
+
+        return;
+    }
+
+    internal_allocator_unmap(memory, internal_allocator_round(size, ALLOCATOR_HUGE_PAGE_SIZE));
+}
+
+static void* internal_allocator_numa_alloc(void *ctx, u64 size)
+{
+    if (size < MC_ALLOCATOR_PAGE_THRESHOLD)
+    {
+        return internal_allocator_malloc(ctx, size);
+    }
+
+    u64 node = (u64)(uintptr_t)ctx;
+    u64 rounded = internal_allocator_round(size, ALLOCATOR_PAGE_SIZE);
+
+    if (!rounded)
+    {
+        return NULL;
+    }
+
+#if defined(__linux__)
+    void *memory = internal_allocator_map(rounded);
+
+    if (memory && node < sizeof(unsigned long) * 8)
+    {
+        /* Pages are only placed on first touch, so setting the policy right after mapping covers all of them */
+        unsigned long mask = 1UL << node;
+        syscall(SYS_mbind, memory, rounded, MPOL_PREFERRED, &mask, sizeof(mask) * 8 + 1, 0);
+    }
+
+    return memory;
+#elif defined(_WIN32)
+    void *memory = VirtualAllocExNuma(GetCurrentProcess(), NULL, rounded, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE, (DWORD)node);
+
+    return memory ? memory : internal_allocator_map(rounded);
+#else
+    (void)node;
+
+    return internal_allocator_map(rounded);
+#endif
+}
+
+static void internal_allocator_numa_free(void *ctx, void *memory, u64 size)
+{
+    if (size < MC_ALLOCATOR_PAGE_THRESHOLD)
+    {
+        internal_allocator_free(ctx, memory, size);
+
+        return;
+    }
+
+    internal_allocator_unmap(memory, internal_allocator_round(size, ALLOCATOR_PAGE_SIZE));
+}
+
+const MC_Allocator* MC_Allocator_Default(void)
+{
+    return &allocator_default;
+}
+
+void MC_Allocator_SetGlobal(const MC_Allocator *allocator)
+{
+    atomic_store_explicit(&allocator_global, allocator, memory_order_release);
+}
+
+const MC_Allocator* MC_Allocator_GetGlobal(void)
+{
+    const MC_Allocator *allocator = atomic_load_explicit(&allocator_global, memory_order_acquire);
+
+    return allocator ? allocator : &allocator_default;
+}
+
+u8 MC_Allocator_IsDefault(const MC_Allocator *allocator)
+{
+    return allocator == NULL || allocator->alloc == internal_allocator_malloc;
+}
+
+void* MC_Allocator_Alloc(const MC_Allocator *allocator, u64 size)
+{
+    allocator = allocator ? allocator : MC_Allocator_GetGlobal();
+
+    return allocator->alloc(allocator->ctx, size);
+}
+
+void* MC_Allocator_Realloc(const MC_Allocator *allocator, void *memory, u64 old_size, u64 new_size)
+{
+    allocator = allocator ? allocator : MC_Allocator_GetGlobal();
+
+    if (!memory)
+    {
+        return allocator->alloc(allocator->ctx, new_size);
+    }
+
+    if (allocator->realloc)
+    {
+        return allocator->realloc(allocator->ctx, memory, old_size, new_size);
+    }
+
+    void *resized = allocator->alloc(allocator->ctx, new_size);
+
+    if (resized)
+    {
+        memcpy(resized, memory, old_size < new_size ? old_size : new_size);
+        MC_Allocator_Free(allocator, memory, old_size);
+    }
+
+    return resized;
+}
+
+void MC_Allocator_Free(const MC_Allocator *allocator, void *memory, u64 size)
+{
+    allocator = allocator ? allocator : MC_Allocator_GetGlobal();
+
+    if (memory && allocator->free)
+    {
+        allocator->free(allocator->ctx, memory, size);
+    }
+}
+
+char* MC_Allocator_StrDup(const MC_Allocator *allocator, const char *str)
+{
+    if (!str)
+    {
+        return NULL;
+    }
+
+    u64 length = strlen(str) + 1;
+    char *copy = (char*)MC_Allocator_Alloc(allocator, length);
+
+    if (copy)
+    {
+        memcpy(copy, str, length);
+    }
+
+    return copy;
+}
+
+MC_Allocator MC_Allocator_Numa(u32 node)
+{
+    MC_Allocator allocator = { internal_allocator_numa_alloc, NULL, internal_allocator_numa_free, (void*)(uintptr_t)node };
+
+    return allocator;
+}
+
+MC_Allocator MC_Allocator_HugePage(void)
+{
+    MC_Allocator allocator = { internal_allocator_huge_alloc, NULL, internal_allocator_huge_free, NULL };
+
+    return allocator;
+}
@@ -0,0 +1,372 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_arena.c                                                                             */
+/* \brief: Provide a bump pointer region allocator                                               */
+/*                                                                                               */
+/* \Expects: mc_arena.h is linked properly and defines interface                                 */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#include "mc_arena.h"
+#include <string.h>     // memcpy, memset, strlen
+
+/**
+ * \brief The number of bytes per chunk when MC_Arena_Init is given 0.
+ */
+#define ARENA_DEFAULT_CHUNK_SIZE (64 * 1024)
+
+/**
+ * \brief ArenaChunk is one block of memory the Arena bumps through, the bytes follow the header.
+ */
+typedef struct ArenaChunk
+{
+    struct ArenaChunk *prev;    // \brief The previous chunk in use, or the next spare chunk
+    u64 capacity;               // \brief Number of bytes following the header
+    u64 used;                   // \brief Number of bytes handed out, including alignment padding
+} ArenaChunk;
+
+/**
+ * \brief Arena Data type: a chain of chunks in use, newest first, plus a list of chunks kept for reuse.
+ */
+struct MC_Arena
+{
+    ArenaChunk *current;    // \brief The chunk allocations are bumped from, NULL right after a Reset
+    ArenaChunk *spare;      // \brief Chunks released by Reset or Rewind, waiting to be reused
+    u64 chunkSize;          // \brief Capacity of a regular chunk
+    u64 reserved;           // \brief Bytes held from the system, headers included
+    MC_Allocator allocator; // \brief Where chunks come from
+#if defined(MC_ALLOC_TRACKING)
+    MC_MemStats memStats;   // \brief Bytes this Arena holds from its allocator, header and chunks
+#endif
+};
+
+static u8* internal_arena_chunk_data(ArenaChunk *chunk)
+{
+    return (u8*)(chunk + 1);
+}
+
+/**
+ * \brief Make a chunk of at least 'needed' bytes the current chunk, reusing a spare one if it is big enough.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static ArenaChunk* internal_arena_push_chunk(MC_Arena *arena, u64 needed)
+{
+    ArenaChunk **link = &arena->spare;
+
+    while (*link && (*link)->capacity < needed)
+    {
+        link = &(*link)->prev;
+    }
+
+    ArenaChunk *chunk = *link;
+
+    if (chunk)
+    {
+        *link = chunk->prev;
+    }
+    else
+    {
+        u64 capacity = needed > arena->chunkSize ? needed : arena->chunkSize;
+
+        if (capacity > U64_MAX - sizeof(ArenaChunk))
+        {
+            return NULL;
+        }
+
+        chunk = (ArenaChunk*)MC_Allocator_Alloc(&arena->allocator, sizeof(ArenaChunk) + capacity);
+
+        if (!chunk)
+        {
+            return NULL;
+        }
+
+        chunk->capacity = capacity;
+        arena->reserved += sizeof(ArenaChunk) + capacity;
+
+        MC_MEMTRACK_ALLOC(MC_MEM_MODULE_ARENA, &arena->memStats, sizeof(ArenaChunk) + capacity);
+    }
+
+    chunk->used = 0;
+    chunk->prev = arena->current;
+    arena->current = chunk;
+
+    return chunk;
+}
+
+/**
+ * \brief Bump 'size' bytes at 'alignment' out of the chunk, or return NULL if they do not fit.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static void* internal_arena_bump(ArenaChunk *chunk, u64 size, u64 alignment)
+{
+    uintptr_t base = (uintptr_t)internal_arena_chunk_data(chunk);
+    u64 offset = (u64)(((base + chunk->used + alignment - 1) & ~(uintptr_t)(alignment - 1)) - base);
+
+    if (offset > chunk->capacity || size > chunk->capacity - offset)
+    {
+        return NULL;
+    }
+
+    chunk->used = offset + size;
+
+    return (void*)(base + offset);
+}
+
+MC_Arena* MC_Arena_Init(u64 chunk_size)
+{
+    return MC_Arena_InitEx(chunk_size, NULL);
+}
+
+MC_Arena* MC_Arena_InitEx(u64 chunk_size, const MC_Allocator *allocator)
+{
+    allocator = allocator ? allocator : MC_Allocator_GetGlobal();
+
+    MC_Arena *arena = (MC_Arena*)MC_Allocator_Alloc(allocator, sizeof(MC_Arena));
+
+    if (!arena)
+    {
+        return NULL;
+    }
+
+    arena->allocator = *allocator;
+    arena->current = NULL;
+    arena->spare = NULL;
+    arena->chunkSize = chunk_size ? chunk_size : ARENA_DEFAULT_CHUNK_SIZE;
+    arena->reserved = 0;
+
+#if defined(MC_ALLOC_TRACKING)
+    memset(&arena->memStats, 0, sizeof(arena->memStats));
+#endif
+    MC_MEMTRACK_ALLOC(MC_MEM_MODULE_ARENA, &arena->memStats, sizeof(MC_Arena));
+
+    if (!internal_arena_push_chunk(arena, arena->chunkSize))
+    {
+        MC_MEMTRACK_FREE(MC_MEM_MODULE_ARENA, NULL, sizeof(MC_Arena));
+        MC_Allocator_Free(allocator, arena, sizeof(MC_Arena));
+
+        return NULL;
+    }
+
+    return arena;
+}
+
+void* MC_Arena_Alloc(MC_Arena *arena, u64 size)
+{
+    return MC_Arena_AllocAligned(arena, size, MC_ARENA_DEFAULT_ALIGNMENT);
+}
+
+void* MC_Arena_AllocAligned(MC_Arena *arena, u64 size, u64 alignment)
+{
+    if (!arena || alignment == 0 || (alignment & (alignment - 1)) != 0 || size > U64_MAX - alignment)
+    {
+        return NULL;
+    }
+
+    void *memory = arena->current ? internal_arena_bump(arena->current, size, alignment) : NULL;
+
+    if (memory)
+    {
+        return memory;
+    }
+
+    /* The rest of the current chunk is abandoned until the next Reset or Rewind */
+    ArenaChunk *chunk = internal_arena_push_chunk(arena, size + alignment - 1);
+
+    if (!chunk)
+    {
+        return NULL;
+    }
+
+    return internal_arena_bump(chunk, size, alignment);
+}
+
+void* MC_Arena_AllocZero(MC_Arena *arena, u64 size)
+{
+    void *memory = MC_Arena_Alloc(arena, size);
+
+    if (memory)
+    {
+        memset(memory, 0, size);
+    }
+
+    return memory;
+}
+
+char* MC_Arena_StrDup(MC_Arena *arena, const char *str)
+{
+    if (!str)
+    {
+        return NULL;
+    }
+
+    u64 length = strlen(str) + 1;
+    char *copy = (char*)MC_Arena_AllocAligned(arena, length, 1);
+
+    if (copy)
+    {
+        memcpy(copy, str, length);
+    }
+
+    return copy;
+}
+
+MC_ArenaMark MC_Arena_Mark(const MC_Arena *arena)
+{
+    MC_ArenaMark mark = { NULL, 0 };
+
+    if (arena && arena->current)
+    {
+        mark.chunk = arena->current;
+        mark.used = arena->current->used;
+    }
+
+    return mark;
+}
+
+void MC_Arena_Rewind(MC_Arena *arena, MC_ArenaMark mark)
+{
+    if (!arena)
+    {
+        return;
+    }
+
+    while (arena->current && arena->current != (ArenaChunk*)mark.chunk)
+    {
+        ArenaChunk *chunk = arena->current;
+        arena->current = chunk->prev;
+        chunk->prev = arena->spare;
+        arena->spare = chunk;
+    }
+
+    if (arena->current && mark.used < arena->current->used)
+    {
+        arena->current->used = mark.used;
+    }
+}
+
+void MC_Arena_Reset(MC_Arena *arena)
+{
+    MC_ArenaMark start = { NULL, 0 };
+
+    MC_Arena_Rewind(arena, start);
+}
+
+u64 MC_Arena_Used(const MC_Arena *arena)
+{
+    if (!arena)
+    {
+        return 0;
+    }
+
+    u64 used = 0;
+
+    for (const ArenaChunk *chunk = arena->current; chunk; chunk = chunk->prev)
+    {
+        used += chunk->used;
+    }
+
+    return used;
+}
+
+u64 MC_Arena_Reserved(const MC_Arena *arena)
+{
+    if (!arena)
+    {
+        return 0;
+    }
+
+    return arena->reserved;
+}
+
+u8 MC_Arena_MemStats(const MC_Arena *arena, MC_MemStats *stats)
+{
+    if (!arena || !stats)
+    {
+        return false;
+    }
+
+#if defined(MC_ALLOC_TRACKING)
+    *stats = arena->memStats;
+
+    return true;
+#else
+    memset(stats, 0, sizeof(*stats));
+
+    return false;
+#endif
+}
+
+static void* internal_arena_allocator_alloc(void *ctx, u64 size)
+{
+    return MC_Arena_Alloc((MC_Arena*)ctx, size);
+}
+
+/**
+ * \brief Resize for MC_Arena_AsAllocator: the latest allocation grows or shrinks in place, others are copied.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static void* internal_arena_allocator_realloc(void *ctx, void *memory, u64 old_size, u64 new_size)
+{
+    MC_Arena *arena = (MC_Arena*)ctx;
+    ArenaChunk *chunk = arena->current;
+
+    if (chunk && (u8*)memory + old_size == internal_arena_chunk_data(chunk) + chunk->used)
+    {
+        u64 offset = (u64)((u8*)memory - internal_arena_chunk_data(chunk));
+
+        if (new_size <= chunk->capacity - offset)
+        {
+            chunk->used = offset + new_size;
+
+            return memory;
+        }
+    }
+
+    void *resized = MC_Arena_Alloc(arena, new_size);
+
+    if (resized)
+    {
+        memcpy(resized, memory, old_size < new_size ? old_size : new_size);
+    }
+
+    return resized;
+}
+
+MC_Allocator MC_Arena_AsAllocator(MC_Arena *arena)
+{
+    MC_Allocator allocator = { internal_arena_allocator_alloc, internal_arena_allocator_realloc, NULL, arena };
+
+    return allocator;
+}
+
+void MC_Arena_Free(MC_Arena **arena)
+{
+    if (!arena || !(*arena))
+    {
+        return;
+    }
+
+    MC_Allocator allocator = (*arena)->allocator;
+    ArenaChunk *lists[2] = { (*arena)->current, (*arena)->spare };
+
+    for (u64 i = 0; i < 2; i++)
+    {
+        while (lists[i])
+        {
+            ArenaChunk *chunk = lists[i];
+            lists[i] = chunk->prev;
+
+            MC_MEMTRACK_FREE(MC_MEM_MODULE_ARENA, NULL, sizeof(ArenaChunk) + chunk->capacity);
+            MC_Allocator_Free(&allocator, chunk, sizeof(ArenaChunk) + chunk->capacity);
+        }
+    }
+
+    MC_MEMTRACK_FREE(MC_MEM_MODULE_ARENA, NULL, sizeof(MC_Arena));
+    MC_Allocator_Free(&allocator, *arena, sizeof(MC_Arena));
+
+    *arena = NULL;
+}
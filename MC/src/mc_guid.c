@@ -9,62 +9,517 @@
 /* ********************************************************************************************* */
 
 #include "mc_guid.h"
+#include "mc_memtrack.h"
 #include <stdio.h>
-#include <stdlib.h>
-#include <objbase.h>    // CoCreateGuid and GUID
+#include <string.h>     // memcpy
+#include <stdatomic.h>  // atomic_load
+#include <threads.h>    // call_once
 #include <inttypes.h>   // PRIX32 / PRIX16 etc
+#include <time.h>       // timespec_get
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define GUID_X86 1
+#include <immintrin.h>      // SSSE3 and AVX2 intrinsics
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>         // __cpuid
+#define GUID_TARGET(isa)
+#else
+#define GUID_TARGET(isa) __attribute__((target(isa)))
+#endif
+#endif
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <bcrypt.h>         // BCryptGenRandom
+#elif defined(__linux__)
+#include <errno.h>          // EINTR
+#include <sys/random.h>     // getrandom
+#include <pthread.h>        // pthread_atfork
+#elif defined(__APPLE__) || defined(__unix__)
+#include <unistd.h>         // getentropy
+#include <pthread.h>        // pthread_atfork
+#endif
+
+/**
+ * \brief Number of characters of a formatted Guid, without the null terminator.
+ */
+#define GUID_STRING_LENGTH 36
+
+/**
+ * \brief Instruction sets the Format and Parse paths can use, detected once at runtime.
+ */
+#define GUID_SIMD_NONE  0
+#define GUID_SIMD_SSSE3 1
+#define GUID_SIMD_AVX2  2
+
+/**
+ * \brief Below this many Guids MC_GUID_Sort uses an insertion sort instead of the 16 radix passes.
+ */
+#define GUID_SORT_INSERTION 32
+
+/**
+ * \brief Odd 64 bit constant of the MC_GUID_Hash multiply, 2^64 divided by the golden ratio.
+ */
+#define GUID_HASH_MULTIPLIER 0x9E3779B97F4A7C15ULL
+
+/**
+ * \brief Number of ChaCha20 blocks of 64 bytes generated per refill, enough for 16 Guids.
+ */
+#define GUID_RNG_BLOCKS 4
+
+/**
+ * \brief Size in bytes of the buffered keystream.
+ */
+#define GUID_RNG_BUFFER_SIZE (GUID_RNG_BLOCKS * 64)
+
+/**
+ * \brief Number of ChaCha rounds, 20 as in RFC 8439.
+ */
+#define GUID_RNG_ROUNDS 20
+
+#define GUID_ROTL32(v, n) (((v) << (n)) | ((v) >> (32 - (n))))
+
+#define GUID_QUARTER_ROUND(a, b, c, d)                  \
+    a += b; d ^= a; d = GUID_ROTL32(d, 16);             \
+    c += d; b ^= c; b = GUID_ROTL32(b, 12);             \
+    a += b; d ^= a; d = GUID_ROTL32(d, 8);              \
+    c += d; b ^= c; b = GUID_ROTL32(b, 7)
+
+/**
+ * \brief GuidRng is one thread's ChaCha20 keystream generator, seeded once from the operating system.
+ */
+typedef struct GuidRng
+{
+    u32 state[16];                      // \brief Constants, 256 bit key, 64 bit block counter, 64 bit nonce
+    u8 buffer[GUID_RNG_BUFFER_SIZE];    // \brief Keystream not handed out yet, from offset on
+    u64 offset;                         // \brief Bytes of buffer already used
+    u64 generation;                     // \brief guid_fork_generation at seeding time
+    u8 seeded;                          // \brief The key came from the operating system
+} GuidRng;
+
+static _Thread_local GuidRng guid_rng;
+
+/**
+ * \brief Number of low bits of guid_v7_last holding the sequence counter, the 48 above hold the timestamp.
+ */
+#define GUID_V7_COUNTER_BITS 16
+
+/**
+ * \brief The last version 7 timestamp and counter handed out in this process, (unix_ms << 16) | counter.
+ */
+static atomic_uint_fast64_t guid_v7_last;
+
+/**
+ * \brief Bumped in the child of every fork, so that no Guid is handed out by both processes.
+ */
+static atomic_uint_fast64_t guid_fork_generation;
+
+#if !defined(_WIN32)
+static once_flag guid_atfork_once = ONCE_FLAG_INIT;
+
+static void internal_guid_atfork_child(void)
+{
+    atomic_fetch_add_explicit(&guid_fork_generation, 1, memory_order_relaxed);
+}
+
+static void internal_guid_atfork_register(void)
+{
+    pthread_atfork(NULL, NULL, internal_guid_atfork_child);
+}
+#endif
+
+/**
+ * \brief Fill size bytes with entropy from the operating system.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static u8 internal_guid_os_random(u8 *out, u64 size)
+{
+#if defined(_WIN32)
+    return BCryptGenRandom(NULL, out, (ULONG)size, BCRYPT_USE_SYSTEM_PREFERRED_RNG) >= 0;
+#elif defined(__linux__)
+    while (size)
+    {
+        ssize_t got = getrandom(out, size, 0);
+
+        if (got < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            return false;
+        }
+
+        out += got;
+        size -= (u64)got;
+    }
+
+    return true;
+#elif defined(__APPLE__) || defined(__unix__)
+    return getentropy(out, size) == 0;     // at most 256 bytes, the seed is far below that
+#else
+    FILE *source = fopen("/dev/urandom", "rb");
+
+    if (!source)
+    {
+        return false;
+    }
+
+    u8 complete = fread(out, 1, size, source) == size;
+    fclose(source);
+
+    return complete;
+#endif
+}
+
+/**
+ * \brief Key the calling thread's generator from the operating system.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static u8 internal_guid_rng_seed(GuidRng *rng)
+{
+    u8 seed[40];    // 32 byte key and 8 byte nonce
+
+#if !defined(_WIN32)
+    call_once(&guid_atfork_once, internal_guid_atfork_register);
+#endif
+
+    rng->generation = atomic_load_explicit(&guid_fork_generation, memory_order_relaxed);
+
+    if (!internal_guid_os_random(seed, sizeof(seed)))
+    {
+        return false;
+    }
+
+    rng->state[0] = 0x61707865;    // "expand 32-byte k"
+    rng->state[1] = 0x3320646e;
+    rng->state[2] = 0x79622d32;
+    rng->state[3] = 0x6b206574;
+
+    for (u64 i = 0; i < 10; i++)
+    {
+        rng->state[4 + (i < 8 ? i : i + 2)] = (u32)seed[i * 4] | (u32)seed[i * 4 + 1] << 8 |
+                                              (u32)seed[i * 4 + 2] << 16 | (u32)seed[i * 4 + 3] << 24;
+    }
+
+    rng->state[12] = 0;
+    rng->state[13] = 0;
+    rng->offset = GUID_RNG_BUFFER_SIZE;
+    rng->seeded = true;
+
+    memset(seed, 0, sizeof(seed));
+
+    return true;
+}
+
+/**
+ * \brief Write the next 64 byte ChaCha20 block of the keystream to out.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static void internal_guid_rng_block(GuidRng *rng, u8 *out)
+{
+    u32 x[16];
+
+    memcpy(x, rng->state, sizeof(x));
+
+    for (u64 round = 0; round < GUID_RNG_ROUNDS; round += 2)
+    {
+        GUID_QUARTER_ROUND(x[0], x[4], x[8],  x[12]);
+        GUID_QUARTER_ROUND(x[1], x[5], x[9],  x[13]);
+        GUID_QUARTER_ROUND(x[2], x[6], x[10], x[14]);
+        GUID_QUARTER_ROUND(x[3], x[7], x[11], x[15]);
+        GUID_QUARTER_ROUND(x[0], x[5], x[10], x[15]);
+        GUID_QUARTER_ROUND(x[1], x[6], x[11], x[12]);
+        GUID_QUARTER_ROUND(x[2], x[7], x[8],  x[13]);
+        GUID_QUARTER_ROUND(x[3], x[4], x[9],  x[14]);
+    }
+
+    for (u64 i = 0; i < 16; i++)
+    {
+        x[i] += rng->state[i];
+    }
+
+#if defined(_WIN32) || (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+    memcpy(out, x, sizeof(x));
+#else
+    for (u64 i = 0; i < 16; i++)
+    {
+        out[i * 4]     = (u8)x[i];
+        out[i * 4 + 1] = (u8)(x[i] >> 8);
+        out[i * 4 + 2] = (u8)(x[i] >> 16);
+        out[i * 4 + 3] = (u8)(x[i] >> 24);
+    }
+#endif
+
+    if (++rng->state[12] == 0)  // 64 bit block counter
+    {
+        rng->state[13]++;
+    }
+}
+
+/**
+ * \brief Refill the keystream buffer with GUID_RNG_BLOCKS ChaCha20 blocks.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static void internal_guid_rng_refill(GuidRng *rng)
+{
+    for (u64 block = 0; block < GUID_RNG_BLOCKS; block++)
+    {
+        internal_guid_rng_block(rng, rng->buffer + block * 64);
+    }
+
+    rng->offset = 0;
+}
+
+/**
+ * \brief Get the calling thread's generator, seeding it on first use and again after a fork. NULL on failure.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static GuidRng* internal_guid_rng(void)
+{
+    GuidRng *rng = &guid_rng;
+
+    if (!rng->seeded || rng->generation != atomic_load_explicit(&guid_fork_generation, memory_order_relaxed))
+    {
+        if (!internal_guid_rng_seed(rng))
+        {
+            return NULL;
+        }
+    }
+
+    return rng;
+}
+
+/**
+ * \brief Take 16 bytes of keystream from the calling thread's generator.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static u8 internal_guid_random16(u8 *out)
+{
+    GuidRng *rng = internal_guid_rng();
+
+    if (!rng)
+    {
+        return false;
+    }
+
+    if (rng->offset == GUID_RNG_BUFFER_SIZE)
+    {
+        internal_guid_rng_refill(rng);
+    }
+
+    memcpy(out, rng->buffer + rng->offset, 16);
+    memset(rng->buffer + rng->offset, 0, 16);   // a handed out Guid is not kept around
+    rng->offset += 16;
+
+    return true;
+}
 
 /**
- * A GUID (Globally Unique Identifier) consists of 16 bytes, and it is typically represented in a specific format:
- * xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx
+ * \brief Set the version 4 and variant bits of a Guid holding 16 random bytes.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * The version nibble is the top of data3 and the RFC 4122 variant the top two bits of data4[0],
+ * which is where they land in the string form.
  */
-typedef struct MC_Guid
+static void internal_guid_stamp_v4(MC_Guid *guid)
+{
+    guid->data3 = (u16)((guid->data3 & 0x0FFF) | 0x4000);
+    guid->data4[0] = (u8)((guid->data4[0] & 0x3F) | 0x80);
+}
+
+static u8 internal_guid_fill(MC_Guid *guid)
 {
-    u32 data1;                  // 4 bytes
-    u16 data2;                  // 2 bytes
-    u16 data3;                  // 2 bytes
-    u8  data4[EIGHT_BYTES];     // 8 bytes
-} MC_Guid;
+    u8 bytes[16];
+
+    if (!internal_guid_random16(bytes))
+    {
+        return false;
+    }
+
+    memcpy(guid, bytes, sizeof(MC_Guid));
+    internal_guid_stamp_v4(guid);
+
+    return true;
+}
 
 u8 MC_GUID_Generate(MC_Guid **guid)
+{
+    return MC_GUID_GenerateEx(guid, NULL);
+}
+
+u8 MC_GUID_GenerateEx(MC_Guid **guid, const MC_Allocator *allocator)
 {
     if (guid == NULL)
     {
         return false;
     }
 
-    GUID new_guid;
-    HRESULT result = CoCreateGuid(&new_guid);
+    *guid = (MC_Guid *)MC_Allocator_Alloc(allocator, sizeof(MC_Guid));
 
-    if (result != S_OK)
+    if (*guid == NULL)
     {
         return false;
     }
 
-    *guid = (MC_Guid *)malloc(sizeof(MC_Guid));
+    MC_MEMTRACK_ALLOC(MC_MEM_MODULE_GUID, NULL, sizeof(MC_Guid));
 
-    if (*guid == NULL)
+    if (!internal_guid_fill(*guid))
+    {
+        MC_GUID_ReleaseEx(guid, allocator);
+
+        return false;
+    }
+
+    return true;
+}
+
+u8 MC_GUID_GenerateInto(MC_Guid *out)
+{
+    if (out == NULL)
+    {
+        return false;
+    }
+
+    return internal_guid_fill(out);
+}
+
+u8 MC_GUID_GenerateBatch(MC_Guid *out, u64 count)
+{
+    if (out == NULL && count)
+    {
+        return false;
+    }
+
+    GuidRng *rng = internal_guid_rng();
+
+    if (!rng)
     {
         return false;
     }
 
-    (*guid)->data1 = new_guid.Data1;
-    (*guid)->data2 = new_guid.Data2;
-    (*guid)->data3 = new_guid.Data3;
+    u64 blocks = count / 4;     // four Guids per ChaCha20 block, written straight into the caller's array
 
-    for (int i = 0; i < EIGHT_BYTES; ++i)
+    for (u64 i = 0; i < blocks; i++)
     {
-        (*guid)->data4[i] = new_guid.Data4[i];
+        internal_guid_rng_block(rng, (u8*)(out + i * 4));
+    }
+
+    for (u64 i = blocks * 4; i < count; i++)
+    {
+        internal_guid_random16((u8*)(out + i));
+    }
+
+    for (u64 i = 0; i < count; i++)
+    {
+        internal_guid_stamp_v4(&out[i]);
     }
 
     return true;
 }
 
+/**
+ * \brief Reserve the next version 7 sequence value, never below unix_ms and always above the last one handed out.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * A single compare and swap keeps the order total across threads. When the clock stands still or
+ * goes backwards the counter carries on from the last value, and a counter running out within one
+ * millisecond carries into the timestamp, which then runs ahead of the clock until it catches up.
+ */
+static u64 internal_guid_v7_next(u64 unix_ms)
+{
+    u64 floor = (unix_ms & 0xFFFFFFFFFFFFULL) << GUID_V7_COUNTER_BITS;
+    u64 last = atomic_load_explicit(&guid_v7_last, memory_order_relaxed);
+    u64 next;
+
+    do
+    {
+        next = floor > last ? floor : last + 1;
+    } while (!atomic_compare_exchange_weak_explicit(&guid_v7_last, &last, next,
+                                                    memory_order_relaxed, memory_order_relaxed));
+
+    return next;
+}
+
+/**
+ * \brief Lay a version 7 Guid out over 16 random bytes: 48 bit timestamp, version, 16 bit counter, variant.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * The top 12 counter bits fill rand_a next to the version nibble and the low 4 sit under the variant
+ * bits, so the string form and MC_Guid field order both sort by timestamp, then counter.
+ */
+static void internal_guid_stamp_v7(MC_Guid *guid, u64 sequence)
+{
+    u64 unix_ms = sequence >> GUID_V7_COUNTER_BITS;
+    u16 counter = (u16)sequence;
+
+    guid->data1 = (u32)(unix_ms >> 16);
+    guid->data2 = (u16)unix_ms;
+    guid->data3 = (u16)(0x7000 | (counter >> 4));
+    guid->data4[0] = (u8)(0x80 | ((counter & 0x0F) << 2) | (guid->data4[0] & 0x03));
+}
+
+u8 MC_GUID_GenerateV7(MC_Guid *out)
+{
+    struct timespec now;
+
+    if (timespec_get(&now, TIME_UTC) != TIME_UTC)
+    {
+        return false;
+    }
+
+    return MC_GUID_GenerateV7At(out, (u64)now.tv_sec * 1000 + (u64)now.tv_nsec / 1000000);
+}
+
+u8 MC_GUID_GenerateV7At(MC_Guid *out, u64 unix_ms)
+{
+    if (out == NULL || !internal_guid_random16((u8*)out))
+    {
+        return false;
+    }
+
+    internal_guid_stamp_v7(out, internal_guid_v7_next(unix_ms));
+
+    return true;
+}
+
+u8 MC_GUID_GenerateArena(MC_Arena *arena, MC_Guid **guid)
+{
+    if (arena == NULL || guid == NULL)
+    {
+        return false;
+    }
+
+    MC_Guid *new_guid = (MC_Guid *)MC_Arena_AllocAligned(arena, sizeof(MC_Guid), _Alignof(MC_Guid));
+
+    if (new_guid == NULL || !internal_guid_fill(new_guid))
+    {
+        return false;
+    }
+
+    *guid = new_guid;
+
+    return true;
+}
+
 void MC_GUID_Release(MC_Guid **guid)
+{
+    MC_GUID_ReleaseEx(guid, NULL);
+}
+
+void MC_GUID_ReleaseEx(MC_Guid **guid, const MC_Allocator *allocator)
 {
     if (guid && *guid)
     {
-        free(*guid);
+        MC_MEMTRACK_FREE(MC_MEM_MODULE_GUID, NULL, sizeof(MC_Guid));
+        MC_Allocator_Free(allocator, *guid, sizeof(MC_Guid));
         *guid = NULL;
     }
 }
@@ -108,4 +563,567 @@ u8 MC_GUID_Format_String(const MC_Guid *guid, char *guid_str, u64 guid_str_size)
         ((u64)guid-> data4[7]));
 
     return true;
-}
\ No newline at end of file
+}
+
+/**
+ * \brief Hex digits used by the formatting paths, uppercase like MC_GUID_Format_String.
+ */
+static const char guid_hex_digits[16] =
+{
+    '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F'
+};
+
+/**
+ * \brief Value of a hex digit plus one, 0 for any character that is not a hex digit.
+ */
+static const u8 guid_hex_values[256] =
+{
+    ['0'] = 1,  ['1'] = 2,  ['2'] = 3,  ['3'] = 4,  ['4'] = 5,  ['5'] = 6,  ['6'] = 7,  ['7'] = 8,
+    ['8'] = 9,  ['9'] = 10, ['A'] = 11, ['B'] = 12, ['C'] = 13, ['D'] = 14, ['E'] = 15, ['F'] = 16,
+    ['a'] = 11, ['b'] = 12, ['c'] = 13, ['d'] = 14, ['e'] = 15, ['f'] = 16
+};
+
+/**
+ * \brief Index into the 16 bytes of an MC_Guid of each byte in string order: data1, data2 and data3
+ * are stored in host order but printed most significant byte first.
+ */
+#if defined(_WIN32) || (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+static const u8 guid_display_order[16] = { 3, 2, 1, 0, 5, 4, 7, 6, 8, 9, 10, 11, 12, 13, 14, 15 };
+#else
+static const u8 guid_display_order[16] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+#endif
+
+/**
+ * \brief Index of the first of the two characters of each byte in the string form.
+ */
+static const u8 guid_char_offsets[16] = { 0, 2, 4, 6, 9, 11, 14, 16, 19, 21, 24, 26, 28, 30, 32, 34 };
+
+static u8 guid_simd_level;
+static once_flag guid_simd_once = ONCE_FLAG_INIT;
+
+static void internal_guid_detect_simd(void)
+{
+#if defined(GUID_X86) && defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+
+    __cpuid(info, 1);
+
+    u8 ssse3 = (info[2] & (1 << 9)) != 0;
+    u8 osAvx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6;
+
+    __cpuidex(info, 7, 0);
+
+    u8 avx2 = osAvx && (info[1] & (1 << 5)) != 0;
+
+    guid_simd_level = avx2 ? GUID_SIMD_AVX2 : ssse3 ? GUID_SIMD_SSSE3 : GUID_SIMD_NONE;
+#elif defined(GUID_X86)
+    __builtin_cpu_init();
+
+    guid_simd_level = __builtin_cpu_supports("avx2")  ? GUID_SIMD_AVX2  :
+                      __builtin_cpu_supports("ssse3") ? GUID_SIMD_SSSE3 : GUID_SIMD_NONE;
+#else
+    guid_simd_level = GUID_SIMD_NONE;
+#endif
+}
+
+static u8 internal_guid_simd(void)
+{
+    call_once(&guid_simd_once, internal_guid_detect_simd);
+
+    return guid_simd_level;
+}
+
+/**
+ * \brief Write the 36 characters of a Guid, one byte at a time through guid_hex_digits.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static void internal_guid_format_scalar(const MC_Guid *guid, char *out)
+{
+    const u8 *bytes = (const u8*)guid;
+
+    for (u64 i = 0; i < 16; i++)
+    {
+        u8 byte = bytes[guid_display_order[i]];
+
+        out[guid_char_offsets[i]]     = guid_hex_digits[byte >> 4];
+        out[guid_char_offsets[i] + 1] = guid_hex_digits[byte & 0x0F];
+    }
+
+    out[8] = out[13] = out[18] = out[23] = '-';
+}
+
+/**
+ * \brief Parse the 36 characters of a Guid one at a time through guid_hex_values.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static u8 internal_guid_parse_scalar(const char *str, MC_Guid *out)
+{
+    if (str[8] != '-' || str[13] != '-' || str[18] != '-' || str[23] != '-')
+    {
+        return false;
+    }
+
+    u8 bytes[16];
+
+    for (u64 i = 0; i < 16; i++)
+    {
+        u8 hi = guid_hex_values[(u8)str[guid_char_offsets[i]]];
+        u8 lo = guid_hex_values[(u8)str[guid_char_offsets[i] + 1]];
+
+        if (!hi || !lo)
+        {
+            return false;
+        }
+
+        bytes[guid_display_order[i]] = (u8)((hi - 1) << 4 | (lo - 1));
+    }
+
+    memcpy(out, bytes, sizeof(bytes));
+
+    return true;
+}
+
+#if defined(GUID_X86)
+
+/**
+ * \brief Turn 16 bytes into their 32 hex characters, the first 16 in *first and the rest in *second.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * Every nibble indexes a 16 entry table held in a register, so one pshufb converts 16 nibbles.
+ */
+GUID_TARGET("ssse3")
+static void internal_guid_hex_ssse3(__m128i bytes, __m128i *first, __m128i *second)
+{
+    const __m128i digits = _mm_loadu_si128((const __m128i*)guid_hex_digits);
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+
+    __m128i hi = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(bytes, 4), nibble));
+    __m128i lo = _mm_shuffle_epi8(digits, _mm_and_si128(bytes, nibble));
+
+    *first = _mm_unpacklo_epi8(hi, lo);
+    *second = _mm_unpackhi_epi8(hi, lo);
+}
+
+/**
+ * \brief Lay 32 hex characters out as the 36 character form: two shuffles insert the gaps, an or fills in the dashes.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+GUID_TARGET("ssse3")
+static void internal_guid_store_ssse3(__m128i first, __m128i second, char *out)
+{
+    const __m128i head = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, -1, 8, 9, 10, 11, -1, 12, 13);
+    const __m128i carry = _mm_setr_epi8(14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i middle = _mm_setr_epi8(-1, -1, -1, 0, 1, 2, 3, -1, 4, 5, 6, 7, 8, 9, 10, 11);
+    const __m128i headDashes = _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, '-', 0, 0, 0, 0, '-', 0, 0);
+    const __m128i middleDashes = _mm_setr_epi8(0, 0, '-', 0, 0, 0, 0, '-', 0, 0, 0, 0, 0, 0, 0, 0);
+
+    __m128i out0 = _mm_or_si128(_mm_shuffle_epi8(first, head), headDashes);
+    __m128i out1 = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(first, carry), _mm_shuffle_epi8(second, middle)), middleDashes);
+    int tail = _mm_cvtsi128_si32(_mm_srli_si128(second, 12));
+
+    _mm_storeu_si128((__m128i*)out, out0);
+    _mm_storeu_si128((__m128i*)(out + 16), out1);
+    memcpy(out + 32, &tail, 4);
+}
+
+GUID_TARGET("ssse3")
+static void internal_guid_format_ssse3(const MC_Guid *guid, char *out)
+{
+    const __m128i order = _mm_loadu_si128((const __m128i*)guid_display_order);
+    __m128i first, second;
+
+    internal_guid_hex_ssse3(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)guid), order), &first, &second);
+    internal_guid_store_ssse3(first, second, out);
+}
+
+/**
+ * \brief Format two Guids at once, one per 128 bit lane, the same steps as the SSSE3 path.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+GUID_TARGET("avx2")
+static void internal_guid_format2_avx2(const MC_Guid *guids, char *out0, char *out1)
+{
+    const __m256i order = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)guid_display_order));
+    const __m256i digits = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)guid_hex_digits));
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+
+    __m256i bytes = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)guids), order);
+    __m256i hi = _mm256_shuffle_epi8(digits, _mm256_and_si256(_mm256_srli_epi16(bytes, 4), nibble));
+    __m256i lo = _mm256_shuffle_epi8(digits, _mm256_and_si256(bytes, nibble));
+    __m256i first = _mm256_unpacklo_epi8(hi, lo);
+    __m256i second = _mm256_unpackhi_epi8(hi, lo);
+
+    internal_guid_store_ssse3(_mm256_castsi256_si128(first), _mm256_castsi256_si128(second), out0);
+    internal_guid_store_ssse3(_mm256_extracti128_si256(first, 1), _mm256_extracti128_si256(second, 1), out1);
+}
+
+/**
+ * \brief Convert 16 hex characters to their nibble values, and flag every character that is not a hex digit.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+GUID_TARGET("ssse3")
+static __m128i internal_guid_unhex_ssse3(__m128i chars, __m128i *valid)
+{
+    __m128i digit = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+    __m128i letter = _mm_sub_epi8(_mm_or_si128(chars, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    __m128i isDigit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+    __m128i isLetter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+
+    *valid = _mm_and_si128(*valid, _mm_or_si128(isDigit, isLetter));
+
+    return _mm_or_si128(_mm_and_si128(isDigit, digit),
+                        _mm_and_si128(isLetter, _mm_add_epi8(letter, _mm_set1_epi8(10))));
+}
+
+/**
+ * \brief Parse 36 characters: gather the 32 hex digits around the dashes, convert them 16 at a
+ * time, then pair the nibbles up with one multiply add.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+GUID_TARGET("ssse3")
+static u8 internal_guid_parse_ssse3(const char *str, MC_Guid *out)
+{
+    if (str[8] != '-' || str[13] != '-' || str[18] != '-' || str[23] != '-')
+    {
+        return false;
+    }
+
+    const __m128i head = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 9, 10, 11, 12, 14, 15, -1, -1);
+    const __m128i headCarry = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 1);
+    const __m128i middle = _mm_setr_epi8(3, 4, 5, 6, 8, 9, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1);
+    const __m128i tail = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 12, 13, 14, 15);
+
+    __m128i a = _mm_loadu_si128((const __m128i*)str);
+    __m128i b = _mm_loadu_si128((const __m128i*)(str + 16));
+    __m128i c = _mm_loadu_si128((const __m128i*)(str + 20));     // ends exactly at the 36th character
+
+    __m128i valid = _mm_set1_epi8(-1);
+    __m128i first = internal_guid_unhex_ssse3(_mm_or_si128(_mm_shuffle_epi8(a, head), _mm_shuffle_epi8(b, headCarry)), &valid);
+    __m128i second = internal_guid_unhex_ssse3(_mm_or_si128(_mm_shuffle_epi8(b, middle), _mm_shuffle_epi8(c, tail)), &valid);
+
+    if (_mm_movemask_epi8(valid) != 0xFFFF)
+    {
+        return false;
+    }
+
+    const __m128i pair = _mm_set1_epi16(0x0110);    // high nibble * 16 + low nibble
+    __m128i bytes = _mm_packus_epi16(_mm_maddubs_epi16(first, pair), _mm_maddubs_epi16(second, pair));
+
+    _mm_storeu_si128((__m128i*)out, _mm_shuffle_epi8(bytes, _mm_loadu_si128((const __m128i*)guid_display_order)));
+
+    return true;
+}
+
+#endif
+
+/**
+ * \brief Format one Guid with the best path the processor supports.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static void internal_guid_format(const MC_Guid *guid, char *out, u8 simd)
+{
+#if defined(GUID_X86)
+    if (simd >= GUID_SIMD_SSSE3)
+    {
+        internal_guid_format_ssse3(guid, out);
+
+        return;
+    }
+#else
+    (void)simd;
+#endif
+
+    internal_guid_format_scalar(guid, out);
+}
+
+/**
+ * \brief Parse one Guid with the best path the processor supports.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static u8 internal_guid_parse(const char *str, MC_Guid *out, u8 simd)
+{
+#if defined(GUID_X86)
+    if (simd >= GUID_SIMD_SSSE3)
+    {
+        return internal_guid_parse_ssse3(str, out);
+    }
+#else
+    (void)simd;
+#endif
+
+    return internal_guid_parse_scalar(str, out);
+}
+
+u8 MC_GUID_Format(const MC_Guid *guid, char *guid_str, u64 guid_str_size)
+{
+    if (guid == NULL || guid_str == NULL || guid_str_size < MC_GUID_SIZE)
+    {
+        return false;
+    }
+
+    internal_guid_format(guid, guid_str, internal_guid_simd());
+    guid_str[GUID_STRING_LENGTH] = '\0';
+
+    return true;
+}
+
+u8 MC_GUID_FormatN(const MC_Guid *guids, u64 count, char *guid_strs, u64 guid_strs_size)
+{
+    if ((guids == NULL || guid_strs == NULL) && count)
+    {
+        return false;
+    }
+
+    if (count > guid_strs_size / MC_GUID_SIZE)
+    {
+        return false;
+    }
+
+    u8 simd = internal_guid_simd();
+    u64 i = 0;
+
+#if defined(GUID_X86)
+    if (simd >= GUID_SIMD_AVX2)
+    {
+        for (; i + 2 <= count; i += 2)
+        {
+            char *out = guid_strs + i * MC_GUID_SIZE;
+
+            internal_guid_format2_avx2(guids + i, out, out + MC_GUID_SIZE);
+            out[GUID_STRING_LENGTH] = '\0';
+            out[MC_GUID_SIZE + GUID_STRING_LENGTH] = '\0';
+        }
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        char *out = guid_strs + i * MC_GUID_SIZE;
+
+        internal_guid_format(guids + i, out, simd);
+        out[GUID_STRING_LENGTH] = '\0';
+    }
+
+    return true;
+}
+
+u8 MC_GUID_Parse(const char *guid_str, u64 guid_str_size, MC_Guid *guid)
+{
+    if (guid_str == NULL || guid == NULL || guid_str_size < GUID_STRING_LENGTH)
+    {
+        return false;
+    }
+
+    return internal_guid_parse(guid_str, guid, internal_guid_simd());
+}
+
+u8 MC_GUID_ParseN(const char *guid_strs, u64 count, MC_Guid *guids)
+{
+    if ((guid_strs == NULL || guids == NULL) && count)
+    {
+        return false;
+    }
+
+    u8 simd = internal_guid_simd();
+
+    for (u64 i = 0; i < count; i++)
+    {
+        if (!internal_guid_parse(guid_strs + i * MC_GUID_SIZE, guids + i, simd))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * \brief Split a Guid into two integers that compare like its string form, data1 to data3 then data4.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static void internal_guid_sort_key(const MC_Guid *guid, u64 *high, u64 *low)
+{
+    *high = ((u64)guid->data1 << 32) | ((u64)guid->data2 << 16) | guid->data3;
+    *low = 0;
+
+    for (u64 i = 0; i < EIGHT_BYTES; i++)
+    {
+        *low = (*low << 8) | guid->data4[i];
+    }
+}
+
+int MC_GUID_Compare(const MC_Guid *left, const MC_Guid *right)
+{
+    if (left == right)
+    {
+        return 0;
+    }
+
+    if (left == NULL || right == NULL)
+    {
+        return left == NULL ? -1 : 1;
+    }
+
+    u64 leftHigh, leftLow, rightHigh, rightLow;
+
+    internal_guid_sort_key(left, &leftHigh, &leftLow);
+    internal_guid_sort_key(right, &rightHigh, &rightLow);
+
+    if (leftHigh != rightHigh)
+    {
+        return leftHigh < rightHigh ? -1 : 1;
+    }
+
+    return (leftLow > rightLow) - (leftLow < rightLow);
+}
+
+u8 MC_GUID_Equal(const MC_Guid *left, const MC_Guid *right)
+{
+    if (left == NULL || right == NULL)
+    {
+        return left == right;
+    }
+
+    u64 a[2], b[2];
+
+    memcpy(a, left, sizeof(a));
+    memcpy(b, right, sizeof(b));
+
+    return ((a[0] ^ b[0]) | (a[1] ^ b[1])) == 0;
+}
+
+u64 MC_GUID_Hash(const MC_Guid *guid)
+{
+    if (guid == NULL)
+    {
+        return 0;
+    }
+
+    u64 halves[2];
+
+    memcpy(halves, guid, sizeof(halves));
+
+    u64 hash = (halves[0] ^ (halves[1] * GUID_HASH_MULTIPLIER)) * GUID_HASH_MULTIPLIER;    // the version 7 timestamp half is not random
+
+    return hash ^ (hash >> 32);
+}
+
+/**
+ * \brief Sort a short run of Guids in place by insertion.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static void internal_guid_insertion_sort(MC_Guid *guids, u64 count)
+{
+    for (u64 i = 1; i < count; i++)
+    {
+        MC_Guid guid = guids[i];
+        u64 j = i;
+
+        while (j > 0 && MC_GUID_Compare(&guids[j - 1], &guid) > 0)
+        {
+            guids[j] = guids[j - 1];
+            j--;
+        }
+
+        guids[j] = guid;
+    }
+}
+
+u8 MC_GUID_Sort(MC_Guid *guids, u64 count)
+{
+    if (guids == NULL)
+    {
+        return count == 0;
+    }
+
+    if (count < GUID_SORT_INSERTION)
+    {
+        internal_guid_insertion_sort(guids, count);
+
+        return true;
+    }
+
+    u64 countsSize = 16 * 256 * sizeof(u64);    // one histogram per byte, all filled in a single read
+
+    if (count > (U64_MAX - countsSize) / sizeof(MC_Guid))
+    {
+        return false;
+    }
+
+    u64 scratchSize = count * sizeof(MC_Guid) + countsSize;
+    MC_Guid *scratch = (MC_Guid*)MC_Allocator_Alloc(NULL, scratchSize);
+
+    if (scratch == NULL)
+    {
+        return false;
+    }
+
+    MC_MEMTRACK_ALLOC(MC_MEM_MODULE_GUID, NULL, scratchSize);
+
+    u64 (*counts)[256] = (u64(*)[256])(scratch + count);
+
+    memset(counts, 0, countsSize);
+
+    for (u64 i = 0; i < count; i++)
+    {
+        const u8 *bytes = (const u8*)&guids[i];
+
+        for (u64 rank = 0; rank < 16; rank++)
+        {
+            counts[rank][bytes[guid_display_order[rank]]]++;
+        }
+    }
+
+    MC_Guid *src = guids;
+    MC_Guid *dst = scratch;
+
+    for (u64 rank = 16; rank-- > 0;)     // least significant byte first
+    {
+        u8 offset = guid_display_order[rank];
+
+        if (counts[rank][((const u8*)src)[offset]] == count)
+        {
+            continue;   // every Guid shares this byte, as the timestamp bytes of version 7 Guids often do
+        }
+
+        u64 position = 0;
+
+        for (u64 b = 0; b < 256; b++)
+        {
+            u64 bucket = counts[rank][b];
+
+            counts[rank][b] = position;
+            position += bucket;
+        }
+
+        for (u64 i = 0; i < count; i++)
+        {
+            dst[counts[rank][((const u8*)&src[i])[offset]]++] = src[i];
+        }
+
+        MC_Guid *swap = src;
+
+        src = dst;
+        dst = swap;
+    }
+
+    if (src != guids)
+    {
+        memcpy(guids, src, count * sizeof(MC_Guid));
+    }
+
+    MC_MEMTRACK_FREE(MC_MEM_MODULE_GUID, NULL, scratchSize);
+    MC_Allocator_Free(NULL, scratch, scratchSize);
+
+    return true;
+}
@@ -0,0 +1,333 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_guidmap.c                                                                           */
+/* \brief: Provide a hash map keyed by MC_Guid                                                   */
+/*                                                                                               */
+/* \Expects: mc_guidmap.h is linked properly and defines interface                               */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#include "mc_guidmap.h"
+#include <stdlib.h>     // free
+#include <string.h>     // memcpy, memset
+
+/**
+ * \brief Smallest number of slots a GuidMap table holds, always a power of two.
+ */
+#define GUIDMAP_MIN_CAPACITY 16
+
+/**
+ * \brief GuidSlot is one entry of the open addressed table, the key held by value.
+ */
+typedef struct GuidSlot
+{
+    MC_Guid key;        // \brief Element in GuidMap is referred to as a Key/Value combination of type <MC_Guid, void*>
+    void *value;        // \brief Element in GuidMap is referred to as a Key/Value combination of type <MC_Guid, void*>
+    u8 used;            // \brief The slot holds a key, TRUE / FALSE.
+    u8 isDynamic;       // \brief Element is created with dyanmic memory and needs to be freed, TRUE / FALSE.
+} GuidSlot;
+
+/**
+ * \brief GuidMap Data type represents a key/value combination of any type of data, keyed by MC_Guid.
+ */
+struct MC_GuidMap
+{
+    GuidSlot *slots;        // \brief Table of capacity slots, linearly probed
+    u64 capacity;           // \brief Number of slots, a power of two
+    u64 count;              // \brief Number of slots in use
+    MC_Allocator allocator; // \brief The allocator the map and table come from
+#if defined(MC_ALLOC_TRACKING)
+    MC_MemStats memStats;   // \brief Bytes this map holds: header and table
+#endif
+};
+
+/**
+ * \brief Compare two keys as two 64 bit words.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static u8 internal_guidmap_equal(const MC_Guid *left, const MC_Guid *right)
+{
+    u64 a[2], b[2];
+
+    memcpy(a, left, sizeof(a));
+    memcpy(b, right, sizeof(b));
+
+    return ((a[0] ^ b[0]) | (a[1] ^ b[1])) == 0;
+}
+
+/**
+ * \brief Find the slot holding key, or the empty slot where it would go.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static GuidSlot* internal_guidmap_find(const MC_GuidMap *map, const MC_Guid *key)
+{
+    u64 mask = map->capacity - 1;
+    u64 index = MC_GUID_Hash(key) & mask;
+
+    while (map->slots[index].used && !internal_guidmap_equal(&map->slots[index].key, key))
+    {
+        index = (index + 1) & mask;
+    }
+
+    return &map->slots[index];
+}
+
+/**
+ * \brief Allocate a zeroed table of capacity slots.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static GuidSlot* internal_guidmap_table(MC_GuidMap *map, u64 capacity)
+{
+    GuidSlot *slots = (GuidSlot*)MC_Allocator_Alloc(&map->allocator, capacity * sizeof(GuidSlot));
+
+    if (slots)
+    {
+        memset(slots, 0, capacity * sizeof(GuidSlot));
+        MC_MEMTRACK_ALLOC(MC_MEM_MODULE_GUIDMAP, &map->memStats, capacity * sizeof(GuidSlot));
+    }
+
+    return slots;
+}
+
+/**
+ * \brief Move every entry into a table twice the size.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static u8 internal_guidmap_grow(MC_GuidMap *map)
+{
+    if (map->capacity > U64_MAX / 2 / sizeof(GuidSlot))
+    {
+        return false;
+    }
+
+    GuidSlot *old = map->slots;
+    u64 oldCapacity = map->capacity;
+    GuidSlot *slots = internal_guidmap_table(map, oldCapacity * 2);
+
+    if (!slots)
+    {
+        return false;
+    }
+
+    map->slots = slots;
+    map->capacity = oldCapacity * 2;
+
+    for (u64 i = 0; i < oldCapacity; i++)
+    {
+        if (old[i].used)
+        {
+            *internal_guidmap_find(map, &old[i].key) = old[i];
+        }
+    }
+
+    MC_MEMTRACK_FREE(MC_MEM_MODULE_GUIDMAP, &map->memStats, oldCapacity * sizeof(GuidSlot));
+    MC_Allocator_Free(&map->allocator, old, oldCapacity * sizeof(GuidSlot));
+
+    return true;
+}
+
+MC_GuidMap* MC_GuidMap_Init(u64 size)
+{
+    return MC_GuidMap_InitEx(size, NULL);
+}
+
+MC_GuidMap* MC_GuidMap_InitEx(u64 size, const MC_Allocator *allocator)
+{
+    if (size > U64_MAX / 2 / sizeof(GuidSlot))
+    {
+        return NULL;
+    }
+
+    u64 capacity = GUIDMAP_MIN_CAPACITY;
+
+    while (capacity / 4 * 3 < size)     // room for size entries below the 3/4 load limit
+    {
+        capacity *= 2;
+    }
+
+    allocator = allocator ? allocator : MC_Allocator_GetGlobal();
+
+    MC_GuidMap *map = (MC_GuidMap*)MC_Allocator_Alloc(allocator, sizeof(MC_GuidMap));
+
+    if (!map)
+    {
+        return NULL;
+    }
+
+    map->allocator = *allocator;
+    map->capacity = capacity;
+    map->count = 0;
+
+#if defined(MC_ALLOC_TRACKING)
+    memset(&map->memStats, 0, sizeof(map->memStats));
+#endif
+    MC_MEMTRACK_ALLOC(MC_MEM_MODULE_GUIDMAP, &map->memStats, sizeof(MC_GuidMap));
+
+    map->slots = internal_guidmap_table(map, capacity);
+
+    if (!map->slots)
+    {
+        MC_MEMTRACK_FREE(MC_MEM_MODULE_GUIDMAP, NULL, sizeof(MC_GuidMap));
+        MC_Allocator_Free(allocator, map, sizeof(MC_GuidMap));
+
+        return NULL;
+    }
+
+    return map;
+}
+
+u8 MC_GuidMap_Insert(MC_GuidMap *map, const MC_Guid *key, void *value, const u8 dynamic)
+{
+    if (!map || !key)
+    {
+        return false;
+    }
+
+    GuidSlot *slot = internal_guidmap_find(map, key);
+
+    if (slot->used)     // key already exists, update value and dynamic flag
+    {
+        if (slot->isDynamic)
+        {
+            free(slot->value);
+        }
+
+        slot->value = value;
+        slot->isDynamic = dynamic;
+
+        return true;
+    }
+
+    if ((map->count + 1) * 4 > map->capacity * 3)
+    {
+        if (!internal_guidmap_grow(map))
+        {
+            return false;
+        }
+
+        slot = internal_guidmap_find(map, key);
+    }
+
+    slot->key = *key;
+    slot->value = value;
+    slot->used = true;
+    slot->isDynamic = dynamic;
+    map->count++;
+
+    return true;
+}
+
+void* MC_GuidMap_Search(const MC_GuidMap *map, const MC_Guid *key)
+{
+    if (!map || !key)
+    {
+        return NULL;
+    }
+
+    GuidSlot *slot = internal_guidmap_find(map, key);
+
+    return slot->used ? slot->value : NULL;
+}
+
+u8 MC_GuidMap_RemoveAt(MC_GuidMap *map, const MC_Guid *key)
+{
+    if (!map || !key)
+    {
+        return false;
+    }
+
+    GuidSlot *slot = internal_guidmap_find(map, key);
+
+    if (!slot->used)
+    {
+        return false;
+    }
+
+    if (slot->isDynamic)
+    {
+        free(slot->value);
+    }
+
+    /* shift later entries of the probe run back into the hole, so no tombstones are needed */
+    u64 mask = map->capacity - 1;
+    u64 hole = (u64)(slot - map->slots);
+    u64 next = hole;
+
+    while (true)
+    {
+        next = (next + 1) & mask;
+
+        if (!map->slots[next].used)
+        {
+            break;
+        }
+
+        u64 home = MC_GUID_Hash(&map->slots[next].key) & mask;
+
+        if (((next - home) & mask) >= ((next - hole) & mask))     // home is at or before the hole, it may move back
+        {
+            map->slots[hole] = map->slots[next];
+            hole = next;
+        }
+    }
+
+    memset(&map->slots[hole], 0, sizeof(GuidSlot));
+    map->count--;
+
+    return true;
+}
+
+u64 MC_GuidMap_Count(const MC_GuidMap *map)
+{
+    return map ? map->count : 0;
+}
+
+void MC_GuidMap_Free(MC_GuidMap **map_ptr)
+{
+    if (!(map_ptr) || !(*map_ptr))
+    {
+        return;
+    }
+
+    MC_GuidMap *map = *map_ptr;
+
+    for (u64 i = 0; i < map->capacity; i++)
+    {
+        if (map->slots[i].used && map->slots[i].isDynamic)
+        {
+            free(map->slots[i].value);
+        }
+    }
+
+    MC_Allocator allocator = map->allocator;
+
+    MC_MEMTRACK_FREE(MC_MEM_MODULE_GUIDMAP, NULL, map->capacity * sizeof(GuidSlot));
+    MC_MEMTRACK_FREE(MC_MEM_MODULE_GUIDMAP, NULL, sizeof(MC_GuidMap));
+    MC_Allocator_Free(&allocator, map->slots, map->capacity * sizeof(GuidSlot));
+    MC_Allocator_Free(&allocator, map, sizeof(MC_GuidMap));
+
+    *map_ptr = NULL;
+}
+
+u8 MC_GuidMap_MemStats(const MC_GuidMap *map, MC_MemStats *stats)
+{
+    if (!map || !stats)
+    {
+        return false;
+    }
+
+#if defined(MC_ALLOC_TRACKING)
+    *stats = map->memStats;
+
+    return true;
+#else
+    memset(stats, 0, sizeof(*stats));
+
+    return false;
+#endif
+}
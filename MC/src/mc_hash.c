@@ -9,9 +9,12 @@
 /* ********************************************************************************************* */
 
 #include "mc_hash.h"
-#include <stdlib.h>     // malloc
-#include <string.h>     // _strdup
+#include "mc_pool.h"
+#include "mc_trace.h"
+#include <stdlib.h>     // free
+#include <string.h>     // strlen, memset
 #include <stdio.h>      // printf
+#include <threads.h>    // call_once
 
 /**
  * \brief Magic number used in the djb2 hash function, which is a
@@ -25,6 +28,11 @@
  */
 #define HASH_SHIFT 5
 
+/**
+ * \brief Number of completely free slabs the shared HashNode Pool keeps before returning memory.
+ */
+#define HASH_NODE_POOL_EMPTY_SLABS 4
+
 /**
  * \brief HashNode is an internal structure to making a HashMap data type.
  */
@@ -43,6 +51,11 @@ struct MC_HashMap
 {
     HashNode **buckets; // \brief A pointer to the base Address of the starting HashNode array
     u64 size;           // \brief The size allocated for this HashMap
+    MC_Allocator allocator; // \brief The allocator the map, buckets, nodes and keys come from
+    u8 poolNodes;           // \brief Nodes come from the shared HashNode Pool rather than allocator
+#if defined(MC_ALLOC_TRACKING)
+    MC_MemStats memStats;   // \brief Bytes this map holds: header, buckets, nodes and keys
+#endif
 };
 
 /**
@@ -68,30 +81,142 @@ static u64 internal_hash_function(const char *str, u64 size)
     return hash % size;
 }
 
+/**
+ * \brief Every HashMap on the default allocator shares one Pool of HashNodes, created on first use and kept for the process lifetime, outside the MC_MEM_MODULE_POOL counters.
+ */
+static MC_Pool *hash_node_pool;
+static once_flag hash_node_pool_once = ONCE_FLAG_INIT;
+
+static void internal_hash_node_pool_init(void)
+{
+    hash_node_pool = MC_Pool_InitShared(sizeof(HashNode), HASH_NODE_POOL_EMPTY_SLABS);
+}
+
+/**
+ * \brief Allocate a HashNode from the shared node Pool, or from the map's allocator.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static HashNode* internal_hash_node_alloc(MC_HashMap *map)
+{
+    HashNode *node = map->poolNodes ? (HashNode*)MC_Pool_Alloc(hash_node_pool)
+                                    : (HashNode*)MC_Allocator_Alloc(&map->allocator, sizeof(HashNode));
+
+    if (node)
+    {
+        MC_MEMTRACK_ALLOC(MC_MEM_MODULE_HASH, &map->memStats, sizeof(HashNode));
+    }
+
+    return node;
+}
+
+/**
+ * \brief Give a HashNode back to wherever internal_hash_node_alloc took it from.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static void internal_hash_node_release(MC_HashMap *map, HashNode *node)
+{
+    MC_MEMTRACK_FREE(MC_MEM_MODULE_HASH, &map->memStats, sizeof(HashNode));
+
+    if (map->poolNodes)
+    {
+        MC_Pool_Release(hash_node_pool, node);
+
+        return;
+    }
+
+    MC_Allocator_Free(&map->allocator, node, sizeof(HashNode));
+}
+
+/**
+ * \brief Release a node along with its key copy.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static void internal_hash_node_destroy(MC_HashMap *map, HashNode *node)
+{
+    if (node->isDynamic)
+    {
+        free(node->value);
+    }
+
+    u64 keySize = strlen(node->key) + 1;
+
+    MC_MEMTRACK_FREE(MC_MEM_MODULE_HASH, &map->memStats, keySize);
+    MC_Allocator_Free(&map->allocator, node->key, keySize);
+    internal_hash_node_release(map, node);
+}
+
 MC_HashMap* MC_Hashmap_Init(u64 size)
 {
-    MC_HashMap *map = (MC_HashMap*)malloc(sizeof(MC_HashMap));
+    return MC_Hashmap_InitEx(size, NULL);
+}
+
+MC_HashMap* MC_Hashmap_InitEx(u64 size, const MC_Allocator *allocator)
+{
+    if (size == 0 || size > U64_MAX / sizeof(HashNode*))
+    {
+        return NULL;
+    }
+
+    allocator = allocator ? allocator : MC_Allocator_GetGlobal();
+
+    MC_HashMap *map = (MC_HashMap*)MC_Allocator_Alloc(allocator, sizeof(MC_HashMap));
 
     if (!map)
     {
         return NULL;
     }
 
-    map->buckets = (HashNode**)calloc(sizeof(HashNode*), size);
+    map->buckets = (HashNode**)MC_Allocator_Alloc(allocator, size * sizeof(HashNode*));
 
     if (!map->buckets)
     {
-        free(map);
+        MC_Allocator_Free(allocator, map, sizeof(MC_HashMap));
 
         return NULL;
     }
 
+    memset(map->buckets, 0, size * sizeof(HashNode*));
+
     map->size = size;
+    map->allocator = *allocator;
+    map->poolNodes = false;
+
+#if defined(MC_ALLOC_TRACKING)
+    memset(&map->memStats, 0, sizeof(map->memStats));
+#endif
+    MC_MEMTRACK_ALLOC(MC_MEM_MODULE_HASH, &map->memStats, sizeof(MC_HashMap));
+    MC_MEMTRACK_ALLOC(MC_MEM_MODULE_HASH, &map->memStats, size * sizeof(HashNode*));
+
+    if (MC_Allocator_IsDefault(allocator))  // a custom allocator sees every allocation, nodes included
+    {
+        call_once(&hash_node_pool_once, internal_hash_node_pool_init);
+        map->poolNodes = hash_node_pool != NULL;
+    }
 
     return map;
 }
 
-u8 MC_Hashmap_Insert(MC_HashMap *map, const char *key, void *value, const u8 dynamic)
+MC_HashMap* MC_Hashmap_InitArena(MC_Arena *arena, u64 size)
+{
+    if (!arena)
+    {
+        return NULL;
+    }
+
+    MC_Allocator allocator = MC_Arena_AsAllocator(arena);
+
+    return MC_Hashmap_InitEx(size, &allocator);
+}
+
+/**
+ * \brief Insert or update a key, see MC_Hashmap_Insert.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static u8 internal_hash_insert(MC_HashMap *map, const char *key, void *value, const u8 dynamic)
 {
     if (!map || !key)
     {
@@ -119,14 +244,24 @@ u8 MC_Hashmap_Insert(MC_HashMap *map, const char *key, void *value, const u8 dyn
         new_node = new_node->next;
     }
 
-    new_node = (HashNode *)malloc(sizeof(HashNode));    // Key didn't exist, create new HashNode and insert it
+    new_node = internal_hash_node_alloc(map);    // Key didn't exist, create new HashNode and insert it
     
     if (!new_node)
     {
         return false;
     }
 
-    new_node->key = _strdup(key);   // _strdup syscall - "I promise to free this memory." - mario
+    new_node->key = MC_Allocator_StrDup(&map->allocator, key);   // "I promise to free this memory." - mario
+
+    if (!new_node->key)
+    {
+        internal_hash_node_release(map, new_node);
+
+        return false;
+    }
+
+    MC_MEMTRACK_ALLOC(MC_MEM_MODULE_HASH, &map->memStats, strlen(key) + 1);
+
     new_node->value = value;
     new_node->isDynamic = dynamic;
     new_node->next = map->buckets[index];
@@ -135,7 +270,12 @@ u8 MC_Hashmap_Insert(MC_HashMap *map, const char *key, void *value, const u8 dyn
     return true;
 }
 
-void* MC_Hashmap_Search(const MC_HashMap *map, const char *key)
+/**
+ * \brief Find the value of a key, see MC_Hashmap_Search.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static void* internal_hash_search(const MC_HashMap *map, const char *key)
 {
     if (!map || !key)
     {
@@ -158,7 +298,12 @@ void* MC_Hashmap_Search(const MC_HashMap *map, const char *key)
     return NULL;
 }
 
-u8 MC_Hashmap_RemoveAt(MC_HashMap *map, const char *key)
+/**
+ * \brief Remove a key, see MC_Hashmap_RemoveAt.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static u8 internal_hash_remove(MC_HashMap *map, const char *key)
 {
     if (!map || !key)
     {
@@ -183,13 +328,7 @@ u8 MC_Hashmap_RemoveAt(MC_HashMap *map, const char *key)
                 map->buckets[index] = node->next;
             }
 
-            if (node->isDynamic)
-            {
-                free(node->value);
-            }
-
-            free(node->key);
-            free(node);
+            internal_hash_node_destroy(map, node);
 
             return true;
         }
@@ -201,6 +340,33 @@ u8 MC_Hashmap_RemoveAt(MC_HashMap *map, const char *key)
     return false;
 }
 
+u8 MC_Hashmap_Insert(MC_HashMap *map, const char *key, void *value, const u8 dynamic)
+{
+    MC_TRACE_MODULE_BEGIN("MC_Hashmap_Insert");
+    u8 inserted = internal_hash_insert(map, key, value, dynamic);
+    MC_TRACE_MODULE_END("MC_Hashmap_Insert");
+
+    return inserted;
+}
+
+void* MC_Hashmap_Search(const MC_HashMap *map, const char *key)
+{
+    MC_TRACE_MODULE_BEGIN("MC_Hashmap_Search");
+    void *value = internal_hash_search(map, key);
+    MC_TRACE_MODULE_END("MC_Hashmap_Search");
+
+    return value;
+}
+
+u8 MC_Hashmap_RemoveAt(MC_HashMap *map, const char *key)
+{
+    MC_TRACE_MODULE_BEGIN("MC_Hashmap_RemoveAt");
+    u8 removed = internal_hash_remove(map, key);
+    MC_TRACE_MODULE_END("MC_Hashmap_RemoveAt");
+
+    return removed;
+}
+
 void MC_Hashmap_Free(MC_HashMap **map_ptr)
 {
     if (!(map_ptr) || !(*map_ptr))
@@ -210,6 +376,8 @@ void MC_Hashmap_Free(MC_HashMap **map_ptr)
 
     MC_HashMap *map = *map_ptr;
 
+    MC_TRACE_MODULE_BEGIN("MC_Hashmap_Free");
+
     for (u64 i = 0; i < map->size; i++)
     {
         HashNode *node = map->buckets[i];
@@ -218,13 +386,7 @@ void MC_Hashmap_Free(MC_HashMap **map_ptr)
         {
             HashNode *next = node->next;
 
-            if (node->isDynamic)
-            {
-                free(node->value);
-            }
-
-            free(node->key);
-            free(node);
+            internal_hash_node_destroy(map, node);
 
             node = next;
         }
@@ -232,10 +394,34 @@ void MC_Hashmap_Free(MC_HashMap **map_ptr)
         map->buckets[i] = NULL;
     }
 
-    free(map->buckets);
-    free(map);
+    MC_Allocator allocator = map->allocator;
+
+    MC_MEMTRACK_FREE(MC_MEM_MODULE_HASH, NULL, map->size * sizeof(HashNode*));
+    MC_MEMTRACK_FREE(MC_MEM_MODULE_HASH, NULL, sizeof(MC_HashMap));
+    MC_Allocator_Free(&allocator, map->buckets, map->size * sizeof(HashNode*));
+    MC_Allocator_Free(&allocator, map, sizeof(MC_HashMap));
 
     *map_ptr = NULL;
+
+    MC_TRACE_MODULE_END("MC_Hashmap_Free");
+}
+
+u8 MC_Hashmap_MemStats(const MC_HashMap *map, MC_MemStats *stats)
+{
+    if (!map || !stats)
+    {
+        return false;
+    }
+
+#if defined(MC_ALLOC_TRACKING)
+    *stats = map->memStats;
+
+    return true;
+#else
+    memset(stats, 0, sizeof(*stats));
+
+    return false;
+#endif
 }
 
 void MC_Hashmap_Print(const MC_HashMap *map)
@@ -0,0 +1,794 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_histogram.c                                                                         */
+/* \brief: Provide a log-linear histogram for latency percentiles                                */
+/*                                                                                               */
+/* \Expects: mc_histogram.h is linked properly and defines interface                             */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#include "mc_histogram.h"
+#include "mc_platform.h"
+#include <string.h>     // memcpy, memcmp, memset
+#include <stdio.h>      // fprintf
+#include <stdatomic.h>  // atomic_load_explicit
+#include <threads.h>    // thrd_current, thrd_equal
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>         // _BitScanReverse64
+#endif
+
+/**
+ * \brief First bytes of a serialized Histogram, followed by its version.
+ */
+#define HISTOGRAM_MAGIC "MCHISTOG"
+#define HISTOGRAM_VERSION 1
+
+/**
+ * \brief Longest LEB128 encoding of a u64.
+ */
+#define HISTOGRAM_VARINT_MAX 10
+
+/**
+ * \brief Recorders a thread remembers its Histogram of without searching, a power of two.
+ */
+#define HISTOGRAM_THREAD_CACHE 8
+
+struct MC_Histogram
+{
+    atomic_uint_fast64_t *counts;   // \brief One per bucket, stored by the recording thread only
+    u64 bucketCount;
+    atomic_uint_fast64_t total;     // \brief Values recorded
+    atomic_uint_fast64_t min;       // \brief U64_MAX while empty
+    atomic_uint_fast64_t max;
+    u8 bits;                        // \brief Each power of two is split into 2^(bits - 1) buckets
+    MC_Allocator allocator;         // \brief The allocator the Histogram and its buckets come from
+#if defined(MC_ALLOC_TRACKING)
+    MC_MemStats memStats;           // \brief Bytes this Histogram holds: header and buckets
+#endif
+};
+
+/**
+ * \brief HistogramShard is the Histogram of one thread recording into a Recorder.
+ */
+typedef struct HistogramShard
+{
+    MC_Histogram *histogram;
+    thrd_t owner;
+    struct HistogramShard *next;
+} HistogramShard;
+
+struct MC_HistogramRecorder
+{
+    _Atomic(HistogramShard*) shards;
+    u64 id;                         // \brief Never reused, so a thread's cache cannot mistake a later Recorder for this one
+    u8 bits;
+    MC_Allocator allocator;
+};
+
+/**
+ * \brief HistogramCacheEntry remembers the calling thread's Histogram in one Recorder.
+ */
+typedef struct HistogramCacheEntry
+{
+    u64 id;                         // \brief The Recorder's id, 0 for none
+    MC_Histogram *histogram;
+} HistogramCacheEntry;
+
+static atomic_uint_fast64_t histogram_next_id = 1;
+static _Thread_local HistogramCacheEntry histogram_thread_cache[HISTOGRAM_THREAD_CACHE];
+
+/**
+ * \brief The index of the highest set bit of a non-zero value.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static inline u32 internal_histogram_msb(u64 value)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+
+    return (u32)index;
+#else
+    return 63u - (u32)__builtin_clzll(value);
+#endif
+}
+
+/**
+ * \brief The bucket of a value: itself below 2^bits, else its top bits after shifting by its exponent.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static inline u64 internal_histogram_index(u64 value, u8 bits)
+{
+    if (value < (1ull << bits))
+    {
+        return value;
+    }
+
+    u32 exponent = internal_histogram_msb(value) - bits + 1;
+
+    return ((u64)exponent << (bits - 1)) + (value >> exponent);
+}
+
+/**
+ * \brief The lowest and highest value a bucket stands for.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static void internal_histogram_range(u8 bits, u64 index, u64 *low, u64 *high)
+{
+    if (index < (1ull << bits))
+    {
+        *low = *high = index;
+
+        return;
+    }
+
+    u64 exponent = (index >> (bits - 1)) - 1;
+    u64 mantissa = index - (exponent << (bits - 1));
+
+    *low = mantissa << exponent;
+    *high = *low + ((1ull << exponent) - 1);
+}
+
+/**
+ * \brief Add to a counter that only the calling thread stores to, which other threads may read.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static inline void internal_histogram_bump(atomic_uint_fast64_t *counter, u64 count)
+{
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + count, memory_order_relaxed);
+}
+
+/**
+ * \brief Count a value into its bucket and widen the range seen.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static inline void internal_histogram_add(MC_Histogram *histogram, u64 value, u64 count)
+{
+    internal_histogram_bump(&histogram->counts[internal_histogram_index(value, histogram->bits)], count);
+    internal_histogram_bump(&histogram->total, count);
+
+    if (value < atomic_load_explicit(&histogram->min, memory_order_relaxed))
+    {
+        atomic_store_explicit(&histogram->min, value, memory_order_relaxed);
+    }
+
+    if (value > atomic_load_explicit(&histogram->max, memory_order_relaxed))
+    {
+        atomic_store_explicit(&histogram->max, value, memory_order_relaxed);
+    }
+}
+
+/**
+ * \brief Write a value as LEB128, seven bits a byte, stopping short at end.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static void internal_histogram_put(u8 **at, const u8 *end, u64 value)
+{
+    do
+    {
+        u8 byte = (u8)(value & 0x7F);
+        value >>= 7;
+
+        if (*at < end)
+        {
+            **at = value ? (u8)(byte | 0x80) : byte;
+        }
+
+        (*at)++;
+    } while (value);
+}
+
+/**
+ * \brief Bytes internal_histogram_put takes for value.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static u64 internal_histogram_put_size(u64 value)
+{
+    u64 size = 1;
+
+    while (value >>= 7)
+    {
+        size++;
+    }
+
+    return size;
+}
+
+/**
+ * \brief Read a LEB128 value.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * \returns u8: true/false corresponding to success fail, false past end or for an overlong encoding
+ */
+static u8 internal_histogram_get(const u8 **at, const u8 *end, u64 *value)
+{
+    *value = 0;
+
+    for (u32 shift = 0; shift < 7 * HISTOGRAM_VARINT_MAX && *at < end; shift += 7)
+    {
+        u8 byte = *(*at)++;
+
+        if (shift == 63 && byte > 1)
+        {
+            return false;   // more than 64 bits
+        }
+
+        *value |= (u64)(byte & 0x7F) << shift;
+
+        if (!(byte & 0x80))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+MC_Histogram* MC_Histogram_Init(u8 sub_bucket_bits)
+{
+    return MC_Histogram_InitEx(sub_bucket_bits, NULL);
+}
+
+MC_Histogram* MC_Histogram_InitEx(u8 sub_bucket_bits, const MC_Allocator *allocator)
+{
+    u8 bits = sub_bucket_bits ? sub_bucket_bits : MC_HISTOGRAM_DEFAULT_BITS;
+
+    if (bits > MC_HISTOGRAM_MAX_BITS)
+    {
+        return NULL;
+    }
+
+    allocator = allocator ? allocator : MC_Allocator_GetGlobal();
+
+    MC_Histogram *histogram = (MC_Histogram*)MC_Allocator_Alloc(allocator, sizeof(MC_Histogram));
+
+    if (!histogram)
+    {
+        return NULL;
+    }
+
+    histogram->allocator = *allocator;
+    histogram->bits = bits;
+    histogram->bucketCount = (u64)(66 - bits) << (bits - 1);    // the top exponent, 64 - bits, holds buckets up to 2^bits - 1
+
+#if defined(MC_ALLOC_TRACKING)
+    memset(&histogram->memStats, 0, sizeof(histogram->memStats));
+#endif
+    MC_MEMTRACK_ALLOC(MC_MEM_MODULE_HISTOGRAM, &histogram->memStats, sizeof(MC_Histogram));
+
+    histogram->counts = (atomic_uint_fast64_t*)MC_Allocator_Alloc(allocator, histogram->bucketCount * sizeof(atomic_uint_fast64_t));
+
+    if (!histogram->counts)
+    {
+        MC_MEMTRACK_FREE(MC_MEM_MODULE_HISTOGRAM, NULL, sizeof(MC_Histogram));
+        MC_Allocator_Free(allocator, histogram, sizeof(MC_Histogram));
+
+        return NULL;
+    }
+
+    MC_MEMTRACK_ALLOC(MC_MEM_MODULE_HISTOGRAM, &histogram->memStats, histogram->bucketCount * sizeof(atomic_uint_fast64_t));
+
+    for (u64 i = 0; i < histogram->bucketCount; i++)
+    {
+        atomic_init(&histogram->counts[i], 0);
+    }
+
+    atomic_init(&histogram->total, 0);
+    atomic_init(&histogram->min, U64_MAX);
+    atomic_init(&histogram->max, 0);
+
+    return histogram;
+}
+
+void MC_Histogram_Record(MC_Histogram *histogram, u64 value)
+{
+    if (histogram)
+    {
+        internal_histogram_add(histogram, value, 1);
+    }
+}
+
+void MC_Histogram_RecordN(MC_Histogram *histogram, u64 value, u64 count)
+{
+    if (histogram && count)
+    {
+        internal_histogram_add(histogram, value, count);
+    }
+}
+
+void MC_Histogram_Reset(MC_Histogram *histogram)
+{
+    if (!histogram)
+    {
+        return;
+    }
+
+    for (u64 i = 0; i < histogram->bucketCount; i++)
+    {
+        atomic_store_explicit(&histogram->counts[i], 0, memory_order_relaxed);
+    }
+
+    atomic_store_explicit(&histogram->total, 0, memory_order_relaxed);
+    atomic_store_explicit(&histogram->min, U64_MAX, memory_order_relaxed);
+    atomic_store_explicit(&histogram->max, 0, memory_order_relaxed);
+}
+
+u8 MC_Histogram_Merge(MC_Histogram *into, const MC_Histogram *from)
+{
+    if (!into || !from)
+    {
+        return false;
+    }
+
+    u64 lowest = atomic_load_explicit(&from->min, memory_order_relaxed);
+    u64 highest = atomic_load_explicit(&from->max, memory_order_relaxed);
+
+    for (u64 i = 0; i < from->bucketCount; i++)
+    {
+        u64 count = atomic_load_explicit(&from->counts[i], memory_order_relaxed);
+
+        if (!count)
+        {
+            continue;
+        }
+
+        if (into->bits == from->bits)
+        {
+            internal_histogram_bump(&into->counts[i], count);
+            internal_histogram_bump(&into->total, count);
+        }
+        else
+        {
+            u64 low, high;
+            internal_histogram_range(from->bits, i, &low, &high);
+            internal_histogram_add(into, high < highest ? high : highest, count);
+        }
+    }
+
+    if (lowest <= highest)  // from holds values, its exact range replaces the bucket values recorded above
+    {
+        if (lowest < atomic_load_explicit(&into->min, memory_order_relaxed))
+        {
+            atomic_store_explicit(&into->min, lowest, memory_order_relaxed);
+        }
+
+        if (highest > atomic_load_explicit(&into->max, memory_order_relaxed))
+        {
+            atomic_store_explicit(&into->max, highest, memory_order_relaxed);
+        }
+    }
+
+    return true;
+}
+
+u64 MC_Histogram_Count(const MC_Histogram *histogram)
+{
+    return histogram ? atomic_load_explicit(&histogram->total, memory_order_relaxed) : 0;
+}
+
+u64 MC_Histogram_Min(const MC_Histogram *histogram)
+{
+    if (!MC_Histogram_Count(histogram))
+    {
+        return 0;
+    }
+
+    return atomic_load_explicit(&histogram->min, memory_order_relaxed);
+}
+
+u64 MC_Histogram_Max(const MC_Histogram *histogram)
+{
+    return histogram ? atomic_load_explicit(&histogram->max, memory_order_relaxed) : 0;
+}
+
+double MC_Histogram_Mean(const MC_Histogram *histogram)
+{
+    u64 total = MC_Histogram_Count(histogram);
+    double sum = 0.0;
+
+    if (!total)
+    {
+        return 0.0;
+    }
+
+    for (u64 i = 0; i < histogram->bucketCount; i++)
+    {
+        u64 count = atomic_load_explicit(&histogram->counts[i], memory_order_relaxed);
+
+        if (count)
+        {
+            u64 low, high;
+            internal_histogram_range(histogram->bits, i, &low, &high);
+            sum += (double)count * ((double)low + (double)(high - low) / 2.0);
+        }
+    }
+
+    return sum / (double)total;
+}
+
+u64 MC_Histogram_Percentile(const MC_Histogram *histogram, double percentile)
+{
+    u64 total = MC_Histogram_Count(histogram);
+
+    if (!total)
+    {
+        return 0;
+    }
+
+    if (percentile <= 0.0)
+    {
+        return MC_Histogram_Min(histogram);
+    }
+
+    double wanted = (percentile >= 100.0 ? 1.0 : percentile / 100.0) * (double)total;
+    u64 target = (u64)wanted;
+    u64 highest = MC_Histogram_Max(histogram);
+    u64 seen = 0;
+
+    target += (double)target < wanted || !target;   // the count at or above which the percentile is reached
+
+    for (u64 i = 0; i < histogram->bucketCount; i++)
+    {
+        seen += atomic_load_explicit(&histogram->counts[i], memory_order_relaxed);
+
+        if (seen >= target)
+        {
+            u64 low, high;
+            internal_histogram_range(histogram->bits, i, &low, &high);
+
+            return high < highest ? high : highest;
+        }
+    }
+
+    return highest;     // values were recorded while the buckets were walked
+}
+
+u64 MC_Histogram_Serialize(const MC_Histogram *histogram, u8 *buffer, u64 size)
+{
+    if (!histogram)
+    {
+        return 0;
+    }
+
+    u64 entries = 0;
+    u64 needed = sizeof(HISTOGRAM_MAGIC) - 1 + 2;
+    u64 next = 0;
+
+    needed += internal_histogram_put_size(atomic_load_explicit(&histogram->min, memory_order_relaxed));
+    needed += internal_histogram_put_size(atomic_load_explicit(&histogram->max, memory_order_relaxed));
+
+    for (u64 i = 0; i < histogram->bucketCount; i++)
+    {
+        u64 count = atomic_load_explicit(&histogram->counts[i], memory_order_relaxed);
+
+        if (count)
+        {
+            needed += internal_histogram_put_size(i - next) + internal_histogram_put_size(count);
+            next = i + 1;
+            entries++;
+        }
+    }
+
+    needed += internal_histogram_put_size(entries);
+
+    if (!buffer || size < needed)
+    {
+        return needed;
+    }
+
+    u8 *at = buffer;
+    const u8 *end = buffer + needed;    // a bucket filled meanwhile is cut off rather than overrun the buffer
+
+    memcpy(at, HISTOGRAM_MAGIC, sizeof(HISTOGRAM_MAGIC) - 1);
+    at += sizeof(HISTOGRAM_MAGIC) - 1;
+    *at++ = HISTOGRAM_VERSION;
+    *at++ = histogram->bits;
+
+    internal_histogram_put(&at, end, atomic_load_explicit(&histogram->min, memory_order_relaxed));
+    internal_histogram_put(&at, end, atomic_load_explicit(&histogram->max, memory_order_relaxed));
+    internal_histogram_put(&at, end, entries);
+
+    next = 0;
+
+    for (u64 i = 0; i < histogram->bucketCount && entries; i++)
+    {
+        u64 count = atomic_load_explicit(&histogram->counts[i], memory_order_relaxed);
+
+        if (count)
+        {
+            internal_histogram_put(&at, end, i - next);
+            internal_histogram_put(&at, end, count);
+            next = i + 1;
+            entries--;
+        }
+    }
+
+    return needed;
+}
+
+MC_Histogram* MC_Histogram_Deserialize(const u8 *buffer, u64 size, const MC_Allocator *allocator)
+{
+    const u64 magic = sizeof(HISTOGRAM_MAGIC) - 1;
+
+    if (!buffer || size < magic + 2 || memcmp(buffer, HISTOGRAM_MAGIC, magic) != 0 ||
+        buffer[magic] != HISTOGRAM_VERSION || !buffer[magic + 1] || buffer[magic + 1] > MC_HISTOGRAM_MAX_BITS)
+    {
+        return NULL;
+    }
+
+    MC_Histogram *histogram = MC_Histogram_InitEx(buffer[magic + 1], allocator);
+    const u8 *at = buffer + magic + 2;
+    const u8 *end = buffer + size;
+    u64 min, max, entries, next = 0, total = 0;
+    u8 valid = histogram && internal_histogram_get(&at, end, &min) && internal_histogram_get(&at, end, &max) &&
+               internal_histogram_get(&at, end, &entries) && entries <= histogram->bucketCount;
+
+    for (u64 e = 0; valid && e < entries; e++)
+    {
+        u64 gap, count;
+
+        valid = internal_histogram_get(&at, end, &gap) && internal_histogram_get(&at, end, &count) &&
+                count && gap < histogram->bucketCount - next;
+
+        if (valid)
+        {
+            atomic_store_explicit(&histogram->counts[next + gap], count, memory_order_relaxed);
+            total += count;
+            next += gap + 1;
+        }
+    }
+
+    if (!valid || at != end || (total && min > max))
+    {
+        MC_Histogram_Free(&histogram);
+
+        return NULL;
+    }
+
+    atomic_store_explicit(&histogram->total, total, memory_order_relaxed);
+    atomic_store_explicit(&histogram->min, total ? min : U64_MAX, memory_order_relaxed);
+    atomic_store_explicit(&histogram->max, total ? max : 0, memory_order_relaxed);
+
+    return histogram;
+}
+
+int MC_Histogram_WriteCdf(const MC_Histogram *histogram, const char *path)
+{
+    FILE *out = stdout;
+
+    if (!histogram || (path && MC_FOpen(&out, path, "w") != 0))
+    {
+        return -1;
+    }
+
+    u64 total = MC_Histogram_Count(histogram);
+    u64 highest = MC_Histogram_Max(histogram);
+    u64 seen = 0;
+
+    fprintf(out, "       Value     Percentile TotalCount 1/(1-Percentile)\n\n");
+
+    for (u64 i = 0; i < histogram->bucketCount && total; i++)
+    {
+        u64 count = atomic_load_explicit(&histogram->counts[i], memory_order_relaxed);
+
+        if (!count)
+        {
+            continue;
+        }
+
+        u64 low, high;
+        internal_histogram_range(histogram->bits, i, &low, &high);
+
+        seen += count;
+        double fraction = seen >= total ? 1.0 : (double)seen / (double)total;
+
+        fprintf(out, "%12.3f %2.12f %10llu", (double)(high < highest ? high : highest), fraction, (unsigned long long)seen);
+
+        if (fraction < 1.0)
+        {
+            fprintf(out, " %14.2f", 1.0 / (1.0 - fraction));
+        }
+
+        fputc('\n', out);
+    }
+
+    fprintf(out, "#[Mean    = %12.3f, Total count    = %12llu]\n", MC_Histogram_Mean(histogram), (unsigned long long)total);
+    fprintf(out, "#[Max     = %12.3f, Min            = %12.3f]\n", (double)highest, (double)MC_Histogram_Min(histogram));
+    fprintf(out, "#[Buckets = %12llu, SubBuckets     = %12llu]\n",
+            (unsigned long long)histogram->bucketCount, 1ull << (histogram->bits - 1));
+
+    int failed = ferror(out);
+
+    if (path)
+    {
+        failed |= fclose(out);
+    }
+
+    return failed ? -1 : 0;
+}
+
+u8 MC_Histogram_MemStats(const MC_Histogram *histogram, MC_MemStats *stats)
+{
+    if (!histogram || !stats)
+    {
+        return false;
+    }
+
+#if defined(MC_ALLOC_TRACKING)
+    *stats = histogram->memStats;
+
+    return true;
+#else
+    memset(stats, 0, sizeof(*stats));
+
+    return false;
+#endif
+}
+
+void MC_Histogram_Free(MC_Histogram **histogram_ptr)
+{
+    if (!(histogram_ptr) || !(*histogram_ptr))
+    {
+        return;
+    }
+
+    MC_Histogram *histogram = *histogram_ptr;
+    MC_Allocator allocator = histogram->allocator;
+
+    MC_MEMTRACK_FREE(MC_MEM_MODULE_HISTOGRAM, NULL, histogram->bucketCount * sizeof(atomic_uint_fast64_t));
+    MC_MEMTRACK_FREE(MC_MEM_MODULE_HISTOGRAM, NULL, sizeof(MC_Histogram));
+    MC_Allocator_Free(&allocator, histogram->counts, histogram->bucketCount * sizeof(atomic_uint_fast64_t));
+    MC_Allocator_Free(&allocator, histogram, sizeof(MC_Histogram));
+
+    *histogram_ptr = NULL;
+}
+
+MC_HistogramRecorder* MC_HistogramRecorder_Init(u8 sub_bucket_bits)
+{
+    u8 bits = sub_bucket_bits ? sub_bucket_bits : MC_HISTOGRAM_DEFAULT_BITS;
+    const MC_Allocator *allocator = MC_Allocator_GetGlobal();
+
+    if (bits > MC_HISTOGRAM_MAX_BITS)
+    {
+        return NULL;
+    }
+
+    MC_HistogramRecorder *recorder = (MC_HistogramRecorder*)MC_Allocator_Alloc(allocator, sizeof(MC_HistogramRecorder));
+
+    if (!recorder)
+    {
+        return NULL;
+    }
+
+    MC_MEMTRACK_ALLOC(MC_MEM_MODULE_HISTOGRAM, NULL, sizeof(MC_HistogramRecorder));
+
+    atomic_init(&recorder->shards, NULL);
+    recorder->id = atomic_fetch_add(&histogram_next_id, 1);
+    recorder->bits = bits;
+    recorder->allocator = *allocator;
+
+    return recorder;
+}
+
+/**
+ * \brief Find the calling thread's Histogram in a Recorder, creating and publishing it on first use.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * \returns MC_Histogram*: The thread's Histogram, NULL if it cannot be allocated.
+ */
+static MC_Histogram* internal_histogram_shard(MC_HistogramRecorder *recorder)
+{
+    thrd_t self = thrd_current();
+
+    for (HistogramShard *shard = atomic_load_explicit(&recorder->shards, memory_order_acquire); shard; shard = shard->next)
+    {
+        if (thrd_equal(shard->owner, self))
+        {
+            return shard->histogram;    // evicted from the cache by another Recorder, or left by an exited thread of the same id
+        }
+    }
+
+    HistogramShard *shard = (HistogramShard*)MC_Allocator_Alloc(&recorder->allocator, sizeof(HistogramShard));
+
+    if (!shard)
+    {
+        return NULL;
+    }
+
+    shard->histogram = MC_Histogram_InitEx(recorder->bits, &recorder->allocator);
+
+    if (!shard->histogram)
+    {
+        MC_Allocator_Free(&recorder->allocator, shard, sizeof(HistogramShard));
+
+        return NULL;
+    }
+
+    MC_MEMTRACK_ALLOC(MC_MEM_MODULE_HISTOGRAM, NULL, sizeof(HistogramShard));
+
+    shard->owner = self;
+    shard->next = atomic_load_explicit(&recorder->shards, memory_order_relaxed);
+
+    while (!atomic_compare_exchange_weak_explicit(&recorder->shards, &shard->next, shard,
+                                                  memory_order_release, memory_order_relaxed))
+    {
+    }
+
+    return shard->histogram;
+}
+
+void MC_HistogramRecorder_Record(MC_HistogramRecorder *recorder, u64 value)
+{
+    if (!recorder)
+    {
+        return;
+    }
+
+    HistogramCacheEntry *entry = &histogram_thread_cache[recorder->id & (HISTOGRAM_THREAD_CACHE - 1)];
+
+    if (entry->id != recorder->id)
+    {
+        MC_Histogram *histogram = internal_histogram_shard(recorder);
+
+        if (!histogram)
+        {
+            return;
+        }
+
+        entry->id = recorder->id;
+        entry->histogram = histogram;
+    }
+
+    internal_histogram_add(entry->histogram, value, 1);
+}
+
+u8 MC_HistogramRecorder_Snapshot(const MC_HistogramRecorder *recorder, MC_Histogram *into)
+{
+    if (!recorder || !into)
+    {
+        return false;
+    }
+
+    for (HistogramShard *shard = atomic_load_explicit(&recorder->shards, memory_order_acquire); shard; shard = shard->next)
+    {
+        MC_Histogram_Merge(into, shard->histogram);
+    }
+
+    return true;
+}
+
+void MC_HistogramRecorder_Free(MC_HistogramRecorder **recorder_ptr)
+{
+    if (!(recorder_ptr) || !(*recorder_ptr))
+    {
+        return;
+    }
+
+    MC_HistogramRecorder *recorder = *recorder_ptr;
+    MC_Allocator allocator = recorder->allocator;
+    HistogramShard *shard = atomic_load(&recorder->shards);
+
+    while (shard)
+    {
+        HistogramShard *next = shard->next;
+
+        MC_Histogram_Free(&shard->histogram);
+        MC_MEMTRACK_FREE(MC_MEM_MODULE_HISTOGRAM, NULL, sizeof(HistogramShard));
+        MC_Allocator_Free(&allocator, shard, sizeof(HistogramShard));
+        shard = next;
+    }
+
+    MC_MEMTRACK_FREE(MC_MEM_MODULE_HISTOGRAM, NULL, sizeof(MC_HistogramRecorder));
+    MC_Allocator_Free(&allocator, recorder, sizeof(MC_HistogramRecorder));
+
+    *recorder_ptr = NULL;
+}
@@ -9,70 +9,2923 @@
 /* ********************************************************************************************* */
 
 #include "mc_log.h"
+#include "mc_spscring.h"
+#include "mc_trace.h"
+#include "mc_platform.h"
 #include <stdarg.h>     // va_start
-#include <time.h>       // time_t
+#include <stddef.h>     // ptrdiff_t
+#include <stdint.h>     // intmax_t, uintptr_t
+#include <time.h>       // time_t, timespec_get
+#include <string.h>     // memcpy
+#include <stdatomic.h>  // atomic_load
+#include <threads.h>    // thrd_create, mtx_lock, tss_create
+#include <errno.h>      // EINTR
+#include <signal.h>     // sigaction, raise
+
+#if defined(_WIN32)
+#include <io.h>             // _write, _fileno
+#include <windows.h>        // CreateFileMappingA, MapViewOfFile
+#else
+#include <unistd.h>         // write, ftruncate
+#include <fcntl.h>          // fcntl, O_APPEND, posix_fallocate
+#include <sys/mman.h>       // mmap, msync
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define LOG_X86 1
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>         // __rdtsc
+#else
+#include <x86intrin.h>      // __rdtsc
+#endif
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LOG_SSE2 1
+#include <emmintrin.h>      // _mm_cmpeq_epi8, _mm_movemask_epi8
+#endif
+
+/**
+ * \brief Test file where output will be written
+ */
+#define LOG_OUTPUT_FILE "last_run_output.txt"
+
+/**
+ * \brief File MC_Log_InitBinary writes to when it is given no path.
+ */
+#define LOG_BINARY_FILE "last_run_output.mclog"
+
+/**
+ * \brief First bytes of a binary log, followed by its version.
+ */
+#define LOG_BINARY_MAGIC "MCLOGBIN"
+#define LOG_BINARY_VERSION 1
+
+/**
+ * \brief Format strings MC_LOG_BINARY can register, sites past it log as text.
+ */
+#define LOG_BINARY_MAX_FORMATS 4096
+
+/**
+ * \brief Arguments a registered format may take, star widths and precisions included.
+ */
+#define LOG_BINARY_MAX_ARGS 16
+
+/**
+ * \brief Bytes kept back for every argument still to come while a string is copied, its worst case.
+ */
+#define LOG_BINARY_ARG_RESERVE (sizeof(u16) + sizeof(u64))
+
+/**
+ * \brief Entry ids above every format id.
+ */
+#define LOG_BINARY_ID_TEXT   0xFFFFFFFFu    // a message formatted by the caller, level then characters
+#define LOG_BINARY_ID_FORMAT 0xFFFFFFFEu    // a format definition, stamp holds the id it defines
+#define LOG_BINARY_ID_CLOCK  0xFFFFFFFDu    // stamp is a tick count, the payload the unix time in ns at that tick
+#define LOG_BINARY_ID_JSON   0xFFFFFFFCu    // an MC_LOG_KV line, level then the line from its "event" member on
+
+/**
+ * \brief How long MC_Log_InitBinary measures the tick rate against the wall clock.
+ */
+#define LOG_CALIBRATE_NS 10000000
+
+/**
+ * \brief Longest conversion specification the decoder rebuilds, flags, width and precision included.
+ */
+#define LOG_SPEC_SIZE 32
+
+#define LOG_NS_PER_SECOND 1000000000ULL
+#define LOG_NS_PER_US 1000ULL
+#define LOG_NS_PER_MS 1000000ULL
+
+/**
+ * \brief Characters in the date and time of a line, YYYY-MM-DD HH:MM:SS, and room for a whole prefix,
+ * "[" date "." microseconds "] [" level "] ".
+ */
+#define LOG_DATE_LENGTH 19
+#define LOG_STAMP_LENGTH (LOG_DATE_LENGTH + 7)
+#define LOG_PREFIX_SIZE 48
+
+/**
+ * \brief Longest start of an MC_LOG_KV line, {"time":"...","level":"...", and the longest number written.
+ */
+#define LOG_KV_HEAD_SIZE 64
+#define LOG_KV_NUMBER_SIZE 32
+
+/**
+ * \brief Members an MC_LOG_KV line ends with when fields had to be left out.
+ */
+#define LOG_KV_TRUNCATED ",\"truncated\":true"
+
+/**
+ * \brief Doubles written with fixed decimals rather than snprintf, and how many decimals at most.
+ */
+#define LOG_KV_FIXED_MIN 1e-3
+#define LOG_KV_FIXED_MAX 1e15
+#define LOG_KV_DECIMALS 9
+#define LOG_KV_DECIMALS_SCALE 1000000000ULL
+
+/**
+ * \brief Bytes mapped per file of the mapped sink when MC_LogRotation gives 0, and the least it accepts,
+ * so one batch of the asynchronous writer always fits an empty file.
+ */
+#define LOG_MAP_DEFAULT_SIZE (64ULL * 1024 * 1024)
+#define LOG_MAP_MIN_SIZE (2ULL * 64 * 1024)
+
+/**
+ * \brief Longest path of a mapped file, the base path and its ".<n>" suffix.
+ */
+#define LOG_MAP_PATH_SIZE 512
+
+/**
+ * \brief Yields a crash handler spends waiting on another thread's rotation or copy before giving up on it,
+ * the thread might be the one the signal interrupted.
+ */
+#define LOG_MAP_CRASH_TRIES 1000
+
+/**
+ * \brief Size of a thread's line buffer in the synchronous mode, longer lines are formatted into the heap.
+ */
+#define LOG_LINE_SIZE 1024
+
+/**
+ * \brief Size of one record in a thread's ring, a formatted line longer than the text it holds is truncated.
+ */
+#define LOG_RECORD_SIZE 256
+
+/**
+ * \brief Records per thread ring when MC_Log_InitAsync is given 0.
+ */
+#define LOG_DEFAULT_RING_CAPACITY 1024
+
+/**
+ * \brief Size of the writer's batch buffer, what it hands to the file in one write.
+ */
+#define LOG_WRITE_BATCH (64 * 1024)
+
+/**
+ * \brief How long the writer sleeps after a pass that found nothing to write, doubling from the first
+ * to the second while the log stays quiet, so a burst does not sit in full rings for a whole sleep.
+ */
+#define LOG_WRITER_IDLE_MIN_NS 10000
+#define LOG_WRITER_IDLE_NS 1000000
+
+/**
+ * \brief How often the writer reports the lines MC_LOG_LIMIT and MC_LOG_SAMPLE sites skipped.
+ */
+#define LOG_SUPPRESSED_REPORT_NS LOG_NS_PER_SECOND
+
+/**
+ * \brief LogRecord is one formatted line, as a thread's ring holds it.
+ */
+typedef struct LogRecord
+{
+    u32 length;                                 // \brief Number of characters in text, the newline included
+    char text[LOG_RECORD_SIZE - sizeof(u32)];   // \brief The line, not null terminated
+} LogRecord;
+
+/**
+ * \brief LogProducer is the ring one thread formats its lines into, read by the writer thread.
+ */
+typedef struct LogProducer
+{
+    MC_SpscRing *ring;                  // \brief LogRecords waiting for the writer
+    atomic_uchar retired;               // \brief The owning thread exited, the next new thread may take the ring over
+    struct LogProducer *next;           // \brief Next is a single linked list of every producer
+} LogProducer;
+
+/**
+ * \brief LogMap is one preallocated file of the mapped sink. Lines are appended by reserving space with one
+ * atomic add and copying into the mapping, there is no system call per line.
+ * \details A reservation that does not fit seals the file at its start, every reservation before it fits,
+ * and the rotating thread waits for them all to be copied before the file is cut to its length and unmapped.
+ */
+typedef struct LogMap
+{
+    char *base;                         // \brief The mapping, size bytes
+    u64 size;
+    atomic_uint_fast64_t used;          // \brief Bytes reserved, past size once the file is sealed
+    atomic_uint_fast64_t committed;     // \brief Bytes copied into the mapping
+    atomic_uint_fast64_t sealed;        // \brief Start of the first reservation that did not fit, the file's final length
+    time_t deadline;                    // \brief When the file is rotated by age, 0 never
+    u64 index;                          // \brief The <n> of its path
+#if defined(_WIN32)
+    HANDLE file;
+    HANDLE mapping;
+#else
+    int fd;
+#endif
+    struct LogMap *next;                // \brief Every file of the run, kept until Close for threads still holding an older one
+} LogMap;
+
+/**
+ * \brief Where MC_Log_Message sends a line.
+ */
+typedef enum LogMode
+{
+    LOG_MODE_SYNC,                      // \brief Straight to the file
+    LOG_MODE_ASYNC,                     // \brief Formatted into the thread's ring
+    LOG_MODE_BINARY                     // \brief Into the thread's ring as a binary entry, formatted by MC_Log_Decode
+} LogMode;
+
+/**
+ * \brief How far the writer thread got, which internal_log_start waits on before reporting success.
+ */
+typedef enum LogWriterState
+{
+    LOG_WRITER_STARTING,                // \brief Created, not yet ready to drain
+    LOG_WRITER_RUNNING,                 // \brief Draining the rings
+    LOG_WRITER_FAILED                   // \brief Could not get its batch buffer and exited
+} LogWriterState;
+
+/**
+ * \brief LogFileHeader opens a binary log, it anchors the tick counter to the wall clock.
+ * \details Every field is in the writing machine's byte order, a log is decoded where it was written.
+ */
+typedef struct LogFileHeader
+{
+    char magic[8];                      // \brief LOG_BINARY_MAGIC, not null terminated
+    u32 version;                        // \brief LOG_BINARY_VERSION
+    u32 reserved;
+    u64 ticks;                          // \brief Tick count at unixNs
+    u64 unixNs;                         // \brief Wall clock in ns since the epoch
+    u64 ticksPerSecond;                 // \brief Measured when the log was opened
+} LogFileHeader;
+
+/**
+ * \brief LogEntry starts every entry of a binary log, size bytes in all, the payload follows it.
+ * \details A message payload is its level in one byte then the raw arguments of format id, or the
+ * characters of a LOG_BINARY_ID_TEXT message.
+ */
+typedef struct LogEntry
+{
+    u32 size;                           // \brief Bytes in the entry, this header included
+    u32 id;                             // \brief Format id, from 1, or one of the LOG_BINARY_ID_ values
+    u64 stamp;                          // \brief Tick count when the call was made
+} LogEntry;
+
+/**
+ * \brief How one argument is read from the va_list and stored: int as 4 bytes, every other integer,
+ * pointer and floating point as 8, a string as a u16 length and its characters.
+ */
+typedef enum LogArg
+{
+    LOG_ARG_INT,                        // \brief int, and anything promoted to it: char, short, %c
+    LOG_ARG_LONG,
+    LOG_ARG_ULONG,
+    LOG_ARG_LLONG,                      // \brief long long and unsigned long long
+    LOG_ARG_INTMAX,
+    LOG_ARG_UINTMAX,
+    LOG_ARG_SIZE,
+    LOG_ARG_PTRDIFF,
+    LOG_ARG_DOUBLE,                     // \brief double, and float after promotion
+    LOG_ARG_LDOUBLE,                    // \brief long double, stored as a double
+    LOG_ARG_STRING,
+    LOG_ARG_POINTER
+} LogArg;
+
+/**
+ * \brief LogFormat is a registered format string, parsed once into the arguments it takes.
+ */
+typedef struct LogFormat
+{
+    const char *format;                 // \brief The caller's format string, which must outlive the log
+    u8 argCount;
+    u8 args[LOG_BINARY_MAX_ARGS];       // \brief LogArg of every argument in order
+} LogFormat;
+
+/**
+ * \brief LogSpec is one conversion specification of a format string.
+ */
+typedef struct LogSpec
+{
+    char text[LOG_SPEC_SIZE];           // \brief The specification as the decoder prints it, integer lengths widened to ll
+    u8 stars;                           // \brief Star widths and precisions, each an int argument ahead of the value
+    u8 type;                            // \brief LogArg of the value
+    u8 valid;                           // \brief false for %n, wide characters and anything not recognized
+} LogSpec;
+
+/**
+ * \brief LogValue is one argument read back from a binary entry.
+ */
+typedef union LogValue
+{
+    int i;
+    long long ll;
+    double d;
+    const char *s;
+    void *p;
+} LogValue;
+
+/**
+ * \brief LogClock maps ticks to wall clock time while decoding.
+ */
+typedef struct LogClock
+{
+    u64 ticks;
+    u64 unixNs;
+    u64 ticksPerSecond;
+} LogClock;
+
+/**
+ * \brief File pointer
+ */
+static FILE *log_output_stream = NULL;
+
+/**
+ * \brief Runtime threshold read inline by the MC_LOG_<level> macros, everything is logged until MC_Log_SetLevel
+ */
+atomic_int mc_log_threshold = MC_LOG_LEVEL_DEBUG;
+
+/**
+ * \brief State of the asynchronous and binary modes, all of it is set up by MC_Log_InitAsync or
+ * MC_Log_InitBinary and torn down by MC_Log_Close.
+ */
+static atomic_uchar log_mode;                   // \brief LogMode, anything but LOG_MODE_SYNC goes through the rings
+static atomic_uchar log_writer_stop;            // \brief Tells the writer to drain and exit
+static _Atomic(LogProducer*) log_producers;     // \brief Head of the producer list, only ever pushed to until Close
+static atomic_uint_fast64_t log_dropped;        // \brief Lines lost to a full ring
+static atomic_uint_fast64_t log_passes;         // \brief Writer passes completed, MC_Log_Flush waits on it
+static atomic_uchar log_writer_state;           // \brief LogWriterState, set by the writer as it starts
+static atomic_uint_fast64_t log_epoch;          // \brief Bumped by every Close, invalidates the producers threads still point at
+static MC_LogOverflow log_overflow;
+static u64 log_ring_capacity;
+static thrd_t log_writer;
+
+static mtx_t log_registry_lock;                 // \brief Guards producer and format registration, never the hot path
+static tss_t log_thread_key;                    // \brief Only there for its destructor, which retires an exiting thread's producer
+static u8 log_registry_ready;
+static once_flag log_registry_once = ONCE_FLAG_INIT;
+
+static _Thread_local LogProducer *log_thread_producer;
+static _Thread_local u64 log_thread_epoch;
+
+/**
+ * \brief The calling thread's last formatted date and time, it changes once a second and lines only
+ * append the microseconds to it.
+ */
+static _Thread_local time_t log_thread_second = -1;
+static _Thread_local char log_thread_date[LOG_DATE_LENGTH + 1];
+
+/**
+ * \brief The calling thread's synchronous line, formatted whole before it is published.
+ */
+static _Thread_local char log_thread_line[LOG_LINE_SIZE];
+
+/**
+ * \brief State of the mapped sink, set up by MC_Log_InitMapped and torn down by MC_Log_Close.
+ */
+static _Atomic(LogMap*) log_map;                // \brief The file being appended to, NULL when lines go to log_output_stream
+static _Atomic(LogMap*) log_map_spare;          // \brief The next file, opened ahead so the crash handler can move to it
+static LogMap *log_maps;                        // \brief Every file the sink moved to, newest first
+static mtx_t log_rotate_lock;                   // \brief Held by the thread opening the next file
+static char log_map_path[LOG_MAP_PATH_SIZE];
+static u64 log_map_size;
+static u64 log_map_seconds;
+static u64 log_map_index;
+
+/**
+ * \brief Fatal signals whose handler writes out what is still waiting before the process dies.
+ */
+static const int log_crash_signals[] = { SIGSEGV, SIGILL, SIGFPE, SIGABRT,
+#if !defined(_WIN32)
+                                         SIGBUS,
+#endif
+};
+#define LOG_CRASH_SIGNALS (sizeof(log_crash_signals) / sizeof(log_crash_signals[0]))
+static atomic_flag log_crashing = ATOMIC_FLAG_INIT;
+static u8 log_crash_installed;                          // \brief Set from MC_Log_InitMapped until Close, even once log_map is NULL
+static atomic_flag log_draining = ATOMIC_FLAG_INIT;     // \brief Held by whoever consumes a ring, the writer or the crash handler
+#if defined(_WIN32)
+static void (*log_crash_previous[LOG_CRASH_SIGNALS])(int);
+#else
+static struct sigaction log_crash_previous[LOG_CRASH_SIGNALS];
+#endif
+
+/**
+ * \brief Formats registered by MC_LOG_BINARY sites, format id n is log_formats[n - 1]. They outlive Close,
+ * the sites keep their ids for the life of the process.
+ */
+static LogFormat log_formats[LOG_BINARY_MAX_FORMATS];
+static atomic_uint log_format_count;            // \brief Published after the format it counts is filled in
+
+/**
+ * \brief Every MC_LOG_LIMIT and MC_LOG_SAMPLE site that ever skipped a line, only ever pushed to. The sites
+ * are statics, they outlive Close like the formats.
+ */
+static _Atomic(MC_LogSite*) log_sites;
+
+/**
+ * \brief Name of a log level as it appears in a line.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static const char* internal_log_level_string(LogLevel lvl)
+{
+    switch (lvl)
+    {
+        case MC_LOG_LEVEL_DEBUG:   return "DEBUG";
+        case MC_LOG_LEVEL_INFO:    return "INFO";
+        case MC_LOG_LEVEL_WARNING: return "WARNING";
+        case MC_LOG_LEVEL_ERROR:   return "ERROR";
+        default:                   return "UNKNOWN";
+    }
+}
+
+/**
+ * \brief Write value as exactly count decimal digits, zero padded.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static void internal_log_digits(char *out, u64 value, u64 count)
+{
+    while (count)
+    {
+        out[--count] = (char)('0' + value % 10);
+        value /= 10;
+    }
+}
+
+/**
+ * \brief Write YYYY-MM-DD HH:MM:SS.uuuuuu in local time, for a wall clock in ns, LOG_STAMP_LENGTH characters.
+ * MC_LocalTime and strftime only run when the second changes for the calling thread.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static void internal_log_stamp(char *out, u64 unixNs)
+{
+    time_t second = (time_t)(unixNs / LOG_NS_PER_SECOND);
+
+    if (second != log_thread_second)
+    {
+        struct tm t = { 0 };
+        MC_LocalTime(&second, &t);
+        strftime(log_thread_date, sizeof(log_thread_date), "%Y-%m-%d %H:%M:%S", &t);
+        log_thread_second = second;
+    }
+
+    memcpy(out, log_thread_date, LOG_DATE_LENGTH);
+    out[LOG_DATE_LENGTH] = '.';
+    internal_log_digits(out + LOG_DATE_LENGTH + 1, unixNs % LOG_NS_PER_SECOND / LOG_NS_PER_US, 6);
+}
+
+/**
+ * \brief Write a line's prefix, [YYYY-MM-DD HH:MM:SS.uuuuuu] [LEVEL] , for a wall clock in ns.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * \returns u64: The number of characters written, at most LOG_PREFIX_SIZE and not null terminated.
+ */
+static u64 internal_log_prefix(char *out, LogLevel lvl, u64 unixNs)
+{
+    const char *name = internal_log_level_string(lvl);
+    u64 nameLength = strlen(name);
+    u64 length = 0;
+
+    out[length++] = '[';
+    internal_log_stamp(out + length, unixNs);
+    length += LOG_STAMP_LENGTH;
+    memcpy(out + length, "] [", 3);
+    length += 3;
+    memcpy(out + length, name, nameLength);
+    length += nameLength;
+    out[length++] = ']';
+    out[length++] = ' ';
+
+    return length;
+}
+
+/**
+ * \brief Wall clock time in ns since the epoch.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static u64 internal_log_unix_ns(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+
+    return (u64)ts.tv_sec * LOG_NS_PER_SECOND + (u64)ts.tv_nsec;
+}
+
+/**
+ * \brief A monotonic clock in ns that is cheap to read rather than precise, a few ms of resolution at worst.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static inline u64 internal_log_coarse_ns(void)
+{
+#if defined(_WIN32)
+    return (u64)GetTickCount64() * LOG_NS_PER_MS;
+#else
+    struct timespec ts;
+#if defined(CLOCK_MONOTONIC_COARSE)
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+
+    return (u64)ts.tv_sec * LOG_NS_PER_SECOND + (u64)ts.tv_nsec;
+#endif
+}
+
+/**
+ * \brief The binary log's timestamp: the time stamp counter on x86, the wall clock in ns elsewhere.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static inline u64 internal_log_ticks(void)
+{
+#if defined(LOG_X86)
+    return __rdtsc();
+#else
+    return internal_log_unix_ns();
+#endif
+}
+
+/**
+ * \brief Every two digit number, "00" to "99", so integers are written two digits per division.
+ */
+static const char log_digit_pairs[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+/**
+ * \brief Write value in decimal, without leading zeros.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * \returns u64: The number of characters written, at most 20.
+ */
+static u64 internal_log_u64(char *out, u64 value)
+{
+    char digits[20];
+    u64 start = sizeof(digits);
+
+    while (value >= 100)
+    {
+        u64 pair = value % 100 * 2;
+        value /= 100;
+        digits[--start] = log_digit_pairs[pair + 1];
+        digits[--start] = log_digit_pairs[pair];
+    }
+
+    if (value >= 10)
+    {
+        digits[--start] = log_digit_pairs[value * 2 + 1];
+        digits[--start] = log_digit_pairs[value * 2];
+    }
+    else
+    {
+        digits[--start] = (char)('0' + value);
+    }
+
+    memcpy(out, digits + start, sizeof(digits) - start);
+
+    return sizeof(digits) - start;
+}
+
+/**
+ * \brief Write value in decimal, with a minus sign when negative.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * \returns u64: The number of characters written, at most 20.
+ */
+static u64 internal_log_i64(char *out, i64 value)
+{
+    if (value >= 0)
+    {
+        return internal_log_u64(out, (u64)value);
+    }
+
+    out[0] = '-';
+
+    return 1 + internal_log_u64(out + 1, 0 - (u64)value);   // INT64_MIN has no positive i64
+}
+
+/**
+ * \brief Write value as a JSON number: up to LOG_KV_DECIMALS decimals, trailing zeros dropped, between
+ * LOG_KV_FIXED_MIN and LOG_KV_FIXED_MAX, %.17g outside of it, null for NaN and the infinities.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * \returns u64: The number of characters written, less than LOG_KV_NUMBER_SIZE.
+ */
+static u64 internal_log_f64(char *out, double value)
+{
+    if (value != value || value - value != 0)
+    {
+        memcpy(out, "null", 4);
+
+        return 4;
+    }
+
+    double magnitude = value < 0 ? -value : value;
+
+    if (magnitude != 0 && (magnitude < LOG_KV_FIXED_MIN || magnitude >= LOG_KV_FIXED_MAX))
+    {
+        int length = snprintf(out, LOG_KV_NUMBER_SIZE, "%.17g", value);
+
+        return length < 0 ? 0 : (u64)length;
+    }
+
+    u64 length = 0;
+    u64 whole = (u64)magnitude;
+    u64 fraction = (u64)((magnitude - (double)whole) * (double)LOG_KV_DECIMALS_SCALE + 0.5);
+
+    if (fraction >= LOG_KV_DECIMALS_SCALE)
+    {
+        whole++;
+        fraction -= LOG_KV_DECIMALS_SCALE;
+    }
+
+    if (value < 0 && (whole || fraction))
+    {
+        out[length++] = '-';
+    }
+
+    length += internal_log_u64(out + length, whole);
+
+    if (fraction)
+    {
+        u64 decimals = LOG_KV_DECIMALS;
+
+        while (fraction % 10 == 0)
+        {
+            fraction /= 10;
+            decimals--;
+        }
+
+        out[length++] = '.';
+        internal_log_digits(out + length, fraction, decimals);
+        length += decimals;
+    }
+
+    return length;
+}
+
+#if defined(LOG_SSE2)
+/**
+ * \brief Index of the lowest set bit of a non zero mask.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static inline u32 internal_log_lowest_bit(u32 mask)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+
+    return (u32)index;
+#else
+    return (u32)__builtin_ctz(mask);
+#endif
+}
+#endif
+
+/**
+ * \brief Write the JSON escape of one quote, backslash or control character.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * \returns u64: The number of characters written, 0 when they do not fit in capacity.
+ */
+static u64 internal_log_json_char(char *out, u64 capacity, u8 c)
+{
+    static const char hex[] = "0123456789abcdef";
+    char escaped[6] = { '\\', (char)c, '0', '0', '0', '0' };
+    u64 length = 2;
+
+    switch (c)
+    {
+        case '"':  break;
+        case '\\': break;
+        case '\n': escaped[1] = 'n'; break;
+        case '\r': escaped[1] = 'r'; break;
+        case '\t': escaped[1] = 't'; break;
+        case '\b': escaped[1] = 'b'; break;
+        case '\f': escaped[1] = 'f'; break;
+        default:
+            escaped[1] = 'u';
+            escaped[4] = hex[c >> 4];
+            escaped[5] = hex[c & 0xF];
+            length = 6;
+            break;
+    }
+
+    if (length > capacity)
+    {
+        return 0;
+    }
+
+    memcpy(out, escaped, length);
+
+    return length;
+}
+
+/**
+ * \brief Write text escaped for a JSON string, as much of it as fits in capacity. Sixteen characters are
+ * checked for quotes, backslashes and control characters at once with SSE2, and copied whole when clean.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * \param consumed: Set to the number of characters of text written, length when all of it fit
+ * \returns u64: The number of characters written.
+ */
+static u64 internal_log_json_escape(char *out, u64 capacity, const char *text, u64 length, u64 *consumed)
+{
+    u64 in = 0;
+    u64 written = 0;
+
+#if defined(LOG_SSE2)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control = _mm_set1_epi8(0x1F);
+
+    while (in + 16 <= length && written + 16 <= capacity)
+    {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)(text + in));
+        __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+                                       _mm_cmpeq_epi8(_mm_min_epu8(chunk, control), chunk));     // at most 0x1F
+        u32 mask = (u32)_mm_movemask_epi8(special);
+
+        _mm_storeu_si128((__m128i*)(out + written), chunk);     // from the first special character on it is overwritten
+
+        if (!mask)
+        {
+            in += 16;
+            written += 16;
+            continue;
+        }
+
+        u32 clean = internal_log_lowest_bit(mask);
+        u64 escaped = internal_log_json_char(out + written + clean, capacity - written - clean, (u8)text[in + clean]);
+
+        if (!escaped)
+        {
+            in += clean;
+            written += clean;
+            break;
+        }
+
+        in += clean + 1;
+        written += clean + escaped;
+    }
+#endif
+
+    for (; in < length; in++)
+    {
+        u8 c = (u8)text[in];
+
+        if (c == '"' || c == '\\' || c < 0x20)
+        {
+            u64 escaped = internal_log_json_char(out + written, capacity - written, c);
+
+            if (!escaped)
+            {
+                break;
+            }
+
+            written += escaped;
+        }
+        else if (written < capacity)
+        {
+            out[written++] = (char)c;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    *consumed = in;
+
+    return written;
+}
+
+/**
+ * \brief Append size bytes at *length when they fit below limit.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * \returns u8: true/false corresponding to success fail
+ */
+static u8 internal_log_kv_put(char *out, u64 limit, u64 *length, const char *data, u64 size)
+{
+    if (*length + size > limit)
+    {
+        return false;
+    }
+
+    memcpy(out + *length, data, size);
+    *length += size;
+
+    return true;
+}
+
+/**
+ * \brief Append a quoted, escaped JSON string when all of it fits below limit.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * \returns u8: true/false corresponding to success fail
+ */
+static u8 internal_log_kv_string(char *out, u64 limit, u64 *length, const char *text)
+{
+    u64 size = strlen(text);
+    u64 consumed = 0;
+
+    if (!internal_log_kv_put(out, limit, length, "\"", 1) || *length + 1 > limit)
+    {
+        return false;
+    }
+
+    *length += internal_log_json_escape(out + *length, limit - *length - 1, text, size, &consumed);   // 1 kept for the quote
+    out[(*length)++] = '"';
+
+    return consumed == size;
+}
+
+/**
+ * \brief Append ,"key":value for one field when all of it fits below limit.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * \returns u8: true/false corresponding to success fail, *length is then past the limit or the field cut short
+ */
+static u8 internal_log_kv_field(char *out, u64 limit, u64 *length, const MC_KV *field)
+{
+    char number[LOG_KV_NUMBER_SIZE];
+
+    if (!internal_log_kv_put(out, limit, length, ",", 1) ||
+        !internal_log_kv_string(out, limit, length, field->key ? field->key : "") ||
+        !internal_log_kv_put(out, limit, length, ":", 1))
+    {
+        return false;
+    }
+
+    switch (field->type)
+    {
+        case MC_KV_TYPE_U64:  return internal_log_kv_put(out, limit, length, number, internal_log_u64(number, field->value.u));
+        case MC_KV_TYPE_I64:  return internal_log_kv_put(out, limit, length, number, internal_log_i64(number, field->value.i));
+        case MC_KV_TYPE_F64:  return internal_log_kv_put(out, limit, length, number, internal_log_f64(number, field->value.f));
+        case MC_KV_TYPE_BOOL: return field->value.u ? internal_log_kv_put(out, limit, length, "true", 4) :
+                                                      internal_log_kv_put(out, limit, length, "false", 5);
+        case MC_KV_TYPE_STR:  return field->value.s ? internal_log_kv_string(out, limit, length, field->value.s) :
+                                                      internal_log_kv_put(out, limit, length, "null", 4);
+        default:              return internal_log_kv_put(out, limit, length, "null", 4);
+    }
+}
+
+/**
+ * \brief Write the start of an MC_LOG_KV line, {"time":"YYYY-MM-DD HH:MM:SS.uuuuuu","level":"LEVEL",
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * \returns u64: The number of characters written, at most LOG_KV_HEAD_SIZE.
+ */
+static u64 internal_log_kv_head(char *out, LogLevel lvl, u64 unixNs)
+{
+    const char *name = internal_log_level_string(lvl);
+    u64 nameLength = strlen(name);
+    u64 length = 0;
+
+    memcpy(out, "{\"time\":\"", 9);
+    length += 9;
+    internal_log_stamp(out + length, unixNs);
+    length += LOG_STAMP_LENGTH;
+    memcpy(out + length, "\",\"level\":\"", 11);
+    length += 11;
+    memcpy(out + length, name, nameLength);
+    length += nameLength;
+    memcpy(out + length, "\",", 2);
+
+    return length + 2;
+}
+
+/**
+ * \brief Write the rest of an MC_LOG_KV line, "event":"...",fields...} without its newline. Fields that do
+ * not fit in size are left out, and LOG_KV_TRUNCATED added, the event is cut short only when it alone
+ * does not fit. size must leave room for more than LOG_KV_TRUNCATED.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * \returns u64: The number of characters written, at most size.
+ */
+static u64 internal_log_kv_body(char *out, u64 size, const char *event, const MC_KV *fields, u64 count)
+{
+    u64 limit = size - (sizeof(LOG_KV_TRUNCATED) - 1) - 1;     // the truncated member and the closing brace always fit
+    u64 eventLength = strlen(event);
+    u64 consumed = 0;
+    u64 length = 9;
+
+    memcpy(out, "\"event\":\"", 9);
+    length += internal_log_json_escape(out + length, limit - length - 1, event, eventLength, &consumed);
+    out[length++] = '"';
+
+    u8 truncated = consumed < eventLength;
+
+    for (u64 i = 0; i < count && !truncated; i++)
+    {
+        u64 mark = length;
+
+        if (!internal_log_kv_field(out, limit, &length, &fields[i]))
+        {
+            length = mark;
+            truncated = true;
+        }
+    }
+
+    if (truncated)
+    {
+        memcpy(out + length, LOG_KV_TRUNCATED, sizeof(LOG_KV_TRUNCATED) - 1);
+        length += sizeof(LOG_KV_TRUNCATED) - 1;
+    }
+
+    out[length++] = '}';
+
+    return length;
+}
+
+/**
+ * \brief Characters an MC_LOG_KV line can take at most, every character escaped to six, newline included.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static u64 internal_log_kv_bound(const char *event, const MC_KV *fields, u64 count)
+{
+    u64 bound = LOG_KV_HEAD_SIZE + 12 + 6 * strlen(event) + sizeof(LOG_KV_TRUNCATED) + 2;
+
+    for (u64 i = 0; i < count; i++)
+    {
+        bound += 4 + 6 * (fields[i].key ? strlen(fields[i].key) : 0) + LOG_KV_NUMBER_SIZE;
+        bound += fields[i].type == MC_KV_TYPE_STR && fields[i].value.s ? 2 + 6 * strlen(fields[i].value.s) : 0;
+    }
+
+    return bound;
+}
+
+/**
+ * \brief Format a whole line, prefix, message and newline, into out.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * \returns u64: The number of characters written, at most size, cut short lines keep their newline.
+ */
+static u64 internal_log_format_line(char *out, u64 size, LogLevel lvl, const char *format, va_list args)
+{
+    char prefix[LOG_PREFIX_SIZE];
+    u64 limit = size - 1;   // the last character is kept for the newline
+    u64 length = internal_log_prefix(prefix, lvl, internal_log_unix_ns());
+
+    length = length < limit ? length : limit;
+    memcpy(out, prefix, length);
+
+    int message = vsnprintf(out + length, size - length, format, args);
+
+    length += message < 0 ? 0 : (u64)message < limit - length ? (u64)message : limit - length;
+    out[length] = '\n';
+
+    return length + 1;
+}
+
+/**
+ * \brief Format a message into a LOG_BINARY_ID_TEXT entry, the decoder adds the prefix and newline.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * \returns u64: The size of the entry, at most size.
+ */
+static u64 internal_log_format_entry(char *out, u64 size, LogLevel lvl, const char *format, va_list args)
+{
+    u64 start = sizeof(LogEntry) + 1;
+    int message = vsnprintf(out + start, size - start, format, args);
+    u64 length = start + (message < 0 ? 0 : (u64)message < size - start ? (u64)message : size - start - 1);
+    LogEntry entry = { (u32)length, LOG_BINARY_ID_TEXT, internal_log_ticks() };
+
+    memcpy(out, &entry, sizeof(entry));
+    out[sizeof(LogEntry)] = (char)lvl;
+
+    return length;
+}
+
+/**
+ * \brief Format a line as the current mode writes it, a text line or a LOG_BINARY_ID_TEXT entry.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * \returns u64: The number of bytes written, at most size.
+ */
+static u64 internal_log_format_record(char *out, u64 size, LogLevel lvl, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+
+    u64 length = atomic_load_explicit(&log_mode, memory_order_relaxed) == LOG_MODE_BINARY ?
+                 internal_log_format_entry(out, size, lvl, format, args) :
+                 internal_log_format_line(out, size, lvl, format, args);
+
+    va_end(args);
+
+    return length;
+}
+
+static void internal_log_thread_exit(void *value)
+{
+    mtx_lock(&log_registry_lock);
+
+    if (value == log_thread_producer && log_thread_epoch == atomic_load(&log_epoch))
+    {
+        atomic_store_explicit(&log_thread_producer->retired, true, memory_order_release);
+    }
+
+    mtx_unlock(&log_registry_lock);
+}
+
+static void internal_log_registry_init(void)
+{
+    log_registry_ready = mtx_init(&log_registry_lock, mtx_plain) == thrd_success &&
+                         mtx_init(&log_rotate_lock, mtx_plain) == thrd_success &&
+                         tss_create(&log_thread_key, internal_log_thread_exit) == thrd_success;
+}
+
+/**
+ * \brief Get the calling thread's producer, taking over a retired one or creating one on first use.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static LogProducer* internal_log_producer(void)
+{
+    if (log_thread_producer && log_thread_epoch == atomic_load_explicit(&log_epoch, memory_order_relaxed))
+    {
+        return log_thread_producer;
+    }
+
+    mtx_lock(&log_registry_lock);
+
+    LogProducer *producer = atomic_load(&log_producers);
+
+    while (producer)
+    {
+        unsigned char retired = true;
+
+        if (atomic_compare_exchange_strong(&producer->retired, &retired, false))
+        {
+            break;
+        }
+
+        producer = producer->next;
+    }
+
+    if (!producer)
+    {
+        producer = (LogProducer*)calloc(1, sizeof(LogProducer));
+        MC_SpscRing *ring = producer ? MC_SpscRing_Init(log_ring_capacity, sizeof(LogRecord)) : NULL;
+
+        if (!ring)
+        {
+            free(producer);
+            mtx_unlock(&log_registry_lock);
+
+            return NULL;
+        }
+
+        producer->ring = ring;
+        producer->next = atomic_load(&log_producers);
+        atomic_store(&log_producers, producer);
+    }
+
+    log_thread_producer = producer;
+    log_thread_epoch = atomic_load(&log_epoch);
+    tss_set(log_thread_key, producer);
+
+    mtx_unlock(&log_registry_lock);
+
+    return producer;
+}
+
+/**
+ * \brief Reserve one record in the calling thread's ring, applying the overflow policy when it is full.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * \returns LogRecord*: The record to fill and commit to *producer, NULL when the line is dropped.
+ */
+static LogRecord* internal_log_reserve(LogProducer **producer)
+{
+    *producer = internal_log_producer();
+
+    if (!*producer)
+    {
+        atomic_fetch_add_explicit(&log_dropped, 1, memory_order_relaxed);
+
+        return NULL;
+    }
+
+    u64 granted = 0;
+    LogRecord *record = (LogRecord*)MC_SpscRing_Reserve((*producer)->ring, 1, &granted);
+
+    while (!record && log_overflow == MC_LOG_OVERFLOW_BLOCK && !atomic_load_explicit(&log_writer_stop, memory_order_relaxed))
+    {
+        thrd_yield();
+        record = (LogRecord*)MC_SpscRing_Reserve((*producer)->ring, 1, &granted);
+    }
+
+    if (!record)
+    {
+        atomic_fetch_add_explicit(&log_dropped, 1, memory_order_relaxed);
+    }
+
+    return record;
+}
+
+/**
+ * \brief Parse the conversion specification p points at, just past its '%'.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * \returns const char*: The first character after the specification.
+ */
+static const char* internal_log_parse_spec(const char *p, LogSpec *spec)
+{
+    u64 n = 0;
+    u8 length = LOG_ARG_INT;
+    u8 longDouble = false;
+
+    *spec = (LogSpec){ .valid = true };
+    spec->text[n++] = '%';
+
+    // flags, width and precision are kept as they are, a star stands for an int argument
+    while (*p && (strchr("-+ #0", *p) || (*p >= '0' && *p <= '9') || *p == '.' || *p == '*') && n < LOG_SPEC_SIZE - 4)
+    {
+        spec->stars += *p == '*';
+        spec->text[n++] = *p++;
+    }
+
+    switch (*p)
+    {
+        case 'h':
+            spec->text[n++] = *p++;
+            if (*p == 'h')
+            {
+                spec->text[n++] = *p++;
+            }
+            break;
+        case 'l':
+            p++;
+            length = *p == 'l' ? (p++, LOG_ARG_LLONG) : LOG_ARG_LONG;
+            break;
+        case 'j': p++; length = LOG_ARG_INTMAX;  break;
+        case 'z': p++; length = LOG_ARG_SIZE;    break;
+        case 't': p++; length = LOG_ARG_PTRDIFF; break;
+        case 'L': p++; longDouble = true;        break;
+        default: break;
+    }
+
+    char conversion = *p;
+    p += conversion != '\0';
+
+    switch (conversion)
+    {
+        case 'd': case 'i':
+            spec->type = length;
+            break;
+        case 'u': case 'o': case 'x': case 'X':
+            spec->type = length == LOG_ARG_LONG ? LOG_ARG_ULONG : length == LOG_ARG_INTMAX ? LOG_ARG_UINTMAX : length;
+            break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            spec->type = longDouble ? LOG_ARG_LDOUBLE : LOG_ARG_DOUBLE;
+            length = LOG_ARG_INT;   // a double needs no length, %lf is %f
+            break;
+        case 'c':
+            spec->type = LOG_ARG_INT;
+            spec->valid = length == LOG_ARG_INT;
+            break;
+        case 's':
+            spec->type = LOG_ARG_STRING;
+            spec->valid = length == LOG_ARG_INT;
+            break;
+        case 'p':
+            spec->type = LOG_ARG_POINTER;
+            break;
+        default:
+            spec->valid = false;    // %n writes through its argument, nothing else is standard
+            break;
+    }
+
+    if (length != LOG_ARG_INT)      // every wider integer is stored as 8 bytes and printed as long long
+    {
+        spec->text[n++] = 'l';
+        spec->text[n++] = 'l';
+    }
+
+    spec->text[n++] = conversion;
+    spec->text[n] = '\0';
+
+    return p;
+}
+
+/**
+ * \brief Parse a format string into the arguments it takes.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * \returns u8: false when a binary entry cannot carry them, the format is then logged as text
+ */
+static u8 internal_log_parse_format(const char *format, LogFormat *parsed)
+{
+    parsed->format = format;
+    parsed->argCount = 0;
+
+    for (const char *p = format; *p; )
+    {
+        if (*p++ != '%')
+        {
+            continue;
+        }
+
+        if (*p == '%')
+        {
+            p++;
+            continue;
+        }
+
+        LogSpec spec;
+        p = internal_log_parse_spec(p, &spec);
+
+        if (!spec.valid || parsed->argCount + spec.stars + 1 > LOG_BINARY_MAX_ARGS)
+        {
+            return false;
+        }
+
+        for (u8 s = 0; s < spec.stars; s++)
+        {
+            parsed->args[parsed->argCount++] = LOG_ARG_INT;
+        }
+
+        parsed->args[parsed->argCount++] = spec.type;
+    }
+
+    return true;
+}
+
+/**
+ * \brief Give a MC_LOG_BINARY site its format id, the first call through it parses the format.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * \returns u32: The format id, LOG_BINARY_ID_TEXT when the format is logged as text.
+ */
+static u32 internal_log_register(atomic_uint *site, const char *format)
+{
+    call_once(&log_registry_once, internal_log_registry_init);
+
+    if (!log_registry_ready)
+    {
+        return LOG_BINARY_ID_TEXT;
+    }
+
+    mtx_lock(&log_registry_lock);
+
+    u32 id = atomic_load_explicit(site, memory_order_relaxed);     // another thread may have got there first
+    u32 count = atomic_load_explicit(&log_format_count, memory_order_relaxed);
+
+    if (!id)
+    {
+        id = count < LOG_BINARY_MAX_FORMATS && internal_log_parse_format(format, &log_formats[count]) ? count + 1 : LOG_BINARY_ID_TEXT;
+
+        if (id != LOG_BINARY_ID_TEXT)
+        {
+            atomic_store_explicit(&log_format_count, id, memory_order_release);
+        }
+
+        atomic_store_explicit(site, id, memory_order_release);
+    }
+
+    mtx_unlock(&log_registry_lock);
+
+    return id;
+}
+
+/**
+ * \brief Copy a call's raw arguments into a binary entry in the calling thread's ring.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static void internal_log_binary(u32 id, u64 stamp, LogLevel lvl, va_list args)
+{
+    LogProducer *producer = NULL;
+    LogRecord *record = internal_log_reserve(&producer);
+
+    if (!record)
+    {
+        return;
+    }
+
+    const LogFormat *parsed = &log_formats[id - 1];
+    char *out = record->text + sizeof(LogEntry);
+    const char *end = record->text + sizeof(record->text);
+
+    *out++ = (char)lvl;
+
+    for (u8 i = 0; i < parsed->argCount; i++)
+    {
+        long long integer = 0;
+        double real = 0;
+
+        switch (parsed->args[i])
+        {
+            case LOG_ARG_INT:
+            {
+                int value = va_arg(args, int);
+                memcpy(out, &value, sizeof(value));
+                out += sizeof(value);
+                continue;
+            }
+            case LOG_ARG_DOUBLE:
+            case LOG_ARG_LDOUBLE:
+                real = parsed->args[i] == LOG_ARG_DOUBLE ? va_arg(args, double) : (double)va_arg(args, long double);
+                memcpy(out, &real, sizeof(real));
+                out += sizeof(real);
+                continue;
+            case LOG_ARG_STRING:
+            {
+                const char *str = va_arg(args, const char*);
+                u64 room = (u64)(end - out) - sizeof(u16) - (u64)(parsed->argCount - i - 1) * LOG_BINARY_ARG_RESERVE;
+                u16 length = 0;
+
+                str = str ? str : "(null)";
+
+                while (length < room && str[length])    // a string too long for the record is cut short
+                {
+                    length++;
+                }
+
+                memcpy(out, &length, sizeof(length));
+                memcpy(out + sizeof(length), str, length);
+                out += sizeof(length) + length;
+                continue;
+            }
+            case LOG_ARG_LONG:    integer = va_arg(args, long);                             break;
+            case LOG_ARG_ULONG:   integer = (long long)va_arg(args, unsigned long);         break;
+            case LOG_ARG_LLONG:   integer = va_arg(args, long long);                        break;
+            case LOG_ARG_INTMAX:  integer = (long long)va_arg(args, intmax_t);              break;
+            case LOG_ARG_UINTMAX: integer = (long long)va_arg(args, uintmax_t);             break;
+            case LOG_ARG_SIZE:    integer = (long long)va_arg(args, size_t);                break;
+            case LOG_ARG_PTRDIFF: integer = (long long)va_arg(args, ptrdiff_t);             break;
+            case LOG_ARG_POINTER: integer = (long long)(uintptr_t)va_arg(args, void*);      break;
+            default: break;
+        }
+
+        memcpy(out, &integer, sizeof(integer));
+        out += sizeof(integer);
+    }
+
+    LogEntry entry = { (u32)(out - record->text), id, stamp };
+
+    memcpy(record->text, &entry, sizeof(entry));
+    record->length = entry.size;
+    MC_SpscRing_Commit(producer->ring, 1);
+}
+
+/**
+ * \brief Format the path of the mapped sink's file n, "<path>.<n>".
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static void internal_log_map_path(char *path, u64 size, u64 index)
+{
+    snprintf(path, size, "%s.%llu", log_map_path, (unsigned long long)index);
+}
+
+/**
+ * \brief Create, preallocate and map the next file of the mapped sink, "<path>.<n>".
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * \returns LogMap*: The file, NULL on failure
+ */
+static LogMap* internal_log_map_open(void)
+{
+    char path[LOG_MAP_PATH_SIZE + 24];
+    LogMap *map = (LogMap*)calloc(1, sizeof(LogMap));
+
+    if (!map)
+    {
+        return NULL;
+    }
+
+    internal_log_map_path(path, sizeof(path), log_map_index);
+    map->size = log_map_size;
+    map->index = log_map_index;
+
+#if defined(_WIN32)
+    LARGE_INTEGER end = { .QuadPart = (LONGLONG)map->size };
+
+    map->file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    map->mapping = map->file != INVALID_HANDLE_VALUE && SetFilePointerEx(map->file, end, NULL, FILE_BEGIN) && SetEndOfFile(map->file) ?
+                   CreateFileMappingA(map->file, NULL, PAGE_READWRITE, (DWORD)(map->size >> 32), (DWORD)map->size, NULL) : NULL;
+    map->base = map->mapping ? (char*)MapViewOfFile(map->mapping, FILE_MAP_WRITE, 0, 0, map->size) : NULL;
+
+    if (!map->base)
+    {
+        if (map->mapping)
+        {
+            CloseHandle(map->mapping);
+        }
+
+        if (map->file != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(map->file);
+        }
+
+        free(map);
+
+        return NULL;
+    }
+#else
+    map->fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+
+    if (map->fd >= 0 && posix_fallocate(map->fd, 0, (off_t)map->size) != 0 && ftruncate(map->fd, (off_t)map->size) != 0)
+    {
+        close(map->fd);
+        map->fd = -1;
+    }
+
+    void *base = map->fd >= 0 ? mmap(NULL, map->size, PROT_READ | PROT_WRITE, MAP_SHARED, map->fd, 0) : MAP_FAILED;
+
+    if (base == MAP_FAILED)
+    {
+        if (map->fd >= 0)
+        {
+            close(map->fd);
+        }
+
+        free(map);
+
+        return NULL;
+    }
+
+    map->base = (char*)base;
+#endif
+
+    atomic_init(&map->used, 0);
+    atomic_init(&map->committed, 0);
+    atomic_init(&map->sealed, UINT64_MAX);
+    map->deadline = log_map_seconds ? time(NULL) + (time_t)log_map_seconds : 0;
+    log_map_index++;
+
+    return map;
+}
+
+/**
+ * \brief Unmap a file of the mapped sink and cut it to the bytes written into it.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static void internal_log_map_close(LogMap *map, u64 length)
+{
+#if defined(_WIN32)
+    LARGE_INTEGER end = { .QuadPart = (LONGLONG)length };
+
+    UnmapViewOfFile(map->base);
+    CloseHandle(map->mapping);
+    SetFilePointerEx(map->file, end, NULL, FILE_BEGIN);
+    SetEndOfFile(map->file);
+    CloseHandle(map->file);
+#else
+    munmap(map->base, map->size);
+
+    if (ftruncate(map->fd, (off_t)length) != 0)
+    {
+        perror("Failed to truncate log file");
+    }
+
+    close(map->fd);
+#endif
+
+    map->base = NULL;
+}
+
+/**
+ * \brief Have a file written to disk and cut to the bytes reserved in it, with only the calls a signal
+ * handler may make.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static void internal_log_map_sync(LogMap *map)
+{
+    u64 used = atomic_load(&map->used);
+    u64 sealed = atomic_load(&map->sealed);
+    u64 length = used < sealed ? used : sealed;
+
+    length = length < map->size ? length : map->size;
+#if defined(_WIN32)
+    FlushViewOfFile(map->base, 0);
+    FlushFileBuffers(map->file);
+#else
+    msync(map->base, map->size, MS_SYNC);
+
+    if (ftruncate(map->fd, (off_t)length) != 0)
+    {
+        length = 0;     // the preallocated tail stays, zero filled
+    }
+#endif
+    (void)length;
+}
+
+/**
+ * \brief Seal a file so nothing more fits, and wait for every reservation ahead of the seal to be copied.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * \param crashing: From the crash handler, give up waiting after LOG_MAP_CRASH_TRIES
+ * \returns u64: The file's final length
+ */
+static u64 internal_log_map_seal(LogMap *map, u8 crashing)
+{
+    u64 start = atomic_fetch_add_explicit(&map->used, map->size + 1, memory_order_acq_rel);     // nothing fits after this
+    u64 sealed = atomic_load(&map->sealed);
+
+    while (start < sealed && !atomic_compare_exchange_weak(&map->sealed, &sealed, start))
+    {
+    }
+
+    // a writer that overflowed before the add above may still lower sealed to its own start, and only
+    // the reservations ahead of the lowest start are ever copied, so wait for the two to meet
+    for (u64 tries = 0; atomic_load_explicit(&map->committed, memory_order_acquire) < (sealed = atomic_load(&map->sealed)) &&
+                        (!crashing || tries < LOG_MAP_CRASH_TRIES); tries++)
+    {
+        thrd_yield();
+    }
+
+    return sealed;
+}
+
+/**
+ * \brief Move the sink from a full file to the spare from the crash handler, without the lock and without
+ * opening, formatting or allocating anything. The full file is written to disk and cut, not unmapped.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * \returns u8: true/false, false once there is no spare and the lines that do not fit are lost
+ */
+static u8 internal_log_map_swap(LogMap *map)
+{
+    LogMap *spare = atomic_exchange(&log_map_spare, NULL);
+    LogMap *none = NULL;
+
+    if (!spare)
+    {
+        return false;
+    }
+
+    if (!atomic_compare_exchange_strong(&log_map, &map, spare))
+    {
+        atomic_compare_exchange_strong(&log_map_spare, &none, spare);   // another thread rotated, retry on its file
+
+        return true;
+    }
+
+    internal_log_map_seal(map, true);
+    internal_log_map_sync(map);
+
+    return true;
+}
+
+/**
+ * \brief Seal the current file once every fitting reservation is copied, and move the sink to the spare,
+ * opening the next spare. Only one thread rotates, the others find log_map already moved on and retry.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * \param crashing: From the crash handler, only swap to the spare, see internal_log_map_swap
+ * \returns u8: true/false, false when crashing and there is no spare
+ */
+static u8 internal_log_map_rotate(LogMap *map, u8 crashing)
+{
+    if (crashing)
+    {
+        return internal_log_map_swap(map);
+    }
+
+    mtx_lock(&log_rotate_lock);
+
+    if (atomic_load_explicit(&log_map, memory_order_acquire) == map)
+    {
+        u64 sealed = internal_log_map_seal(map, false);
+        LogMap *next = atomic_exchange(&log_map_spare, NULL);
+
+        if (next)
+        {
+            next->deadline = log_map_seconds ? time(NULL) + (time_t)log_map_seconds : 0;   // its age counts from now
+        }
+        else
+        {
+            next = internal_log_map_open();     // the last spare could not be opened
+        }
+
+        if (next)
+        {
+            next->next = log_maps;
+            log_maps = next;
+        }
+
+        atomic_store_explicit(&log_map, next, memory_order_release);    // NULL if the disk is full, later lines are lost
+        internal_log_map_close(map, sealed);
+
+        if (next)
+        {
+            atomic_store(&log_map_spare, internal_log_map_open());
+        }
+    }
+
+    mtx_unlock(&log_rotate_lock);
+
+    return true;
+}
+
+/**
+ * \brief Append bytes to the mapped sink, rotating when the current file is full or old enough.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * \param crashing: From the crash handler, see internal_log_map_rotate
+ * \returns u8: true/false corresponding to success fail, false once no file can be opened, or when crashing
+ * once the spare is used up
+ */
+static u8 internal_log_map_append(const char *data, u64 size, u8 crashing)
+{
+    LogMap *map;
+
+    while ((map = atomic_load_explicit(&log_map, memory_order_acquire)) != NULL && size <= map->size)
+    {
+        if (!crashing && map->deadline && time(NULL) >= map->deadline)
+        {
+            internal_log_map_rotate(map, false);
+            continue;
+        }
+
+        u64 start = atomic_fetch_add_explicit(&map->used, size, memory_order_relaxed);
+
+        if (start + size <= map->size)
+        {
+            memcpy(map->base + start, data, size);
+            atomic_fetch_add_explicit(&map->committed, size, memory_order_release);
+
+            return true;
+        }
+
+        u64 sealed = atomic_load(&map->sealed);
+
+        while (start < sealed && !atomic_compare_exchange_weak(&map->sealed, &sealed, start))
+        {
+        }
+
+        if (!internal_log_map_rotate(map, crashing))
+        {
+            return false;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * \brief Append whole lines to the file with one write call, bypassing stdio and its lock. The file is
+ * opened for appending, so the lines of concurrent callers never tear or overwrite each other.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * \returns u8: true/false corresponding to success fail
+ */
+static u8 internal_log_publish(const char *data, u64 size)
+{
+    if (atomic_load_explicit(&log_map, memory_order_relaxed))
+    {
+        return internal_log_map_append(data, size, false);
+    }
+
+    if (!log_output_stream)
+    {
+        return false;   // the mapped sink could not open its next file
+    }
+
+#if defined(_WIN32)
+    int fd = _fileno(log_output_stream);
+#else
+    int fd = fileno(log_output_stream);
+#endif
+
+    while (size)
+    {
+        u64 chunk = size < LOG_WRITE_BATCH ? size : LOG_WRITE_BATCH;
+#if defined(_WIN32)
+        long long written = _write(fd, data, (unsigned int)chunk);
+#else
+        long long written = write(fd, data, chunk);
+#endif
+
+        if (written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+
+        if (written <= 0)
+        {
+            return false;
+        }
+
+        data += written;
+        size -= (u64)written;
+    }
+
+    return true;
+}
+
+/**
+ * \brief Hand the batch to the file in one write.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static void internal_log_write(char *batch, u64 *used)
+{
+    if (*used)
+    {
+        MC_TRACE_MODULE_BEGIN("MC_Log write");
+        internal_log_publish(batch, *used);     // nowhere to report a failing log, the batch is lost
+        MC_TRACE_MODULE_END("MC_Log write");
+        *used = 0;
+    }
+}
+
+/**
+ * \brief Append bytes to the writer's batch, handing the batch to the file first when they do not fit.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static void internal_log_append(char *batch, u64 *used, const void *data, u64 size)
+{
+    if (*used + size > LOG_WRITE_BATCH)
+    {
+        internal_log_write(batch, used);
+    }
+
+    memcpy(batch + *used, data, size);
+    *used += size;
+}
+
+/**
+ * \brief Fatal signal handler of the mapped sink: copy what the rings still hold into the current file, have
+ * the file written to disk and cut to its length, then let the signal take its course.
+ * \details The writer thread finishes the pass it is in first; a handler running on the writer itself, or
+ * waiting on it for too long, leaves the rings alone. Nothing is allocated, formatted or opened: a full file
+ * moves the sink to the spare opened ahead of time, and the lines past the spare are lost.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static void internal_log_crash(int sig)
+{
+    u64 i = 0;
+
+    while (i < LOG_CRASH_SIGNALS && log_crash_signals[i] != sig)
+    {
+        i++;
+    }
+
+    if (!atomic_flag_test_and_set(&log_crashing))
+    {
+        u64 tries = 0;
+
+        while (atomic_flag_test_and_set_explicit(&log_draining, memory_order_acquire) && ++tries < LOG_MAP_CRASH_TRIES)
+        {
+            thrd_yield();   // the writer finishes its pass into the file first
+        }
+
+        for (LogProducer *producer = tries < LOG_MAP_CRASH_TRIES ? atomic_load(&log_producers) : NULL; producer; producer = producer->next)
+        {
+            u64 granted = 0;
+            const LogRecord *records;
+
+            while ((records = (const LogRecord*)MC_SpscRing_Acquire(producer->ring, log_ring_capacity, &granted)))
+            {
+                for (u64 r = 0; r < granted; r++)
+                {
+                    internal_log_map_append(records[r].text, records[r].length, true);
+                }
+
+                MC_SpscRing_Release(producer->ring, granted);
+            }
+        }
+
+        LogMap *map = atomic_load(&log_map);
+        LogMap *spare = atomic_load(&log_map_spare);
+
+        if (map)
+        {
+            internal_log_map_sync(map);
+        }
+
+#if !defined(_WIN32)
+        if (spare && ftruncate(spare->fd, 0) != 0)
+        {
+            spare = NULL;   // left preallocated, zero filled
+        }
+#endif
+        (void)spare;
+    }
+
+    if (i < LOG_CRASH_SIGNALS)
+    {
+#if defined(_WIN32)
+        signal(sig, log_crash_previous[i]);
+#else
+        sigaction(sig, &log_crash_previous[i], NULL);
+#endif
+    }
+
+    raise(sig);     // delivered once the handler returns, to the handler there was before MC_Log_InitMapped
+}
+
+/**
+ * \brief Install or remove internal_log_crash on every fatal signal.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static void internal_log_crash_handlers(u8 install)
+{
+    if (install == log_crash_installed)
+    {
+        return;     // installing twice would save internal_log_crash as the previous handler
+    }
+
+    for (u64 i = 0; i < LOG_CRASH_SIGNALS; i++)
+    {
+#if defined(_WIN32)
+        if (install)
+        {
+            log_crash_previous[i] = signal(log_crash_signals[i], internal_log_crash);
+        }
+        else
+        {
+            signal(log_crash_signals[i], log_crash_previous[i]);
+        }
+#else
+        if (install)
+        {
+            struct sigaction action = { 0 };
+
+            action.sa_handler = internal_log_crash;
+            sigemptyset(&action.sa_mask);
+            sigaction(log_crash_signals[i], &action, &log_crash_previous[i]);
+        }
+        else
+        {
+            sigaction(log_crash_signals[i], &log_crash_previous[i], NULL);
+        }
+#endif
+    }
+
+    log_crash_installed = install;
+    atomic_flag_clear(&log_crashing);
+}
+
+/**
+ * \brief Move every record waiting in every ring into the file, a batch at a time.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * \returns u64: The number of records written.
+ */
+static u64 internal_log_drain(char *batch, u64 *used)
+{
+    u64 written = 0;
+    u8 mapped = atomic_load_explicit(&log_map, memory_order_relaxed) != NULL;
+
+    for (LogProducer *producer = atomic_load(&log_producers); producer; producer = producer->next)
+    {
+        u64 granted = 0;
+        const LogRecord *records;
+
+        while (atomic_flag_test_and_set_explicit(&log_draining, memory_order_acquire))
+        {
+            thrd_yield();   // held for good by a crash handler
+        }
+
+        while ((records = (const LogRecord*)MC_SpscRing_Acquire(producer->ring, log_ring_capacity, &granted)))
+        {
+            for (u64 i = 0; i < granted; i++)
+            {
+                if (mapped)
+                {
+                    internal_log_map_append(records[i].text, records[i].length, false);    // released only once in the file, a crash finds the rest in the ring
+                }
+                else
+                {
+                    internal_log_append(batch, used, records[i].text, records[i].length);
+                }
+            }
+
+            MC_SpscRing_Release(producer->ring, granted);
+            written += granted;
+        }
+
+        atomic_flag_clear_explicit(&log_draining, memory_order_release);
+    }
+
+    return written;
+}
+
+/**
+ * \brief Append a line telling how many lines were dropped since the last such line, MC_LOG_OVERFLOW_COUNT only.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static void internal_log_report_dropped(char *batch, u64 *used, u64 *reported)
+{
+    u64 dropped = atomic_load_explicit(&log_dropped, memory_order_relaxed);
+
+    if (log_overflow != MC_LOG_OVERFLOW_COUNT || dropped == *reported)
+    {
+        return;
+    }
+
+    char line[LOG_RECORD_SIZE];
+    u64 length = internal_log_format_record(line, sizeof(line), MC_LOG_LEVEL_WARNING, "%llu log message(s) dropped",
+                                            (unsigned long long)(dropped - *reported));
+
+    internal_log_append(batch, used, line, length);
+    *reported = dropped;
+}
+
+/**
+ * \brief Count a line an MC_LOG_LIMIT or MC_LOG_SAMPLE site skipped, and list the site on its first one.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static void internal_log_suppress(MC_LogSite *site)
+{
+    atomic_fetch_add_explicit(&site->suppressed, 1, memory_order_relaxed);
+
+    if (!atomic_load_explicit(&site->listed, memory_order_relaxed) && !atomic_exchange(&site->listed, true))
+    {
+        MC_LogSite *head = atomic_load(&log_sites);
+
+        do
+        {
+            site->next = head;
+        } while (!atomic_compare_exchange_weak(&log_sites, &head, site));
+    }
+}
+
+/**
+ * \brief Log how many lines a site skipped since they were last reported, if any.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * \param now: internal_log_coarse_ns, to report only once LOG_SUPPRESSED_REPORT_NS passed since the site's
+ * last report, 0 to report anyway
+ */
+static void internal_log_site_report(MC_LogSite *site, u64 now)
+{
+    u64 reported = atomic_load_explicit(&site->reported, memory_order_relaxed);
+
+    if (now && (now - reported < LOG_SUPPRESSED_REPORT_NS ||
+                !atomic_compare_exchange_strong_explicit(&site->reported, &reported, now, memory_order_relaxed, memory_order_relaxed)))
+    {
+        return;     // too soon, or another thread is reporting
+    }
+
+    u64 count = atomic_exchange_explicit(&site->suppressed, 0, memory_order_relaxed);
+
+    if (count)
+    {
+        MC_Log_Message(MC_LOG_LEVEL_WARNING, "%llu line(s) suppressed at %s:%d", (unsigned long long)count, site->file, site->line);
+    }
+}
+
+/**
+ * \brief Append a line for every site that skipped lines since it was last reported, once a
+ * LOG_SUPPRESSED_REPORT_NS has passed since the last time, or when stopping.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static void internal_log_report_suppressed(char *batch, u64 *used, u64 *reportedNs, u8 stopping)
+{
+    u64 now = internal_log_unix_ns();
+
+    if (!stopping && now - *reportedNs < LOG_SUPPRESSED_REPORT_NS)
+    {
+        return;
+    }
+
+    *reportedNs = now;
+
+    for (MC_LogSite *site = atomic_load_explicit(&log_sites, memory_order_acquire); site; site = site->next)
+    {
+        u64 count = atomic_exchange_explicit(&site->suppressed, 0, memory_order_relaxed);
+
+        if (count)
+        {
+            char line[LOG_RECORD_SIZE];
+            u64 length = internal_log_format_record(line, sizeof(line), MC_LOG_LEVEL_WARNING, "%llu line(s) suppressed at %s:%d",
+                                                    (unsigned long long)count, site->file, site->line);
+
+            internal_log_append(batch, used, line, length);
+        }
+    }
+}
+
+/**
+ * \brief Append a definition entry for every format registered since the last call, binary mode only.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static void internal_log_define_formats(char *batch, u64 *used, u64 *defined)
+{
+    u64 count = atomic_load_explicit(&log_format_count, memory_order_acquire);
+
+    for (; *defined < count; (*defined)++)
+    {
+        const char *format = log_formats[*defined].format;
+        u64 length = strlen(format);
+
+        length = length < LOG_WRITE_BATCH - sizeof(LogEntry) ? length : LOG_WRITE_BATCH - sizeof(LogEntry);
+
+        LogEntry entry = { (u32)(sizeof(LogEntry) + length), LOG_BINARY_ID_FORMAT, *defined + 1 };
+
+        internal_log_append(batch, used, &entry, sizeof(entry));
+        internal_log_append(batch, used, format, length);
+    }
+}
+
+/**
+ * \brief Append a clock entry, so decoding does not lean on the tick rate measured at open for long.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static void internal_log_sync_clock(char *batch, u64 *used)
+{
+    char data[sizeof(LogEntry) + sizeof(u64)];
+    LogEntry entry = { sizeof(data), LOG_BINARY_ID_CLOCK, internal_log_ticks() };
+    u64 unixNs = internal_log_unix_ns();
+
+    memcpy(data, &entry, sizeof(entry));
+    memcpy(data + sizeof(entry), &unixNs, sizeof(unixNs));
+    internal_log_append(batch, used, data, sizeof(data));
+}
+
+static int internal_log_writer(void *arg)
+{
+    (void)arg;
+
+    char *batch = (char*)malloc(LOG_WRITE_BATCH);
+    u64 used = 0;
+    u64 reported = 0;
+    u64 reportedNs = internal_log_unix_ns();
+    u64 defined = 0;
+    long idle = LOG_WRITER_IDLE_MIN_NS;
+    u8 binary = atomic_load(&log_mode) == LOG_MODE_BINARY;
+
+    if (!batch)
+    {
+        atomic_store_explicit(&log_writer_state, LOG_WRITER_FAILED, memory_order_release);
+
+        return 1;
+    }
+
+    atomic_store_explicit(&log_writer_state, LOG_WRITER_RUNNING, memory_order_release);
+
+    while (true)
+    {
+        u8 stopping = atomic_load_explicit(&log_writer_stop, memory_order_acquire);     // read first, so the drain after it sees every line logged before Close
+
+        if (binary)
+        {
+            internal_log_define_formats(batch, &used, &defined);
+        }
+
+        u64 written = internal_log_drain(batch, &used);
+
+        internal_log_report_dropped(batch, &used, &reported);
+        internal_log_report_suppressed(batch, &used, &reportedNs, stopping);
+
+        if (binary && written)
+        {
+            internal_log_sync_clock(batch, &used);
+        }
+
+        internal_log_write(batch, &used);
+
+        atomic_fetch_add_explicit(&log_passes, 1, memory_order_release);   // every pass, so Flush returns while others keep logging
+
+        if (written)
+        {
+            idle = LOG_WRITER_IDLE_MIN_NS;
+            continue;
+        }
+
+        if (stopping)
+        {
+            break;
+        }
+
+        thrd_sleep(&(struct timespec){ .tv_nsec = idle }, NULL);
+        idle = idle * 2 < LOG_WRITER_IDLE_NS ? idle * 2 : LOG_WRITER_IDLE_NS;
+    }
+
+    free(batch);
+
+    return 0;
+}
+
+/**
+ * \brief Start the writer thread on the already open log_output_stream and switch to mode.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static int internal_log_start(LogMode mode, u64 ring_capacity, MC_LogOverflow overflow)
+{
+    log_ring_capacity = ring_capacity ? ring_capacity : LOG_DEFAULT_RING_CAPACITY;
+    log_overflow = overflow;
+    atomic_store(&log_dropped, 0);
+    atomic_store(&log_writer_stop, false);
+    atomic_store(&log_writer_state, LOG_WRITER_STARTING);
+    atomic_store(&log_mode, mode);  // set first, the writer reads it when it starts
+
+    if (thrd_create(&log_writer, internal_log_writer, NULL) != thrd_success)
+    {
+        atomic_store(&log_mode, LOG_MODE_SYNC);
+        MC_Log_Close();
+
+        return -1;
+    }
+
+    u8 state;
+
+    while ((state = atomic_load_explicit(&log_writer_state, memory_order_acquire)) == LOG_WRITER_STARTING)
+    {
+        thrd_yield();
+    }
+
+    if (state == LOG_WRITER_FAILED)
+    {
+        MC_Log_Close();     // joins the writer, which has already exited, and closes the file
+
+        return -1;
+    }
+
+    return 0;
+}
+
+/**
+ * \brief Open log_output_stream, truncated, with every write appending.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static int internal_log_open(const char *path, const char *mode)
+{
+    if (MC_FOpen(&log_output_stream, path, mode) != 0)
+    {
+        perror("Failed to open log file");
+
+        return -1;
+    }
+
+#if !defined(_WIN32)
+    int fd = fileno(log_output_stream);
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_APPEND);     // the CRT serializes _write per descriptor on Windows
+#endif
+
+    return 0;
+}
+
+int MC_Log_Init()
+{
+    return internal_log_open(LOG_OUTPUT_FILE, "w");     // Use "w" to overwrite the file each run
+}
+
+int MC_Log_InitAsync(u64 ring_capacity, MC_LogOverflow overflow)
+{
+    call_once(&log_registry_once, internal_log_registry_init);
+
+    if (!log_registry_ready || atomic_load(&log_mode) != LOG_MODE_SYNC ||
+        (!log_output_stream && !atomic_load(&log_map) && MC_Log_Init() != 0))  // keep a log MC_Log_Init already opened
+    {
+        return -1;
+    }
+
+    return internal_log_start(LOG_MODE_ASYNC, ring_capacity, overflow);
+}
+
+int MC_Log_InitMapped(const MC_LogRotation *rotation)
+{
+    call_once(&log_registry_once, internal_log_registry_init);
+
+    const char *path = rotation && rotation->path ? rotation->path : LOG_OUTPUT_FILE;
+    u64 size = rotation && rotation->file_size ? rotation->file_size : LOG_MAP_DEFAULT_SIZE;
+
+    if (!log_registry_ready || atomic_load(&log_mode) != LOG_MODE_SYNC || atomic_load(&log_map) || log_maps || log_output_stream ||
+        strlen(path) >= LOG_MAP_PATH_SIZE)
+    {
+        return -1;
+    }
+
+    memcpy(log_map_path, path, strlen(path) + 1);
+    log_map_size = size > LOG_MAP_MIN_SIZE ? size : LOG_MAP_MIN_SIZE;
+    log_map_seconds = rotation ? rotation->rotate_seconds : 0;
+    log_map_index = 0;
+
+    LogMap *map = internal_log_map_open();
+
+    if (!map)
+    {
+        perror("Failed to map log file");
+
+        return -1;
+    }
+
+    log_maps = map;
+    atomic_store(&log_map_spare, internal_log_map_open());     // without one the crash handler stops at a full file
+    atomic_store_explicit(&log_map, map, memory_order_release);
+    internal_log_crash_handlers(true);
+
+    return 0;
+}
+
+int MC_Log_InitBinary(const char *path, u64 ring_capacity, MC_LogOverflow overflow)
+{
+    call_once(&log_registry_once, internal_log_registry_init);
+
+    // a rotated file would lack the formats, a text file opened by MC_Log_Init cannot take binary entries
+    if (!log_registry_ready || atomic_load(&log_mode) != LOG_MODE_SYNC || atomic_load(&log_map) || log_output_stream)
+    {
+        return -1;
+    }
+
+    if (internal_log_open(path ? path : LOG_BINARY_FILE, "wb") != 0)
+    {
+        return -1;
+    }
+
+    // measure the tick rate against the wall clock, the header then anchors ticks to the end of it
+    u64 startTicks = internal_log_ticks();
+    u64 startNs = internal_log_unix_ns();
+
+    thrd_sleep(&(struct timespec){ .tv_nsec = LOG_CALIBRATE_NS }, NULL);
+
+    LogFileHeader header = { LOG_BINARY_MAGIC, LOG_BINARY_VERSION, 0, internal_log_ticks(), internal_log_unix_ns(), 0 };
+
+    header.ticksPerSecond = header.unixNs > startNs ?
+                            (u64)((double)(header.ticks - startTicks) * LOG_NS_PER_SECOND / (double)(header.unixNs - startNs)) :
+                            LOG_NS_PER_SECOND;
+
+    if (!internal_log_publish((const char*)&header, sizeof(header)))
+    {
+        MC_Log_Close();
+
+        return -1;
+    }
+
+    return internal_log_start(LOG_MODE_BINARY, ring_capacity, overflow);
+}
+
+void MC_Log_Flush()
+{
+    if (atomic_load_explicit(&log_mode, memory_order_acquire) == LOG_MODE_SYNC)
+    {
+        return;
+    }
+
+    MC_TRACE_MODULE_BEGIN("MC_Log_Flush");
+
+    u64 start = atomic_load_explicit(&log_passes, memory_order_acquire);
+
+    while (atomic_load_explicit(&log_passes, memory_order_acquire) < start + 2)    // one whole pass that began after this call
+    {
+        thrd_yield();
+    }
+
+    MC_TRACE_MODULE_END("MC_Log_Flush");
+}
+
+u64 MC_Log_Dropped()
+{
+    return atomic_load_explicit(&log_dropped, memory_order_relaxed);
+}
+
+void MC_Log_Close()
+{
+    MC_TRACE_MODULE_BEGIN("MC_Log_Close");
+
+    if (atomic_load(&log_mode) == LOG_MODE_SYNC)
+    {
+        for (MC_LogSite *site = atomic_load_explicit(&log_sites, memory_order_acquire); site; site = site->next)
+        {
+            internal_log_site_report(site, 0);  // the writer does it on its last pass otherwise
+        }
+    }
+    else
+    {
+        atomic_store_explicit(&log_writer_stop, true, memory_order_release);
+        thrd_join(log_writer, NULL);
+
+        mtx_lock(&log_registry_lock);
+
+        atomic_store(&log_mode, LOG_MODE_SYNC);
+        atomic_fetch_add(&log_epoch, 1);    // threads still holding a producer register again next time
+
+        LogProducer *producer = atomic_exchange(&log_producers, NULL);
+
+        while (producer)
+        {
+            LogProducer *next = producer->next;
+
+            MC_SpscRing_Free(&producer->ring);
+            free(producer);
+            producer = next;
+        }
+
+        mtx_unlock(&log_registry_lock);
+    }
+
+    internal_log_crash_handlers(false);     // also after a failed rotation left log_map NULL
+
+    LogMap *map = atomic_exchange(&log_map, NULL);
+
+    if (map)
+    {
+        internal_log_map_close(map, atomic_load(&map->committed));  // nobody is logging, every reservation is copied
+    }
+
+    LogMap *spare = atomic_exchange(&log_map_spare, NULL);
+
+    if (spare)
+    {
+        char path[LOG_MAP_PATH_SIZE + 24];
+
+        internal_log_map_path(path, sizeof(path), spare->index);
+        internal_log_map_close(spare, 0);
+        remove(path);   // never written to
+        free(spare);
+    }
+
+    while (log_maps)
+    {
+        LogMap *next = log_maps->next;
+
+        free(log_maps);
+        log_maps = next;
+    }
+
+    if (log_output_stream != NULL)
+    {
+        fclose(log_output_stream);
+        log_output_stream = NULL;
+    }
+
+    MC_TRACE_MODULE_END("MC_Log_Close");
+}
 
 /**
- * \brief Test file where output will be written
+ * \brief Format a line into the calling thread's ring, as text or as a text entry of the binary log.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
  */
-#define LOG_OUTPUT_FILE "last_run_output.txt"
+static void internal_log_async(LogMode mode, LogLevel lvl, const char *format, va_list args)
+{
+    LogProducer *producer = NULL;
+    LogRecord *record = internal_log_reserve(&producer);
+
+    if (!record)
+    {
+        return;
+    }
+
+    record->length = mode == LOG_MODE_BINARY ?
+                     (u32)internal_log_format_entry(record->text, sizeof(record->text), lvl, format, args) :
+                     (u32)internal_log_format_line(record->text, sizeof(record->text), lvl, format, args);
+    MC_SpscRing_Commit(producer->ring, 1);
+}
 
 /**
- * \brief File pointer
+ * \brief Log a line in whatever mode the log is in.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
  */
-static FILE *log_output_stream = NULL;
+static void internal_log_message(LogLevel lvl, const char *format, va_list args)
+{
+    LogMode mode = (LogMode)atomic_load_explicit(&log_mode, memory_order_acquire);
 
-int MC_Log_Init()
+    if (mode != LOG_MODE_SYNC)
+    {
+        internal_log_async(mode, lvl, format, args);
+
+        return;
+    }
+
+    if (log_output_stream == NULL && !atomic_load_explicit(&log_map, memory_order_relaxed))
+    {
+        return;
+    }
+
+    // Format the whole line in the thread's buffer, then publish it in one write
+    va_list retry;
+    va_copy(retry, args);
+
+    char *line = log_thread_line;
+    u64 length = internal_log_prefix(line, lvl, internal_log_unix_ns());
+    int message = vsnprintf(line + length, LOG_LINE_SIZE - length, format, args);
+
+    if (message >= 0 && length + (u64)message >= LOG_LINE_SIZE)     // too long for the buffer, format it again into one that fits
+    {
+        line = (char*)malloc(length + (u64)message + 1);
+
+        if (line)
+        {
+            memcpy(line, log_thread_line, length);
+            vsnprintf(line + length, (u64)message + 1, format, retry);
+        }
+        else
+        {
+            line = log_thread_line;
+            message = (int)(LOG_LINE_SIZE - 1 - length);    // cut short rather than lost
+        }
+    }
+
+    va_end(retry);
+
+    length += message < 0 ? 0 : (u64)message;
+    line[length] = '\n';    // over the terminating null
+    MC_TRACE_MODULE_BEGIN("MC_Log write");
+    internal_log_publish(line, length + 1);
+    MC_TRACE_MODULE_END("MC_Log write");
+
+    if (line != log_thread_line)
+    {
+        free(line);
+    }
+}
+
+u8 MC_Log_Limit(MC_LogSite *site, u64 per_second, u64 burst)
 {
-    if (fopen_s(&log_output_stream, LOG_OUTPUT_FILE, "w") != 0) // Use "w" to overwrite the file each run
-    { 
-        perror("Failed to open log file");
-        
-        return -1;
+    if (!site)
+    {
+        return false;
     }
 
-    return 0;
+    if (!per_second)
+    {
+        internal_log_suppress(site);
+
+        return false;
+    }
+
+    // a token bucket kept as the time it runs empty: each line pushes it one interval later, and a line is
+    // skipped while that time is more than burst - 1 intervals ahead of now
+    u64 now = internal_log_coarse_ns();
+    u64 interval = per_second < LOG_NS_PER_SECOND ? LOG_NS_PER_SECOND / per_second : 1;
+    u64 tolerance = (burst ? burst - 1 : 0) * interval;
+    u64 empty = atomic_load_explicit(&site->state, memory_order_relaxed);
+    u64 next;
+
+    do
+    {
+        u64 ahead = empty > now ? empty - now : 0;
+
+        if (ahead > tolerance)
+        {
+            internal_log_suppress(site);
+
+            return false;
+        }
+
+        next = now + ahead + interval;
+    } while (!atomic_compare_exchange_weak_explicit(&site->state, &empty, next, memory_order_relaxed, memory_order_relaxed));
+
+    if (atomic_load_explicit(&site->suppressed, memory_order_relaxed))
+    {
+        internal_log_site_report(site, now);
+    }
+
+    return true;
 }
 
-void MC_Log_Close()
+u8 MC_Log_Sample(MC_LogSite *site, u64 n)
 {
-    if (log_output_stream != NULL)
+    if (!site)
     {
-        fclose(log_output_stream);
-        log_output_stream = NULL;
+        return false;
+    }
+
+    u64 call = atomic_fetch_add_explicit(&site->state, 1, memory_order_relaxed);
+
+    if (n > 1 && call % n)
+    {
+        internal_log_suppress(site);
+
+        return false;
+    }
+
+    if (atomic_load_explicit(&site->suppressed, memory_order_relaxed))
+    {
+        internal_log_site_report(site, internal_log_coarse_ns());
     }
+
+    return true;
+}
+
+void MC_Log_SetLevel(LogLevel lvl)
+{
+    atomic_store_explicit(&mc_log_threshold, (int)lvl, memory_order_relaxed);
+}
+
+LogLevel MC_Log_GetLevel()
+{
+    return (LogLevel)atomic_load_explicit(&mc_log_threshold, memory_order_relaxed);
 }
 
 void MC_Log_Message(LogLevel lvl, const char *format, ...)
 {
-    if (log_output_stream == NULL)
+    if (!MC_LOG_ENABLED(lvl))   // direct callers skip the macros' check
     {
         return;
     }
 
-    const char *level_str = NULL;
-    switch (lvl)
+    va_list args;
+    va_start(args, format);
+    internal_log_message(lvl, format, args);
+    va_end(args);
+}
+
+void MC_Log_KV(LogLevel lvl, const char *event, const MC_KV *fields, u64 count)
+{
+    if (!event || (count && !fields) || !MC_LOG_ENABLED(lvl))
+    {
+        return;
+    }
+
+    LogMode mode = (LogMode)atomic_load_explicit(&log_mode, memory_order_acquire);
+
+    if (mode != LOG_MODE_SYNC)
+    {
+        LogProducer *producer = NULL;
+        LogRecord *record = internal_log_reserve(&producer);
+        u64 length = 0;
+
+        if (!record)
+        {
+            return;
+        }
+
+        if (mode == LOG_MODE_BINARY)
+        {
+            u64 start = sizeof(LogEntry) + 1;
+            LogEntry entry;
+
+            length = start + internal_log_kv_body(record->text + start, sizeof(record->text) - start, event, fields, count);
+            entry = (LogEntry){ (u32)length, LOG_BINARY_ID_JSON, internal_log_ticks() };
+            memcpy(record->text, &entry, sizeof(entry));
+            record->text[sizeof(LogEntry)] = (char)lvl;
+        }
+        else
+        {
+            length = internal_log_kv_head(record->text, lvl, internal_log_unix_ns());
+            length += internal_log_kv_body(record->text + length, sizeof(record->text) - length - 1, event, fields, count);
+            record->text[length++] = '\n';
+        }
+
+        record->length = (u32)length;
+        MC_SpscRing_Commit(producer->ring, 1);
+
+        return;
+    }
+
+    if (log_output_stream == NULL && !atomic_load_explicit(&log_map, memory_order_relaxed))
+    {
+        return;
+    }
+
+    u64 size = internal_log_kv_bound(event, fields, count);
+    char *line = size <= LOG_LINE_SIZE ? log_thread_line : (char*)malloc(size);
+
+    if (!line)
+    {
+        line = log_thread_line;     // fields left out rather than the line lost
+        size = LOG_LINE_SIZE;
+    }
+
+    u64 length = internal_log_kv_head(line, lvl, internal_log_unix_ns());
+
+    length += internal_log_kv_body(line + length, size - length - 1, event, fields, count);
+    line[length++] = '\n';
+    internal_log_publish(line, length);
+
+    if (line != log_thread_line)
+    {
+        free(line);
+    }
+}
+
+void MC_Log_Binary(atomic_uint *site, LogLevel lvl, const char *format, ...)
+{
+    u64 stamp = internal_log_ticks();
+
+    if (!site || !format || !MC_LOG_ENABLED(lvl))
     {
-        case MC_LOG_LEVEL_DEBUG:   level_str = "DEBUG"; break;
-        case MC_LOG_LEVEL_INFO:    level_str = "INFO"; break;
-        case MC_LOG_LEVEL_WARNING: level_str = "WARNING"; break;
-        case MC_LOG_LEVEL_ERROR:   level_str = "ERROR"; break;
-        default:                   level_str = "UNKNOWN"; break;
+        return;
     }
 
-    // Get current time
-    time_t now = time(NULL);
-    struct tm t;
-    localtime_s(&t, &now);
-    char time_str[20];
-    strftime(time_str, sizeof(time_str), "%Y-%m-%d %H:%M:%S", &t);
+    u32 id = atomic_load_explicit(site, memory_order_acquire);
+
+    if (!id)
+    {
+        id = internal_log_register(site, format);
+    }
 
-    // Print log message
     va_list args;
     va_start(args, format);
-    fprintf(log_output_stream, "[%s] [%s] ", time_str, level_str);
-    vfprintf(log_output_stream, format, args);
-    fprintf(log_output_stream, "\n");
+
+    if (id != LOG_BINARY_ID_TEXT && atomic_load_explicit(&log_mode, memory_order_acquire) == LOG_MODE_BINARY)
+    {
+        internal_log_binary(id, stamp, lvl, args);
+    }
+    else
+    {
+        internal_log_message(lvl, format, args);
+    }
+
     va_end(args);
-    fflush(log_output_stream);
+}
+
+/**
+ * \brief Read the next entry of a binary log, its payload into *payload, grown as needed.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * \returns int: 1 for an entry, 0 at the end of the file, -1 for a truncated or corrupt entry
+ */
+static int internal_log_read_entry(FILE *in, LogEntry *entry, char **payload, u64 *capacity)
+{
+    size_t got = fread(entry, 1, sizeof(*entry), in);
+
+    if (got == 0)
+    {
+        return 0;
+    }
+
+    if (got != sizeof(*entry) || entry->size < sizeof(*entry))
+    {
+        return -1;
+    }
+
+    u64 size = entry->size - sizeof(*entry);
+
+    if (size + 1 > *capacity)
+    {
+        char *grown = (char*)realloc(*payload, size + 1);
+
+        if (!grown)
+        {
+            return -1;
+        }
+
+        *payload = grown;
+        *capacity = size + 1;
+    }
+
+    if (fread(*payload, 1, size, in) != size)
+    {
+        return -1;
+    }
+
+    (*payload)[size] = '\0';    // so a format definition or text message reads as a string
+
+    return 1;
+}
+
+/**
+ * \brief Read one stored argument back, stopping at the end of the payload.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * \returns u8: true/false corresponding to success fail
+ */
+static u8 internal_log_read_arg(u8 type, const char **cursor, const char *end, LogValue *value, char *str, u64 str_size)
+{
+    u64 size = type == LOG_ARG_INT ? sizeof(int) : type == LOG_ARG_STRING ? sizeof(u16) : sizeof(u64);
+
+    if ((u64)(end - *cursor) < size)
+    {
+        return false;
+    }
+
+    switch (type)
+    {
+        case LOG_ARG_INT:     memcpy(&value->i, *cursor, sizeof(value->i));   break;
+        case LOG_ARG_DOUBLE:
+        case LOG_ARG_LDOUBLE: memcpy(&value->d, *cursor, sizeof(value->d));   break;
+        case LOG_ARG_POINTER:
+        {
+            u64 address;
+            memcpy(&address, *cursor, sizeof(address));
+            value->p = (void*)(uintptr_t)address;
+            break;
+        }
+        case LOG_ARG_STRING:
+        {
+            u16 length;
+            memcpy(&length, *cursor, sizeof(length));
+
+            if ((u64)(end - *cursor) < size + length || length >= str_size)
+            {
+                return false;
+            }
+
+            memcpy(str, *cursor + size, length);
+            str[length] = '\0';
+            value->s = str;
+            size += length;
+            break;
+        }
+        default:              memcpy(&value->ll, *cursor, sizeof(value->ll)); break;
+    }
+
+    *cursor += size;
+
+    return true;
+}
+
+/**
+ * \brief Print the message of a binary entry by walking its format as the producer parsed it.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * \returns u8: false when the payload ran out before the format did
+ */
+static u8 internal_log_print_message(FILE *out, const char *format, const char *payload, const char *end)
+{
+    char str[LOG_RECORD_SIZE];
+
+    for (const char *p = format; *p; )
+    {
+        const char *literal = p;
+
+        while (*p && *p != '%')
+        {
+            p++;
+        }
+
+        fwrite(literal, 1, (u64)(p - literal), out);
+
+        if (!*p)
+        {
+            break;
+        }
+
+        if (*++p == '%')
+        {
+            fputc('%', out);
+            p++;
+            continue;
+        }
+
+        LogSpec spec;
+        LogValue value;
+        LogValue stars[2] = { 0 };
+
+        p = internal_log_parse_spec(p, &spec);
+
+        for (u8 s = 0; s < spec.stars; s++)
+        {
+            if (s >= 2 || !internal_log_read_arg(LOG_ARG_INT, &payload, end, &stars[s], str, sizeof(str)))
+            {
+                return false;
+            }
+        }
+
+        if (!spec.valid || !internal_log_read_arg(spec.type, &payload, end, &value, str, sizeof(str)))
+        {
+            return false;
+        }
+
+#define LOG_PRINT(v) (spec.stars == 0 ? fprintf(out, spec.text, v) :                          \
+                      spec.stars == 1 ? fprintf(out, spec.text, stars[0].i, v) :              \
+                                        fprintf(out, spec.text, stars[0].i, stars[1].i, v))
+
+        switch (spec.type)
+        {
+            case LOG_ARG_INT:     LOG_PRINT(value.i);  break;
+            case LOG_ARG_DOUBLE:
+            case LOG_ARG_LDOUBLE: LOG_PRINT(value.d);  break;
+            case LOG_ARG_STRING:  LOG_PRINT(value.s);  break;
+            case LOG_ARG_POINTER: LOG_PRINT(value.p);  break;
+            default:              LOG_PRINT(value.ll); break;
+        }
+
+#undef LOG_PRINT
+    }
+
+    return true;
+}
+
+int MC_Log_Decode(const char *binary_path, FILE *out)
+{
+    FILE *in = NULL;
+    LogFileHeader header;
+
+    if (!binary_path || !out || MC_FOpen(&in, binary_path, "rb") != 0)
+    {
+        return -1;
+    }
+
+    if (fread(&header, sizeof(header), 1, in) != 1 || memcmp(header.magic, LOG_BINARY_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != LOG_BINARY_VERSION || !header.ticksPerSecond)
+    {
+        fclose(in);
+
+        return -1;
+    }
+
+    LogEntry entry;
+    char *payload = NULL;
+    u64 capacity = 0;
+    char **formats = NULL;
+    u64 formatCount = 0;
+    int status;
+
+    // the writer defines a format at the start of a pass, entries drained in that same pass may come first
+    while ((status = internal_log_read_entry(in, &entry, &payload, &capacity)) == 1)
+    {
+        if (entry.id != LOG_BINARY_ID_FORMAT || !entry.stamp || entry.stamp > LOG_BINARY_MAX_FORMATS)
+        {
+            continue;
+        }
+
+        if (entry.stamp > formatCount)
+        {
+            char **grown = (char**)realloc(formats, entry.stamp * sizeof(char*));
+
+            if (!grown)
+            {
+                status = -1;
+                break;
+            }
+
+            memset(grown + formatCount, 0, (entry.stamp - formatCount) * sizeof(char*));
+            formats = grown;
+            formatCount = entry.stamp;
+        }
+
+        free(formats[entry.stamp - 1]);
+        formats[entry.stamp - 1] = payload;     // keep the buffer, the next entry gets a new one
+        payload = NULL;
+        capacity = 0;
+    }
+
+    LogClock clock = { header.ticks, header.unixNs, header.ticksPerSecond };
+
+    if (status == 0 && fseek(in, sizeof(header), SEEK_SET) != 0)
+    {
+        status = -1;
+    }
+
+    while (status == 0 && (status = internal_log_read_entry(in, &entry, &payload, &capacity)) == 1)
+    {
+        status = 0;
+        u64 size = entry.size - sizeof(entry);
+
+        if (entry.id == LOG_BINARY_ID_FORMAT)
+        {
+            continue;
+        }
+
+
+        if (entry.id == LOG_BINARY_ID_CLOCK)
+        {
+            if (size >= sizeof(u64))
+            {
+                clock.ticks = entry.stamp;
+                memcpy(&clock.unixNs, payload, sizeof(u64));
+            }
+
+            continue;
+        }
+
+        if (!size)
+        {
+            status = -1;
+            break;
+        }
+
+        char prefix[LOG_KV_HEAD_SIZE];
+        double offset = (double)(i64)(entry.stamp - clock.ticks) * LOG_NS_PER_SECOND / (double)clock.ticksPerSecond;
+        u64 unixNs = (u64)((i64)clock.unixNs + (i64)offset);
+
+        if (entry.id == LOG_BINARY_ID_JSON)
+        {
+            fwrite(prefix, 1, internal_log_kv_head(prefix, (LogLevel)(u8)payload[0], unixNs), out);
+            fwrite(payload + 1, 1, size - 1, out);
+            fputc('\n', out);
+            continue;
+        }
+
+        fwrite(prefix, 1, internal_log_prefix(prefix, (LogLevel)(u8)payload[0], unixNs), out);
+
+        if (entry.id == LOG_BINARY_ID_TEXT)
+        {
+            fputs(payload + 1, out);
+        }
+        else if (entry.id > formatCount || !formats[entry.id - 1] ||
+                 !internal_log_print_message(out, formats[entry.id - 1], payload + 1, payload + size))
+        {
+            fprintf(out, " (undecodable entry, format %u)", entry.id);
+        }
+
+        fputc('\n', out);
+    }
+
+    for (u64 i = 0; i < formatCount; i++)
+    {
+        free(formats[i]);
+    }
+
+    free(formats);
+    free(payload);
+    fclose(in);
+
+    return status == 0 ? 0 : -1;
 }
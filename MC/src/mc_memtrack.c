@@ -0,0 +1,320 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_memtrack.c                                                                          */
+/* \brief: Provide opt in accounting of every allocation made by MC                              */
+/*                                                                                               */
+/* \Expects: mc_memtrack.h is linked properly and defines interface                              */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#include "mc_memtrack.h"
+#include <stdlib.h>     // calloc, free
+#include <stdio.h>      // printf
+#include <stdatomic.h>  // atomic_fetch_add
+#include <threads.h>    // tss_t, call_once
+
+/**
+ * \brief A thread publishes its batch after this many operations.
+ */
+#define MEMTRACK_BATCH_OPS 64
+
+/**
+ * \brief A thread publishes its batch once a module's pending bytes reach this much either way.
+ */
+#define MEMTRACK_BATCH_BYTES (64 * 1024)
+
+/**
+ * \brief MemTrackCounters are the shared counters of one module.
+ */
+typedef struct MemTrackCounters
+{
+    atomic_uint_fast64_t liveBytes;     // \brief Wraps below zero while a free is published ahead of its allocation
+    atomic_uint_fast64_t peakBytes;
+    atomic_uint_fast64_t allocCount;
+    atomic_uint_fast64_t freeCount;
+} MemTrackCounters;
+
+/**
+ * \brief MemTrackBatch holds one thread's counts not yet published to the shared counters.
+ */
+typedef struct MemTrackBatch
+{
+    i64 bytes[MC_MEM_MODULE_COUNT];     // \brief Bytes allocated minus bytes freed
+    u64 allocs[MC_MEM_MODULE_COUNT];
+    u64 frees[MC_MEM_MODULE_COUNT];
+    u64 ops;                            // \brief Operations since the last publish
+} MemTrackBatch;
+
+static const char *memtrack_module_names[MC_MEM_MODULE_COUNT] =
+{
+    "hash", "stack", "guid", "arena", "pool", "workdeque", "spscring", "mpmcqueue", "guidmap", "histogram"
+};
+
+static MemTrackCounters memtrack_modules[MC_MEM_MODULE_COUNT];
+static tss_t memtrack_batch_key;
+static u8 memtrack_batch_ready;
+static once_flag memtrack_once = ONCE_FLAG_INIT;
+
+/**
+ * \brief Add one module's pending counts to its shared counters, and raise the peak.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static void internal_memtrack_publish(MC_MemModule module, i64 bytes, u64 allocs, u64 frees)
+{
+    MemTrackCounters *counters = &memtrack_modules[module];
+    u64 live = (u64)atomic_fetch_add_explicit(&counters->liveBytes, (u64)bytes, memory_order_relaxed) + (u64)bytes;
+    u64 peak = atomic_load_explicit(&counters->peakBytes, memory_order_relaxed);
+
+    while ((i64)live > 0 && live > peak &&
+           !atomic_compare_exchange_weak_explicit(&counters->peakBytes, &peak, live, memory_order_relaxed, memory_order_relaxed))
+    {
+    }
+
+    atomic_fetch_add_explicit(&counters->allocCount, allocs, memory_order_relaxed);
+    atomic_fetch_add_explicit(&counters->freeCount, frees, memory_order_relaxed);
+}
+
+/**
+ * \brief Publish and clear every module of a batch.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static void internal_memtrack_flush_batch(MemTrackBatch *batch)
+{
+    for (u64 i = 0; i < MC_MEM_MODULE_COUNT; i++)
+    {
+        if (batch->bytes[i] || batch->allocs[i] || batch->frees[i])
+        {
+            internal_memtrack_publish((MC_MemModule)i, batch->bytes[i], batch->allocs[i], batch->frees[i]);
+
+            batch->bytes[i] = 0;
+            batch->allocs[i] = 0;
+            batch->frees[i] = 0;
+        }
+    }
+
+    batch->ops = 0;
+}
+
+/**
+ * \brief Runs when a thread exits, so that its last counts are not lost.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static void internal_memtrack_batch_destroy(void *arg)
+{
+    internal_memtrack_flush_batch((MemTrackBatch*)arg);
+    free(arg);
+}
+
+static void internal_memtrack_init(void)
+{
+    memtrack_batch_ready = tss_create(&memtrack_batch_key, internal_memtrack_batch_destroy) == thrd_success;
+}
+
+/**
+ * \brief Get the calling thread's batch, creating it on first use. NULL if there is none to be had.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static MemTrackBatch* internal_memtrack_batch(void)
+{
+    call_once(&memtrack_once, internal_memtrack_init);
+
+    if (!memtrack_batch_ready)
+    {
+        return NULL;
+    }
+
+    MemTrackBatch *batch = (MemTrackBatch*)tss_get(memtrack_batch_key);
+
+    if (batch)
+    {
+        return batch;
+    }
+
+    batch = (MemTrackBatch*)calloc(1, sizeof(MemTrackBatch));
+
+    if (batch && tss_set(memtrack_batch_key, batch) != thrd_success)
+    {
+        free(batch);
+        batch = NULL;
+    }
+
+    return batch;
+}
+
+/**
+ * \brief Count one operation against the calling thread's batch, publishing straight away without one.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static void internal_memtrack_record(MC_MemModule module, i64 bytes, u64 allocs, u64 frees)
+{
+    MemTrackBatch *batch = internal_memtrack_batch();
+
+    if (!batch)
+    {
+        internal_memtrack_publish(module, bytes, allocs, frees);
+
+        return;
+    }
+
+    batch->bytes[module] += bytes;
+    batch->allocs[module] += allocs;
+    batch->frees[module] += frees;
+
+    if (++batch->ops >= MEMTRACK_BATCH_OPS ||
+        batch->bytes[module] >= MEMTRACK_BATCH_BYTES || batch->bytes[module] <= -MEMTRACK_BATCH_BYTES)
+    {
+        internal_memtrack_flush_batch(batch);
+    }
+}
+
+u8 MC_MemTrack_IsEnabled(void)
+{
+#if defined(MC_ALLOC_TRACKING)
+    return true;
+#else
+    return false;
+#endif
+}
+
+void MC_MemTrack_Alloc(MC_MemModule module, MC_MemStats *instance, u64 size)
+{
+    if ((u64)module >= MC_MEM_MODULE_COUNT && module != MC_MEM_MODULE_NONE)
+    {
+        return;
+    }
+
+    if (instance)
+    {
+        instance->liveBytes += size;
+        instance->allocCount++;
+
+        if (instance->liveBytes > instance->peakBytes)
+        {
+            instance->peakBytes = instance->liveBytes;
+        }
+    }
+
+    if (module != MC_MEM_MODULE_NONE)
+    {
+        internal_memtrack_record(module, (i64)size, 1, 0);
+    }
+}
+
+void MC_MemTrack_Free(MC_MemModule module, MC_MemStats *instance, u64 size)
+{
+    if ((u64)module >= MC_MEM_MODULE_COUNT && module != MC_MEM_MODULE_NONE)
+    {
+        return;
+    }
+
+    if (instance)
+    {
+        instance->liveBytes -= size < instance->liveBytes ? size : instance->liveBytes;
+        instance->freeCount++;
+    }
+
+    if (module != MC_MEM_MODULE_NONE)
+    {
+        internal_memtrack_record(module, -(i64)size, 0, 1);
+    }
+}
+
+void MC_MemTrack_Flush(void)
+{
+    MemTrackBatch *batch = internal_memtrack_batch();
+
+    if (batch)
+    {
+        internal_memtrack_flush_batch(batch);
+    }
+}
+
+u8 MC_MemTrack_Module(MC_MemModule module, MC_MemStats *stats)
+{
+    if (!stats || (u64)module >= MC_MEM_MODULE_COUNT)
+    {
+        return false;
+    }
+
+    stats->liveBytes = 0;
+    stats->peakBytes = 0;
+    stats->allocCount = 0;
+    stats->freeCount = 0;
+
+    if (!MC_MemTrack_IsEnabled())
+    {
+        return false;
+    }
+
+    MC_MemTrack_Flush();
+
+    MemTrackCounters *counters = &memtrack_modules[module];
+    u64 live = atomic_load_explicit(&counters->liveBytes, memory_order_relaxed);
+
+    stats->liveBytes = (i64)live > 0 ? live : 0;
+    stats->peakBytes = atomic_load_explicit(&counters->peakBytes, memory_order_relaxed);
+    stats->allocCount = atomic_load_explicit(&counters->allocCount, memory_order_relaxed);
+    stats->freeCount = atomic_load_explicit(&counters->freeCount, memory_order_relaxed);
+
+    return true;
+}
+
+const char* MC_MemTrack_ModuleName(MC_MemModule module)
+{
+    if ((u64)module >= MC_MEM_MODULE_COUNT)
+    {
+        return "unknown";
+    }
+
+    return memtrack_module_names[module];
+}
+
+void MC_MemTrack_PrintSummary(void)
+{
+    if (!MC_MemTrack_IsEnabled())
+    {
+        printf("Memory tracking is disabled, build with MC_ALLOC_TRACKING\n");
+
+        return;
+    }
+
+    printf("%-10s %14s %14s %12s %12s\n", "module", "live bytes", "peak bytes", "allocs", "frees");
+
+    for (u64 i = 0; i < MC_MEM_MODULE_COUNT; i++)
+    {
+        MC_MemStats stats;
+
+        MC_MemTrack_Module((MC_MemModule)i, &stats);
+
+        printf("%-10s %14llu %14llu %12llu %12llu\n", memtrack_module_names[i],
+            (unsigned long long)stats.liveBytes, (unsigned long long)stats.peakBytes,
+            (unsigned long long)stats.allocCount, (unsigned long long)stats.freeCount);
+    }
+}
+
+u64 MC_MemTrack_ReportLeaks(void)
+{
+    u64 leaked = 0;
+
+    for (u64 i = 0; i < MC_MEM_MODULE_COUNT; i++)
+    {
+        MC_MemStats stats;
+
+        if (MC_MemTrack_Module((MC_MemModule)i, &stats) && (stats.liveBytes || stats.allocCount != stats.freeCount))
+        {
+            printf("Leak in %s: %llu bytes live, %llu allocations not freed\n", memtrack_module_names[i],
+                (unsigned long long)stats.liveBytes,
+                (unsigned long long)(stats.allocCount - stats.freeCount));
+
+            leaked += stats.liveBytes;
+        }
+    }
+
+    return leaked;
+}
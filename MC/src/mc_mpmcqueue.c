@@ -0,0 +1,394 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_mpmcqueue.c                                                                         */
+/* \brief: Provide a bounded multi producer, multi consumer queue                                */
+/*                                                                                               */
+/* \Expects: mc_mpmcqueue.h is linked properly and defines interface                             */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#include "mc_mpmcqueue.h"
+#include "mc_memtrack.h"
+#include <stdlib.h>     // malloc
+#include <string.h>     // memcpy
+#include <stdatomic.h>  // atomic_*
+
+#if defined(__linux__)
+#include <limits.h>         // INT_MAX
+#include <unistd.h>         // syscall
+#include <sys/syscall.h>    // SYS_futex
+#include <linux/futex.h>    // FUTEX_WAIT_PRIVATE
+#elif defined(_WIN32)
+#include <windows.h>        // WaitOnAddress, links Synchronization.lib
+#else
+#include <threads.h>        // thrd_yield
+#endif
+
+/**
+ * \brief MpmcSlot header, the element bytes follow it directly in memory.
+ * \details A slot at position pos is free for the producer of pos when sequence == pos, and holds
+ * the element of pos for its consumer when sequence == pos + 1. The consumer then hands it to
+ * the producer of the next lap by setting sequence = pos + capacity.
+ */
+typedef struct MpmcSlot
+{
+    atomic_uint_fast64_t sequence;
+} MpmcSlot;
+
+/**
+ * \brief MpmcQueue Data type: the claim positions and the futex words each get their own cache line.
+ * \details Explicit padding is used rather than alignas so that malloc is sufficient.
+ */
+struct MC_MpmcQueue
+{
+    u8 *slots;                          // \brief capacity slots of stride bytes each
+    u64 mask;                           // \brief capacity - 1, capacity is always a power of two
+    u64 elemSize;                       // \brief Size of one element in bytes
+    u64 stride;                         // \brief Size of one slot header plus element, 8 byte aligned
+    u8 padShared[MC_CACHE_LINE_SIZE];
+
+    atomic_uint_fast64_t enqueuePos;    // \brief Next position a producer will claim
+    u8 padEnqueue[MC_CACHE_LINE_SIZE - sizeof(atomic_uint_fast64_t)];
+
+    atomic_uint_fast64_t dequeuePos;    // \brief Next position a consumer will claim
+    u8 padDequeue[MC_CACHE_LINE_SIZE - sizeof(atomic_uint_fast64_t)];
+
+    atomic_uint notFull;                // \brief Futex word, bumped when a slot frees up and producers sleep
+    atomic_uint notFullWaiters;         // \brief Number of producers sleeping, or about to
+    atomic_uint notEmpty;               // \brief Futex word, bumped when an element arrives and consumers sleep
+    atomic_uint notEmptyWaiters;        // \brief Number of consumers sleeping, or about to
+    atomic_bool closed;                 // \brief Set by MC_MpmcQueue_Close
+};
+
+/**
+ * \brief Sleep until *address no longer holds expected, or a spurious wake up.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static void internal_futex_wait(atomic_uint *address, u32 expected)
+{
+#if defined(__linux__)
+    syscall(SYS_futex, (u32*)address, FUTEX_WAIT_PRIVATE, expected, NULL, NULL, 0);
+#elif defined(_WIN32)
+    WaitOnAddress((volatile VOID*)address, &expected, sizeof(expected), INFINITE);
+#else
+    (void)address;
+    (void)expected;
+    thrd_yield();
+#endif
+}
+
+/**
+ * \brief Wake every thread sleeping on address.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static void internal_futex_wake(atomic_uint *address)
+{
+#if defined(__linux__)
+    syscall(SYS_futex, (u32*)address, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+#elif defined(_WIN32)
+    WakeByAddressAll((PVOID)address);
+#else
+    (void)address;
+#endif
+}
+
+/**
+ * \brief Wake the sleepers of one side, but only pay for the syscall if somebody is sleeping.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * The seq_cst fence pairs with the waiter's seq_cst increment of waiters: either we see the
+ * waiter and wake it, or the waiter's re-check after its increment sees our published slot.
+ */
+static void internal_mpmcqueue_notify(atomic_uint *event, atomic_uint *waiters)
+{
+    atomic_thread_fence(memory_order_seq_cst);
+
+    if (atomic_load_explicit(waiters, memory_order_relaxed) > 0)
+    {
+        atomic_fetch_add_explicit(event, 1, memory_order_release);
+        internal_futex_wake(event);
+    }
+}
+
+static MpmcSlot* internal_mpmcqueue_slot(const MC_MpmcQueue *queue, u64 position)
+{
+    return (MpmcSlot*)(queue->slots + (position & queue->mask) * queue->stride);
+}
+
+MC_MpmcQueue* MC_MpmcQueue_Init(u64 capacity, u64 elem_size)
+{
+    if (elem_size == 0 || elem_size > U64_MAX / 2)
+    {
+        return NULL;
+    }
+
+    u64 rounded = 2;
+
+    while (rounded < capacity)
+    {
+        if (rounded > U64_MAX / 2)
+        {
+            return NULL;
+        }
+
+        rounded *= 2;
+    }
+
+    u64 stride = sizeof(MpmcSlot) + ((elem_size + 7) & ~(u64)7);
+
+    if (rounded > U64_MAX / stride)
+    {
+        return NULL;
+    }
+
+    MC_MpmcQueue *queue = (MC_MpmcQueue*)malloc(sizeof(MC_MpmcQueue));
+
+    if (!queue)
+    {
+        return NULL;
+    }
+
+    queue->slots = (u8*)malloc(rounded * stride);
+
+    if (!queue->slots)
+    {
+        free(queue);
+
+        return NULL;
+    }
+
+    MC_MEMTRACK_ALLOC(MC_MEM_MODULE_MPMCQUEUE, NULL, sizeof(MC_MpmcQueue));
+    MC_MEMTRACK_ALLOC(MC_MEM_MODULE_MPMCQUEUE, NULL, rounded * stride);
+
+    queue->mask = rounded - 1;
+    queue->elemSize = elem_size;
+    queue->stride = stride;
+
+    for (u64 i = 0; i < rounded; i++)
+    {
+        atomic_init(&internal_mpmcqueue_slot(queue, i)->sequence, i);
+    }
+
+    atomic_init(&queue->enqueuePos, 0);
+    atomic_init(&queue->dequeuePos, 0);
+    atomic_init(&queue->notFull, 0);
+    atomic_init(&queue->notFullWaiters, 0);
+    atomic_init(&queue->notEmpty, 0);
+    atomic_init(&queue->notEmptyWaiters, 0);
+    atomic_init(&queue->closed, false);
+
+    return queue;
+}
+
+u8 MC_MpmcQueue_TryEnqueue(MC_MpmcQueue* queue, const void* value)
+{
+    if (!queue || !value || atomic_load_explicit(&queue->closed, memory_order_relaxed))
+    {
+        return false;
+    }
+
+    u64 position = atomic_load_explicit(&queue->enqueuePos, memory_order_relaxed);
+    MpmcSlot *slot;
+
+    for (;;)
+    {
+        slot = internal_mpmcqueue_slot(queue, position);
+        u64 sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        i64 difference = (i64)(sequence - position);
+
+        if (difference == 0)
+        {
+            if (atomic_compare_exchange_weak_explicit(&queue->enqueuePos, &position, position + 1,
+                                                      memory_order_relaxed, memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (difference < 0)
+        {
+            return false;   // the slot still holds last lap's element: full
+        }
+        else
+        {
+            position = atomic_load_explicit(&queue->enqueuePos, memory_order_relaxed);
+        }
+    }
+
+    memcpy((u8*)slot + sizeof(MpmcSlot), value, queue->elemSize);
+    atomic_store_explicit(&slot->sequence, position + 1, memory_order_release);
+
+    internal_mpmcqueue_notify(&queue->notEmpty, &queue->notEmptyWaiters);
+
+    return true;
+}
+
+u8 MC_MpmcQueue_TryDequeue(MC_MpmcQueue* queue, void* out)
+{
+    if (!queue || !out)
+    {
+        return false;
+    }
+
+    u64 position = atomic_load_explicit(&queue->dequeuePos, memory_order_relaxed);
+    MpmcSlot *slot;
+
+    for (;;)
+    {
+        slot = internal_mpmcqueue_slot(queue, position);
+        u64 sequence = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+        i64 difference = (i64)(sequence - (position + 1));
+
+        if (difference == 0)
+        {
+            if (atomic_compare_exchange_weak_explicit(&queue->dequeuePos, &position, position + 1,
+                                                      memory_order_relaxed, memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        else if (difference < 0)
+        {
+            return false;   // the slot was not written yet: empty
+        }
+        else
+        {
+            position = atomic_load_explicit(&queue->dequeuePos, memory_order_relaxed);
+        }
+    }
+
+    memcpy(out, (u8*)slot + sizeof(MpmcSlot), queue->elemSize);
+    atomic_store_explicit(&slot->sequence, position + queue->mask + 1, memory_order_release);
+
+    internal_mpmcqueue_notify(&queue->notFull, &queue->notFullWaiters);
+
+    return true;
+}
+
+u8 MC_MpmcQueue_Enqueue(MC_MpmcQueue* queue, const void* value)
+{
+    if (!queue || !value)
+    {
+        return false;
+    }
+
+    while (!MC_MpmcQueue_TryEnqueue(queue, value))
+    {
+        /* Announce ourselves, snapshot the futex word, then re-check before sleeping on it */
+        atomic_fetch_add_explicit(&queue->notFullWaiters, 1, memory_order_seq_cst);
+        u32 event = atomic_load_explicit(&queue->notFull, memory_order_acquire);
+
+        if (atomic_load_explicit(&queue->closed, memory_order_acquire))
+        {
+            atomic_fetch_sub_explicit(&queue->notFullWaiters, 1, memory_order_relaxed);
+
+            return false;
+        }
+
+        if (MC_MpmcQueue_TryEnqueue(queue, value))
+        {
+            atomic_fetch_sub_explicit(&queue->notFullWaiters, 1, memory_order_relaxed);
+
+            return true;
+        }
+
+        internal_futex_wait(&queue->notFull, event);
+        atomic_fetch_sub_explicit(&queue->notFullWaiters, 1, memory_order_relaxed);
+    }
+
+    return true;
+}
+
+u8 MC_MpmcQueue_Dequeue(MC_MpmcQueue* queue, void* out)
+{
+    if (!queue || !out)
+    {
+        return false;
+    }
+
+    while (!MC_MpmcQueue_TryDequeue(queue, out))
+    {
+        atomic_fetch_add_explicit(&queue->notEmptyWaiters, 1, memory_order_seq_cst);
+        u32 event = atomic_load_explicit(&queue->notEmpty, memory_order_acquire);
+
+        if (MC_MpmcQueue_TryDequeue(queue, out))
+        {
+            atomic_fetch_sub_explicit(&queue->notEmptyWaiters, 1, memory_order_relaxed);
+
+            return true;
+        }
+
+        if (atomic_load_explicit(&queue->closed, memory_order_acquire))
+        {
+            atomic_fetch_sub_explicit(&queue->notEmptyWaiters, 1, memory_order_relaxed);
+
+            return false;   // closed and drained
+        }
+
+        internal_futex_wait(&queue->notEmpty, event);
+        atomic_fetch_sub_explicit(&queue->notEmptyWaiters, 1, memory_order_relaxed);
+    }
+
+    return true;
+}
+
+void MC_MpmcQueue_Close(MC_MpmcQueue* queue)
+{
+    if (!queue)
+    {
+        return;
+    }
+
+    atomic_store_explicit(&queue->closed, true, memory_order_seq_cst);
+
+    atomic_fetch_add_explicit(&queue->notFull, 1, memory_order_release);
+    atomic_fetch_add_explicit(&queue->notEmpty, 1, memory_order_release);
+    internal_futex_wake(&queue->notFull);
+    internal_futex_wake(&queue->notEmpty);
+}
+
+u8 MC_MpmcQueue_IsEmpty(const MC_MpmcQueue* queue)
+{
+    return MC_MpmcQueue_Size(queue) == 0;
+}
+
+u64 MC_MpmcQueue_Size(const MC_MpmcQueue* queue)
+{
+    if (!queue)
+    {
+        return 0;
+    }
+
+    MC_MpmcQueue *shared = (MC_MpmcQueue*)queue;
+    u64 dequeued = atomic_load_explicit(&shared->dequeuePos, memory_order_acquire);
+    u64 enqueued = atomic_load_explicit(&shared->enqueuePos, memory_order_acquire);
+
+    return enqueued > dequeued ? enqueued - dequeued : 0;
+}
+
+u64 MC_MpmcQueue_Capacity(const MC_MpmcQueue* queue)
+{
+    if (!queue)
+    {
+        return 0;
+    }
+
+    return queue->mask + 1;
+}
+
+void MC_MpmcQueue_Free(MC_MpmcQueue** queue)
+{
+    if (!queue || !(*queue))
+    {
+        return;
+    }
+
+    MC_MEMTRACK_FREE(MC_MEM_MODULE_MPMCQUEUE, NULL, ((*queue)->mask + 1) * (*queue)->stride);
+    MC_MEMTRACK_FREE(MC_MEM_MODULE_MPMCQUEUE, NULL, sizeof(MC_MpmcQueue));
+    free((*queue)->slots);
+    free(*queue);
+
+    *queue = NULL;
+}
@@ -0,0 +1,271 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_perfcounters.c                                                                      */
+/* \brief: Provide hardware performance counters read around regions of code                     */
+/*                                                                                               */
+/* \Expects: mc_perfcounters.h is linked properly and defines interface                          */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#include "mc_perfcounters.h"
+#include <stdlib.h>     // calloc, free
+#include <string.h>     // memset
+#include <stdio.h>      // printf
+
+#if defined(__linux__)
+#define PERF_LINUX 1
+#include <linux/perf_event.h>   // perf_event_attr, PERF_EVENT_IOC_ENABLE
+#include <sys/ioctl.h>          // ioctl
+#include <sys/syscall.h>        // SYS_perf_event_open
+#include <unistd.h>             // syscall, read, close
+#endif
+
+static const char *perf_event_names[MC_PERF_EVENT_COUNT] =
+{
+    "cycles", "instructions", "cache misses", "branch misses", "page faults", "context switches"
+};
+
+#if defined(PERF_LINUX)
+/**
+ * \brief The perf_event_open type and config of each MC_PerfEvent.
+ */
+static const struct
+{
+    u32 type;
+    u64 config;
+} perf_event_configs[MC_PERF_EVENT_COUNT] =
+{
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+    { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS },
+    { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES }
+};
+
+/**
+ * \brief What a read of the group leader returns with PERF_FORMAT_GROUP and both times.
+ */
+typedef struct PerfGroupRead
+{
+    u64 count;                          // \brief Counters in the group
+    u64 enabledNs;                      // \brief Time the group was enabled
+    u64 runningNs;                      // \brief Time the group was on the PMU, less than enabledNs when multiplexed
+    u64 values[MC_PERF_EVENT_COUNT];    // \brief In the order the counters were opened
+} PerfGroupRead;
+#endif
+
+struct MC_PerfCounters
+{
+    int leader;                         // \brief Descriptor of the first counter opened, which the others follow
+    int fds[MC_PERF_EVENT_COUNT];       // \brief -1 for a counter that is not open
+    u8 order[MC_PERF_EVENT_COUNT];      // \brief The event of each value of a group read
+    u32 count;
+    u32 available;
+};
+
+/**
+ * \brief Read the group's counts into sample, scaling them up if the group was multiplexed.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * \returns u8: true/false corresponding to success fail
+ */
+static u8 internal_perf_read(const MC_PerfCounters *counters, MC_PerfSample *sample)
+{
+    memset(sample, 0, sizeof(*sample));
+
+#if defined(PERF_LINUX)
+    PerfGroupRead group;
+    ssize_t size = read(counters->leader, &group, sizeof(group));
+
+    if (size < (ssize_t)(3 * sizeof(u64)) || group.count != counters->count || !group.runningNs)
+    {
+        return false;
+    }
+
+    sample->multiplexed = group.runningNs < group.enabledNs;
+
+    for (u32 i = 0; i < counters->count; i++)
+    {
+        sample->values[counters->order[i]] = sample->multiplexed ?
+            (u64)((double)group.values[i] * (double)group.enabledNs / (double)group.runningNs) : group.values[i];
+    }
+
+    sample->available = counters->available;
+
+    return true;
+#else
+    (void)counters;
+
+    return false;
+#endif
+}
+
+MC_PerfCounters* MC_PerfCounters_Open(void)
+{
+#if defined(PERF_LINUX)
+    MC_PerfCounters *counters = (MC_PerfCounters*)calloc(1, sizeof(MC_PerfCounters));
+
+    if (!counters)
+    {
+        return NULL;
+    }
+
+    counters->leader = -1;
+
+    for (u32 event = 0; event < MC_PERF_EVENT_COUNT; event++)
+    {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+
+        attr.size = sizeof(attr);
+        attr.type = perf_event_configs[event].type;
+        attr.config = perf_event_configs[event].config;
+        attr.disabled = counters->leader < 0;   // the others start and stop with the leader
+        attr.exclude_kernel = 1;                // all perf_event_paranoid 2 allows
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        counters->fds[event] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, counters->leader, PERF_FLAG_FD_CLOEXEC);
+
+        if (counters->fds[event] < 0)
+        {
+            continue;   // refused or not supported, measured without it
+        }
+
+        if (counters->leader < 0)
+        {
+            counters->leader = counters->fds[event];
+        }
+
+        counters->order[counters->count++] = (u8)event;
+        counters->available |= 1u << event;
+    }
+
+    if (!counters->count)
+    {
+        free(counters);
+
+        return NULL;
+    }
+
+    return counters;
+#else
+    return NULL;
+#endif
+}
+
+u32 MC_PerfCounters_Available(const MC_PerfCounters *counters)
+{
+    return counters ? counters->available : 0;
+}
+
+u8 MC_PerfCounters_Start(MC_PerfCounters *counters)
+{
+#if defined(PERF_LINUX)
+    if (!counters)
+    {
+        return false;
+    }
+
+    return ioctl(counters->leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP) == 0 &&
+           ioctl(counters->leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP) == 0;
+#else
+    (void)counters;
+
+    return false;
+#endif
+}
+
+u8 MC_PerfCounters_Read(MC_PerfCounters *counters, MC_PerfSample *sample)
+{
+    if (!sample)
+    {
+        return false;
+    }
+
+    if (!counters)
+    {
+        memset(sample, 0, sizeof(*sample));
+
+        return false;
+    }
+
+    return internal_perf_read(counters, sample);
+}
+
+u8 MC_PerfCounters_Stop(MC_PerfCounters *counters, MC_PerfSample *sample)
+{
+#if defined(PERF_LINUX)
+    u8 stopped = counters && ioctl(counters->leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP) == 0;
+#else
+    u8 stopped = false;
+#endif
+
+    if (!sample)
+    {
+        return stopped;
+    }
+
+    return MC_PerfCounters_Read(counters, sample) && stopped;
+}
+
+void MC_PerfCounters_Close(MC_PerfCounters **counters)
+{
+    if (!counters || !(*counters))
+    {
+        return;
+    }
+
+#if defined(PERF_LINUX)
+    for (u32 event = 0; event < MC_PERF_EVENT_COUNT; event++)
+    {
+        if ((*counters)->fds[event] >= 0)
+        {
+            close((*counters)->fds[event]);
+        }
+    }
+#endif
+
+    free(*counters);
+    *counters = NULL;
+}
+
+const char* MC_PerfCounters_EventName(MC_PerfEvent event)
+{
+    return (u32)event < MC_PERF_EVENT_COUNT ? perf_event_names[event] : "unknown";
+}
+
+void MC_PerfCounters_PrintPerOp(const MC_PerfSample *sample, u64 ops)
+{
+    if (!sample || !sample->available)
+    {
+        return;
+    }
+
+    const u32 ipc = (1u << MC_PERF_CYCLES) | (1u << MC_PERF_INSTRUCTIONS);
+    double divisor = (double)(ops ? ops : 1);
+
+    const char *separator = " ";
+
+    printf("\t[PERF]:");
+
+    if ((sample->available & ipc) == ipc)
+    {
+        printf(" IPC %.2f", (double)sample->values[MC_PERF_INSTRUCTIONS] /
+                            (double)(sample->values[MC_PERF_CYCLES] ? sample->values[MC_PERF_CYCLES] : 1));
+        separator = ", ";
+    }
+
+    for (u32 event = 0; event < MC_PERF_EVENT_COUNT; event++)
+    {
+        if (sample->available & (1u << event))
+        {
+            printf("%s%.3f %s/op", separator, (double)sample->values[event] / divisor, perf_event_names[event]);
+            separator = ", ";
+        }
+    }
+
+    printf("%s\n", sample->multiplexed ? " (multiplexed)" : "");
+}
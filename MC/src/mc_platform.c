@@ -0,0 +1,70 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_platform.c                                                                          */
+/* \brief: Provide the C runtime calls whose safe forms differ between Windows and POSIX         */
+/*                                                                                               */
+/* \Expects: mc_platform.h is linked properly and defines interface                              */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#include "mc_platform.h"
+#include <string.h>     // strdup
+#include <errno.h>      // errno, EINVAL
+
+int MC_FOpen(FILE **stream, const char *path, const char *mode)
+{
+    if (!stream)
+    {
+        return EINVAL;
+    }
+
+#if defined(_WIN32)
+    return fopen_s(stream, path, mode);
+#else
+    *stream = NULL;
+
+    if (!path || !mode)
+    {
+        return EINVAL;
+    }
+
+    errno = 0;
+    *stream = fopen(path, mode);
+
+    if (!(*stream))
+    {
+        return errno ? errno : EINVAL;
+    }
+
+    return 0;
+#endif
+}
+
+u8 MC_LocalTime(const time_t *time, struct tm *result)
+{
+    if (!time || !result)
+    {
+        return false;
+    }
+
+#if defined(_WIN32)
+    return localtime_s(result, time) == 0;
+#else
+    return localtime_r(time, result) != NULL;
+#endif
+}
+
+char* MC_StrDup(const char *str)
+{
+    if (!str)
+    {
+        return NULL;
+    }
+
+#if defined(_WIN32)
+    return _strdup(str);
+#else
+    return strdup(str);
+#endif
+}
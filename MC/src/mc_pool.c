@@ -0,0 +1,598 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_pool.c                                                                              */
+/* \brief: Provide a fixed size object pool allocator                                            */
+/*                                                                                               */
+/* \Expects: mc_pool.h is linked properly and defines interface                                  */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#include "mc_pool.h"
+#include <stdlib.h>     // aligned_alloc, calloc
+#include <string.h>     // memset
+#include <threads.h>    // mtx_t, tss_t
+
+#if defined(_WIN32)
+#include <malloc.h>     // _aligned_malloc
+#endif
+
+/**
+ * \brief Alignment of every object, matching what malloc guarantees on 64 bit targets.
+ */
+#define POOL_ALIGNMENT 16
+
+/**
+ * \brief The least number of objects a slab holds, larger objects get larger slabs.
+ */
+#define POOL_MIN_OBJECTS_PER_SLAB 8
+
+/**
+ * \brief The number of free objects a thread caches per Pool.
+ */
+#define POOL_MAGAZINE_SIZE 64
+
+/**
+ * \brief The number of objects moved between a magazine and the Pool under a single lock.
+ */
+#define POOL_MAGAZINE_BATCH (POOL_MAGAZINE_SIZE / 2)
+
+/**
+ * \brief PoolSlab is the header at the start of every slab, the objects follow it.
+ * \details Slabs are aligned to their own size, so the slab of any object is found by masking its address.
+ */
+typedef struct PoolSlab
+{
+    struct PoolSlab *next;      // \brief Next slab in the list of all slabs
+    struct PoolSlab *prev;      // \brief Previous slab in the list of all slabs
+    struct PoolSlab *nextFree;  // \brief Next slab in the list of slabs with free objects
+    struct PoolSlab *prevFree;  // \brief Previous slab in the list of slabs with free objects
+    void *freeList;             // \brief Intrusive list of free objects, each one stores the next in its first bytes
+    u64 freeCount;              // \brief Number of objects on freeList
+} PoolSlab;
+
+/**
+ * \brief PoolMagazine is one thread's cache of free objects for one Pool.
+ */
+typedef struct PoolMagazine
+{
+    MC_Pool *pool;                      // \brief The Pool the cached objects belong to
+    struct PoolMagazine *next;          // \brief Next magazine of the same Pool
+    struct PoolMagazine *prev;          // \brief Previous magazine of the same Pool
+    u64 count;                          // \brief Number of cached objects
+    void *items[POOL_MAGAZINE_SIZE];    // \brief The cached objects
+} PoolMagazine;
+
+/**
+ * \brief Pool Data type: slabs and their free lists are shared under one lock, magazines are per thread.
+ */
+struct MC_Pool
+{
+    mtx_t lock;                 // \brief Guards every field below except the sizes
+    tss_t magazineKey;          // \brief The calling thread's PoolMagazine for this Pool
+    PoolSlab *slabs;            // \brief Every slab held from the system
+    PoolSlab *partial;          // \brief Slabs with at least one free object, allocation takes from the head
+    PoolMagazine *magazines;    // \brief Every magazine, so that Free can release them
+    u64 objectSize;             // \brief Size of one object, rounded up to POOL_ALIGNMENT
+    u64 slabSize;               // \brief Size and alignment of one slab
+    u64 headerSize;             // \brief Size of the PoolSlab header, rounded up to POOL_ALIGNMENT
+    u64 objectsPerSlab;         // \brief Number of objects in one slab
+    u64 slabCount;              // \brief Number of slabs held from the system
+    u64 emptySlabs;             // \brief Number of slabs whose objects are all free
+    u64 maxEmptySlabs;          // \brief Number of empty slabs kept before releasing them
+#if defined(MC_ALLOC_TRACKING)
+    MC_MemStats memStats;       // \brief Bytes of slabs held from the system
+    MC_MemModule memModule;     // \brief MC_MEM_MODULE_POOL, MC_MEM_MODULE_NONE for a Pool kept for the process lifetime
+#endif
+};
+
+static u64 internal_pool_round_up(u64 value)
+{
+    return (value + POOL_ALIGNMENT - 1) & ~(u64)(POOL_ALIGNMENT - 1);
+}
+
+static void* internal_pool_aligned_alloc(u64 size)
+{
+#if defined(_WIN32)
+    return _aligned_malloc(size, size);
+#else
+    return aligned_alloc(size, size);
+#endif
+}
+
+static void internal_pool_aligned_free(void *memory)
+{
+#if defined(_WIN32)
+    _aligned_free(memory);
+#else
+    free(memory);
+#endif
+}
+
+static PoolSlab* internal_pool_slab_of(const MC_Pool *pool, void *object)
+{
+    return (PoolSlab*)((uintptr_t)object & ~(uintptr_t)(pool->slabSize - 1));
+}
+
+static void internal_pool_link_partial(MC_Pool *pool, PoolSlab *slab)
+{
+    slab->prevFree = NULL;
+    slab->nextFree = pool->partial;
+
+    if (pool->partial)
+    {
+        pool->partial->prevFree = slab;
+    }
+
+    pool->partial = slab;
+}
+
+static void internal_pool_unlink_partial(MC_Pool *pool, PoolSlab *slab)
+{
+    if (slab->prevFree)
+    {
+        slab->prevFree->nextFree = slab->nextFree;
+    }
+    else
+    {
+        pool->partial = slab->nextFree;
+    }
+
+    if (slab->nextFree)
+    {
+        slab->nextFree->prevFree = slab->prevFree;
+    }
+}
+
+/**
+ * \brief Get a slab from the system and thread all of its objects onto its free list. Lock held.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static PoolSlab* internal_pool_new_slab(MC_Pool *pool)
+{
+    PoolSlab *slab = (PoolSlab*)internal_pool_aligned_alloc(pool->slabSize);
+
+    if (!slab)
+    {
+        return NULL;
+    }
+
+    MC_MEMTRACK_ALLOC(pool->memModule, &pool->memStats, pool->slabSize);
+
+    u8 *objects = (u8*)slab + pool->headerSize;
+    slab->freeList = NULL;
+
+    for (u64 i = pool->objectsPerSlab; i > 0; i--)     // lowest address first out
+    {
+        void **object = (void**)(objects + (i - 1) * pool->objectSize);
+        *object = slab->freeList;
+        slab->freeList = object;
+    }
+
+    slab->freeCount = pool->objectsPerSlab;
+    slab->prev = NULL;
+    slab->next = pool->slabs;
+
+    if (pool->slabs)
+    {
+        pool->slabs->prev = slab;
+    }
+
+    pool->slabs = slab;
+    pool->slabCount++;
+    pool->emptySlabs++;
+    internal_pool_link_partial(pool, slab);
+
+    return slab;
+}
+
+/**
+ * \brief Take up to count free objects out of the slabs. Lock held.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static u64 internal_pool_take(MC_Pool *pool, void **out, u64 count)
+{
+    u64 taken = 0;
+
+    while (taken < count)
+    {
+        PoolSlab *slab = pool->partial ? pool->partial : internal_pool_new_slab(pool);
+
+        if (!slab)
+        {
+            break;
+        }
+
+        if (slab->freeCount == pool->objectsPerSlab)
+        {
+            pool->emptySlabs--;
+        }
+
+        while (taken < count && slab->freeList)
+        {
+            void **object = (void**)slab->freeList;
+            slab->freeList = *object;
+            slab->freeCount--;
+            out[taken++] = object;
+        }
+
+        if (!slab->freeList)
+        {
+            internal_pool_unlink_partial(pool, slab);
+        }
+    }
+
+    return taken;
+}
+
+/**
+ * \brief Put count objects back onto their slabs, releasing slabs past the empty threshold. Lock held.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static void internal_pool_give(MC_Pool *pool, void **objects, u64 count)
+{
+    for (u64 i = 0; i < count; i++)
+    {
+        PoolSlab *slab = internal_pool_slab_of(pool, objects[i]);
+        void **object = (void**)objects[i];
+
+        *object = slab->freeList;
+        slab->freeList = object;
+
+        if (slab->freeCount++ == 0)
+        {
+            internal_pool_link_partial(pool, slab);
+        }
+
+        if (slab->freeCount < pool->objectsPerSlab)
+        {
+            continue;
+        }
+
+        if (pool->emptySlabs < pool->maxEmptySlabs)
+        {
+            pool->emptySlabs++;
+            continue;
+        }
+
+        internal_pool_unlink_partial(pool, slab);
+
+        if (slab->prev)
+        {
+            slab->prev->next = slab->next;
+        }
+        else
+        {
+            pool->slabs = slab->next;
+        }
+
+        if (slab->next)
+        {
+            slab->next->prev = slab->prev;
+        }
+
+        pool->slabCount--;
+        MC_MEMTRACK_FREE(pool->memModule, &pool->memStats, pool->slabSize);
+        internal_pool_aligned_free(slab);
+    }
+}
+
+/**
+ * \brief Runs when a thread exits: hand its cached objects back and drop its magazine.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static void internal_pool_magazine_destroy(void *arg)
+{
+    PoolMagazine *magazine = (PoolMagazine*)arg;
+    MC_Pool *pool = magazine->pool;
+
+    mtx_lock(&pool->lock);
+
+    internal_pool_give(pool, magazine->items, magazine->count);
+
+    if (magazine->prev)
+    {
+        magazine->prev->next = magazine->next;
+    }
+    else
+    {
+        pool->magazines = magazine->next;
+    }
+
+    if (magazine->next)
+    {
+        magazine->next->prev = magazine->prev;
+    }
+
+    mtx_unlock(&pool->lock);
+
+    MC_MEMTRACK_FREE(pool->memModule, NULL, sizeof(PoolMagazine));
+    free(magazine);
+}
+
+/**
+ * \brief Get the calling thread's magazine for the Pool, creating it on first use. NULL if out of memory.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static PoolMagazine* internal_pool_magazine(MC_Pool *pool)
+{
+    PoolMagazine *magazine = (PoolMagazine*)tss_get(pool->magazineKey);
+
+    if (magazine)
+    {
+        return magazine;
+    }
+
+    magazine = (PoolMagazine*)calloc(1, sizeof(PoolMagazine));
+
+    if (!magazine)
+    {
+        return NULL;
+    }
+
+    if (tss_set(pool->magazineKey, magazine) != thrd_success)
+    {
+        free(magazine);
+
+        return NULL;
+    }
+
+    MC_MEMTRACK_ALLOC(pool->memModule, NULL, sizeof(PoolMagazine));
+
+    magazine->pool = pool;
+
+    mtx_lock(&pool->lock);
+
+    magazine->next = pool->magazines;
+
+    if (pool->magazines)
+    {
+        pool->magazines->prev = magazine;
+    }
+
+    pool->magazines = magazine;
+
+    mtx_unlock(&pool->lock);
+
+    return magazine;
+}
+
+/**
+ * \brief Allocate a Pool whose memory is counted under module.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static MC_Pool* internal_pool_init(u64 object_size, u64 max_empty_slabs, MC_MemModule module)
+{
+    if (object_size == 0 || object_size > U64_MAX / 2 / POOL_MIN_OBJECTS_PER_SLAB)
+    {
+        return NULL;
+    }
+
+    MC_Pool *pool = (MC_Pool*)malloc(sizeof(MC_Pool));
+
+    if (!pool)
+    {
+        return NULL;
+    }
+
+    pool->objectSize = internal_pool_round_up(object_size < sizeof(void*) ? sizeof(void*) : object_size);
+    pool->headerSize = internal_pool_round_up(sizeof(PoolSlab));
+    pool->slabSize = MC_POOL_SLAB_SIZE;
+
+    while ((pool->slabSize - pool->headerSize) / pool->objectSize < POOL_MIN_OBJECTS_PER_SLAB)
+    {
+        pool->slabSize *= 2;
+    }
+
+    pool->objectsPerSlab = (pool->slabSize - pool->headerSize) / pool->objectSize;
+    pool->slabs = NULL;
+    pool->partial = NULL;
+    pool->magazines = NULL;
+    pool->slabCount = 0;
+    pool->emptySlabs = 0;
+    pool->maxEmptySlabs = max_empty_slabs;
+
+#if defined(MC_ALLOC_TRACKING)
+    memset(&pool->memStats, 0, sizeof(pool->memStats));
+    pool->memModule = module;
+#endif
+
+    if (mtx_init(&pool->lock, mtx_plain) != thrd_success)
+    {
+        free(pool);
+
+        return NULL;
+    }
+
+    if (tss_create(&pool->magazineKey, internal_pool_magazine_destroy) != thrd_success)
+    {
+        mtx_destroy(&pool->lock);
+        free(pool);
+
+        return NULL;
+    }
+
+    MC_MEMTRACK_ALLOC(module, NULL, sizeof(MC_Pool));
+    (void)module;
+
+    return pool;
+}
+
+MC_Pool* MC_Pool_Init(u64 object_size, u64 max_empty_slabs)
+{
+    return internal_pool_init(object_size, max_empty_slabs, MC_MEM_MODULE_POOL);
+}
+
+MC_Pool* MC_Pool_InitShared(u64 object_size, u64 max_empty_slabs)
+{
+    return internal_pool_init(object_size, max_empty_slabs, MC_MEM_MODULE_NONE);
+}
+
+void* MC_Pool_Alloc(MC_Pool *pool)
+{
+    if (!pool)
+    {
+        return NULL;
+    }
+
+    PoolMagazine *magazine = internal_pool_magazine(pool);
+    void *object = NULL;
+
+    if (!magazine)      // no cache for this thread, go to the slabs directly
+    {
+        mtx_lock(&pool->lock);
+        internal_pool_take(pool, &object, 1);
+        mtx_unlock(&pool->lock);
+
+        return object;
+    }
+
+    if (magazine->count == 0)
+    {
+        mtx_lock(&pool->lock);
+        magazine->count = internal_pool_take(pool, magazine->items, POOL_MAGAZINE_BATCH);
+        mtx_unlock(&pool->lock);
+
+        if (magazine->count == 0)
+        {
+            return NULL;
+        }
+    }
+
+    return magazine->items[--magazine->count];
+}
+
+void MC_Pool_Release(MC_Pool *pool, void *object)
+{
+    if (!pool || !object)
+    {
+        return;
+    }
+
+    PoolMagazine *magazine = internal_pool_magazine(pool);
+
+    if (!magazine)
+    {
+        mtx_lock(&pool->lock);
+        internal_pool_give(pool, &object, 1);
+        mtx_unlock(&pool->lock);
+
+        return;
+    }
+
+    if (magazine->count == POOL_MAGAZINE_SIZE)
+    {
+        mtx_lock(&pool->lock);
+        internal_pool_give(pool, magazine->items + POOL_MAGAZINE_BATCH, POOL_MAGAZINE_SIZE - POOL_MAGAZINE_BATCH);
+        mtx_unlock(&pool->lock);
+
+        magazine->count = POOL_MAGAZINE_BATCH;
+    }
+
+    magazine->items[magazine->count++] = object;
+}
+
+void MC_Pool_Flush(MC_Pool *pool)
+{
+    if (!pool)
+    {
+        return;
+    }
+
+    PoolMagazine *magazine = (PoolMagazine*)tss_get(pool->magazineKey);
+
+    if (!magazine || magazine->count == 0)
+    {
+        return;
+    }
+
+    mtx_lock(&pool->lock);
+    internal_pool_give(pool, magazine->items, magazine->count);
+    mtx_unlock(&pool->lock);
+
+    magazine->count = 0;
+}
+
+u64 MC_Pool_ObjectSize(const MC_Pool *pool)
+{
+    if (!pool)
+    {
+        return 0;
+    }
+
+    return pool->objectSize;
+}
+
+u64 MC_Pool_SlabCount(MC_Pool *pool)
+{
+    if (!pool)
+    {
+        return 0;
+    }
+
+    mtx_lock(&pool->lock);
+    u64 count = pool->slabCount;
+    mtx_unlock(&pool->lock);
+
+    return count;
+}
+
+u8 MC_Pool_MemStats(MC_Pool *pool, MC_MemStats *stats)
+{
+    if (!pool || !stats)
+    {
+        return false;
+    }
+
+#if defined(MC_ALLOC_TRACKING)
+    mtx_lock(&pool->lock);
+    *stats = pool->memStats;
+    mtx_unlock(&pool->lock);
+
+    return true;
+#else
+    memset(stats, 0, sizeof(*stats));
+
+    return false;
+#endif
+}
+
+void MC_Pool_Free(MC_Pool **pool)
+{
+    if (!pool || !(*pool))
+    {
+        return;
+    }
+
+    tss_delete((*pool)->magazineKey);   // no destructor runs for this Pool from here on
+
+    while ((*pool)->magazines)
+    {
+        PoolMagazine *magazine = (*pool)->magazines;
+        (*pool)->magazines = magazine->next;
+
+        MC_MEMTRACK_FREE((*pool)->memModule, NULL, sizeof(PoolMagazine));
+        free(magazine);
+    }
+
+    while ((*pool)->slabs)
+    {
+        PoolSlab *slab = (*pool)->slabs;
+        (*pool)->slabs = slab->next;
+
+        MC_MEMTRACK_FREE((*pool)->memModule, NULL, (*pool)->slabSize);
+        internal_pool_aligned_free(slab);
+    }
+
+    MC_MEMTRACK_FREE((*pool)->memModule, NULL, sizeof(MC_Pool));
+    mtx_destroy(&(*pool)->lock);
+    free(*pool);
+
+    *pool = NULL;
+}
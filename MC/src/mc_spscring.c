@@ -0,0 +1,307 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_spscring.c                                                                          */
+/* \brief: Provide a lock-free single producer, single consumer ring buffer                      */
+/*                                                                                               */
+/* \Expects: mc_spscring.h is linked properly and defines interface                              */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#include "mc_spscring.h"
+#include "mc_memtrack.h"
+#include <stdlib.h>     // malloc
+#include <string.h>     // memcpy
+#include <stdatomic.h>  // atomic_*
+
+/**
+ * \brief SpscRing Data type: three cache lines, read-only, producer owned and consumer owned.
+ * \details Positions grow without bound and are mapped onto items with a mask. Each side keeps a
+ * private copy of the other side's position and only reloads the shared one when its copy says
+ * the ring is full (producer) or empty (consumer), so in steady state neither side touches the
+ * other's cache line. Explicit padding is used rather than alignas so that malloc is sufficient.
+ */
+struct MC_SpscRing
+{
+    u8 *items;                          // \brief Element storage, capacity * elemSize bytes
+    u64 mask;                           // \brief capacity - 1, capacity is always a power of two
+    u64 elemSize;                       // \brief Size of one element in bytes
+    u8 padShared[MC_CACHE_LINE_SIZE];
+
+    atomic_uint_fast64_t tail;          // \brief Producer: next position to write
+    u64 cachedHead;                     // \brief Producer: last observed value of head
+    u8 padTail[MC_CACHE_LINE_SIZE - sizeof(atomic_uint_fast64_t) - sizeof(u64)];
+
+    atomic_uint_fast64_t head;          // \brief Consumer: next position to read
+    u64 cachedTail;                     // \brief Consumer: last observed value of tail
+    u8 padHead[MC_CACHE_LINE_SIZE - sizeof(atomic_uint_fast64_t) - sizeof(u64)];
+};
+
+/**
+ * \brief Number of free slots as seen by the producer, refreshing its view of head only when needed.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static u64 internal_spscring_free(MC_SpscRing *ring, u64 tail, u64 wanted)
+{
+    u64 capacity = ring->mask + 1;
+    u64 available = capacity - (tail - ring->cachedHead);
+
+    if (available < wanted)
+    {
+        ring->cachedHead = atomic_load_explicit(&ring->head, memory_order_acquire);
+        available = capacity - (tail - ring->cachedHead);
+    }
+
+    return available;
+}
+
+/**
+ * \brief Number of readable elements as seen by the consumer, refreshing its view of tail only when needed.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static u64 internal_spscring_used(MC_SpscRing *ring, u64 head, u64 wanted)
+{
+    u64 available = ring->cachedTail - head;
+
+    if (available < wanted)
+    {
+        ring->cachedTail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+        available = ring->cachedTail - head;
+    }
+
+    return available;
+}
+
+MC_SpscRing* MC_SpscRing_Init(u64 capacity, u64 elem_size)
+{
+    if (elem_size == 0)
+    {
+        return NULL;
+    }
+
+    u64 rounded = 1;
+
+    while (rounded < capacity)
+    {
+        if (rounded > U64_MAX / 2)
+        {
+            return NULL;
+        }
+
+        rounded *= 2;
+    }
+
+    if (rounded > U64_MAX / elem_size)
+    {
+        return NULL;
+    }
+
+    MC_SpscRing *ring = (MC_SpscRing*)malloc(sizeof(MC_SpscRing));
+
+    if (!ring)
+    {
+        return NULL;
+    }
+
+    ring->items = (u8*)malloc(rounded * elem_size);
+
+    if (!ring->items)
+    {
+        free(ring);
+
+        return NULL;
+    }
+
+    MC_MEMTRACK_ALLOC(MC_MEM_MODULE_SPSCRING, NULL, sizeof(MC_SpscRing));
+    MC_MEMTRACK_ALLOC(MC_MEM_MODULE_SPSCRING, NULL, rounded * elem_size);
+
+    ring->mask = rounded - 1;
+    ring->elemSize = elem_size;
+    ring->cachedHead = 0;
+    ring->cachedTail = 0;
+    atomic_init(&ring->tail, 0);
+    atomic_init(&ring->head, 0);
+
+    return ring;
+}
+
+u8 MC_SpscRing_Enqueue(MC_SpscRing* ring, const void* value)
+{
+    return MC_SpscRing_EnqueueN(ring, value, 1) == 1;
+}
+
+u64 MC_SpscRing_EnqueueN(MC_SpscRing* ring, const void* values, u64 count)
+{
+    if (!ring || !values || count == 0)
+    {
+        return 0;
+    }
+
+    u64 tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    u64 available = internal_spscring_free(ring, tail, count);
+
+    if (count > available)
+    {
+        count = available;
+    }
+
+    /* Copy in at most two runs: up to the end of the storage, then wrapped around to the start */
+    u64 index = tail & ring->mask;
+    u64 first = ring->mask + 1 - index;
+    first = first < count ? first : count;
+
+    memcpy(ring->items + index * ring->elemSize, values, first * ring->elemSize);
+    memcpy(ring->items, (const u8*)values + first * ring->elemSize, (count - first) * ring->elemSize);
+
+    atomic_store_explicit(&ring->tail, tail + count, memory_order_release);
+
+    return count;
+}
+
+u8 MC_SpscRing_Dequeue(MC_SpscRing* ring, void* out)
+{
+    return MC_SpscRing_DequeueN(ring, out, 1) == 1;
+}
+
+u64 MC_SpscRing_DequeueN(MC_SpscRing* ring, void* out, u64 count)
+{
+    if (!ring || !out || count == 0)
+    {
+        return 0;
+    }
+
+    u64 head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    u64 available = internal_spscring_used(ring, head, count);
+
+    if (count > available)
+    {
+        count = available;
+    }
+
+    u64 index = head & ring->mask;
+    u64 first = ring->mask + 1 - index;
+    first = first < count ? first : count;
+
+    memcpy(out, ring->items + index * ring->elemSize, first * ring->elemSize);
+    memcpy((u8*)out + first * ring->elemSize, ring->items, (count - first) * ring->elemSize);
+
+    atomic_store_explicit(&ring->head, head + count, memory_order_release);
+
+    return count;
+}
+
+void* MC_SpscRing_Reserve(MC_SpscRing* ring, u64 count, u64* granted)
+{
+    if (granted)
+    {
+        *granted = 0;
+    }
+
+    if (!ring || !granted || count == 0)
+    {
+        return NULL;
+    }
+
+    u64 tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    u64 index = tail & ring->mask;
+    u64 contiguous = ring->mask + 1 - index;
+    u64 available = internal_spscring_free(ring, tail, count < contiguous ? count : contiguous);
+
+    count = count < available ? count : available;
+    count = count < contiguous ? count : contiguous;
+    *granted = count;
+
+    return count ? ring->items + index * ring->elemSize : NULL;
+}
+
+void MC_SpscRing_Commit(MC_SpscRing* ring, u64 count)
+{
+    if (!ring || count == 0)
+    {
+        return;
+    }
+
+    u64 tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+    atomic_store_explicit(&ring->tail, tail + count, memory_order_release);
+}
+
+const void* MC_SpscRing_Acquire(MC_SpscRing* ring, u64 count, u64* granted)
+{
+    if (granted)
+    {
+        *granted = 0;
+    }
+
+    if (!ring || !granted || count == 0)
+    {
+        return NULL;
+    }
+
+    u64 head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    u64 index = head & ring->mask;
+    u64 contiguous = ring->mask + 1 - index;
+    u64 available = internal_spscring_used(ring, head, count < contiguous ? count : contiguous);
+
+    count = count < available ? count : available;
+    count = count < contiguous ? count : contiguous;
+    *granted = count;
+
+    return count ? ring->items + index * ring->elemSize : NULL;
+}
+
+void MC_SpscRing_Release(MC_SpscRing* ring, u64 count)
+{
+    if (!ring || count == 0)
+    {
+        return;
+    }
+
+    u64 head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+    atomic_store_explicit(&ring->head, head + count, memory_order_release);
+}
+
+u8 MC_SpscRing_IsEmpty(const MC_SpscRing* ring)
+{
+    return MC_SpscRing_Size(ring) == 0;
+}
+
+u64 MC_SpscRing_Size(const MC_SpscRing* ring)
+{
+    if (!ring)
+    {
+        return 0;
+    }
+
+    MC_SpscRing *shared = (MC_SpscRing*)ring;
+    u64 head = atomic_load_explicit(&shared->head, memory_order_acquire);
+    u64 tail = atomic_load_explicit(&shared->tail, memory_order_acquire);
+
+    return tail > head ? tail - head : 0;
+}
+
+u64 MC_SpscRing_Capacity(const MC_SpscRing* ring)
+{
+    if (!ring)
+    {
+        return 0;
+    }
+
+    return ring->mask + 1;
+}
+
+void MC_SpscRing_Free(MC_SpscRing** ring)
+{
+    if (!ring || !(*ring))
+    {
+        return;
+    }
+
+    MC_MEMTRACK_FREE(MC_MEM_MODULE_SPSCRING, NULL, ((*ring)->mask + 1) * (*ring)->elemSize);
+    MC_MEMTRACK_FREE(MC_MEM_MODULE_SPSCRING, NULL, sizeof(MC_SpscRing));
+    free((*ring)->items);
+    free(*ring);
+
+    *ring = NULL;
+}
@@ -8,8 +8,22 @@
 /*                                                                                               */
 /* ********************************************************************************************* */
 
-#include <stdlib.h>
+#include <stdlib.h>     // free
+#include <string.h>     // memcpy, memset
+#include <threads.h>    // call_once
 #include "mc_stack.h"
+#include "mc_pool.h"
+#include "mc_trace.h"
+
+/**
+ * \brief The number of elements a typed Stack reserves on its first push.
+ */
+#define STACK_TYPED_INITIAL_CAPACITY 16
+
+/**
+ * \brief Number of completely free slabs the shared StackNode Pool keeps before returning memory.
+ */
+#define STACK_NODE_POOL_EMPTY_SLABS 4
 
 typedef struct StackNode
 {
@@ -20,23 +34,298 @@ typedef struct StackNode
 
 struct MC_Stack
 {
-    StackNode* top;
-    u64 size;
+    StackNode* top;     // \brief Pointer Stack: singly linked list of nodes, NULL for a typed Stack
+    u64 size;           // \brief Number of elements currently held, in either mode
+    u8* items;          // \brief Typed Stack: contiguous element storage, items[0] is the bottom
+    u64 capacity;       // \brief Typed Stack: number of elements items can hold
+    u64 elemSize;       // \brief Typed Stack: size of one element in bytes, 0 for a pointer Stack
+    MC_Allocator allocator; // \brief The allocator the Stack, its nodes and its storage come from
+    u8 poolNodes;           // \brief Nodes come from the shared StackNode Pool rather than allocator
+    StackNode* spare;       // \brief Bulk reclaiming allocator: popped nodes kept for the next Push, since they cannot be freed
+#if defined(MC_ALLOC_TRACKING)
+    MC_MemStats memStats;   // \brief Bytes this Stack holds: header, nodes in use and element storage
+#endif
 };
 
-MC_Stack* MC_Stack_Init()
+/**
+ * \brief Every pointer Stack on the default allocator shares one Pool of StackNodes, created on first use and kept for the process lifetime, outside the MC_MEM_MODULE_POOL counters.
+ */
+static MC_Pool* stack_node_pool;
+static once_flag stack_node_pool_once = ONCE_FLAG_INIT;
+
+static void internal_stack_node_pool_init(void)
+{
+    stack_node_pool = MC_Pool_InitShared(sizeof(StackNode), STACK_NODE_POOL_EMPTY_SLABS);
+}
+
+/**
+ * \brief Get a node for the next Push, from the shared node Pool, the spare list, or the Stack's allocator.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static StackNode* internal_stack_node_alloc(MC_Stack* stack)
+{
+    StackNode* node = stack->spare;
+
+    if (stack->poolNodes)
+    {
+        node = (StackNode*)MC_Pool_Alloc(stack_node_pool);
+    }
+    else if (node)
+    {
+        stack->spare = node->next;
+    }
+    else
+    {
+        node = (StackNode*)MC_Allocator_Alloc(&stack->allocator, sizeof(StackNode));
+    }
+
+    if (node)
+    {
+        MC_MEMTRACK_ALLOC(MC_MEM_MODULE_STACK, &stack->memStats, sizeof(StackNode));
+    }
+
+    return node;
+}
+
+/**
+ * \brief Give back a popped node, a Stack on a bulk reclaiming allocator keeps it on its spare list.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static void internal_stack_node_release(MC_Stack* stack, StackNode* node)
+{
+    MC_MEMTRACK_FREE(MC_MEM_MODULE_STACK, &stack->memStats, sizeof(StackNode));
+
+    if (stack->poolNodes)
+    {
+        MC_Pool_Release(stack_node_pool, node);
+
+        return;
+    }
+
+    if (stack->allocator.free)
+    {
+        MC_Allocator_Free(&stack->allocator, node, sizeof(StackNode));
+
+        return;
+    }
+
+    node->next = stack->spare;
+    stack->spare = node;
+}
+
+/**
+ * \brief Compute the capacity typed storage should grow to in order to hold 'needed' elements.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * Capacity doubles so that a long run of pushes costs amortized O(1) and
+ * only O(log n) reallocations in total. Returns 0 if the size would overflow.
+ */
+static u64 internal_stack_next_capacity(u64 capacity, u64 needed, u64 elem_size)
+{
+    capacity = capacity ? capacity : STACK_TYPED_INITIAL_CAPACITY;
+
+    while (capacity < needed)
+    {
+        if (capacity > U64_MAX / 2)
+        {
+            return 0;
+        }
+
+        capacity *= 2;
+    }
+
+    return capacity > U64_MAX / elem_size ? 0 : capacity;
+}
+
+/**
+ * \brief Grow the typed storage so that it can hold at least 'needed' elements.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static u8 internal_stack_grow(MC_Stack* stack, u64 needed)
+{
+    if (needed <= stack->capacity)
+    {
+        return true;
+    }
+
+    u64 capacity = internal_stack_next_capacity(stack->capacity, needed, stack->elemSize);
+
+    if (!capacity)
+    {
+        return false;
+    }
+
+    MC_TRACE_MODULE_BEGIN("MC_Stack grow");
+    u8* items = (u8*)MC_Allocator_Realloc(&stack->allocator, stack->items,
+                                          stack->capacity * stack->elemSize, capacity * stack->elemSize);
+    MC_TRACE_MODULE_END("MC_Stack grow");
+
+    if (!items)
+    {
+        return false;
+    }
+
+    if (stack->capacity)
+    {
+        MC_MEMTRACK_FREE(MC_MEM_MODULE_STACK, &stack->memStats, stack->capacity * stack->elemSize);
+    }
+
+    MC_MEMTRACK_ALLOC(MC_MEM_MODULE_STACK, &stack->memStats, capacity * stack->elemSize);
+
+    stack->items = items;
+    stack->capacity = capacity;
+
+    return true;
+}
+
+/**
+ * \brief Grow a SmallStack so that it can hold at least 'needed' elements.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * The first spill copies the inline elements into a fresh heap buffer, after
+ * that the heap buffer is grown in place like a typed MC_Stack.
+ */
+static u8 internal_small_stack_grow(MC_SmallStack* stack, u64 needed)
+{
+    if (needed <= stack->capacity)
+    {
+        return true;
+    }
+
+    u64 capacity = internal_stack_next_capacity(stack->capacity, needed, stack->elemSize);
+
+    if (!capacity)
+    {
+        return false;
+    }
+
+    u8 spilled = stack->items != stack->inlineItems;
+    MC_TRACE_MODULE_BEGIN("MC_SmallStack grow");
+    u8* items = (u8*)MC_Allocator_Realloc(stack->allocator, spilled ? stack->items : NULL,
+                                          stack->capacity * stack->elemSize, capacity * stack->elemSize);
+    MC_TRACE_MODULE_END("MC_SmallStack grow");
+
+    if (!items)
+    {
+        return false;
+    }
+
+    if (!spilled)
+    {
+        memcpy(items, stack->inlineItems, stack->size * stack->elemSize);
+    }
+    else
+    {
+        MC_MEMTRACK_FREE(MC_MEM_MODULE_STACK, NULL, stack->capacity * stack->elemSize);
+    }
+
+    MC_MEMTRACK_ALLOC(MC_MEM_MODULE_STACK, NULL, capacity * stack->elemSize);
+
+    stack->items = items;
+    stack->capacity = capacity;
+
+    return true;
+}
+
+/**
+ * \brief Allocate and clear a Stack header through allocator, NULL meaning the global one.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static MC_Stack* internal_stack_init(const MC_Allocator* allocator, u64 elem_size)
 {
-    MC_Stack* stack = (MC_Stack*)malloc(sizeof(MC_Stack));
+    allocator = allocator ? allocator : MC_Allocator_GetGlobal();
+
+    MC_Stack* stack = (MC_Stack*)MC_Allocator_Alloc(allocator, sizeof(MC_Stack));
 
     if (stack)
     {
         stack->top = NULL;
         stack->size = 0;
+        stack->items = NULL;
+        stack->capacity = 0;
+        stack->elemSize = elem_size;
+        stack->allocator = *allocator;
+        stack->poolNodes = false;
+        stack->spare = NULL;
+
+#if defined(MC_ALLOC_TRACKING)
+        memset(&stack->memStats, 0, sizeof(stack->memStats));
+#endif
+        MC_MEMTRACK_ALLOC(MC_MEM_MODULE_STACK, &stack->memStats, sizeof(MC_Stack));
+
+        if (elem_size == 0 && MC_Allocator_IsDefault(allocator))  // a custom allocator sees every allocation, nodes included
+        {
+            call_once(&stack_node_pool_once, internal_stack_node_pool_init);
+            stack->poolNodes = stack_node_pool != NULL;
+        }
     }
 
     return stack;
 }
 
+MC_Stack* MC_Stack_Init()
+{
+    return internal_stack_init(NULL, 0);
+}
+
+MC_Stack* MC_Stack_InitEx(const MC_Allocator* allocator)
+{
+    return internal_stack_init(allocator, 0);
+}
+
+MC_Stack* MC_Stack_InitArena(MC_Arena* arena)
+{
+    if (!arena)
+    {
+        return NULL;
+    }
+
+    MC_Allocator allocator = MC_Arena_AsAllocator(arena);
+
+    return internal_stack_init(&allocator, 0);
+}
+
+MC_Stack* MC_Stack_InitTyped(u64 elem_size)
+{
+    return MC_Stack_InitTypedEx(elem_size, NULL);
+}
+
+MC_Stack* MC_Stack_InitTypedEx(u64 elem_size, const MC_Allocator* allocator)
+{
+    if (elem_size == 0)
+    {
+        return NULL;
+    }
+
+    return internal_stack_init(allocator, elem_size);
+}
+
+MC_Stack* MC_Stack_InitTypedArena(MC_Arena* arena, u64 elem_size)
+{
+    if (!arena)
+    {
+        return NULL;
+    }
+
+    MC_Allocator allocator = MC_Arena_AsAllocator(arena);
+
+    return MC_Stack_InitTypedEx(elem_size, &allocator);
+}
+
+u8 MC_Stack_Reserve(MC_Stack* stack, u64 capacity)
+{
+    if (!stack || !stack->elemSize)
+    {
+        return false;
+    }
+
+    return internal_stack_grow(stack, capacity);
+}
+
 u8 MC_Stack_Push(MC_Stack* stack, void* value, u8 isDynamic)
 {
     if (!stack)
@@ -44,7 +333,20 @@ u8 MC_Stack_Push(MC_Stack* stack, void* value, u8 isDynamic)
         return false;
     }
 
-    StackNode* newNode = (StackNode*)malloc(sizeof(StackNode));
+    if (stack->elemSize)
+    {
+        if (!value || !internal_stack_grow(stack, stack->size + 1))
+        {
+            return false;
+        }
+
+        memcpy(stack->items + stack->size * stack->elemSize, value, stack->elemSize);
+        stack->size++;
+
+        return true;
+    }
+
+    StackNode* newNode = internal_stack_node_alloc(stack);
 
     if (!newNode)
     {
@@ -60,41 +362,131 @@ u8 MC_Stack_Push(MC_Stack* stack, void* value, u8 isDynamic)
     return true;
 }
 
+u8 MC_Stack_PushN(MC_Stack* stack, const void* values, u64 count)
+{
+    if (!stack || (!values && count))
+    {
+        return false;
+    }
+
+    if (stack->elemSize)
+    {
+        if (count > U64_MAX - stack->size || !internal_stack_grow(stack, stack->size + count))
+        {
+            return false;
+        }
+
+        memcpy(stack->items + stack->size * stack->elemSize, values, count * stack->elemSize);
+        stack->size += count;
+
+        return true;
+    }
+
+    void* const* pointers = (void* const*)values;
+
+    for (u64 i = 0; i < count; i++)
+    {
+        if (!MC_Stack_Push(stack, pointers[i], false))
+        {
+            MC_Stack_PopN(stack, NULL, i);  // roll back the partial run, none of it was dynamic
+
+            return false;
+        }
+    }
+
+    return true;
+}
+
 void* MC_Stack_Pop(MC_Stack* stack)
 {
-    if (!stack || !stack->top)
+    if (!stack || stack->size == 0)
     {
         return NULL;
     }
 
+    if (stack->elemSize)
+    {
+        stack->size--;
+
+        return stack->items + stack->size * stack->elemSize;
+    }
+
     StackNode* temp = stack->top;
     void* value = temp->data;
     stack->top = stack->top->next;
 
-    if (temp->isDynamic)
+    internal_stack_node_release(stack, temp);     // the value itself, dynamic or not, now belongs to the caller
+    stack->size--;
+
+    return value;
+}
+
+u64 MC_Stack_PopN(MC_Stack* stack, void* out, u64 count)
+{
+    if (!stack)
     {
-        free(temp->data);
+        return 0;
     }
 
-    free(temp);
-    stack->size--;
+    if (count > stack->size)
+    {
+        count = stack->size;
+    }
 
-    return value;
+    if (stack->elemSize)
+    {
+        stack->size -= count;
+
+        if (out)
+        {
+            memcpy(out, stack->items + stack->size * stack->elemSize, count * stack->elemSize);
+        }
+
+        return count;
+    }
+
+    void** pointers = (void**)out;
+
+    for (u64 i = count; i > 0; i--)
+    {
+        StackNode* temp = stack->top;
+        stack->top = temp->next;
+
+        if (pointers)
+        {
+            pointers[i - 1] = temp->data;
+        }
+        else if (temp->isDynamic)
+        {
+            free(temp->data);   // discarded, nobody else can reach it anymore
+        }
+
+        internal_stack_node_release(stack, temp);
+    }
+
+    stack->size -= count;
+
+    return count;
 }
 
 void* MC_Stack_Peek(const MC_Stack* stack)
 {
-    if (!stack || !stack->top)
+    if (!stack || stack->size == 0)
     {
         return NULL;
     }
 
+    if (stack->elemSize)
+    {
+        return stack->items + (stack->size - 1) * stack->elemSize;
+    }
+
     return stack->top->data;
 }
 
 u8 MC_Stack_IsEmpty(const MC_Stack* stack)
 {
-    return stack == NULL || stack->top == NULL;
+    return stack == NULL || stack->size == 0;
 }
 
 u64 MC_Stack_Size(const MC_Stack* stack)
@@ -114,6 +506,8 @@ void MC_Stack_Free(MC_Stack** stack)
         return;
     }
 
+    MC_TRACE_MODULE_BEGIN("MC_Stack_Free");
+
     StackNode* current = (*stack)->top;
 
     while (current)
@@ -126,10 +520,175 @@ void MC_Stack_Free(MC_Stack** stack)
             free(temp->data);
         }
 
-        free(temp);
+        internal_stack_node_release(*stack, temp);
+    }
+
+    MC_Allocator allocator = (*stack)->allocator;
+
+    if ((*stack)->capacity)
+    {
+        MC_MEMTRACK_FREE(MC_MEM_MODULE_STACK, NULL, (*stack)->capacity * (*stack)->elemSize);
     }
 
-    free(*stack);
+    MC_MEMTRACK_FREE(MC_MEM_MODULE_STACK, NULL, sizeof(MC_Stack));
+    MC_Allocator_Free(&allocator, (*stack)->items, (*stack)->capacity * (*stack)->elemSize);
+    MC_Allocator_Free(&allocator, *stack, sizeof(MC_Stack));
 
     *stack = NULL;
+
+    MC_TRACE_MODULE_END("MC_Stack_Free");
+}
+
+u8 MC_Stack_MemStats(const MC_Stack* stack, MC_MemStats* stats)
+{
+    if (!stack || !stats)
+    {
+        return false;
+    }
+
+#if defined(MC_ALLOC_TRACKING)
+    *stats = stack->memStats;
+
+    return true;
+#else
+    memset(stats, 0, sizeof(*stats));
+
+    return false;
+#endif
+}
+
+u8 MC_SmallStack_Init(MC_SmallStack* stack, void* inline_items, u64 inline_count, u64 elem_size)
+{
+    if (!stack || elem_size == 0 || (!inline_items && inline_count))
+    {
+        return false;
+    }
+
+    stack->items = (u8*)inline_items;
+    stack->inlineItems = (u8*)inline_items;
+    stack->size = 0;
+    stack->capacity = inline_count;
+    stack->inlineCapacity = inline_count;
+    stack->elemSize = elem_size;
+    stack->allocator = MC_Allocator_GetGlobal();
+
+    return true;
+}
+
+u8 MC_SmallStack_Push(MC_SmallStack* stack, const void* value)
+{
+    if (!stack || !value)
+    {
+        return false;
+    }
+
+    if (stack->size == stack->capacity && !internal_small_stack_grow(stack, stack->size + 1))
+    {
+        return false;
+    }
+
+    memcpy(stack->items + stack->size * stack->elemSize, value, stack->elemSize);
+    stack->size++;
+
+    return true;
+}
+
+u8 MC_SmallStack_PushN(MC_SmallStack* stack, const void* values, u64 count)
+{
+    if (!stack || (!values && count))
+    {
+        return false;
+    }
+
+    if (count > U64_MAX - stack->size || !internal_small_stack_grow(stack, stack->size + count))
+    {
+        return false;
+    }
+
+    memcpy(stack->items + stack->size * stack->elemSize, values, count * stack->elemSize);
+    stack->size += count;
+
+    return true;
+}
+
+void* MC_SmallStack_Pop(MC_SmallStack* stack)
+{
+    if (!stack || stack->size == 0)
+    {
+        return NULL;
+    }
+
+    stack->size--;
+
+    return stack->items + stack->size * stack->elemSize;
+}
+
+u64 MC_SmallStack_PopN(MC_SmallStack* stack, void* out, u64 count)
+{
+    if (!stack)
+    {
+        return 0;
+    }
+
+    if (count > stack->size)
+    {
+        count = stack->size;
+    }
+
+    stack->size -= count;
+
+    if (out)
+    {
+        memcpy(out, stack->items + stack->size * stack->elemSize, count * stack->elemSize);
+    }
+
+    return count;
+}
+
+void* MC_SmallStack_Peek(const MC_SmallStack* stack)
+{
+    if (!stack || stack->size == 0)
+    {
+        return NULL;
+    }
+
+    return stack->items + (stack->size - 1) * stack->elemSize;
+}
+
+u8 MC_SmallStack_IsEmpty(const MC_SmallStack* stack)
+{
+    return stack == NULL || stack->size == 0;
+}
+
+u8 MC_SmallStack_IsInline(const MC_SmallStack* stack)
+{
+    return stack == NULL || stack->items == stack->inlineItems;
+}
+
+u64 MC_SmallStack_Size(const MC_SmallStack* stack)
+{
+    if (!stack)
+    {
+        return 0;
+    }
+
+    return stack->size;
+}
+
+void MC_SmallStack_Free(MC_SmallStack* stack)
+{
+    if (!stack)
+    {
+        return;
+    }
+
+    if (stack->items != stack->inlineItems)
+    {
+        MC_MEMTRACK_FREE(MC_MEM_MODULE_STACK, NULL, stack->capacity * stack->elemSize);
+        MC_Allocator_Free(stack->allocator, stack->items, stack->capacity * stack->elemSize);
+    }
+
+    stack->items = stack->inlineItems;
+    stack->size = 0;
+    stack->capacity = stack->inlineCapacity;
 }
@@ -0,0 +1,487 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_trace.c                                                                             */
+/* \brief: Provide scoped tracing spans written as Chrome trace events                           */
+/*                                                                                               */
+/* \Expects: mc_trace.h is linked properly and defines interface                                 */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#include "mc_trace.h"
+#include "mc_platform.h"
+#include <stdlib.h>     // malloc, free
+#include <stdio.h>      // fprintf, fputs
+#include <string.h>     // strcmp
+#include <time.h>       // timespec_get
+#include <threads.h>    // thrd_sleep
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define TRACE_X86 1
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>         // __rdtsc
+#else
+#include <x86intrin.h>      // __rdtsc
+#endif
+#endif
+
+/**
+ * \brief File MC_Trace_Write writes to when it is given no path.
+ */
+#define TRACE_OUTPUT_FILE "last_run_trace.json"
+
+/**
+ * \brief Events a thread's buffer holds when MC_Trace_Start is given 0.
+ */
+#define TRACE_DEFAULT_EVENTS 65536
+
+/**
+ * \brief Shortest span of time the tick rate is measured over, MC_Trace_Write sleeps out the rest.
+ */
+#define TRACE_CALIBRATE_NS 10000000ULL
+
+#define TRACE_NS_PER_SECOND 1000000000ULL
+
+/**
+ * \brief Deepest nesting of spans MC_Trace_Histogram follows on a thread.
+ */
+#define TRACE_HISTOGRAM_DEPTH 64
+
+/**
+ * \brief Deepest nesting of open spans whose names a thread keeps, deeper ends are matched by count only.
+ */
+#define TRACE_OPEN_DEPTH 64
+
+/**
+ * \brief The kinds of event, indexing trace_phases.
+ */
+typedef enum TraceType
+{
+    TRACE_BEGIN,
+    TRACE_END,
+    TRACE_INSTANT,
+    TRACE_COUNTER
+} TraceType;
+
+/**
+ * \brief The "ph" of each TraceType in the trace event format.
+ */
+static const char trace_phases[] = { 'B', 'E', 'i', 'C' };
+
+/**
+ * \brief TraceEvent is one recorded event, timed in ticks until it is written.
+ */
+typedef struct TraceEvent
+{
+    u64 ticks;
+    const char *name;
+    i64 value;          // \brief The value of a TRACE_COUNTER, unused otherwise
+    u8 type;
+} TraceEvent;
+
+/**
+ * \brief TraceBuffer holds the events of one thread in one session.
+ */
+typedef struct TraceBuffer
+{
+    atomic_uint_fast64_t count;     // \brief Events recorded, stored by the owning thread only, after each event
+    atomic_uint_fast64_t dropped;   // \brief Events lost to a full buffer, stored by the owning thread only
+    u64 capacity;
+    u64 tid;
+    struct TraceBuffer *next;
+    TraceEvent events[];
+} TraceBuffer;
+
+atomic_uchar mc_trace_enabled;
+
+static _Atomic(TraceBuffer*) trace_buffers;
+static atomic_uint_fast64_t trace_epoch;    // \brief Bumped by every MC_Trace_Start, older thread buffers are stale
+static atomic_uint_fast64_t trace_next_tid;
+static u64 trace_capacity;
+static u64 trace_start_ticks;
+static u64 trace_start_ns;
+static u8 trace_started;
+
+_Thread_local u32 mc_trace_open_spans;
+
+static _Thread_local TraceBuffer *trace_thread_buffer;
+static _Thread_local u64 trace_thread_epoch;
+static _Thread_local const char *trace_thread_open[TRACE_OPEN_DEPTH];   // \brief Names of the open spans, innermost last
+
+/**
+ * \brief The wall clock in ns.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static u64 internal_trace_ns(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+
+    return (u64)ts.tv_sec * TRACE_NS_PER_SECOND + (u64)ts.tv_nsec;
+}
+
+/**
+ * \brief An event's timestamp: the time stamp counter on x86, the wall clock in ns elsewhere.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static inline u64 internal_trace_ticks(void)
+{
+#if defined(TRACE_X86)
+    return __rdtsc();
+#else
+    return internal_trace_ns();
+#endif
+}
+
+/**
+ * \brief Get the calling thread's buffer for the current session, creating it if asked to.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * \returns TraceBuffer*: The buffer, NULL if it does not exist and was not created.
+ */
+static TraceBuffer* internal_trace_buffer(u8 create)
+{
+    u64 epoch = atomic_load_explicit(&trace_epoch, memory_order_acquire);
+
+    if (trace_thread_buffer && trace_thread_epoch == epoch)
+    {
+        return trace_thread_buffer;
+    }
+
+    if (!create)
+    {
+        return NULL;
+    }
+
+    TraceBuffer *buffer = (TraceBuffer*)malloc(sizeof(TraceBuffer) + trace_capacity * sizeof(TraceEvent));
+
+    if (!buffer)
+    {
+        return NULL;
+    }
+
+    atomic_init(&buffer->count, 0);
+    atomic_init(&buffer->dropped, 0);
+    buffer->capacity = trace_capacity;
+    buffer->tid = atomic_fetch_add(&trace_next_tid, 1) + 1;
+    buffer->next = atomic_load(&trace_buffers);
+
+    while (!atomic_compare_exchange_weak(&trace_buffers, &buffer->next, buffer))
+    {
+    }
+
+    trace_thread_buffer = buffer;
+    trace_thread_epoch = epoch;
+    mc_trace_open_spans = 0;    // spans of the previous session are never closed
+
+    return buffer;
+}
+
+/**
+ * \brief Append an event to a buffer, counting it as dropped when the buffer is full.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * \returns u8: true/false corresponding to success fail
+ */
+static u8 internal_trace_record(TraceBuffer *buffer, TraceType type, const char *name, i64 value)
+{
+    u64 count = atomic_load_explicit(&buffer->count, memory_order_relaxed);
+
+    if (count >= buffer->capacity)
+    {
+        atomic_store_explicit(&buffer->dropped, atomic_load_explicit(&buffer->dropped, memory_order_relaxed) + 1,
+                              memory_order_relaxed);
+
+        return false;
+    }
+
+    TraceEvent *event = &buffer->events[count];
+
+    event->ticks = internal_trace_ticks();
+    event->name = name;
+    event->value = value;
+    event->type = (u8)type;
+
+    atomic_store_explicit(&buffer->count, count + 1, memory_order_release);     // MC_Trace_Write reads up to here
+
+    return true;
+}
+
+/**
+ * \brief Record an event of a recording session from the calling thread.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * \returns u8: true/false corresponding to success fail, false while no session is recording
+ */
+static u8 internal_trace_event(TraceType type, const char *name, i64 value)
+{
+    if (!atomic_load_explicit(&mc_trace_enabled, memory_order_acquire))
+    {
+        return false;
+    }
+
+    TraceBuffer *buffer = internal_trace_buffer(true);
+
+    return buffer && internal_trace_record(buffer, type, name, value);
+}
+
+/**
+ * \brief Write a name as a JSON string.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static void internal_trace_write_string(FILE *out, const char *str)
+{
+    fputc('"', out);
+
+    for (const unsigned char *c = (const unsigned char*)(str ? str : ""); *c; c++)
+    {
+        if (*c == '"' || *c == '\\')
+        {
+            fputc('\\', out);
+            fputc(*c, out);
+        }
+        else if (*c < 0x20)
+        {
+            fprintf(out, "\\u%04x", *c);
+        }
+        else
+        {
+            fputc(*c, out);
+        }
+    }
+
+    fputc('"', out);
+}
+
+/**
+ * \brief Nanoseconds per tick, measured from MC_Trace_Start to now over at least TRACE_CALIBRATE_NS.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static double internal_trace_ns_per_tick(void)
+{
+    u64 elapsed = internal_trace_ns() - trace_start_ns;
+
+    if (elapsed < TRACE_CALIBRATE_NS)
+    {
+        thrd_sleep(&(struct timespec){ .tv_nsec = (long)(TRACE_CALIBRATE_NS - elapsed) }, NULL);
+    }
+
+    u64 ns = internal_trace_ns();
+    u64 ticks = internal_trace_ticks();
+
+    return ticks > trace_start_ticks && ns > trace_start_ns ?
+           (double)(ns - trace_start_ns) / (double)(ticks - trace_start_ticks) : 1.0;
+}
+
+u8 MC_Trace_IsEnabled(void)
+{
+#if defined(MC_TRACING)
+    return true;
+#else
+    return false;
+#endif
+}
+
+int MC_Trace_Start(u64 events_per_thread)
+{
+    u64 capacity = events_per_thread ? events_per_thread : TRACE_DEFAULT_EVENTS;
+
+    if (atomic_load(&mc_trace_enabled) || capacity > (UINT64_MAX - sizeof(TraceBuffer)) / sizeof(TraceEvent))
+    {
+        return -1;
+    }
+
+    atomic_fetch_add(&trace_epoch, 1);  // threads still holding a buffer create a new one on their next event
+
+    TraceBuffer *buffer = atomic_exchange(&trace_buffers, NULL);
+
+    while (buffer)
+    {
+        TraceBuffer *next = buffer->next;
+
+        free(buffer);
+        buffer = next;
+    }
+
+    trace_capacity = capacity;
+    trace_started = true;
+    atomic_store(&trace_next_tid, 0);
+
+    trace_start_ns = internal_trace_ns();
+    trace_start_ticks = internal_trace_ticks();
+
+    atomic_store_explicit(&mc_trace_enabled, true, memory_order_release);
+
+    return 0;
+}
+
+void MC_Trace_Stop(void)
+{
+    atomic_store_explicit(&mc_trace_enabled, false, memory_order_release);
+}
+
+int MC_Trace_Write(const char *path)
+{
+    FILE *out;
+
+    if (!trace_started || MC_FOpen(&out, path ? path : TRACE_OUTPUT_FILE, "w") != 0)
+    {
+        return -1;
+    }
+
+    double usPerTick = internal_trace_ns_per_tick() / 1000.0;
+    u8 first = true;
+
+    fputs("{\"traceEvents\":[", out);
+
+    for (TraceBuffer *buffer = atomic_load(&trace_buffers); buffer; buffer = buffer->next)
+    {
+        u64 count = atomic_load_explicit(&buffer->count, memory_order_acquire);
+
+        for (u64 i = 0; i < count; i++)
+        {
+            const TraceEvent *event = &buffer->events[i];
+            u64 since = event->ticks > trace_start_ticks ? event->ticks - trace_start_ticks : 0;
+
+            fputs(first ? "\n{\"name\":" : ",\n{\"name\":", out);
+            internal_trace_write_string(out, event->name);
+            fprintf(out, ",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%llu",
+                    trace_phases[event->type], (double)since * usPerTick, (unsigned long long)buffer->tid);
+
+            if (event->type == TRACE_INSTANT)
+            {
+                fputs(",\"s\":\"t\"", out);
+            }
+            else if (event->type == TRACE_COUNTER)
+            {
+                fprintf(out, ",\"args\":{\"value\":%lld}", (long long)event->value);
+            }
+
+            fputc('}', out);
+            first = false;
+        }
+    }
+
+    fputs("\n],\"displayTimeUnit\":\"ns\"}\n", out);
+
+    int failed = ferror(out);
+
+    return fclose(out) == 0 && !failed ? 0 : -1;
+}
+
+u64 MC_Trace_Histogram(const char *name, MC_Histogram *into)
+{
+    if (!trace_started || !name || !into)
+    {
+        return 0;
+    }
+
+    double nsPerTick = internal_trace_ns_per_tick();
+    u64 begins[TRACE_HISTOGRAM_DEPTH];
+    u64 spans = 0;
+
+    for (TraceBuffer *buffer = atomic_load(&trace_buffers); buffer; buffer = buffer->next)
+    {
+        u64 count = atomic_load_explicit(&buffer->count, memory_order_acquire);
+        u64 depth = 0;
+
+        for (u64 i = 0; i < count; i++)
+        {
+            const TraceEvent *event = &buffer->events[i];
+
+            if (event->type == TRACE_BEGIN)
+            {
+                if (depth < TRACE_HISTOGRAM_DEPTH)
+                {
+                    begins[depth] = event->ticks;
+                }
+
+                depth++;
+            }
+            else if (event->type == TRACE_END && depth && --depth < TRACE_HISTOGRAM_DEPTH &&
+                     event->name && strcmp(event->name, name) == 0)
+            {
+                MC_Histogram_Record(into, (u64)((double)(event->ticks - begins[depth]) * nsPerTick));
+                spans++;
+            }
+        }
+    }
+
+    return spans;
+}
+
+u64 MC_Trace_Dropped(void)
+{
+    u64 dropped = 0;
+
+    for (TraceBuffer *buffer = atomic_load(&trace_buffers); buffer; buffer = buffer->next)
+    {
+        dropped += atomic_load_explicit(&buffer->dropped, memory_order_relaxed);
+    }
+
+    return dropped;
+}
+
+u8 MC_Trace_Begin(const char *name)
+{
+    if (!internal_trace_event(TRACE_BEGIN, name, 0))
+    {
+        return false;
+    }
+
+    if (mc_trace_open_spans < TRACE_OPEN_DEPTH)
+    {
+        trace_thread_open[mc_trace_open_spans] = name;
+    }
+
+    mc_trace_open_spans++;
+
+    return true;
+}
+
+void MC_Trace_End(const char *name)
+{
+    TraceBuffer *buffer = internal_trace_buffer(false);     // after MC_Trace_Stop too, so begun spans are closed
+
+    if (!buffer)
+    {
+        mc_trace_open_spans = 0;    // begun in a session since replaced
+
+        return;
+    }
+
+    u32 depth = mc_trace_open_spans;
+
+    if (!depth)
+    {
+        return;
+    }
+
+    // after MC_Trace_Stop an inner span's begin is skipped, its end must not close the outer span
+    if (depth <= TRACE_OPEN_DEPTH)
+    {
+        const char *open = trace_thread_open[depth - 1];
+
+        if (open != name && (!open || !name || strcmp(open, name) != 0))
+        {
+            return;
+        }
+    }
+
+    mc_trace_open_spans = depth - 1;
+    internal_trace_record(buffer, TRACE_END, name, 0);
+}
+
+void MC_Trace_Instant(const char *name)
+{
+    internal_trace_event(TRACE_INSTANT, name, 0);
+}
+
+void MC_Trace_Counter(const char *name, i64 value)
+{
+    internal_trace_event(TRACE_COUNTER, name, value);
+}
@@ -0,0 +1,274 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_workdeque.c                                                                         */
+/* \brief: Provide a work-stealing deque (Chase-Lev) for task schedulers                         */
+/*                                                                                               */
+/* \Expects: mc_workdeque.h is linked properly and defines interface                             */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#include "mc_workdeque.h"
+#include "mc_memtrack.h"
+#include <stdlib.h>     // malloc
+#include <stdatomic.h>  // atomic_*
+
+/**
+ * \brief The smallest circular array a WorkDeque is created with.
+ */
+#define WORKDEQUE_MIN_CAPACITY 16
+
+/**
+ * \brief WorkDequeArray is the internal circular storage of a WorkDeque.
+ * \details Arrays replaced by a resize are kept on the retired list until the WorkDeque is freed,
+ * since a thief may still be reading from one after the owner has moved on.
+ */
+typedef struct WorkDequeArray
+{
+    u64 mask;                           // \brief capacity - 1, capacity is always a power of two
+    struct WorkDequeArray *retired;     // \brief Next older array that was replaced by a resize
+    _Atomic(void*) slots[];             // \brief The elements, indexed by position & mask
+} WorkDequeArray;
+
+/**
+ * \brief WorkDeque keeps the owner's index and the thieves' index on separate cache lines.
+ * \details Explicit padding is used rather than alignas so that plain malloc stays sufficient.
+ * Positions grow without bound and are mapped onto the array with a mask. The Chase-Lev paper
+ * calls the owner's end 'bottom' and the thieves' end 'top', here they are named the other way
+ * around to match the MC_Stack picture of pushing and popping at the top.
+ */
+struct MC_WorkDeque
+{
+    atomic_int_fast64_t top;                                        // \brief Owner end, next free position
+    u8 padTop[MC_CACHE_LINE_SIZE - sizeof(atomic_int_fast64_t)];
+    atomic_int_fast64_t bottom;                                     // \brief Steal end, oldest element
+    u8 padBottom[MC_CACHE_LINE_SIZE - sizeof(atomic_int_fast64_t)];
+    _Atomic(WorkDequeArray*) array;                                 // \brief Current circular storage
+};
+
+/**
+ * \brief Allocate a circular array able to hold capacity elements.
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ */
+static WorkDequeArray* internal_workdeque_array(u64 capacity)
+{
+    WorkDequeArray *array = (WorkDequeArray*)malloc(sizeof(WorkDequeArray) + capacity * sizeof(_Atomic(void*)));
+
+    if (array)
+    {
+        array->mask = capacity - 1;
+        array->retired = NULL;
+
+        MC_MEMTRACK_ALLOC(MC_MEM_MODULE_WORKDEQUE, NULL, sizeof(WorkDequeArray) + capacity * sizeof(_Atomic(void*)));
+    }
+
+    return array;
+}
+
+/**
+ * \brief Double the circular array, copying the live range [bottom, top).
+ *
+ * \details - INTERNAL FUNCTION, NOT EXPOSED PUBLICLY
+ * Only the owner resizes, so plain relaxed loads of its own slots are enough. The new array is
+ * published with release semantics so a thief that observes it also observes the copied slots.
+ */
+static WorkDequeArray* internal_workdeque_grow(MC_WorkDeque *deque, WorkDequeArray *old, i64 bottom, i64 top)
+{
+    WorkDequeArray *array = internal_workdeque_array((old->mask + 1) * 2);
+
+    if (!array)
+    {
+        return NULL;
+    }
+
+    for (i64 i = bottom; i < top; i++)
+    {
+        void *value = atomic_load_explicit(&old->slots[i & old->mask], memory_order_relaxed);
+        atomic_store_explicit(&array->slots[i & array->mask], value, memory_order_relaxed);
+    }
+
+    array->retired = old;
+    atomic_store_explicit(&deque->array, array, memory_order_release);
+
+    return array;
+}
+
+MC_WorkDeque* MC_WorkDeque_Init(u64 capacity)
+{
+    u64 rounded = WORKDEQUE_MIN_CAPACITY;
+
+    while (rounded < capacity)
+    {
+        if (rounded > U64_MAX / 2)
+        {
+            return NULL;
+        }
+
+        rounded *= 2;
+    }
+
+    MC_WorkDeque *deque = (MC_WorkDeque*)malloc(sizeof(MC_WorkDeque));
+
+    if (!deque)
+    {
+        return NULL;
+    }
+
+    WorkDequeArray *array = internal_workdeque_array(rounded);
+
+    if (!array)
+    {
+        free(deque);
+
+        return NULL;
+    }
+
+    MC_MEMTRACK_ALLOC(MC_MEM_MODULE_WORKDEQUE, NULL, sizeof(MC_WorkDeque));
+
+    atomic_init(&deque->top, 0);
+    atomic_init(&deque->bottom, 0);
+    atomic_init(&deque->array, array);
+
+    return deque;
+}
+
+u8 MC_WorkDeque_Push(MC_WorkDeque* deque, void* value)
+{
+    if (!deque || !value)
+    {
+        return false;
+    }
+
+    i64 top = atomic_load_explicit(&deque->top, memory_order_relaxed);
+    i64 bottom = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+    WorkDequeArray *array = atomic_load_explicit(&deque->array, memory_order_relaxed);
+
+    if (top - bottom > (i64)array->mask)
+    {
+        array = internal_workdeque_grow(deque, array, bottom, top);
+
+        if (!array)
+        {
+            return false;
+        }
+    }
+
+    atomic_store_explicit(&array->slots[top & array->mask], value, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);      // the slot must be visible before the new top
+    atomic_store_explicit(&deque->top, top + 1, memory_order_relaxed);
+
+    return true;
+}
+
+void* MC_WorkDeque_Pop(MC_WorkDeque* deque)
+{
+    if (!deque)
+    {
+        return NULL;
+    }
+
+    i64 top = atomic_load_explicit(&deque->top, memory_order_relaxed) - 1;
+    WorkDequeArray *array = atomic_load_explicit(&deque->array, memory_order_relaxed);
+
+    /**
+     * Claim the top slot first, then look at bottom. The seq_cst fence orders our store of top
+     * against the thieves' store of bottom, so the owner and a thief can never both believe
+     * they own the same last element.
+     */
+    atomic_store_explicit(&deque->top, top, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    i64 bottom = atomic_load_explicit(&deque->bottom, memory_order_relaxed);
+
+    if (bottom > top)   // already empty, undo the claim
+    {
+        atomic_store_explicit(&deque->top, top + 1, memory_order_relaxed);
+
+        return NULL;
+    }
+
+    void *value = atomic_load_explicit(&array->slots[top & array->mask], memory_order_relaxed);
+
+    if (bottom == top)  // last element, race the thieves for it
+    {
+        if (!atomic_compare_exchange_strong_explicit(&deque->bottom, &bottom, bottom + 1,
+                                                     memory_order_seq_cst, memory_order_relaxed))
+        {
+            value = NULL;
+        }
+
+        atomic_store_explicit(&deque->top, top + 1, memory_order_relaxed);
+    }
+
+    return value;
+}
+
+void* MC_WorkDeque_Steal(MC_WorkDeque* deque)
+{
+    if (!deque)
+    {
+        return NULL;
+    }
+
+    i64 bottom = atomic_load_explicit(&deque->bottom, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    i64 top = atomic_load_explicit(&deque->top, memory_order_acquire);
+
+    if (bottom >= top)
+    {
+        return NULL;
+    }
+
+    WorkDequeArray *array = atomic_load_explicit(&deque->array, memory_order_acquire);
+    void *value = atomic_load_explicit(&array->slots[bottom & array->mask], memory_order_relaxed);
+
+    if (!atomic_compare_exchange_strong_explicit(&deque->bottom, &bottom, bottom + 1,
+                                                 memory_order_seq_cst, memory_order_relaxed))
+    {
+        return NULL;    // lost the race to the owner or another thief
+    }
+
+    return value;
+}
+
+u8 MC_WorkDeque_IsEmpty(const MC_WorkDeque* deque)
+{
+    return MC_WorkDeque_Size(deque) == 0;
+}
+
+u64 MC_WorkDeque_Size(const MC_WorkDeque* deque)
+{
+    if (!deque)
+    {
+        return 0;
+    }
+
+    i64 bottom = atomic_load_explicit(&((MC_WorkDeque*)deque)->bottom, memory_order_relaxed);
+    i64 top = atomic_load_explicit(&((MC_WorkDeque*)deque)->top, memory_order_relaxed);
+
+    return top > bottom ? (u64)(top - bottom) : 0;
+}
+
+void MC_WorkDeque_Free(MC_WorkDeque** deque)
+{
+    if (!deque || !(*deque))
+    {
+        return;
+    }
+
+    WorkDequeArray *array = atomic_load_explicit(&(*deque)->array, memory_order_relaxed);
+
+    while (array)
+    {
+        WorkDequeArray *retired = array->retired;
+
+        MC_MEMTRACK_FREE(MC_MEM_MODULE_WORKDEQUE, NULL, sizeof(WorkDequeArray) + (array->mask + 1) * sizeof(_Atomic(void*)));
+        free(array);
+        array = retired;
+    }
+
+    MC_MEMTRACK_FREE(MC_MEM_MODULE_WORKDEQUE, NULL, sizeof(MC_WorkDeque));
+    free(*deque);
+
+    *deque = NULL;
+}
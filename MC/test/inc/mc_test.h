@@ -18,9 +18,34 @@
 #include "mc_type.h"
 #include "mc_stack.h"
 #include "mc_guid.h"
+#include "mc_workdeque.h"
+#include "mc_spscring.h"
+#include "mc_mpmcqueue.h"
+#include "mc_arena.h"
+#include "mc_pool.h"
+#include "mc_allocator.h"
+#include "mc_memtrack.h"
+#include "mc_guidmap.h"
+#include "mc_log.h"
+#include "mc_trace.h"
+#include "mc_perfcounters.h"
+#include "mc_histogram.h"
+#include "mc_platform.h"
 #include "mc_test_hash.h"
 #include "mc_test_type.h"
 #include "mc_test_stack.h"
 #include "mc_test_guid.h"
+#include "mc_test_workdeque.h"
+#include "mc_test_spscring.h"
+#include "mc_test_mpmcqueue.h"
+#include "mc_test_arena.h"
+#include "mc_test_pool.h"
+#include "mc_test_allocator.h"
+#include "mc_test_memtrack.h"
+#include "mc_test_guidmap.h"
+#include "mc_test_log.h"
+#include "mc_test_trace.h"
+#include "mc_test_perfcounters.h"
+#include "mc_test_histogram.h"
 
 #endif
@@ -0,0 +1,41 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_test_allocator.h                                                                    */
+/* \brief: Test prototypes for the allocator interface                                           */
+/*                                                                                               */
+/* \Expects: No expectations are made prior to type definitions in this file                     */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#ifndef MC_TEST_ALLOCATOR_H
+#define MC_TEST_ALLOCATOR_H
+
+#include "mc_type.h"
+
+/**
+ * \brief Test the default allocator, and the global allocator falling back to it
+ */
+u32 Test_MC_Allocator_Default(void);
+
+/**
+ * \brief Test every container made by an InitEx constructor allocates and frees through its allocator
+ */
+u32 Test_MC_Allocator_InitEx(void);
+
+/**
+ * \brief Test the plain constructors follow the global allocator, and keep it until they are freed
+ */
+u32 Test_MC_Allocator_Global(void);
+
+/**
+ * \brief Test realloc is emulated with alloc, copy and free when an allocator leaves it NULL
+ */
+u32 Test_MC_Allocator_ReallocEmulated(void);
+
+/**
+ * \brief Test the NUMA and huge page allocators on small and large sizes, and under a HashMap
+ */
+u32 Test_MC_Allocator_Pages(void);
+
+#endif
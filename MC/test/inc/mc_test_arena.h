@@ -0,0 +1,36 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_test_arena.h                                                                        */
+/* \brief: Test prototypes for the arena interface                                               */
+/*                                                                                               */
+/* \Expects: No expectations are made prior to type definitions in this file                     */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#ifndef MC_TEST_ARENA_H
+#define MC_TEST_ARENA_H
+
+#include "mc_type.h"
+
+/**
+ * \brief Test Arena init and clear functionality
+ */
+u32 Test_MC_Arena_InitAndFree(void);
+
+/**
+ * \brief Test allocations honour their alignment and chain new chunks, including oversized ones
+ */
+u32 Test_MC_Arena_AllocAndChain(void);
+
+/**
+ * \brief Test Rewind releases exactly what was allocated after the Mark, across chunks
+ */
+u32 Test_MC_Arena_MarkAndRewind(void);
+
+/**
+ * \brief Test Reset releases everything and that refilling reuses the chunks instead of allocating
+ */
+u32 Test_MC_Arena_ResetReuse(void);
+
+#endif
@@ -23,4 +23,69 @@ u32 Test_MC_Guid_Generate(void);
  */
 u32 Test_MC_Guid_Format(void);
 
+/**
+ * \brief Test Guids generated into an Arena are distinct and released with the Arena
+ */
+u32 Test_MC_Guid_Arena(void);
+
+/**
+ * \brief Test Guids carry the RFC 4122 version 4 and variant bits
+ */
+u32 Test_MC_Guid_Version(void);
+
+/**
+ * \brief Test Guids generated concurrently by several threads never repeat
+ */
+u32 Test_MC_Guid_Unique(void);
+
+/**
+ * \brief Test Guids generated by value into caller memory
+ */
+u32 Test_MC_Guid_GenerateInto(void);
+
+/**
+ * \brief Test batch generation fills every element, including a count that is not a multiple of four
+ */
+u32 Test_MC_Guid_GenerateBatch(void);
+
+/**
+ * \brief Test the table and SIMD formatter matches the snprintf formatter byte for byte
+ */
+u32 Test_MC_Guid_FormatFast(void);
+
+/**
+ * \brief Test parsing round trips formatted Guids, accepts either case and rejects malformed strings
+ */
+u32 Test_MC_Guid_Parse(void);
+
+/**
+ * \brief Test bulk formatting and parsing over an odd count of Guids
+ */
+u32 Test_MC_Guid_FormatN(void);
+
+/**
+ * \brief Test version 7 Guids carry their bits and timestamp and sort in generation order
+ */
+u32 Test_MC_Guid_V7(void);
+
+/**
+ * \brief Test version 7 Guids stay strictly increasing when the clock goes backwards or the counter runs out
+ */
+u32 Test_MC_Guid_V7ClockRegression(void);
+
+/**
+ * \brief Test version 7 Guids from several threads are increasing per thread and never repeat
+ */
+u32 Test_MC_Guid_V7Threads(void);
+
+/**
+ * \brief Test Compare agrees with the order of the formatted strings, and Equal and Hash with each other
+ */
+u32 Test_MC_Guid_Compare(void);
+
+/**
+ * \brief Test the radix sort orders large and small arrays without losing any Guid
+ */
+u32 Test_MC_Guid_Sort(void);
+
 #endif
@@ -0,0 +1,36 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_test_guidmap.h                                                                      */
+/* \brief: Test prototypes for the guidmap interface                                             */
+/*                                                                                               */
+/* \Expects: No expectations are made prior to type definitions in this file                     */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#ifndef MC_TEST_GUIDMAP_H
+#define MC_TEST_GUIDMAP_H
+
+#include "mc_type.h"
+
+/**
+ * \brief Test GuidMap init and free functionality
+ */
+u32 Test_MC_GuidMap_InitAndFree(void);
+
+/**
+ * \brief Test inserting, updating and searching, growing well past the initial size
+ */
+u32 Test_MC_GuidMap_InsertAndSearch(void);
+
+/**
+ * \brief Test removing keys keeps every other key reachable
+ */
+u32 Test_MC_GuidMap_Remove(void);
+
+/**
+ * \brief Test dynamic values are freed on update, removal and free
+ */
+u32 Test_MC_GuidMap_Dynamic(void);
+
+#endif
@@ -33,4 +33,9 @@ u32 Test_MC_Hash_DynamicInsertion(void);
  */
 u32 Test_MC_Hash_SearchAndRemove(void);
 
+/**
+ * \brief Test a HashMap placed in an Arena inserts, searches and removes, and is released by the Arena
+ */
+u32 Test_MC_Hash_Arena(void);
+
 #endif
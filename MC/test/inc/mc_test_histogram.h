@@ -0,0 +1,61 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_test_histogram.h                                                                    */
+/* \brief: Test prototypes for the histogram interface                                           */
+/*                                                                                               */
+/* \Expects: No expectations are made prior to type definitions in this file                     */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#ifndef MC_TEST_HISTOGRAM_H
+#define MC_TEST_HISTOGRAM_H
+
+#include "mc_type.h"
+
+/**
+ * \brief Test small values are exact, the range and count are kept, and bad arguments are refused
+ */
+u32 Test_MC_Histogram_Record(void);
+
+/**
+ * \brief Test a value is reported at most one sub bucket above itself, at every magnitude up to U64_MAX
+ */
+u32 Test_MC_Histogram_Precision(void);
+
+/**
+ * \brief Test percentiles and the mean of a uniform range, and an empty Histogram
+ */
+u32 Test_MC_Histogram_Percentile(void);
+
+/**
+ * \brief Test merging Histograms of equal and of different precision
+ */
+u32 Test_MC_Histogram_Merge(void);
+
+/**
+ * \brief Test a Histogram survives Serialize and Deserialize, and malformed encodings are refused
+ */
+u32 Test_MC_Histogram_Serialize(void);
+
+/**
+ * \brief Test the cumulative distribution written to a file ends at the whole count
+ */
+u32 Test_MC_Histogram_WriteCdf(void);
+
+/**
+ * \brief Test values recorded from several threads at once are all in a Snapshot
+ */
+u32 Test_MC_Histogram_Recorder(void);
+
+/**
+ * \brief Test the bytes a Histogram holds are tracked
+ */
+u32 Test_MC_Histogram_MemStats(void);
+
+/**
+ * \brief Test the durations of trace spans are gathered by name
+ */
+u32 Test_MC_Histogram_Trace(void);
+
+#endif
@@ -0,0 +1,74 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_test_log.h                                                                          */
+/* \brief: Test prototypes for the log interface                                                 */
+/*                                                                                               */
+/* \Expects: No expectations are made prior to type definitions in this file                     */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#ifndef MC_TEST_LOG_H
+#define MC_TEST_LOG_H
+
+#include "mc_type.h"
+
+/**
+ * \brief Test synchronous logging writes one formatted line per call
+ */
+u32 Test_MC_Log_Sync(void);
+
+/**
+ * \brief Test synchronous logging from several threads never tears a line, and keeps lines longer than the buffer whole
+ */
+u32 Test_MC_Log_SyncThreads(void);
+
+/**
+ * \brief Test asynchronous logging from several threads keeps every line, in order per thread, after a line
+ * logged before MC_Log_InitAsync
+ */
+u32 Test_MC_Log_Async(void);
+
+/**
+ * \brief Test MC_Log_Flush makes earlier lines visible in the file while the log stays open, and returns
+ * while another thread keeps logging
+ */
+u32 Test_MC_Log_Flush(void);
+
+/**
+ * \brief Test the drop and count overflow policies account for every line
+ */
+u32 Test_MC_Log_Overflow(void);
+
+/**
+ * \brief Test the runtime threshold skips lower levels without evaluating their arguments
+ */
+u32 Test_MC_Log_Level(void);
+
+/**
+ * \brief Test every line carries the local time to the microsecond, never going back between lines
+ */
+u32 Test_MC_Log_Timestamp(void);
+
+/**
+ * \brief Test a binary log from several threads decodes to the lines the text modes would have written
+ */
+u32 Test_MC_Log_Binary(void);
+
+/**
+ * \brief Test mapped files rotate by size with no line lost, torn or left with padding, survive a crash, and
+ * give the signal handlers back on Close after a failed rotation
+ */
+u32 Test_MC_Log_Mapped(void);
+
+/**
+ * \brief Test structured lines are valid JSON in every mode, escaped, with exact numbers, and cut at a field
+ */
+u32 Test_MC_Log_KV(void);
+
+/**
+ * \brief Test limited and sampled sites log their share without evaluating the rest, and report every skipped line
+ */
+u32 Test_MC_Log_RateLimit(void);
+
+#endif
@@ -0,0 +1,36 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_test_memtrack.h                                                                     */
+/* \brief: Test prototypes for the memtrack interface                                            */
+/*                                                                                               */
+/* \Expects: No expectations are made prior to type definitions in this file                     */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#ifndef MC_TEST_MEMTRACK_H
+#define MC_TEST_MEMTRACK_H
+
+#include "mc_type.h"
+
+/**
+ * \brief Test the queries report zeros and false when tracking is compiled out, and module names
+ */
+u32 Test_MC_MemTrack_Disabled(void);
+
+/**
+ * \brief Test per instance counters of HashMap, Stack and Arena follow their allocations
+ */
+u32 Test_MC_MemTrack_Instance(void);
+
+/**
+ * \brief Test module counters balance across threads, whose batches are published as they exit
+ */
+u32 Test_MC_MemTrack_Concurrent(void);
+
+/**
+ * \brief Test live memory is reported as leaked until it is freed, and the shared node Pools never are
+ */
+u32 Test_MC_MemTrack_Leaks(void);
+
+#endif
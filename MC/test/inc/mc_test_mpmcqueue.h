@@ -0,0 +1,36 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_test_mpmcqueue.h                                                                    */
+/* \brief: Test prototypes for the mpmcqueue interface                                           */
+/*                                                                                               */
+/* \Expects: No expectations are made prior to type definitions in this file                     */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#ifndef MC_TEST_MPMCQUEUE_H
+#define MC_TEST_MPMCQUEUE_H
+
+#include "mc_type.h"
+
+/**
+ * \brief Test MpmcQueue init and clear functionality, and capacity rounding
+ */
+u32 Test_MC_MpmcQueue_InitAndFree(void);
+
+/**
+ * \brief Test TryEnqueue and TryDequeue are first in, first out and respect full and empty
+ */
+u32 Test_MC_MpmcQueue_TryFifo(void);
+
+/**
+ * \brief Test several producer and consumer threads hand over every element exactly once
+ */
+u32 Test_MC_MpmcQueue_Concurrent(void);
+
+/**
+ * \brief Test Close wakes sleeping consumers, rejects enqueues and lets the queue drain
+ */
+u32 Test_MC_MpmcQueue_Close(void);
+
+#endif
@@ -0,0 +1,31 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_test_perfcounters.h                                                                 */
+/* \brief: Test prototypes for the perfcounters interface                                        */
+/*                                                                                               */
+/* \Expects: No expectations are made prior to type definitions in this file                     */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#ifndef MC_TEST_PERFCOUNTERS_H
+#define MC_TEST_PERFCOUNTERS_H
+
+#include "mc_type.h"
+
+/**
+ * \brief Test every function accepts counters that could not be opened and measures nothing
+ */
+u32 Test_MC_PerfCounters_Unavailable(void);
+
+/**
+ * \brief Test a region is counted, reads while running never go backwards, and stopped counters stay put
+ */
+u32 Test_MC_PerfCounters_Region(void);
+
+/**
+ * \brief Test event names, including an out of range event
+ */
+u32 Test_MC_PerfCounters_EventName(void);
+
+#endif
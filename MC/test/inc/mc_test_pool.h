@@ -0,0 +1,36 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_test_pool.h                                                                         */
+/* \brief: Test prototypes for the pool interface                                                */
+/*                                                                                               */
+/* \Expects: No expectations are made prior to type definitions in this file                     */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#ifndef MC_TEST_POOL_H
+#define MC_TEST_POOL_H
+
+#include "mc_type.h"
+
+/**
+ * \brief Test Pool init and clear functionality, and object size rounding
+ */
+u32 Test_MC_Pool_InitAndFree(void);
+
+/**
+ * \brief Test objects are distinct, aligned, writable and reused after Release
+ */
+u32 Test_MC_Pool_AllocRelease(void);
+
+/**
+ * \brief Test completely free slabs are returned to the system past the threshold
+ */
+u32 Test_MC_Pool_SlabRelease(void);
+
+/**
+ * \brief Test threads allocating, and releasing objects allocated by other threads
+ */
+u32 Test_MC_Pool_Concurrent(void);
+
+#endif
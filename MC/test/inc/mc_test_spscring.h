@@ -0,0 +1,41 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_test_spscring.h                                                                     */
+/* \brief: Test prototypes for the spscring interface                                            */
+/*                                                                                               */
+/* \Expects: No expectations are made prior to type definitions in this file                     */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#ifndef MC_TEST_SPSCRING_H
+#define MC_TEST_SPSCRING_H
+
+#include "mc_type.h"
+
+/**
+ * \brief Test SpscRing init and clear functionality, and capacity rounding
+ */
+u32 Test_MC_SpscRing_InitAndFree(void);
+
+/**
+ * \brief Test Enqueue and Dequeue are first in, first out and respect full and empty
+ */
+u32 Test_MC_SpscRing_EnqueueDequeue(void);
+
+/**
+ * \brief Test EnqueueN and DequeueN wrap around the end of the ring and stop when full or empty
+ */
+u32 Test_MC_SpscRing_Batch(void);
+
+/**
+ * \brief Test Reserve/Commit and Acquire/Release hand out contiguous slots without copying
+ */
+u32 Test_MC_SpscRing_ReserveCommit(void);
+
+/**
+ * \brief Test a producer and a consumer thread pass every element across in order
+ */
+u32 Test_MC_SpscRing_Concurrent(void);
+
+#endif
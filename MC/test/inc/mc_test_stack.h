@@ -43,4 +43,34 @@ u32 Test_MC_Stack_IsEmpty(void);
  */
 u32 Test_MC_Stack_GetSize(void);
 
+/**
+ * \brief Test typed Stack stores elements by value, and Pop/Peek hand back copies in LIFO order
+ */
+u32 Test_MC_Stack_TypedPushPop(void);
+
+/**
+ * \brief Test PushN and PopN move whole runs for both typed and pointer Stacks
+ */
+u32 Test_MC_Stack_PushNPopN(void);
+
+/**
+ * \brief Test Pop hands ownership of a dynamic value back to the caller instead of freeing it
+ */
+u32 Test_MC_Stack_PopDynamicOwnership(void);
+
+/**
+ * \brief Test SmallStack stays in its inline storage while within the inline count
+ */
+u32 Test_MC_Stack_SmallStackInline(void);
+
+/**
+ * \brief Test SmallStack spills to the heap past its inline count and keeps every element intact
+ */
+u32 Test_MC_Stack_SmallStackSpill(void);
+
+/**
+ * \brief Test pointer and typed Stacks placed in an Arena, and that popped nodes are recycled
+ */
+u32 Test_MC_Stack_Arena(void);
+
 #endif
@@ -0,0 +1,42 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_test_trace.h                                                                        */
+/* \brief: Test prototypes for the trace interface                                               */
+/*                                                                                               */
+/* \Expects: No expectations are made prior to type definitions in this file                     */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#ifndef MC_TEST_TRACE_H
+#define MC_TEST_TRACE_H
+
+#include "mc_type.h"
+
+/**
+ * \brief Test nothing is recorded or written outside of a session, and a session cannot start twice
+ */
+u32 Test_MC_Trace_Disabled(void);
+
+/**
+ * \brief Test nested scopes, instants and counters are written as balanced, escaped, ordered trace events
+ */
+u32 Test_MC_Trace_Scope(void);
+
+/**
+ * \brief Test several threads record into buffers of their own, each written under its own tid
+ */
+u32 Test_MC_Trace_Threads(void);
+
+/**
+ * \brief Test a full buffer drops and counts events without leaving a span unbalanced
+ */
+u32 Test_MC_Trace_Dropped(void);
+
+/**
+ * \brief Test the hash and stack spans are recorded when built with MC_TRACING, and absent otherwise,
+ * and calls after MC_Trace_Stop record no ends
+ */
+u32 Test_MC_Trace_Modules(void);
+
+#endif
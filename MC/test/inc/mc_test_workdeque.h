@@ -0,0 +1,36 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_test_workdeque.h                                                                    */
+/* \brief: Test prototypes for the workdeque interface                                           */
+/*                                                                                               */
+/* \Expects: No expectations are made prior to type definitions in this file                     */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#ifndef MC_TEST_WORKDEQUE_H
+#define MC_TEST_WORKDEQUE_H
+
+#include "mc_type.h"
+
+/**
+ * \brief Test WorkDeque init and clear functionality
+ */
+u32 Test_MC_WorkDeque_InitAndFree(void);
+
+/**
+ * \brief Test owner Push and Pop behave in last in, first out fashion
+ */
+u32 Test_MC_WorkDeque_PushPop(void);
+
+/**
+ * \brief Test Steal takes the oldest elements first, and the WorkDeque grows past its capacity
+ */
+u32 Test_MC_WorkDeque_StealAndGrow(void);
+
+/**
+ * \brief Test every pushed element is taken exactly once while several thieves steal concurrently
+ */
+u32 Test_MC_WorkDeque_ConcurrentSteal(void);
+
+#endif
@@ -0,0 +1,341 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_test_module_allocator.c                                                             */
+/* \brief: Source code for testing mc_allocator                                                  */
+/*                                                                                               */
+/* \Expects: 1. All necessary mc definitions are defined and linked properly                     */
+/*                                                                                               */
+/*           Unit tests should follow a step by step approach and be specific to the             */
+/*           name of the function which they are evoked.                                         */
+/*           1. Arrange - Stage the entities to be tested on                                     */
+/*           2. Act - If necessary, perform any routines that might be necessary                 */
+/*           3. Assert - Determine if expectations are met for the test                          */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#include "mc_test.h"
+#include <stdlib.h>     // malloc
+#include <string.h>     // memset
+#include <stdio.h>      // snprintf
+
+/**
+ * \brief Counts what goes through it, and checks every free and realloc is given the size it allocated.
+ */
+typedef struct
+{
+    u64 allocs;
+    u64 frees;
+    u64 reallocs;
+    u64 liveBytes;
+    u64 badSizes;
+} TestAllocator;
+
+static void* test_allocator_alloc(void *ctx, u64 size)
+{
+    TestAllocator *test = (TestAllocator*)ctx;
+    u64 *block = (u64*)malloc(size + 16);
+
+    if (!block)
+    {
+        return NULL;
+    }
+
+    block[0] = size;    // 16 byte header keeps the user pointer 16 byte aligned
+    test->allocs++;
+    test->liveBytes += size;
+
+    return block + 2;
+}
+
+static void test_allocator_free(void *ctx, void *memory, u64 size)
+{
+    TestAllocator *test = (TestAllocator*)ctx;
+    u64 *block = (u64*)memory - 2;
+
+    test->badSizes += block[0] != size;
+    test->frees++;
+    test->liveBytes -= block[0];
+
+    free(block);
+}
+
+static void* test_allocator_realloc(void *ctx, void *memory, u64 old_size, u64 new_size)
+{
+    TestAllocator *test = (TestAllocator*)ctx;
+    u8 *resized = (u8*)test_allocator_alloc(ctx, new_size);
+
+    if (resized)
+    {
+        memcpy(resized, memory, old_size < new_size ? old_size : new_size);
+        test_allocator_free(ctx, memory, old_size);
+        test->reallocs++;
+    }
+
+    return resized;
+}
+
+u32 Test_MC_Allocator_Default(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    const MC_Allocator *allocator = MC_Allocator_Default();
+
+    /* Act */
+    u8 *memory = (u8*)MC_Allocator_Alloc(NULL, TEST_CONSTANT_10);
+    ASSERT_NOT_NULL(memory, failCount);
+    memset(memory, 0xAB, TEST_CONSTANT_10);
+
+    u8 *resized = (u8*)MC_Allocator_Realloc(NULL, memory, TEST_CONSTANT_10, TEST_CONSTANT_10000);
+    char *copy = MC_Allocator_StrDup(NULL, "MarCore");
+
+    /* Assert */
+    ASSERT_TRUE(MC_Allocator_IsDefault(allocator), failCount);
+    ASSERT_TRUE(MC_Allocator_IsDefault(NULL), failCount);
+    ASSERT_TRUE(MC_Allocator_GetGlobal() == allocator, failCount);
+    ASSERT_NOT_NULL(resized, failCount);
+    ASSERT_EQUAL_UINT64(resized[TEST_CONSTANT_10 - 1], 0xABULL, failCount);
+    ASSERT_NOT_NULL(copy, failCount);
+    ASSERT_STRING_EQUAL(copy, "MarCore", 8, failCount);
+    ASSERT_NULL(MC_Allocator_StrDup(NULL, NULL), failCount);
+
+    MC_Allocator_Free(NULL, resized, TEST_CONSTANT_10000);
+    MC_Allocator_Free(NULL, copy, 8);
+    MC_Allocator_Free(NULL, NULL, 0);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Allocator_InitEx(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    TestAllocator test = { 0 };
+    MC_Allocator allocator = { test_allocator_alloc, test_allocator_realloc, test_allocator_free, &test };
+    char key[TEST_CONSTANT_32];
+
+    MC_HashMap *map = MC_Hashmap_InitEx(TEST_CONSTANT_10, &allocator);
+    MC_Stack *stack = MC_Stack_InitEx(&allocator);
+    MC_Stack *typed = MC_Stack_InitTypedEx(sizeof(u64), &allocator);
+    MC_Arena *arena = MC_Arena_InitEx(0, &allocator);
+    MC_Guid *guid = NULL;
+
+    ASSERT_NOT_NULL(map, failCount);
+    ASSERT_NOT_NULL(stack, failCount);
+    ASSERT_NOT_NULL(typed, failCount);
+    ASSERT_NOT_NULL(arena, failCount);
+    ASSERT_FALSE(MC_Allocator_IsDefault(&allocator), failCount);
+
+    /* Act */
+    for (u64 i = 0; i < TEST_CONSTANT_10000; i++)
+    {
+        snprintf(key, sizeof(key), "Index: %05llu", (unsigned long long)i);
+        ASSERT_TRUE(MC_Hashmap_Insert(map, key, NULL, false), failCount);
+        ASSERT_TRUE(MC_Stack_Push(stack, NULL, false), failCount);
+        ASSERT_TRUE(MC_Stack_Push(typed, &i, false), failCount);
+    }
+
+    u64 allocsWhileFull = test.allocs;
+
+    for (u64 i = 0; i < TEST_CONSTANT_10000 / 2; i++)
+    {
+        snprintf(key, sizeof(key), "Index: %05llu", (unsigned long long)i);
+        ASSERT_TRUE(MC_Hashmap_RemoveAt(map, key), failCount);
+        MC_Stack_Pop(stack);
+    }
+
+    u8 generated = MC_GUID_GenerateEx(&guid, &allocator);
+
+    /* Assert */
+    ASSERT_TRUE(allocsWhileFull >= TEST_CONSTANT_10000 * 3, failCount);    // node and key per entry, node per push
+    ASSERT_TRUE(test.reallocs > 0, failCount);
+    ASSERT_EQUAL_UINT64(*(u64*)MC_Stack_Peek(typed), TEST_CONSTANT_10000 - 1, failCount);
+
+    if (generated)  // Guid generation itself may be unavailable, its allocation is what is under test
+    {
+        MC_GUID_ReleaseEx(&guid, &allocator);
+        ASSERT_NULL(guid, failCount);
+    }
+
+    MC_Hashmap_Free(&map);
+    MC_Stack_Free(&stack);
+    MC_Stack_Free(&typed);
+    MC_Arena_Free(&arena);
+
+    ASSERT_EQUAL_UINT64(test.liveBytes, 0, failCount);
+    ASSERT_EQUAL_UINT64(test.allocs, test.frees, failCount);
+    ASSERT_EQUAL_UINT64(test.badSizes, 0, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Allocator_Global(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    TestAllocator test = { 0 };
+    MC_Allocator allocator = { test_allocator_alloc, test_allocator_realloc, test_allocator_free, &test };
+
+    MC_Allocator_SetGlobal(&allocator);
+
+    MC_HashMap *map = MC_Hashmap_Init(TEST_CONSTANT_10);
+    MC_Stack *stack = MC_Stack_Init();
+    MC_Guid *guid = NULL;
+    MC_SMALL_STACK(small, u64, 4);
+
+    /* Act */
+    ASSERT_TRUE(MC_Hashmap_Insert(map, "key", NULL, false), failCount);
+    ASSERT_TRUE(MC_Stack_Push(stack, NULL, false), failCount);
+
+    for (u64 i = 0; i < TEST_CONSTANT_10; i++)
+    {
+        ASSERT_TRUE(MC_SmallStack_Push(&small, &i), failCount);
+    }
+
+    u8 generated = MC_GUID_Generate(&guid);
+
+    MC_Allocator_SetGlobal(NULL);   // created under the counting allocator, so they must be freed through it still
+
+    /* Assert */
+    ASSERT_TRUE(MC_Allocator_GetGlobal() == MC_Allocator_Default(), failCount);
+    ASSERT_TRUE(test.allocs >= 6, failCount);
+    ASSERT_FALSE(MC_SmallStack_IsInline(&small), failCount);
+
+    if (generated)
+    {
+        MC_GUID_ReleaseEx(&guid, &allocator);
+    }
+
+    MC_Hashmap_Free(&map);
+    MC_Stack_Free(&stack);
+    MC_SmallStack_Free(&small);
+
+    ASSERT_EQUAL_UINT64(test.liveBytes, 0, failCount);
+    ASSERT_EQUAL_UINT64(test.badSizes, 0, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Allocator_ReallocEmulated(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    TestAllocator test = { 0 };
+    MC_Allocator allocator = { test_allocator_alloc, NULL, test_allocator_free, &test };
+    MC_Stack *typed = MC_Stack_InitTypedEx(sizeof(u64), &allocator);
+    u64 mismatches = 0;
+
+    ASSERT_NOT_NULL(typed, failCount);
+
+    /* Act */
+    for (u64 i = 0; i < TEST_CONSTANT_10000; i++)
+    {
+        ASSERT_TRUE(MC_Stack_Push(typed, &i, false), failCount);
+    }
+
+    for (u64 i = TEST_CONSTANT_10000; i > 0; i--)
+    {
+        mismatches += *(u64*)MC_Stack_Pop(typed) != i - 1;
+    }
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(mismatches, 0, failCount);
+    ASSERT_EQUAL_UINT64(test.reallocs, 0, failCount);
+    ASSERT_TRUE(test.frees > 0, failCount);    // every growth released the old storage itself
+
+    MC_Stack_Free(&typed);
+
+    ASSERT_EQUAL_UINT64(test.liveBytes, 0, failCount);
+    ASSERT_EQUAL_UINT64(test.badSizes, 0, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Allocator_Pages(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    MC_Allocator allocators[2] = { MC_Allocator_Numa(0), MC_Allocator_HugePage() };
+    u64 sizes[3] = { TEST_CONSTANT_32, MC_ALLOCATOR_PAGE_THRESHOLD + 1, MC_ALLOCATOR_HUGE_THRESHOLD * 3 + 1 };
+    char key[TEST_CONSTANT_32];
+
+    for (u64 a = 0; a < 2; a++)
+    {
+        ASSERT_NULL(allocators[a].realloc, failCount);
+        ASSERT_FALSE(MC_Allocator_IsDefault(&allocators[a]), failCount);
+
+        for (u64 s = 0; s < 3; s++)
+        {
+            /* Act */
+            u8 *memory = (u8*)MC_Allocator_Alloc(&allocators[a], sizes[s]);
+            ASSERT_NOT_NULL(memory, failCount);
+
+            if (!memory)
+            {
+                continue;
+            }
+
+            memset(memory, 0x5A, sizes[s]);
+
+            u8 *resized = (u8*)MC_Allocator_Realloc(&allocators[a], memory, sizes[s], sizes[s] * 2);
+
+            /* Assert */
+            ASSERT_TRUE(((uintptr_t)memory & 15) == 0, failCount);
+            ASSERT_NOT_NULL(resized, failCount);
+            ASSERT_EQUAL_UINT64((u64)(resized ? resized[sizes[s] - 1] : 0), 0x5AULL, failCount);
+
+            MC_Allocator_Free(&allocators[a], resized, sizes[s] * 2);
+        }
+    }
+
+    /* A bucket array well past the huge page threshold */
+    MC_HashMap *map = MC_Hashmap_InitEx(MC_ALLOCATOR_HUGE_THRESHOLD, &allocators[1]);
+    ASSERT_NOT_NULL(map, failCount);
+
+    for (u64 i = 0; i < TEST_CONSTANT_10000; i++)
+    {
+        snprintf(key, sizeof(key), "Index: %05llu", (unsigned long long)i);
+        ASSERT_TRUE(MC_Hashmap_Insert(map, key, (void*)(uintptr_t)(i + 1), false), failCount);
+    }
+
+    snprintf(key, sizeof(key), "Index: %05llu", (unsigned long long)TEST_CONSTANT_10);
+    ASSERT_TRUE(MC_Hashmap_Search(map, key) == (void*)(uintptr_t)(TEST_CONSTANT_10 + 1), failCount);
+
+    MC_Hashmap_Free(&map);
+    ASSERT_NULL(map, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+int main(void)
+{
+    int failCount = 0;
+
+    failCount += Test_MC_Allocator_Default();
+    failCount += Test_MC_Allocator_InitEx();
+    failCount += Test_MC_Allocator_Global();
+    failCount += Test_MC_Allocator_ReallocEmulated();
+    failCount += Test_MC_Allocator_Pages();
+
+    return failCount;
+}
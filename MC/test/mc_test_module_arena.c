@@ -0,0 +1,193 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_test_module_arena.c                                                                 */
+/* \brief: Source code for testing mc_arena                                                      */
+/*                                                                                               */
+/* \Expects: 1. All necessary mc definitions are defined and linked properly                     */
+/*                                                                                               */
+/*           Unit tests should follow a step by step approach and be specific to the             */
+/*           name of the function which they are evoked.                                         */
+/*           1. Arrange - Stage the entities to be tested on                                     */
+/*           2. Act - If necessary, perform any routines that might be necessary                 */
+/*           3. Assert - Determine if expectations are met for the test                          */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#include "mc_test.h"
+#include <string.h>     // memset
+
+#define TEST_ARENA_CHUNK 1024
+
+u32 Test_MC_Arena_InitAndFree(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    MC_Arena *arena = MC_Arena_Init(0);
+
+    ASSERT_NOT_NULL(arena, failCount);
+    ASSERT_EQUAL_UINT64(MC_Arena_Used(arena), 0, failCount);
+    ASSERT_TRUE(MC_Arena_Reserved(arena) > 0, failCount);
+
+    /* Act */
+    MC_Arena_Free(&arena);
+
+    /* Assert */
+    ASSERT_NULL(arena, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Arena_AllocAndChain(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    MC_Arena *arena = MC_Arena_Init(TEST_ARENA_CHUNK);
+    u64 misaligned = 0;
+
+    ASSERT_NOT_NULL(arena, failCount);
+    ASSERT_NULL(MC_Arena_AllocAligned(arena, 8, 3), failCount);    // not a power of two
+
+    /* Act */
+    for (u64 i = 0; i < TEST_CONSTANT_1000000; i++)
+    {
+        u64 alignment = 1ULL << (i % 8);
+        u8 *memory = (u8*)MC_Arena_AllocAligned(arena, i % TEST_CONSTANT_32 + 1, alignment);
+
+        if (memory == NULL || ((uintptr_t)memory & (alignment - 1)) != 0)
+        {
+            misaligned++;
+            continue;
+        }
+
+        memset(memory, 0xAB, i % TEST_CONSTANT_32 + 1);     // ASan catches writes past the chunk
+    }
+
+    u64 reservedBefore = MC_Arena_Reserved(arena);
+    u8 *big = (u8*)MC_Arena_Alloc(arena, TEST_ARENA_CHUNK * 4);     // larger than a chunk
+    u64 reservedAfter = MC_Arena_Reserved(arena);
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(misaligned, 0, failCount);
+    ASSERT_NOT_NULL(big, failCount);
+    ASSERT_TRUE(reservedAfter - reservedBefore >= TEST_ARENA_CHUNK * 4, failCount);
+    ASSERT_TRUE(MC_Arena_Used(arena) <= MC_Arena_Reserved(arena), failCount);
+
+    char *copy = MC_Arena_StrDup(arena, "MarCore");
+    ASSERT_STRING_EQUAL(copy, "MarCore", sizeof("MarCore"), failCount);
+
+    MC_Arena_Free(&arena);
+
+    ASSERT_NULL(arena, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Arena_MarkAndRewind(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    MC_Arena *arena = MC_Arena_Init(TEST_ARENA_CHUNK);
+
+    ASSERT_NOT_NULL(arena, failCount);
+
+    u64 *kept = (u64*)MC_Arena_Alloc(arena, sizeof(u64));
+    *kept = TEST_CONSTANT_10000;
+    MC_ArenaMark mark = MC_Arena_Mark(arena);
+    u64 usedAtMark = MC_Arena_Used(arena);
+
+    /* Act */
+    for (u64 i = 0; i < TEST_CONSTANT_10000; i++)   // spills over many chunks
+    {
+        MC_Arena_Alloc(arena, TEST_CONSTANT_32);
+    }
+
+    u64 reservedBeforeRewind = MC_Arena_Reserved(arena);
+    MC_Arena_Rewind(arena, mark);
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(MC_Arena_Used(arena), usedAtMark, failCount);
+    ASSERT_EQUAL_UINT64(*kept, TEST_CONSTANT_10000, failCount);
+
+    u64 *next = (u64*)MC_Arena_Alloc(arena, sizeof(u64));      // lands right after the kept allocation
+    ASSERT_TRUE((u8*)next - (u8*)kept == MC_ARENA_DEFAULT_ALIGNMENT, failCount);
+
+    for (u64 i = 0; i < TEST_CONSTANT_10000; i++)
+    {
+        MC_Arena_Alloc(arena, TEST_CONSTANT_32);
+    }
+
+    ASSERT_EQUAL_UINT64(MC_Arena_Reserved(arena), reservedBeforeRewind, failCount);
+
+    MC_Arena_Free(&arena);
+
+    ASSERT_NULL(arena, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Arena_ResetReuse(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    MC_Arena *arena = MC_Arena_Init(TEST_ARENA_CHUNK);
+    u64 reservedAfterFirstRound = 0;
+    u64 failedAllocs = 0;
+
+    ASSERT_NOT_NULL(arena, failCount);
+
+    /* Act */
+    for (u64 round = 0; round < TEST_CONSTANT_10; round++)
+    {
+        for (u64 i = 0; i < TEST_CONSTANT_10000; i++)
+        {
+            failedAllocs += MC_Arena_Alloc(arena, TEST_CONSTANT_10) == NULL;
+        }
+
+        if (round == 0)
+        {
+            reservedAfterFirstRound = MC_Arena_Reserved(arena);
+        }
+
+        MC_Arena_Reset(arena);
+    }
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(failedAllocs, 0, failCount);
+    ASSERT_EQUAL_UINT64(MC_Arena_Used(arena), 0, failCount);
+    ASSERT_EQUAL_UINT64(MC_Arena_Reserved(arena), reservedAfterFirstRound, failCount);
+
+    MC_Arena_Free(&arena);
+
+    ASSERT_NULL(arena, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+int main(void)
+{
+    int failCount = 0;
+
+    failCount += Test_MC_Arena_InitAndFree();
+    failCount += Test_MC_Arena_AllocAndChain();
+    failCount += Test_MC_Arena_MarkAndRewind();
+    failCount += Test_MC_Arena_ResetReuse();
+
+    return failCount;
+}
@@ -15,6 +15,59 @@
 /* ********************************************************************************************* */
 
 #include "mc_test.h"
+#include <stdlib.h>     // malloc, calloc
+#include <threads.h>    // thrd_create
+#include <string.h>     // memcmp, memset, strlen
+#include <time.h>       // timespec_get
+
+#define TEST_GUID_THREADS 4
+
+typedef struct
+{
+    char (*strs)[MC_GUID_SIZE];     // TEST_CONSTANT_10000 formatted Guids
+    u64 failed;
+    u64 unordered;                  // version 7 Guids not above the one before them
+} TestGuid;
+
+static int test_guid_worker(void *arg)
+{
+    TestGuid *test = (TestGuid*)arg;
+
+    for (u64 i = 0; i < TEST_CONSTANT_10000; i++)
+    {
+        MC_Guid *guid = NULL;
+
+        if (!MC_GUID_Generate(&guid) || !MC_GUID_Format_String(guid, test->strs[i], MC_GUID_SIZE))
+        {
+            test->failed++;
+            test->strs[i][0] = '\0';
+        }
+
+        MC_GUID_Release(&guid);
+    }
+
+    return 0;
+}
+
+static int test_guid_v7_worker(void *arg)
+{
+    TestGuid *test = (TestGuid*)arg;
+
+    for (u64 i = 0; i < TEST_CONSTANT_10000; i++)
+    {
+        MC_Guid guid;
+
+        if (!MC_GUID_GenerateV7(&guid) || !MC_GUID_Format(&guid, test->strs[i], MC_GUID_SIZE))
+        {
+            test->failed++;
+            test->strs[i][0] = '\0';
+        }
+
+        test->unordered += i && strcmp(test->strs[i - 1], test->strs[i]) >= 0;
+    }
+
+    return 0;
+}
 
 u32 Test_MC_Guid_Generate(void)
 {
@@ -94,12 +147,563 @@ u32 Test_MC_Guid_Format(void)
     return failCount;
 }
 
+u32 Test_MC_Guid_Arena(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount           = 0;
+    u16 successGenerates    = 0;
+    MC_Arena *arena         = MC_Arena_Init(0);
+    MC_Guid *first          = NULL;
+    MC_Guid *second         = NULL;
+    char firstStr[MC_GUID_SIZE];
+    char secondStr[MC_GUID_SIZE];
+
+    ASSERT_NOT_NULL(arena, failCount);
+    ASSERT_FALSE(MC_GUID_GenerateArena(NULL, &first), failCount);
+
+    /* Act */
+    successGenerates += MC_GUID_GenerateArena(arena, &first);
+    successGenerates += MC_GUID_GenerateArena(arena, &second);
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(successGenerates, 2, failCount);
+    ASSERT_TRUE(MC_GUID_Format_String(first, firstStr, MC_GUID_SIZE), failCount);
+    ASSERT_TRUE(MC_GUID_Format_String(second, secondStr, MC_GUID_SIZE), failCount);
+    ASSERT_STRING_NOT_EQUAL(firstStr, secondStr, MC_GUID_SIZE, failCount);
+
+    MC_Arena_Free(&arena);      // releases both Guids, they are never passed to MC_GUID_Release
+
+    ASSERT_NULL(arena, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Guid_Version(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount   = 0;
+    u64 badVersions = 0;
+    u64 badVariants = 0;
+    char str[MC_GUID_SIZE];
+
+    /* Act */
+    for (u64 i = 0; i < TEST_CONSTANT_10000; i++)
+    {
+        MC_Guid *guid = NULL;
+
+        ASSERT_TRUE(MC_GUID_Generate(&guid), failCount);
+        ASSERT_TRUE(MC_GUID_Format_String(guid, str, MC_GUID_SIZE), failCount);
+
+        badVersions += str[14] != '4';
+        badVariants += str[19] != '8' && str[19] != '9' && str[19] != 'A' && str[19] != 'B';
+
+        MC_GUID_Release(&guid);
+    }
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(badVersions, 0, failCount);
+    ASSERT_EQUAL_UINT64(badVariants, 0, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Guid_Unique(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount   = 0;
+    u64 duplicates  = 0;
+    thrd_t threads[TEST_GUID_THREADS];
+    TestGuid tests[TEST_GUID_THREADS];
+    MC_HashMap *seen = MC_Hashmap_Init(TEST_CONSTANT_10000);
+
+    /* Act */
+    for (u64 t = 0; t < TEST_GUID_THREADS; t++)
+    {
+        tests[t].strs = malloc(TEST_CONSTANT_10000 * MC_GUID_SIZE);
+        tests[t].failed = 0;
+        thrd_create(&threads[t], test_guid_worker, &tests[t]);
+    }
+
+    for (u64 t = 0; t < TEST_GUID_THREADS; t++)
+    {
+        thrd_join(threads[t], NULL);
+        ASSERT_EQUAL_UINT64(tests[t].failed, 0, failCount);
+
+        for (u64 i = 0; i < TEST_CONSTANT_10000; i++)
+        {
+            duplicates += MC_Hashmap_Search(seen, tests[t].strs[i]) != NULL;  // every key is 36 characters
+            MC_Hashmap_Insert(seen, tests[t].strs[i], seen, false);
+        }
+
+        free(tests[t].strs);
+    }
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(duplicates, 0, failCount);
+
+    MC_Hashmap_Free(&seen);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Guid_GenerateInto(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    MC_Guid first;
+    MC_Guid second;
+    char firstStr[MC_GUID_SIZE];
+    char secondStr[MC_GUID_SIZE];
+
+    /* Act */
+    ASSERT_TRUE(MC_GUID_GenerateInto(&first), failCount);
+    ASSERT_TRUE(MC_GUID_GenerateInto(&second), failCount);
+    ASSERT_FALSE(MC_GUID_GenerateInto(NULL), failCount);
+
+    MC_GUID_Format_String(&first, firstStr, MC_GUID_SIZE);
+    MC_GUID_Format_String(&second, secondStr, MC_GUID_SIZE);
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(sizeof(MC_Guid), 16, failCount);
+    ASSERT_EQUAL_UINT64(first.data3 >> 12, 4, failCount);
+    ASSERT_EQUAL_UINT64(first.data4[0] >> 6, 2, failCount);
+    ASSERT_STRING_NOT_EQUAL(firstStr, secondStr, MC_GUID_SIZE, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Guid_GenerateBatch(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount   = 0;
+    u64 count       = TEST_CONSTANT_10000 + 3;
+    u64 badBits     = 0;
+    u64 duplicates  = 0;
+    MC_Guid *guids  = (MC_Guid*)calloc(count + 1, sizeof(MC_Guid));
+    MC_HashMap *seen = MC_Hashmap_Init(TEST_CONSTANT_10000);
+    char str[MC_GUID_SIZE];
+
+    ASSERT_NOT_NULL(guids, failCount);
+
+    /* Act */
+    ASSERT_TRUE(MC_GUID_GenerateBatch(guids, count), failCount);
+    ASSERT_TRUE(MC_GUID_GenerateBatch(NULL, 0), failCount);
+    ASSERT_FALSE(MC_GUID_GenerateBatch(NULL, 1), failCount);
+
+    for (u64 i = 0; i < count; i++)
+    {
+        badBits += (guids[i].data3 >> 12) != 4 || (guids[i].data4[0] >> 6) != 2;
+
+        MC_GUID_Format_String(&guids[i], str, MC_GUID_SIZE);
+        duplicates += MC_Hashmap_Search(seen, str) != NULL;
+        MC_Hashmap_Insert(seen, str, seen, false);
+    }
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(badBits, 0, failCount);
+    ASSERT_EQUAL_UINT64(duplicates, 0, failCount);
+    ASSERT_EQUAL_UINT64(guids[count].data1 | guids[count].data2 | guids[count].data3, 0, failCount);    // nothing past the end
+
+    MC_Hashmap_Free(&seen);
+    free(guids);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Guid_FormatFast(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount   = 0;
+    u64 mismatches  = 0;
+    MC_Guid guids[TEST_CONSTANT_10000];
+    char expected[MC_GUID_SIZE];
+    char actual[MC_GUID_SIZE];
+    MC_Guid edges[2];
+
+    memset(&edges[0], 0x00, sizeof(MC_Guid));
+    memset(&edges[1], 0xFF, sizeof(MC_Guid));
+
+    /* Act */
+    MC_GUID_GenerateBatch(guids, TEST_CONSTANT_10000);
+
+    for (u64 i = 0; i < TEST_CONSTANT_10000; i++)
+    {
+        MC_GUID_Format_String(&guids[i], expected, MC_GUID_SIZE);
+        MC_GUID_Format(&guids[i], actual, MC_GUID_SIZE);
+        mismatches += memcmp(expected, actual, MC_GUID_SIZE) != 0;
+    }
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(mismatches, 0, failCount);
+    ASSERT_TRUE(MC_GUID_Format(&edges[0], actual, MC_GUID_SIZE), failCount);
+    ASSERT_STRING_EQUAL(actual, "00000000-0000-0000-0000-000000000000", MC_GUID_SIZE, failCount);
+    ASSERT_TRUE(MC_GUID_Format(&edges[1], actual, MC_GUID_SIZE), failCount);
+    ASSERT_STRING_EQUAL(actual, "FFFFFFFF-FFFF-FFFF-FFFF-FFFFFFFFFFFF", MC_GUID_SIZE, failCount);
+    ASSERT_FALSE(MC_GUID_Format(&guids[0], actual, MC_GUID_SIZE - 1), failCount);
+    ASSERT_FALSE(MC_GUID_Format(NULL, actual, MC_GUID_SIZE), failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Guid_Parse(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount   = 0;
+    u64 mismatches  = 0;
+    MC_Guid guid;
+    MC_Guid parsed;
+    char str[MC_GUID_SIZE];
+    const char *known = "01234567-89ab-CDEF-a0B1-c2D3e4F5a6B7";
+
+    /* Act */
+    for (u64 i = 0; i < TEST_CONSTANT_10000; i++)
+    {
+        MC_GUID_GenerateInto(&guid);
+        MC_GUID_Format(&guid, str, MC_GUID_SIZE);
+        mismatches += !MC_GUID_Parse(str, MC_GUID_SIZE, &parsed) || memcmp(&guid, &parsed, sizeof(MC_Guid)) != 0;
+    }
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(mismatches, 0, failCount);
+    ASSERT_TRUE(MC_GUID_Parse(known, strlen(known), &parsed), failCount);
+    ASSERT_EQUAL_UINT64(parsed.data1, 0x01234567ULL, failCount);
+    ASSERT_EQUAL_UINT64(parsed.data2, 0x89ABULL, failCount);
+    ASSERT_EQUAL_UINT64(parsed.data3, 0xCDEFULL, failCount);
+    ASSERT_EQUAL_UINT64(parsed.data4[0], 0xA0ULL, failCount);
+    ASSERT_EQUAL_UINT64(parsed.data4[7], 0xB7ULL, failCount);
+
+    ASSERT_FALSE(MC_GUID_Parse("01234567-89ab-CDEF-a0B1-c2D3e4F5a6Bg", MC_GUID_SIZE, &parsed), failCount);
+    ASSERT_FALSE(MC_GUID_Parse("01234567-89ab-CDEF-a0B1-c2D3e4F5a6B:", MC_GUID_SIZE, &parsed), failCount);
+    ASSERT_FALSE(MC_GUID_Parse("0123456-789ab-CDEF-a0B1-c2D3e4F5a6B7", MC_GUID_SIZE, &parsed), failCount);
+    ASSERT_FALSE(MC_GUID_Parse("01234567 89ab-CDEF-a0B1-c2D3e4F5a6B7", MC_GUID_SIZE, &parsed), failCount);
+    ASSERT_FALSE(MC_GUID_Parse(known, strlen(known) - 1, &parsed), failCount);
+    ASSERT_FALSE(MC_GUID_Parse(NULL, MC_GUID_SIZE, &parsed), failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Guid_FormatN(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount   = 0;
+    u64 count       = TEST_CONSTANT_10000 + 1;
+    u64 mismatches  = 0;
+    MC_Guid *guids  = (MC_Guid*)malloc(count * sizeof(MC_Guid));
+    MC_Guid *parsed = (MC_Guid*)malloc(count * sizeof(MC_Guid));
+    char *strs      = (char*)malloc(count * MC_GUID_SIZE);
+    char expected[MC_GUID_SIZE];
+
+    ASSERT_NOT_NULL(guids, failCount);
+    ASSERT_NOT_NULL(parsed, failCount);
+    ASSERT_NOT_NULL(strs, failCount);
+
+    /* Act */
+    MC_GUID_GenerateBatch(guids, count);
+
+    ASSERT_TRUE(MC_GUID_FormatN(guids, count, strs, count * MC_GUID_SIZE), failCount);
+    ASSERT_TRUE(MC_GUID_ParseN(strs, count, parsed), failCount);
+
+    for (u64 i = 0; i < count; i++)
+    {
+        MC_GUID_Format_String(&guids[i], expected, MC_GUID_SIZE);
+        mismatches += memcmp(expected, strs + i * MC_GUID_SIZE, MC_GUID_SIZE) != 0;
+        mismatches += memcmp(&guids[i], &parsed[i], sizeof(MC_Guid)) != 0;
+    }
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(mismatches, 0, failCount);
+    ASSERT_FALSE(MC_GUID_FormatN(guids, count, strs, count * MC_GUID_SIZE - 1), failCount);
+    ASSERT_FALSE(MC_GUID_FormatN(guids, UINT64_MAX, strs, count * MC_GUID_SIZE), failCount);
+    ASSERT_TRUE(MC_GUID_FormatN(NULL, 0, NULL, 0), failCount);
+
+    strs[(count - 1) * MC_GUID_SIZE + 8] = 'X';     // break the dash of the last string
+    ASSERT_FALSE(MC_GUID_ParseN(strs, count, parsed), failCount);
+
+    free(strs);
+    free(parsed);
+    free(guids);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Guid_Compare(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount   = 0;
+    u64 misordered  = 0;
+    u64 hashesEqual = 0;
+    MC_Guid guids[TEST_CONSTANT_10000];
+    MC_Guid copy;
+    char left[MC_GUID_SIZE];
+    char right[MC_GUID_SIZE];
+
+    MC_GUID_GenerateBatch(guids, TEST_CONSTANT_10000);
+    copy = guids[0];
+
+    /* Act */
+    for (u64 i = 1; i < TEST_CONSTANT_10000; i++)
+    {
+        MC_GUID_Format(&guids[i - 1], left, MC_GUID_SIZE);
+        MC_GUID_Format(&guids[i], right, MC_GUID_SIZE);
+
+        int expected = strcmp(left, right);
+        int actual = MC_GUID_Compare(&guids[i - 1], &guids[i]);
+
+        misordered += (expected < 0) != (actual < 0) || (expected > 0) != (actual > 0);
+        hashesEqual += MC_GUID_Hash(&guids[i - 1]) == MC_GUID_Hash(&guids[i]);
+    }
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(misordered, 0, failCount);
+    ASSERT_EQUAL_UINT64(hashesEqual, 0, failCount);
+    ASSERT_TRUE(MC_GUID_Compare(&guids[0], &copy) == 0, failCount);
+    ASSERT_TRUE(MC_GUID_Equal(&guids[0], &copy), failCount);
+    ASSERT_FALSE(MC_GUID_Equal(&guids[0], &guids[1]), failCount);
+    ASSERT_EQUAL_UINT64(MC_GUID_Hash(&guids[0]), MC_GUID_Hash(&copy), failCount);
+    ASSERT_TRUE(MC_GUID_Compare(NULL, &copy) < 0, failCount);
+    ASSERT_FALSE(MC_GUID_Equal(NULL, &copy), failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Guid_Sort(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount   = 0;
+    u64 count       = TEST_CONSTANT_10000 + 3;
+    u64 misordered  = 0;
+    u64 hashBefore  = 0;
+    u64 hashAfter   = 0;
+    MC_Guid *guids  = (MC_Guid*)malloc(count * sizeof(MC_Guid));
+    MC_Guid small[TEST_CONSTANT_10];
+
+    ASSERT_NOT_NULL(guids, failCount);
+
+    MC_GUID_GenerateBatch(guids, count);
+    MC_GUID_GenerateBatch(small, TEST_CONSTANT_10);
+
+    for (u64 i = 0; i < count; i += 2)
+    {
+        guids[i].data1 = guids[0].data1;    // half the keys share their leading bytes
+    }
+
+    for (u64 i = 0; i < count; i++)
+    {
+        hashBefore += MC_GUID_Hash(&guids[i]);
+    }
+
+    /* Act */
+    ASSERT_TRUE(MC_GUID_Sort(guids, count), failCount);
+    ASSERT_TRUE(MC_GUID_Sort(small, TEST_CONSTANT_10), failCount);
+    ASSERT_TRUE(MC_GUID_Sort(NULL, 0), failCount);
+    ASSERT_FALSE(MC_GUID_Sort(NULL, 1), failCount);
+
+    for (u64 i = 0; i < count; i++)
+    {
+        hashAfter += MC_GUID_Hash(&guids[i]);
+        misordered += i && MC_GUID_Compare(&guids[i - 1], &guids[i]) > 0;
+    }
+
+    for (u64 i = 1; i < TEST_CONSTANT_10; i++)
+    {
+        misordered += MC_GUID_Compare(&small[i - 1], &small[i]) > 0;
+    }
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(misordered, 0, failCount);
+    ASSERT_EQUAL_UINT64(hashBefore, hashAfter, failCount);     // the same Guids, only moved
+
+    free(guids);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Guid_V7(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount   = 0;
+    u64 unordered   = 0;
+    u64 badBits     = 0;
+    u64 tooEarly    = 0;
+    MC_Guid guid;
+    char prev[MC_GUID_SIZE] = "";
+    char str[MC_GUID_SIZE];
+    struct timespec now;
+
+    timespec_get(&now, TIME_UTC);
+    u64 start = (u64)now.tv_sec * 1000 + (u64)now.tv_nsec / 1000000;
+
+    /* Act */
+    for (u64 i = 0; i < TEST_CONSTANT_10000; i++)
+    {
+        ASSERT_TRUE(MC_GUID_GenerateV7(&guid), failCount);
+        MC_GUID_Format(&guid, str, MC_GUID_SIZE);
+
+        unordered += strcmp(prev, str) >= 0;
+        badBits += (guid.data3 >> 12) != 7 || (guid.data4[0] >> 6) != 2;
+        tooEarly += (((u64)guid.data1 << 16) | guid.data2) < start;
+        memcpy(prev, str, MC_GUID_SIZE);
+    }
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(unordered, 0, failCount);
+    ASSERT_EQUAL_UINT64(badBits, 0, failCount);
+    ASSERT_EQUAL_UINT64(tooEarly, 0, failCount);
+    ASSERT_FALSE(MC_GUID_GenerateV7(NULL), failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Guid_V7ClockRegression(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount   = 0;
+    u64 unordered   = 0;
+    u64 future      = 0x7FFFFFFFFFFFULL;    // far above the clock, the sequence stays here for the rest of the process
+    MC_Guid guid;
+    char prev[MC_GUID_SIZE];
+    char str[MC_GUID_SIZE];
+
+    /* Act */
+    ASSERT_TRUE(MC_GUID_GenerateV7At(&guid, future), failCount);
+    MC_GUID_Format(&guid, prev, MC_GUID_SIZE);
+
+    for (u64 i = 0; i < TEST_CONSTANT_1000000; i++)     // more than one millisecond of counter
+    {
+        if (i % 2)
+        {
+            MC_GUID_GenerateV7At(&guid, future - i);
+        }
+        else
+        {
+            MC_GUID_GenerateV7(&guid);
+        }
+
+        MC_GUID_Format(&guid, str, MC_GUID_SIZE);
+        unordered += strcmp(prev, str) >= 0;
+        memcpy(prev, str, MC_GUID_SIZE);
+    }
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(unordered, 0, failCount);
+    ASSERT_EQUAL_UINT64((((u64)guid.data1 << 16) | guid.data2), future + 1, failCount);     // the counter carried once
+    ASSERT_EQUAL_UINT64(guid.data3 >> 12, 7, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Guid_V7Threads(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount   = 0;
+    u64 duplicates  = 0;
+    thrd_t threads[TEST_GUID_THREADS];
+    TestGuid tests[TEST_GUID_THREADS];
+    MC_HashMap *seen = MC_Hashmap_Init(TEST_CONSTANT_10000);
+
+    /* Act */
+    for (u64 t = 0; t < TEST_GUID_THREADS; t++)
+    {
+        tests[t].strs = malloc(TEST_CONSTANT_10000 * MC_GUID_SIZE);
+        tests[t].failed = 0;
+        tests[t].unordered = 0;
+        thrd_create(&threads[t], test_guid_v7_worker, &tests[t]);
+    }
+
+    for (u64 t = 0; t < TEST_GUID_THREADS; t++)
+    {
+        thrd_join(threads[t], NULL);
+        ASSERT_EQUAL_UINT64(tests[t].failed, 0, failCount);
+        ASSERT_EQUAL_UINT64(tests[t].unordered, 0, failCount);
+
+        for (u64 i = 0; i < TEST_CONSTANT_10000; i++)
+        {
+            duplicates += MC_Hashmap_Search(seen, tests[t].strs[i]) != NULL;
+            MC_Hashmap_Insert(seen, tests[t].strs[i], seen, false);
+        }
+
+        free(tests[t].strs);
+    }
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(duplicates, 0, failCount);
+
+    MC_Hashmap_Free(&seen);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
 int main(void)
 {
     int failCount = 0;
 
     failCount += Test_MC_Guid_Generate();
     failCount += Test_MC_Guid_Format();
+    failCount += Test_MC_Guid_Arena();
+    failCount += Test_MC_Guid_Version();
+    failCount += Test_MC_Guid_Unique();
+    failCount += Test_MC_Guid_GenerateInto();
+    failCount += Test_MC_Guid_GenerateBatch();
+    failCount += Test_MC_Guid_FormatFast();
+    failCount += Test_MC_Guid_Parse();
+    failCount += Test_MC_Guid_FormatN();
+    failCount += Test_MC_Guid_Compare();
+    failCount += Test_MC_Guid_Sort();
+    failCount += Test_MC_Guid_V7();
+    failCount += Test_MC_Guid_V7Threads();
+    failCount += Test_MC_Guid_V7ClockRegression();     // last, it leaves the sequence far in the future
 
     return failCount;
 }
@@ -0,0 +1,188 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_test_module_guidmap.c                                                               */
+/* \brief: Source code for testing mc_guidmap                                                    */
+/*                                                                                               */
+/* \Expects: 1. All necessary mc definitions are defined and linked properly                     */
+/*                                                                                               */
+/*           Unit tests should follow a step by step approach and be specific to the             */
+/*           name of the function which they are evoked.                                         */
+/*           1. Arrange - Stage the entities to be tested on                                     */
+/*           2. Act - If necessary, perform any routines that might be necessary                 */
+/*           3. Assert - Determine if expectations are met for the test                          */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#include "mc_test.h"
+#include <stdlib.h>     // malloc
+
+u32 Test_MC_GuidMap_InitAndFree(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    MC_GuidMap *map = MC_GuidMap_Init(TEST_CONSTANT_32);
+
+    ASSERT_NOT_NULL(map, failCount);
+    ASSERT_EQUAL_UINT64(MC_GuidMap_Count(map), 0, failCount);
+
+    /* Act */
+    MC_GuidMap_Free(&map);
+
+    /* Assert */
+    ASSERT_NULL(map, failCount);
+    ASSERT_EQUAL_UINT64(MC_GuidMap_Count(NULL), 0, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_GuidMap_InsertAndSearch(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount   = 0;
+    u64 inserts     = 0;
+    u64 found       = 0;
+    u64 values[TEST_CONSTANT_10000];
+    MC_Guid guids[TEST_CONSTANT_10000];
+    MC_Guid missing;
+    MC_GuidMap *map = MC_GuidMap_Init(TEST_CONSTANT_10);     // grows many times
+
+    MC_GUID_GenerateBatch(guids, TEST_CONSTANT_10000);
+    MC_GUID_GenerateInto(&missing);
+
+    /* Act */
+    for (u64 i = 0; i < TEST_CONSTANT_10000; i++)
+    {
+        values[i] = i;
+        inserts += MC_GuidMap_Insert(map, &guids[i], &values[i], false);
+    }
+
+    for (u64 i = 0; i < TEST_CONSTANT_10000; i++)
+    {
+        found += MC_GuidMap_Search(map, &guids[i]) == &values[i];
+    }
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(inserts, TEST_CONSTANT_10000, failCount);
+    ASSERT_EQUAL_UINT64(found, TEST_CONSTANT_10000, failCount);
+    ASSERT_EQUAL_UINT64(MC_GuidMap_Count(map), TEST_CONSTANT_10000, failCount);
+    ASSERT_NULL(MC_GuidMap_Search(map, &missing), failCount);
+
+    ASSERT_TRUE(MC_GuidMap_Insert(map, &guids[0], &values[1], false), failCount);   // update in place
+    ASSERT_TRUE(MC_GuidMap_Search(map, &guids[0]) == &values[1], failCount);
+    ASSERT_EQUAL_UINT64(MC_GuidMap_Count(map), TEST_CONSTANT_10000, failCount);
+
+    ASSERT_FALSE(MC_GuidMap_Insert(NULL, &guids[0], NULL, false), failCount);
+    ASSERT_FALSE(MC_GuidMap_Insert(map, NULL, NULL, false), failCount);
+    ASSERT_NULL(MC_GuidMap_Search(map, NULL), failCount);
+
+    MC_GuidMap_Free(&map);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_GuidMap_Remove(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount   = 0;
+    u64 removes     = 0;
+    u64 found       = 0;
+    u64 gone        = 0;
+    u64 values[TEST_CONSTANT_10000];
+    MC_Guid guids[TEST_CONSTANT_10000];
+    MC_GuidMap *map = MC_GuidMap_Init(TEST_CONSTANT_10000);
+
+    for (u64 i = 0; i < TEST_CONSTANT_10000; i++)
+    {
+        MC_GUID_GenerateV7(&guids[i]);     // time ordered keys share their leading bytes
+        values[i] = i;
+        MC_GuidMap_Insert(map, &guids[i], &values[i], false);
+    }
+
+    /* Act */
+    for (u64 i = 0; i < TEST_CONSTANT_10000; i += 3)
+    {
+        removes += MC_GuidMap_RemoveAt(map, &guids[i]);
+    }
+
+    for (u64 i = 0; i < TEST_CONSTANT_10000; i++)
+    {
+        void *value = MC_GuidMap_Search(map, &guids[i]);
+
+        if (i % 3 == 0)
+        {
+            gone += value == NULL;
+        }
+        else
+        {
+            found += value == &values[i];
+        }
+    }
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(removes, gone, failCount);
+    ASSERT_EQUAL_UINT64(removes, (TEST_CONSTANT_10000 + 2) / 3, failCount);
+    ASSERT_EQUAL_UINT64(found, TEST_CONSTANT_10000 - removes, failCount);
+    ASSERT_EQUAL_UINT64(MC_GuidMap_Count(map), TEST_CONSTANT_10000 - removes, failCount);
+    ASSERT_FALSE(MC_GuidMap_RemoveAt(map, &guids[0]), failCount);
+
+    MC_GuidMap_Free(&map);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_GuidMap_Dynamic(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    MC_Guid guids[TEST_CONSTANT_32];
+    MC_GuidMap *map = MC_GuidMap_Init(TEST_CONSTANT_32);
+
+    MC_GUID_GenerateBatch(guids, TEST_CONSTANT_32);
+
+    /* Act */
+    for (u64 i = 0; i < TEST_CONSTANT_32; i++)
+    {
+        ASSERT_TRUE(MC_GuidMap_Insert(map, &guids[i], malloc(TEST_CONSTANT_32), true), failCount);
+    }
+
+    ASSERT_TRUE(MC_GuidMap_Insert(map, &guids[0], malloc(TEST_CONSTANT_32), true), failCount);     // frees the old value
+    ASSERT_TRUE(MC_GuidMap_RemoveAt(map, &guids[1]), failCount);                                 // frees its value
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(MC_GuidMap_Count(map), TEST_CONSTANT_32 - 1, failCount);
+
+    MC_GuidMap_Free(&map);      // frees the rest, a leak checker reports anything missed
+
+    ASSERT_NULL(map, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+int main(void)
+{
+    int failCount = 0;
+
+    failCount += Test_MC_GuidMap_InitAndFree();
+    failCount += Test_MC_GuidMap_InsertAndSearch();
+    failCount += Test_MC_GuidMap_Remove();
+    failCount += Test_MC_GuidMap_Dynamic();
+
+    return failCount;
+}
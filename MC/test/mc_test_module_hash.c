@@ -56,9 +56,9 @@ u32 Test_MC_Hash_BigSize(void)
     /* Act */
     for (u64 i = 0; i < TEST_CONSTANT_1000000; i++)
     {
-        sprintf_s(temp, sizeof(temp), "Index: %lld", i);
-        strncpy_s(key, sizeof(key), temp, sizeof(key) - 1);
-        strncpy_s(value, sizeof(value), temp, sizeof(value) - 1);
+        snprintf(temp, sizeof(temp), "Index: %llu", (unsigned long long)i);
+        snprintf(key, sizeof(key), "%s", temp);
+        snprintf(value, sizeof(value), "%s", temp);
 
         successfulInserts += MC_Hashmap_Insert(hashmap, key, value, false);
     }
@@ -92,9 +92,9 @@ u32 Test_MC_Hash_DynamicInsertion(void)
     /* Act */
     for (u8 i = 0; i < TEST_CONSTANT_32; i++)
     {
-        sprintf_s(temp, sizeof(temp), "Index: %d", i);
-        strncpy_s(key, sizeof(key), temp, sizeof(key) - 1);
-        char *value = _strdup(temp);
+        snprintf(temp, sizeof(temp), "Index: %d", i);
+        snprintf(key, sizeof(key), "%s", temp);
+        char *value = MC_StrDup(temp);
 
         successfulInserts += MC_Hashmap_Insert(hashmap, key, value, true);
     }
@@ -131,10 +131,10 @@ u32 Test_MC_Hash_SearchAndRemove(void)
     /* Assert */
     for (u8 i = 0; i < TEST_CONSTANT_32; i++)
     {
-        sprintf_s(temp, sizeof(temp), "Index: %d", i);
+        snprintf(temp, sizeof(temp), "Index: %d", i);
 
-        strncpy_s(key, sizeof(key), temp, sizeof(key) - 1);
-        strncpy_s(value, sizeof(key), temp, sizeof(key) - 1);
+        snprintf(key, sizeof(key), "%s", temp);
+        snprintf(value, sizeof(key), "%s", temp);
 
         successfulInserts += MC_Hashmap_Insert(hashmap, key, value, false);
     }
@@ -143,8 +143,8 @@ u32 Test_MC_Hash_SearchAndRemove(void)
 
     for (u8 i = 0; i < TEST_CONSTANT_10; i++)
     {
-        sprintf_s(temp, sizeof(temp),"Index: %d", i);
-        strncpy_s(key, sizeof(key), temp, sizeof(key) - 1);
+        snprintf(temp, sizeof(temp),"Index: %d", i);
+        snprintf(key, sizeof(key), "%s", temp);
 
         successfulRemoves += MC_Hashmap_RemoveAt(hashmap, key);
         void* o = MC_Hashmap_Search(hashmap, key);
@@ -163,6 +163,59 @@ u32 Test_MC_Hash_SearchAndRemove(void)
     return failCount;
 }
 
+u32 Test_MC_Hash_Arena(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    MC_Arena *arena = MC_Arena_Init(0);
+    MC_HashMap *hashmap = MC_Hashmap_InitArena(arena, TEST_CONSTANT_32);
+    u64 successfulInserts = 0;
+    u64 successfulSearches = 0;
+
+    char key[TEST_CONSTANT_32];
+
+    ASSERT_NOT_NULL(hashmap, failCount);
+    ASSERT_NULL(MC_Hashmap_InitArena(NULL, TEST_CONSTANT_32), failCount);
+
+    /* Act */
+    for (u64 i = 0; i < TEST_CONSTANT_10000; i++)
+    {
+        snprintf(key, sizeof(key), "Index: %05llu", (unsigned long long)i);    // fixed width, keys are compared by prefix
+
+        successfulInserts += MC_Hashmap_Insert(hashmap, key, (void*)(uintptr_t)(i + 1), false);
+    }
+
+    for (u64 i = 0; i < TEST_CONSTANT_10000; i++)
+    {
+        snprintf(key, sizeof(key), "Index: %05llu", (unsigned long long)i);
+
+        successfulSearches += MC_Hashmap_Search(hashmap, key) == (void*)(uintptr_t)(i + 1);
+    }
+
+    u8 removed = MC_Hashmap_RemoveAt(hashmap, "Index: 00000");
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(successfulInserts, TEST_CONSTANT_10000, failCount);
+    ASSERT_EQUAL_UINT64(successfulSearches, TEST_CONSTANT_10000, failCount);
+    ASSERT_TRUE(removed, failCount);
+    ASSERT_NULL(MC_Hashmap_Search(hashmap, "Index: 00000"), failCount);
+    ASSERT_TRUE(MC_Arena_Used(arena) > TEST_CONSTANT_10000 * TEST_CONSTANT_10, failCount);
+
+    MC_Hashmap_Free(&hashmap);
+
+    ASSERT_NULL(hashmap, failCount);
+
+    MC_Arena_Free(&arena);      // releases the map, buckets, nodes and keys at once
+
+    ASSERT_NULL(arena, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
 int main(void)
 {
     int failCount = 0;
@@ -171,6 +224,7 @@ int main(void)
     failCount += Test_MC_Hash_BigSize();
     failCount += Test_MC_Hash_DynamicInsertion();
     failCount += Test_MC_Hash_SearchAndRemove();
+    failCount += Test_MC_Hash_Arena();
 
     return failCount;
 }
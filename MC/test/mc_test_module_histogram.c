@@ -0,0 +1,481 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_test_module_histogram.c                                                             */
+/* \brief: Source code for testing mc_histogram                                                  */
+/*                                                                                               */
+/* \Expects: 1. All necessary mc definitions are defined and linked properly                     */
+/*                                                                                               */
+/*           Unit tests should follow a step by step approach and be specific to the             */
+/*           name of the function which they are evoked.                                         */
+/*           1. Arrange - Stage the entities to be tested on                                     */
+/*           2. Act - If necessary, perform any routines that might be necessary                 */
+/*           3. Assert - Determine if expectations are met for the test                          */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#include "mc_test.h"
+#include <string.h>     // strstr, memcpy
+#include <threads.h>    // thrd_create
+
+/**
+ * \brief The file the cumulative distribution test writes to.
+ */
+#define TEST_HISTOGRAM_FILE "last_run_histogram.hgrm"
+
+/**
+ * \brief Threads recording into one Recorder at once.
+ */
+#define TEST_HISTOGRAM_THREADS 4
+
+/**
+ * \brief Spans the trace test records of each name.
+ */
+#define TEST_HISTOGRAM_SPANS 100
+
+static MC_HistogramRecorder *test_histogram_recorder;
+
+/**
+ * \brief Work inside the traced spans is folded in here so it is not optimized away.
+ */
+static volatile u64 test_histogram_sink;
+
+static int test_histogram_worker(void *arg)
+{
+    u64 thread = (u64)(uintptr_t)arg;
+
+    for (u64 i = 0; i < TEST_CONSTANT_1000000; i++)
+    {
+        MC_HistogramRecorder_Record(test_histogram_recorder, thread * TEST_CONSTANT_1000000 + i);
+    }
+
+    return 0;
+}
+
+u32 Test_MC_Histogram_Record(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    MC_Histogram *histogram = MC_Histogram_Init(0);
+    MC_Histogram *tooPrecise = MC_Histogram_Init(MC_HISTOGRAM_MAX_BITS + 1);
+    u8 exact = true;
+
+    /* Act */
+    for (u64 value = 0; value < 256; value++)
+    {
+        MC_Histogram_Record(histogram, value);
+    }
+
+    for (u64 value = 0; value < 256; value++)
+    {
+        exact &= MC_Histogram_Percentile(histogram, (double)(value + 1) * 100.0 / 256.0) == value;
+    }
+
+    MC_Histogram_RecordN(histogram, 1000, 3);
+    MC_Histogram_RecordN(histogram, 2000, 0);
+    MC_Histogram_Record(NULL, 1);
+
+    /* Assert */
+    ASSERT_NOT_NULL(histogram, failCount);
+    ASSERT_NULL(tooPrecise, failCount);
+    ASSERT_TRUE(exact, failCount);
+    ASSERT_EQUAL_UINT64(MC_Histogram_Count(histogram), 259, failCount);
+    ASSERT_EQUAL_UINT64(MC_Histogram_Min(histogram), 0, failCount);
+    ASSERT_EQUAL_UINT64(MC_Histogram_Max(histogram), 1000, failCount);
+    ASSERT_EQUAL_UINT64(MC_Histogram_Count(NULL), 0, failCount);
+
+    MC_Histogram_Reset(histogram);
+
+    ASSERT_EQUAL_UINT64(MC_Histogram_Count(histogram), 0, failCount);
+    ASSERT_EQUAL_UINT64(MC_Histogram_Max(histogram), 0, failCount);
+
+    MC_Histogram_Free(&histogram);
+    MC_Histogram_Free(&histogram);
+
+    ASSERT_NULL(histogram, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Histogram_Precision(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    u8 bitsTried[] = { 1, 4, MC_HISTOGRAM_DEFAULT_BITS, MC_HISTOGRAM_MAX_BITS };
+    u8 bounded = true;
+
+    /* Act */
+    for (u64 b = 0; b < sizeof(bitsTried); b++)
+    {
+        MC_Histogram *histogram = MC_Histogram_Init(bitsTried[b]);
+
+        for (u32 shift = 0; histogram && shift < 64; shift++)
+        {
+            u64 values[] = { 1ull << shift, (1ull << shift) + ((1ull << shift) >> 1) + 1, (U64_MAX >> (63 - shift)) };
+
+            for (u64 v = 0; v < 3; v++)
+            {
+                MC_Histogram_Reset(histogram);
+                MC_Histogram_Record(histogram, values[v]);
+                MC_Histogram_Record(histogram, U64_MAX);    // so the bucket's top is not capped at the value
+
+                u64 reported = MC_Histogram_Percentile(histogram, 50.0);
+
+                bounded &= reported >= values[v] && reported - values[v] <= (values[v] >> (bitsTried[b] - 1));
+            }
+        }
+
+        bounded &= histogram != NULL && MC_Histogram_Percentile(histogram, 100.0) == U64_MAX;
+
+        MC_Histogram_Free(&histogram);
+    }
+
+    /* Assert */
+    ASSERT_TRUE(bounded, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Histogram_Percentile(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    MC_Histogram *histogram = MC_Histogram_Init(0);
+    MC_Histogram *empty = MC_Histogram_Init(0);
+
+    /* Act */
+    for (u64 value = 1; value <= TEST_CONSTANT_10000; value++)
+    {
+        MC_Histogram_Record(histogram, value);
+    }
+
+    u64 p50 = MC_Histogram_Percentile(histogram, 50.0);
+    u64 p99 = MC_Histogram_Percentile(histogram, 99.0);
+    u64 p999 = MC_Histogram_Percentile(histogram, 99.9);
+
+    /* Assert */
+    ASSERT_TRUE(p50 >= 5000 && p50 <= 5000 + 5000 / 128, failCount);
+    ASSERT_TRUE(p99 >= 9900 && p99 <= 9900 + 9900 / 128, failCount);
+    ASSERT_TRUE(p999 >= 9990 && p999 <= TEST_CONSTANT_10000, failCount);
+    ASSERT_EQUAL_UINT64(MC_Histogram_Percentile(histogram, 100.0), TEST_CONSTANT_10000, failCount);
+    ASSERT_EQUAL_UINT64(MC_Histogram_Percentile(histogram, 0.0), 1, failCount);
+    ASSERT_DOUBLE_EQUAL(MC_Histogram_Mean(histogram), 5000.5, 5000.5 / 128, failCount);
+    ASSERT_EQUAL_UINT64(MC_Histogram_Percentile(empty, 50.0), 0, failCount);
+    ASSERT_EQUAL_UINT64(MC_Histogram_Min(empty), 0, failCount);
+    ASSERT_DOUBLE_EQUAL(MC_Histogram_Mean(empty), 0.0, 0.0, failCount);
+
+    MC_Histogram_Free(&histogram);
+    MC_Histogram_Free(&empty);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Histogram_Merge(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    MC_Histogram *low = MC_Histogram_Init(0);
+    MC_Histogram *high = MC_Histogram_Init(0);
+    MC_Histogram *coarse = MC_Histogram_Init(4);
+    MC_Histogram *empty = MC_Histogram_Init(0);
+
+    for (u64 value = 1; value <= 1000; value++)
+    {
+        MC_Histogram_Record(low, value);
+        MC_Histogram_Record(high, value + 1000);
+    }
+
+    /* Act */
+    u8 merged = MC_Histogram_Merge(low, high);
+    u8 mergedEmpty = MC_Histogram_Merge(low, empty);
+    u8 mergedCoarse = MC_Histogram_Merge(coarse, low);
+    u64 p50 = MC_Histogram_Percentile(low, 50.0);
+    u64 coarseP50 = MC_Histogram_Percentile(coarse, 50.0);
+
+    /* Assert */
+    ASSERT_TRUE(merged && mergedEmpty && mergedCoarse, failCount);
+    ASSERT_FALSE(MC_Histogram_Merge(NULL, low), failCount);
+    ASSERT_EQUAL_UINT64(MC_Histogram_Count(low), 2000, failCount);
+    ASSERT_EQUAL_UINT64(MC_Histogram_Min(low), 1, failCount);
+    ASSERT_EQUAL_UINT64(MC_Histogram_Max(low), 2000, failCount);
+    ASSERT_TRUE(p50 >= 1000 && p50 <= 1000 + 1000 / 128, failCount);
+    ASSERT_EQUAL_UINT64(MC_Histogram_Count(coarse), 2000, failCount);
+    ASSERT_EQUAL_UINT64(MC_Histogram_Min(coarse), 1, failCount);
+    ASSERT_EQUAL_UINT64(MC_Histogram_Max(coarse), 2000, failCount);
+    ASSERT_TRUE(coarseP50 >= 1000 && coarseP50 <= 1000 + 1000 / 8 + 1000 / 128, failCount);
+
+    MC_Histogram_Free(&low);
+    MC_Histogram_Free(&high);
+    MC_Histogram_Free(&coarse);
+    MC_Histogram_Free(&empty);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Histogram_Serialize(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    MC_Histogram *histogram = MC_Histogram_Init(MC_HISTOGRAM_MAX_BITS);
+    MC_Histogram *empty = MC_Histogram_Init(0);
+    u8 buffer[1024];
+    u8 small[4] = { 0 };
+    u8 bad[1024];
+
+    for (u64 value = 1; value < U64_MAX / 3; value *= 3)
+    {
+        MC_Histogram_RecordN(histogram, value, value % 7 + 1);
+    }
+
+    MC_Histogram_Record(histogram, U64_MAX);
+
+    /* Act */
+    u64 needed = MC_Histogram_Serialize(histogram, NULL, 0);
+    u64 tooSmall = MC_Histogram_Serialize(histogram, small, sizeof(small));
+    u64 written = MC_Histogram_Serialize(histogram, buffer, sizeof(buffer));
+    MC_Histogram *copy = MC_Histogram_Deserialize(buffer, written, NULL);
+
+    u8 emptyBuffer[32];
+    u64 emptyWritten = MC_Histogram_Serialize(empty, emptyBuffer, sizeof(emptyBuffer));
+    MC_Histogram *emptyCopy = MC_Histogram_Deserialize(emptyBuffer, emptyWritten, NULL);
+
+    memcpy(bad, buffer, written);
+    MC_Histogram *truncated = MC_Histogram_Deserialize(bad, written - 1, NULL);
+    MC_Histogram *trailing = MC_Histogram_Deserialize(bad, written + 1, NULL);
+    bad[0] = 'X';
+    MC_Histogram *badMagic = MC_Histogram_Deserialize(bad, written, NULL);
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(needed, written, failCount);
+    ASSERT_EQUAL_UINT64(tooSmall, needed, failCount);
+    ASSERT_EQUAL_UINT64(small[0], 0, failCount);
+    ASSERT_TRUE(written < 256, failCount);  // only the buckets holding values are encoded
+    ASSERT_NOT_NULL(copy, failCount);
+    ASSERT_EQUAL_UINT64(MC_Histogram_Count(copy), MC_Histogram_Count(histogram), failCount);
+    ASSERT_EQUAL_UINT64(MC_Histogram_Min(copy), 1, failCount);
+    ASSERT_EQUAL_UINT64(MC_Histogram_Max(copy), U64_MAX, failCount);
+    ASSERT_EQUAL_UINT64(MC_Histogram_Percentile(copy, 50.0), MC_Histogram_Percentile(histogram, 50.0), failCount);
+    ASSERT_EQUAL_UINT64(MC_Histogram_Percentile(copy, 90.0), MC_Histogram_Percentile(histogram, 90.0), failCount);
+    ASSERT_EQUAL_UINT64(MC_Histogram_Serialize(copy, bad, sizeof(bad)), written, failCount);
+    ASSERT_ARRAY_EQUAL(bad, buffer, written, failCount);
+    ASSERT_NOT_NULL(emptyCopy, failCount);
+    ASSERT_EQUAL_UINT64(MC_Histogram_Count(emptyCopy), 0, failCount);
+    ASSERT_NULL(truncated, failCount);
+    ASSERT_NULL(trailing, failCount);
+    ASSERT_NULL(badMagic, failCount);
+    ASSERT_NULL(MC_Histogram_Deserialize(NULL, written, NULL), failCount);
+    ASSERT_EQUAL_UINT64(MC_Histogram_Serialize(NULL, buffer, sizeof(buffer)), 0, failCount);
+
+    MC_Histogram_Free(&histogram);
+    MC_Histogram_Free(&empty);
+    MC_Histogram_Free(&copy);
+    MC_Histogram_Free(&emptyCopy);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Histogram_WriteCdf(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    MC_Histogram *histogram = MC_Histogram_Init(0);
+    static char text[TEST_CONSTANT_1000000];    // a line per bucket holding values, about 1000 of them
+    FILE *in = NULL;
+
+    for (u64 value = 1; value <= TEST_CONSTANT_10000; value++)
+    {
+        MC_Histogram_Record(histogram, value);
+    }
+
+    /* Act */
+    int written = MC_Histogram_WriteCdf(histogram, TEST_HISTOGRAM_FILE);
+
+    if (MC_FOpen(&in, TEST_HISTOGRAM_FILE, "r") == 0)
+    {
+        fread(text, 1, sizeof(text) - 1, in);
+        fclose(in);
+    }
+
+    /* Assert */
+    ASSERT_EQUAL_INT64(written, 0, failCount);
+    ASSERT_NOT_NULL(strstr(text, "Percentile TotalCount"), failCount);
+    ASSERT_NOT_NULL(strstr(text, "10000.000 1.000000000000      10000\n"), failCount);
+    ASSERT_NOT_NULL(strstr(text, "Total count    =        10000]"), failCount);
+    ASSERT_EQUAL_INT64(MC_Histogram_WriteCdf(NULL, TEST_HISTOGRAM_FILE), -1, failCount);
+
+    MC_Histogram_Free(&histogram);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Histogram_Recorder(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    thrd_t threads[TEST_HISTOGRAM_THREADS];
+    MC_Histogram *snapshot = MC_Histogram_Init(0);
+
+    test_histogram_recorder = MC_HistogramRecorder_Init(0);
+
+    /* Act */
+    for (u64 t = 0; t < TEST_HISTOGRAM_THREADS; t++)
+    {
+        thrd_create(&threads[t], test_histogram_worker, (void*)(uintptr_t)t);
+    }
+
+    for (u64 t = 0; t < TEST_HISTOGRAM_THREADS; t++)
+    {
+        thrd_join(threads[t], NULL);
+    }
+
+    MC_HistogramRecorder_Record(test_histogram_recorder, 0);   // the main thread gets a Histogram too
+
+    u8 snapped = MC_HistogramRecorder_Snapshot(test_histogram_recorder, snapshot);
+
+    /* Assert */
+    ASSERT_TRUE(snapped, failCount);
+    ASSERT_FALSE(MC_HistogramRecorder_Snapshot(NULL, snapshot), failCount);
+    ASSERT_NULL(MC_HistogramRecorder_Init(MC_HISTOGRAM_MAX_BITS + 1), failCount);
+    ASSERT_EQUAL_UINT64(MC_Histogram_Count(snapshot), TEST_HISTOGRAM_THREADS * TEST_CONSTANT_1000000 + 1, failCount);
+    ASSERT_EQUAL_UINT64(MC_Histogram_Min(snapshot), 0, failCount);
+    ASSERT_EQUAL_UINT64(MC_Histogram_Max(snapshot), TEST_HISTOGRAM_THREADS * TEST_CONSTANT_1000000 - 1, failCount);
+
+    MC_HistogramRecorder_Free(&test_histogram_recorder);
+    MC_HistogramRecorder_Free(&test_histogram_recorder);
+    MC_Histogram_Free(&snapshot);
+
+    ASSERT_NULL(test_histogram_recorder, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Histogram_MemStats(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    MC_MemStats stats = { 1, 1, 1, 1 };
+    MC_Histogram *histogram = MC_Histogram_Init(0);
+
+    /* Act */
+    u8 tracked = MC_Histogram_MemStats(histogram, &stats);
+
+    /* Assert */
+    ASSERT_TRUE(tracked == MC_MemTrack_IsEnabled(), failCount);
+    ASSERT_FALSE(MC_Histogram_MemStats(NULL, &stats), failCount);
+
+    if (tracked)
+    {
+        ASSERT_EQUAL_UINT64(stats.allocCount, 2, failCount);   // header and buckets
+        ASSERT_TRUE(stats.liveBytes > 7424 * sizeof(u64), failCount);
+    }
+    else
+    {
+        ASSERT_EQUAL_UINT64(stats.liveBytes, 0, failCount);
+    }
+
+    MC_Histogram_Free(&histogram);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Histogram_Trace(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    MC_Histogram *inner = MC_Histogram_Init(0);
+    MC_Histogram *outer = MC_Histogram_Init(0);
+    u64 beforeStart = MC_Trace_Histogram("inner", inner);
+
+    /* Act */
+    int started = MC_Trace_Start(0);
+
+    for (u64 i = 0; i < TEST_HISTOGRAM_SPANS; i++)
+    {
+        MC_Trace_Begin("outer");
+        MC_Trace_Begin("inner");
+
+        for (u64 spin = 0; spin < TEST_CONSTANT_10000; spin++)
+        {
+            test_histogram_sink += spin;
+        }
+
+        MC_Trace_End("inner");
+        MC_Trace_End("outer");
+    }
+
+    MC_Trace_Begin("open");     // never ended
+    MC_Trace_Stop();
+
+    u64 innerSpans = MC_Trace_Histogram("inner", inner);
+    u64 outerSpans = MC_Trace_Histogram("outer", outer);
+    u64 openSpans = MC_Trace_Histogram("open", outer);
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(beforeStart, 0, failCount);
+    ASSERT_EQUAL_INT64(started, 0, failCount);
+    ASSERT_EQUAL_UINT64(innerSpans, TEST_HISTOGRAM_SPANS, failCount);
+    ASSERT_EQUAL_UINT64(outerSpans, TEST_HISTOGRAM_SPANS, failCount);
+    ASSERT_EQUAL_UINT64(openSpans, 0, failCount);
+    ASSERT_EQUAL_UINT64(MC_Histogram_Count(outer), TEST_HISTOGRAM_SPANS, failCount);
+    ASSERT_TRUE(MC_Histogram_Min(inner) > 0, failCount);
+    ASSERT_TRUE(MC_Histogram_Max(outer) >= MC_Histogram_Min(inner), failCount);
+    ASSERT_EQUAL_UINT64(MC_Trace_Histogram(NULL, inner), 0, failCount);
+
+    MC_Histogram_Free(&inner);
+    MC_Histogram_Free(&outer);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+int main(void)
+{
+    int failCount = 0;
+
+    failCount += Test_MC_Histogram_Record();
+    failCount += Test_MC_Histogram_Precision();
+    failCount += Test_MC_Histogram_Percentile();
+    failCount += Test_MC_Histogram_Merge();
+    failCount += Test_MC_Histogram_Serialize();
+    failCount += Test_MC_Histogram_WriteCdf();
+    failCount += Test_MC_Histogram_Recorder();
+    failCount += Test_MC_Histogram_MemStats();
+    failCount += Test_MC_Histogram_Trace();
+
+    return failCount;
+}
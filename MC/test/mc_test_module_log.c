@@ -0,0 +1,957 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_test_module_log.c                                                                   */
+/* \brief: Source code for testing mc_log                                                        */
+/*                                                                                               */
+/* \Expects: 1. All necessary mc definitions are defined and linked properly                     */
+/*                                                                                               */
+/*           Unit tests should follow a step by step approach and be specific to the             */
+/*           name of the function which they are evoked.                                         */
+/*           1. Arrange - Stage the entities to be tested on                                     */
+/*           2. Act - If necessary, perform any routines that might be necessary                 */
+/*           3. Assert - Determine if expectations are met for the test                          */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+/* Every level is exercised, whatever the build compiles out elsewhere */
+#undef MC_LOG_COMPILE_LEVEL
+#define MC_LOG_COMPILE_LEVEL 0
+
+#include "mc_test.h"
+#include <string.h>     // strstr
+#include <threads.h>    // thrd_create
+#include <time.h>       // mktime
+#include <math.h>       // NAN
+#if !defined(_WIN32)
+#include <signal.h>         // SIGABRT
+#include <sys/resource.h>   // setrlimit
+#include <sys/stat.h>       // mkdir
+#include <sys/wait.h>       // waitpid
+#include <unistd.h>         // fork
+#endif
+
+/**
+ * \brief The file mc_log writes to.
+ */
+#define TEST_LOG_FILE "last_run_output.txt"
+
+/**
+ * \brief The binary log Test_MC_Log_Binary writes and decodes into TEST_LOG_FILE.
+ */
+#define TEST_LOG_BINARY_FILE "last_run_output.mclog"
+
+/**
+ * \brief The base path of the files Test_MC_Log_Mapped rotates through, and the size of each.
+ */
+#define TEST_LOG_MAPPED_FILE "last_run_output.mapped"
+#define TEST_LOG_MAPPED_SIZE (128 * 1024)
+
+/**
+ * \brief Directory removed under an open mapped sink, so its next file cannot be created.
+ */
+#define TEST_LOG_LOST_DIR "last_run_output.lost"
+
+#define TEST_LOG_THREADS 4
+
+/**
+ * \brief Counts gathered from reading the log file back.
+ */
+typedef struct
+{
+    u64 lines;                              // every line
+    u64 threadLines[TEST_LOG_THREADS];      // lines written by Test_MC_Log_Async workers
+    u64 unordered;                          // worker lines not following the previous one of the same thread
+    u64 reportedDrops;                      // sum of the counts in "log message(s) dropped" lines
+    u64 reports;                            // "line(s) suppressed at" lines
+    u64 reportedSuppressed;                 // sum of their counts
+} TestLogContents;
+
+/**
+ * \brief Set to stop test_log_busy.
+ */
+static atomic_uchar test_log_busy_stop;
+
+/**
+ * \brief Log as thread 2 until test_log_busy_stop is set, so the writer always has lines to drain.
+ */
+static int test_log_busy(void *arg)
+{
+    (void)arg;
+
+    for (u64 i = 0; !atomic_load(&test_log_busy_stop); i++)
+    {
+        MC_LOG_INFO("thread %u line %llu", 2u, (unsigned long long)i);
+    }
+
+    return 0;
+}
+
+static void test_log_read(TestLogContents *contents)
+{
+    FILE *file = NULL;
+    char line[TEST_CONSTANT_32 * 8];
+    u64 next[TEST_LOG_THREADS] = { 0 };
+
+    memset(contents, 0, sizeof(*contents));
+
+    if (MC_FOpen(&file, TEST_LOG_FILE, "r") != 0)
+    {
+        return;
+    }
+
+    while (fgets(line, sizeof(line), file))
+    {
+        unsigned int thread = 0;
+        unsigned long long index = 0;
+        const char *message = strstr(line, "] ");
+
+        contents->lines++;
+        message = message ? strstr(message + 2, "] ") : NULL;
+
+        if (message && sscanf(message + 2, "thread %u line %llu", &thread, &index) == 2 && thread < TEST_LOG_THREADS)
+        {
+            contents->unordered += index != next[thread];
+            next[thread] = index + 1;
+            contents->threadLines[thread]++;
+        }
+        else if (message && strstr(message, " line(s) suppressed at ") && sscanf(message + 2, "%llu", &index) == 1)
+        {
+            contents->reports++;
+            contents->reportedSuppressed += index;
+        }
+        else if (message && sscanf(message + 2, "%llu log message(s) dropped", &index) == 1)
+        {
+            contents->reportedDrops += index;
+        }
+    }
+
+    fclose(file);
+}
+
+/**
+ * \brief Join the mapped files into TEST_LOG_FILE in rotation order, then remove them.
+ * \returns u64: The number of files, their largest size and the number of NUL bytes in them
+ */
+static u64 test_log_gather(u64 *largest, u64 *nuls)
+{
+    FILE *out = NULL;
+    FILE *in = NULL;
+    char path[TEST_CONSTANT_32 * 8];
+    char chunk[TEST_CONSTANT_32 * 128];
+    u64 files = 0;
+
+    *largest = 0;
+    *nuls = 0;
+
+    if (MC_FOpen(&out, TEST_LOG_FILE, "wb") != 0)
+    {
+        return 0;
+    }
+
+    for (;;)
+    {
+        snprintf(path, sizeof(path), "%s.%llu", TEST_LOG_MAPPED_FILE, (unsigned long long)files);
+
+        if (MC_FOpen(&in, path, "rb") != 0)
+        {
+            break;
+        }
+
+        u64 size = 0;
+        size_t read;
+
+        while ((read = fread(chunk, 1, sizeof(chunk), in)) > 0)
+        {
+            for (size_t i = 0; i < read; i++)
+            {
+                *nuls += chunk[i] == '\0';
+            }
+
+            fwrite(chunk, 1, read, out);
+            size += read;
+        }
+
+        fclose(in);
+        remove(path);
+        *largest = size > *largest ? size : *largest;
+        files++;
+    }
+
+    fclose(out);
+
+    return files;
+}
+
+static int test_log_worker(void *arg)
+{
+    u64 thread = (u64)(uintptr_t)arg;
+
+    for (u64 i = 0; i < TEST_CONSTANT_10000; i++)
+    {
+        MC_LOG_INFO("thread %u line %llu", (unsigned int)thread, (unsigned long long)i);
+    }
+
+    return 0;
+}
+
+static int test_log_binary_worker(void *arg)
+{
+    u64 thread = (u64)(uintptr_t)arg;
+
+    for (u64 i = 0; i < TEST_CONSTANT_10000; i++)
+    {
+        MC_LOG_BINARY(MC_LOG_LEVEL_INFO, "thread %u line %llu", (unsigned int)thread, (unsigned long long)i);
+    }
+
+    return 0;
+}
+
+static u64 test_log_evaluations;
+
+static unsigned long long test_log_argument(u64 value)
+{
+    test_log_evaluations++;
+
+    return value;
+}
+
+u32 Test_MC_Log_Sync(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    TestLogContents contents;
+    char line[TEST_CONSTANT_32 * 8] = "";
+    FILE *file = NULL;
+
+    ASSERT_EQUAL_UINT64(MC_Log_Init(), 0, failCount);
+
+    /* Act */
+    MC_LOG_WARNING("thread %u line %llu", 0u, 0ULL);
+    MC_LOG_ERROR("thread %u line %llu", 0u, 1ULL);
+    MC_LOG_DEBUG("thread %u line %llu", 0u, 2ULL);
+    MC_Log_Close();
+
+    test_log_read(&contents);
+
+    if (MC_FOpen(&file, TEST_LOG_FILE, "r") == 0)
+    {
+        fgets(line, sizeof(line), file);
+        fclose(file);
+    }
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(contents.lines, 3, failCount);
+    ASSERT_EQUAL_UINT64(contents.threadLines[0], 3, failCount);
+    ASSERT_EQUAL_UINT64(contents.unordered, 0, failCount);
+    ASSERT_NOT_NULL(strstr(line, "] [WARNING] thread 0 line 0\n"), failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Log_SyncThreads(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    thrd_t threads[TEST_LOG_THREADS];
+    TestLogContents contents;
+    char text[TEST_CONSTANT_32 * 64];
+    char line[TEST_CONSTANT_32 * 80] = "";
+    FILE *file = NULL;
+
+    memset(text, 'x', sizeof(text) - 1);
+    text[sizeof(text) - 1] = '\0';
+
+    ASSERT_EQUAL_UINT64(MC_Log_Init(), 0, failCount);
+
+    /* Act */
+    for (u64 t = 0; t < TEST_LOG_THREADS; t++)
+    {
+        thrd_create(&threads[t], test_log_worker, (void*)(uintptr_t)t);
+    }
+
+    for (u64 t = 0; t < TEST_LOG_THREADS; t++)
+    {
+        thrd_join(threads[t], NULL);
+    }
+
+    MC_Log_Close();
+    test_log_read(&contents);
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(contents.lines, TEST_LOG_THREADS * TEST_CONSTANT_10000, failCount);    // a torn line would add to it
+    ASSERT_EQUAL_UINT64(contents.unordered, 0, failCount);
+
+    for (u64 t = 0; t < TEST_LOG_THREADS; t++)
+    {
+        ASSERT_EQUAL_UINT64(contents.threadLines[t], TEST_CONSTANT_10000, failCount);
+    }
+
+    /* Arrange */
+    ASSERT_EQUAL_UINT64(MC_Log_Init(), 0, failCount);
+
+    /* Act */
+    MC_LOG_INFO("%s", text);    // longer than a thread's line buffer
+    MC_Log_Close();
+
+    if (MC_FOpen(&file, TEST_LOG_FILE, "r") == 0)
+    {
+        fgets(line, sizeof(line), file);
+        fclose(file);
+    }
+
+    const char *message = strstr(line, "] [INFO] ");
+
+    /* Assert */
+    ASSERT_NOT_NULL(message, failCount);
+
+    if (message)
+    {
+        ASSERT_EQUAL_UINT64(strlen(message), strlen("] [INFO] ") + strlen(text) + 1, failCount);   // whole, with its newline
+    }
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Log_Async(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    thrd_t threads[TEST_LOG_THREADS];
+    TestLogContents contents;
+
+    ASSERT_EQUAL_UINT64(MC_Log_Init(), 0, failCount);
+    MC_LOG_INFO("written before MC_Log_InitAsync");    // the file is kept, not opened again
+    ASSERT_EQUAL_UINT64(MC_Log_InitAsync(0, MC_LOG_OVERFLOW_BLOCK), 0, failCount);
+    ASSERT_EQUAL_UINT64((u64)MC_Log_InitAsync(0, MC_LOG_OVERFLOW_BLOCK), (u64)-1, failCount);   // already open
+
+    /* Act */
+    for (u64 t = 0; t < TEST_LOG_THREADS; t++)
+    {
+        thrd_create(&threads[t], test_log_worker, (void*)(uintptr_t)t);
+    }
+
+    for (u64 t = 0; t < TEST_LOG_THREADS; t++)
+    {
+        thrd_join(threads[t], NULL);
+    }
+
+    u64 dropped = MC_Log_Dropped();
+
+    MC_Log_Close();     // drains whatever the writer has not reached yet
+    test_log_read(&contents);
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(dropped, 0, failCount);
+    ASSERT_EQUAL_UINT64(contents.lines, TEST_LOG_THREADS * TEST_CONSTANT_10000 + 1, failCount);
+    ASSERT_EQUAL_UINT64(contents.unordered, 0, failCount);
+
+    for (u64 t = 0; t < TEST_LOG_THREADS; t++)
+    {
+        ASSERT_EQUAL_UINT64(contents.threadLines[t], TEST_CONSTANT_10000, failCount);
+    }
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Log_Flush(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    TestLogContents contents, busy;
+    thrd_t thread;
+
+    ASSERT_EQUAL_UINT64(MC_Log_InitAsync(TEST_CONSTANT_32, MC_LOG_OVERFLOW_BLOCK), 0, failCount);
+
+    /* Act */
+    for (u64 i = 0; i < TEST_CONSTANT_10; i++)
+    {
+        MC_LOG_INFO("thread %u line %llu", 1u, (unsigned long long)i);
+    }
+
+    MC_Log_Flush();
+    test_log_read(&contents);     // the log is still open
+
+    MC_Log_Close();
+
+    // another thread never stops logging, Flush must not wait for the rings to be empty
+    ASSERT_EQUAL_UINT64(MC_Log_InitAsync(TEST_CONSTANT_32, MC_LOG_OVERFLOW_BLOCK), 0, failCount);
+
+    atomic_store(&test_log_busy_stop, false);
+    thrd_create(&thread, test_log_busy, NULL);
+
+    for (u64 i = 0; i < TEST_CONSTANT_10; i++)
+    {
+        MC_LOG_INFO("thread %u line %llu", 1u, (unsigned long long)i);
+    }
+
+    MC_Log_Flush();
+    test_log_read(&busy);
+
+    atomic_store(&test_log_busy_stop, true);
+    thrd_join(thread, NULL);
+    MC_Log_Close();
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(contents.lines, TEST_CONSTANT_10, failCount);
+    ASSERT_EQUAL_UINT64(contents.threadLines[1], TEST_CONSTANT_10, failCount);
+    ASSERT_EQUAL_UINT64(busy.threadLines[1], TEST_CONSTANT_10, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Log_Overflow(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    TestLogContents contents;
+
+    ASSERT_EQUAL_UINT64(MC_Log_InitAsync(TEST_CONSTANT_10, MC_LOG_OVERFLOW_DROP), 0, failCount);
+
+    /* Act */
+    test_log_worker((void*)(uintptr_t)2);
+
+    u64 dropped = MC_Log_Dropped();
+
+    MC_Log_Close();
+    test_log_read(&contents);
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(contents.threadLines[2] + dropped, TEST_CONSTANT_10000, failCount);
+    ASSERT_EQUAL_UINT64(contents.reportedDrops, 0, failCount);
+
+    /* Arrange */
+    ASSERT_EQUAL_UINT64(MC_Log_InitAsync(TEST_CONSTANT_10, MC_LOG_OVERFLOW_COUNT), 0, failCount);
+
+    /* Act */
+    test_log_worker((void*)(uintptr_t)3);
+
+    dropped = MC_Log_Dropped();
+
+    MC_Log_Close();
+    test_log_read(&contents);
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(contents.threadLines[3] + dropped, TEST_CONSTANT_10000, failCount);
+    ASSERT_EQUAL_UINT64(contents.reportedDrops, dropped, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Log_Level(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    TestLogContents contents;
+
+    test_log_evaluations = 0;
+    ASSERT_EQUAL_UINT64(MC_Log_Init(), 0, failCount);
+    ASSERT_EQUAL_UINT64(MC_Log_GetLevel(), MC_LOG_LEVEL_DEBUG, failCount);
+
+    /* Act */
+    MC_Log_SetLevel(MC_LOG_LEVEL_WARNING);
+
+    MC_LOG_DEBUG("thread %u line %llu", 0u, test_log_argument(0));
+    MC_LOG_INFO("thread %u line %llu", 0u, test_log_argument(0));
+    MC_LOG_WARNING("thread %u line %llu", 0u, test_log_argument(0));
+    MC_LOG_ERROR("thread %u line %llu", 0u, test_log_argument(1));
+    MC_Log_Message(MC_LOG_LEVEL_INFO, "thread %u line %llu", 0u, 2ULL);     // direct calls are filtered too
+
+    MC_Log_SetLevel(MC_LOG_LEVEL_OFF);
+    MC_LOG_ERROR("thread %u line %llu", 0u, test_log_argument(2));
+
+    ASSERT_FALSE(MC_LOG_ENABLED(MC_LOG_LEVEL_ERROR), failCount);
+
+    MC_Log_SetLevel(MC_LOG_LEVEL_DEBUG);
+    MC_Log_Close();
+    test_log_read(&contents);
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(test_log_evaluations, 2, failCount);    // filtered statements never evaluate their arguments
+    ASSERT_EQUAL_UINT64(contents.lines, 2, failCount);
+    ASSERT_EQUAL_UINT64(contents.unordered, 0, failCount);
+    ASSERT_TRUE(MC_LOG_ENABLED(MC_LOG_LEVEL_DEBUG), failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Log_Timestamp(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    char line[TEST_CONSTANT_32 * 8];
+    FILE *file = NULL;
+    u64 lines = 0;
+    u64 parsed = 0;
+    u64 unordered = 0;
+    u64 previous = 0;
+    time_t before = time(NULL);
+
+    ASSERT_EQUAL_UINT64(MC_Log_Init(), 0, failCount);
+
+    /* Act */
+    for (u64 i = 0; i < TEST_CONSTANT_10000; i++)
+    {
+        MC_LOG_INFO("thread %u line %llu", 0u, (unsigned long long)i);
+    }
+
+    MC_Log_Close();
+
+    time_t after = time(NULL);
+
+    if (MC_FOpen(&file, TEST_LOG_FILE, "r") == 0)
+    {
+        while (fgets(line, sizeof(line), file))
+        {
+            struct tm t = { 0 };
+            unsigned int micros = 0;
+            int end = 0;
+
+            lines++;
+
+            if (sscanf(line, "[%4d-%2d-%2d %2d:%2d:%2d.%6u]%n", &t.tm_year, &t.tm_mon, &t.tm_mday,
+                       &t.tm_hour, &t.tm_min, &t.tm_sec, &micros, &end) != 7 || end != 28)
+            {
+                continue;
+            }
+
+            t.tm_year -= 1900;
+            t.tm_mon -= 1;
+            t.tm_isdst = -1;
+
+            time_t second = mktime(&t);
+            u64 stamp = (u64)second * 1000000ULL + micros;
+
+            parsed += second >= before && second <= after;
+            unordered += stamp < previous;
+            previous = stamp;
+        }
+
+        fclose(file);
+    }
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(lines, TEST_CONSTANT_10000, failCount);
+    ASSERT_EQUAL_UINT64(parsed, TEST_CONSTANT_10000, failCount);    // every line carries the current local time
+    ASSERT_EQUAL_UINT64(unordered, 0, failCount);                   // and microseconds that never go back
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Log_Binary(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    thrd_t threads[2];
+    TestLogContents contents;
+    char expected[TEST_CONSTANT_32 * 8];
+    char line[TEST_CONSTANT_32 * 8];
+    u64 found = 0;
+    int decoded = -1;
+    FILE *file = NULL;
+
+    snprintf(expected, sizeof(expected), "mixed %d %s %llu %5.2f %p %*d %% %c %hhu %zu %Lf %ld",
+             -7, "text", 1ULL << 40, 3.14159, (void*)&failCount, 6, 42, 'x', (unsigned char)200, (size_t)12345,
+             (long double)2.5, -123456L);
+
+    ASSERT_EQUAL_UINT64(MC_Log_Init(), 0, failCount);
+    ASSERT_EQUAL_UINT64((u64)MC_Log_InitBinary(TEST_LOG_BINARY_FILE, 0, MC_LOG_OVERFLOW_BLOCK), (u64)-1, failCount);  // text log open
+    MC_Log_Close();
+    ASSERT_EQUAL_UINT64(MC_Log_InitBinary(TEST_LOG_BINARY_FILE, 0, MC_LOG_OVERFLOW_BLOCK), 0, failCount);
+    ASSERT_EQUAL_UINT64((u64)MC_Log_InitAsync(0, MC_LOG_OVERFLOW_BLOCK), (u64)-1, failCount);   // already open
+
+    /* Act */
+    for (u64 t = 0; t < 2; t++)
+    {
+        thrd_create(&threads[t], test_log_binary_worker, (void*)(uintptr_t)t);
+    }
+
+    MC_LOG_BINARY(MC_LOG_LEVEL_ERROR, "mixed %d %s %llu %5.2f %p %*d %% %c %hhu %zu %Lf %ld",
+                  -7, "text", 1ULL << 40, 3.14159, (void*)&failCount, 6, 42, 'x', (unsigned char)200, (size_t)12345,
+                  (long double)2.5, -123456L);
+    MC_LOG_WARNING("thread %u line %llu", 2u, 0ULL);     // a text message in the binary log
+
+    for (u64 t = 0; t < 2; t++)
+    {
+        thrd_join(threads[t], NULL);
+    }
+
+    MC_Log_Close();
+
+    if (MC_FOpen(&file, TEST_LOG_FILE, "w") == 0)
+    {
+        decoded = MC_Log_Decode(TEST_LOG_BINARY_FILE, file);
+        fclose(file);
+    }
+
+    test_log_read(&contents);
+
+    if (MC_FOpen(&file, TEST_LOG_FILE, "r") == 0)
+    {
+        while (fgets(line, sizeof(line), file))
+        {
+            const char *message = strstr(line, "] [ERROR] ");
+
+            found += message && strncmp(message + strlen("] [ERROR] "), expected, strlen(expected)) == 0;
+        }
+
+        fclose(file);
+    }
+
+    int rejected = MC_Log_Decode(TEST_LOG_FILE, stdout);    // text is not a binary log
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(decoded, 0, failCount);
+    ASSERT_EQUAL_UINT64((u64)rejected, (u64)-1, failCount);
+    ASSERT_EQUAL_UINT64(contents.lines, 2 * TEST_CONSTANT_10000 + 2, failCount);
+    ASSERT_EQUAL_UINT64(contents.threadLines[0], TEST_CONSTANT_10000, failCount);
+    ASSERT_EQUAL_UINT64(contents.threadLines[1], TEST_CONSTANT_10000, failCount);
+    ASSERT_EQUAL_UINT64(contents.threadLines[2], 1, failCount);
+    ASSERT_EQUAL_UINT64(contents.unordered, 0, failCount);
+    ASSERT_EQUAL_UINT64(found, 1, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Log_Mapped(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    thrd_t threads[TEST_LOG_THREADS];
+    TestLogContents contents;
+    MC_LogRotation rotation = { TEST_LOG_MAPPED_FILE, TEST_LOG_MAPPED_SIZE, 0 };
+    u64 largest = 0;
+    u64 nuls = 0;
+    u64 files = 0;
+
+    for (u64 async = 0; async < 2; async++)
+    {
+        ASSERT_EQUAL_UINT64(MC_Log_InitMapped(&rotation), 0, failCount);
+        ASSERT_EQUAL_UINT64((u64)MC_Log_InitMapped(&rotation), (u64)-1, failCount);    // already open
+
+        if (async)
+        {
+            ASSERT_EQUAL_UINT64(MC_Log_InitAsync(0, MC_LOG_OVERFLOW_BLOCK), 0, failCount);
+        }
+
+        /* Act */
+        for (u64 t = 0; t < TEST_LOG_THREADS; t++)
+        {
+            thrd_create(&threads[t], test_log_worker, (void*)(uintptr_t)t);
+        }
+
+        for (u64 t = 0; t < TEST_LOG_THREADS; t++)
+        {
+            thrd_join(threads[t], NULL);
+        }
+
+        MC_Log_Close();
+        files = test_log_gather(&largest, &nuls);
+        test_log_read(&contents);
+
+        /* Assert */
+        ASSERT_EQUAL_UINT64((u64)(files > 2), true, failCount);
+        ASSERT_EQUAL_UINT64((u64)(largest <= TEST_LOG_MAPPED_SIZE), true, failCount);
+        ASSERT_EQUAL_UINT64(nuls, 0, failCount);    // every file cut to its length
+        ASSERT_EQUAL_UINT64(contents.lines, TEST_LOG_THREADS * TEST_CONSTANT_10000, failCount);
+        ASSERT_EQUAL_UINT64(contents.unordered, 0, failCount);
+
+        for (u64 t = 0; t < TEST_LOG_THREADS; t++)
+        {
+            ASSERT_EQUAL_UINT64(contents.threadLines[t], TEST_CONSTANT_10000, failCount);
+        }
+    }
+
+#if !defined(_WIN32)
+    /* Arrange */
+    int status = 0;
+    pid_t child = fork();
+
+    /* Act */
+    if (child == 0)
+    {
+        struct rlimit core = { 0, 0 };
+
+        setrlimit(RLIMIT_CORE, &core);
+        rotation.file_size = TEST_LOG_MAPPED_SIZE * 8;  // the whole ring fits the rest of a file and the spare
+
+        if (MC_Log_InitMapped(&rotation) != 0 || MC_Log_InitAsync(TEST_CONSTANT_10000, MC_LOG_OVERFLOW_BLOCK) != 0)
+        {
+            _exit(1);
+        }
+
+        test_log_worker((void*)0);
+        abort();    // lines still in the ring, the handler has to copy them
+    }
+
+    waitpid(child, &status, 0);
+    files = test_log_gather(&largest, &nuls);
+    test_log_read(&contents);
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64((u64)(WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT), true, failCount);
+    ASSERT_EQUAL_UINT64((u64)(files >= 1), true, failCount);
+    ASSERT_EQUAL_UINT64(contents.threadLines[0], TEST_CONSTANT_10000, failCount);
+    ASSERT_EQUAL_UINT64(contents.unordered, 0, failCount);
+
+    /* Arrange */
+    MC_LogRotation lost = { TEST_LOG_LOST_DIR "/lost", TEST_LOG_MAPPED_SIZE, 0 };
+    struct sigaction before;
+    struct sigaction afterFailed;
+    struct sigaction afterReopened;
+
+    sigaction(SIGSEGV, NULL, &before);
+    mkdir(TEST_LOG_LOST_DIR, 0755);
+    ASSERT_EQUAL_UINT64(MC_Log_InitMapped(&lost), 0, failCount);
+    remove(TEST_LOG_LOST_DIR "/lost.0");
+    remove(TEST_LOG_LOST_DIR "/lost.1");
+    rmdir(TEST_LOG_LOST_DIR);
+
+    /* Act */
+    test_log_worker((void*)0);  // fills the first file and the spare, the file after them cannot be made
+    MC_Log_Close();
+    sigaction(SIGSEGV, NULL, &afterFailed);
+
+    ASSERT_EQUAL_UINT64(MC_Log_InitMapped(&rotation), 0, failCount);
+    MC_Log_Close();
+    sigaction(SIGSEGV, NULL, &afterReopened);
+    test_log_gather(&largest, &nuls);
+
+    /* Assert */
+    ASSERT_TRUE(afterFailed.sa_handler == before.sa_handler, failCount);   // the handlers are restored with log_map NULL
+    ASSERT_TRUE(afterReopened.sa_handler == before.sa_handler, failCount);
+#endif
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Log_KV(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    char lines[3][TEST_CONSTANT_32 * 32];
+    char text[TEST_CONSTANT_32 * 16];
+    u64 count = 0;
+    int decoded = -1;
+    FILE *file = NULL;
+    const char *expected = "\"event\":\"order \\\"placed\\\"\",\"id\":18446744073709551615,\"delta\":-9223372036854775808,"
+                           "\"k\\\"ey\":null,\"a\":12.5,\"b\":-0.001,\"c\":3,\"d\":0.1,\"e\":123456.789,\"f\":1,\"g\":1e+20,"
+                           "\"h\":null,\"note\":\"tab\\there \\\"q\\\" back\\\\slash \\u0001 and a clean run longer than sixteen\","
+                           "\"none\":null,\"ok\":true,\"no\":false}\n";
+
+    memset(text, 'x', sizeof(text) - 1);
+    text[sizeof(text) - 1] = '\0';
+    memset(lines, 0, sizeof(lines));
+    test_log_evaluations = 0;
+
+    ASSERT_EQUAL_UINT64(MC_Log_Init(), 0, failCount);
+
+    /* Act */
+    MC_Log_SetLevel(MC_LOG_LEVEL_INFO);
+    MC_LOG_KV(MC_LOG_LEVEL_DEBUG, "skipped", MC_KV_U64("value", test_log_argument(1)));
+    MC_Log_SetLevel(MC_LOG_LEVEL_DEBUG);
+    MC_LOG_KV(MC_LOG_LEVEL_INFO, "order \"placed\"", MC_KV_U64("id", UINT64_MAX), MC_KV_I64("delta", INT64_MIN),
+              MC_KV_STR("k\"ey", NULL), MC_KV_F64("a", 12.5), MC_KV_F64("b", -0.001), MC_KV_F64("c", 3.0),
+              MC_KV_F64("d", 0.1), MC_KV_F64("e", 123456.789), MC_KV_F64("f", 0.9999999999), MC_KV_F64("g", 1e20),
+              MC_KV_F64("h", NAN), MC_KV_STR("note", "tab\there \"q\" back\\slash \x01 and a clean run longer than sixteen"),
+              MC_KV_STR("none", NULL), MC_KV_BOOL("ok", 1), MC_KV_BOOL("no", 0));
+    MC_LOG_KV(MC_LOG_LEVEL_WARNING, "empty");
+    MC_LOG_KV(MC_LOG_LEVEL_ERROR, "long", MC_KV_STR("text", text));    // longer than a thread's line buffer
+    MC_Log_Close();
+
+    if (MC_FOpen(&file, TEST_LOG_FILE, "r") == 0)
+    {
+        while (count < 3 && fgets(lines[count], sizeof(lines[count]), file))
+        {
+            count++;
+        }
+
+        fclose(file);
+    }
+
+    const char *body = strstr(lines[0], "\"level\":\"INFO\",");
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(test_log_evaluations, 0, failCount);
+    ASSERT_EQUAL_UINT64(count, 3, failCount);
+    ASSERT_EQUAL_UINT64((u64)strncmp(lines[0], "{\"time\":\"", 9), 0, failCount);
+    ASSERT_NOT_NULL(body, failCount);
+
+    if (body)
+    {
+        ASSERT_EQUAL_UINT64((u64)strcmp(body + strlen("\"level\":\"INFO\","), expected), 0, failCount);
+    }
+
+    ASSERT_NOT_NULL(strstr(lines[1], "\"level\":\"WARNING\",\"event\":\"empty\"}\n"), failCount);
+    ASSERT_EQUAL_UINT64((u64)(strlen(lines[2]) > sizeof(text)), true, failCount);    // whole, synchronous lines are never cut
+
+    /* Arrange */
+    ASSERT_EQUAL_UINT64(MC_Log_InitAsync(0, MC_LOG_OVERFLOW_BLOCK), 0, failCount);
+
+    /* Act */
+    MC_LOG_KV(MC_LOG_LEVEL_INFO, "long", MC_KV_U64("id", 7), MC_KV_STR("text", text), MC_KV_U64("after", 8));
+    MC_Log_Close();
+
+    memset(lines, 0, sizeof(lines));
+
+    if (MC_FOpen(&file, TEST_LOG_FILE, "r") == 0)
+    {
+        fgets(lines[0], sizeof(lines[0]), file);
+        fclose(file);
+    }
+
+    /* Assert */
+    ASSERT_NOT_NULL(strstr(lines[0], "\"event\":\"long\",\"id\":7,\"truncated\":true}\n"), failCount);
+
+    /* Arrange */
+    ASSERT_EQUAL_UINT64(MC_Log_InitBinary(TEST_LOG_BINARY_FILE, 0, MC_LOG_OVERFLOW_BLOCK), 0, failCount);
+
+    /* Act */
+    MC_LOG_KV(MC_LOG_LEVEL_ERROR, "stored", MC_KV_I64("value", -42), MC_KV_STR("quote", "\""));
+    MC_Log_Close();
+
+    memset(lines, 0, sizeof(lines));
+
+    if (MC_FOpen(&file, TEST_LOG_FILE, "w") == 0)
+    {
+        decoded = MC_Log_Decode(TEST_LOG_BINARY_FILE, file);
+        fclose(file);
+    }
+
+    if (MC_FOpen(&file, TEST_LOG_FILE, "r") == 0)
+    {
+        fgets(lines[0], sizeof(lines[0]), file);
+        fclose(file);
+    }
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(decoded, 0, failCount);
+    ASSERT_EQUAL_UINT64((u64)strncmp(lines[0], "{\"time\":\"", 9), 0, failCount);
+    ASSERT_NOT_NULL(strstr(lines[0], "\"level\":\"ERROR\",\"event\":\"stored\",\"value\":-42,\"quote\":\"\\\"\"}\n"), failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+static void test_log_limited(u64 site)
+{
+    for (u64 i = 0; i < TEST_CONSTANT_10000; i++)
+    {
+        if (site)   // a site's bucket stays empty for a second after a run
+        {
+            MC_LOG_LIMIT(MC_LOG_LEVEL_WARNING, 1, 5, "thread %u line %llu", 0u, test_log_argument(i));
+        }
+        else
+        {
+            MC_LOG_LIMIT(MC_LOG_LEVEL_WARNING, 1, 5, "thread %u line %llu", 0u, test_log_argument(i));
+        }
+    }
+}
+
+u32 Test_MC_Log_RateLimit(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    TestLogContents contents;
+
+    for (u64 async = 0; async < 2; async++)
+    {
+        test_log_evaluations = 0;
+
+        int opened = async ? MC_Log_InitAsync(0, MC_LOG_OVERFLOW_BLOCK) : MC_Log_Init();
+
+        ASSERT_EQUAL_UINT64(opened, 0, failCount);
+
+        /* Act */
+        test_log_limited(async);     // one site, the burst of five and whatever a second refills
+        MC_Log_Close();         // reports what is left, through the writer when asynchronous
+        test_log_read(&contents);
+
+        /* Assert */
+        ASSERT_EQUAL_UINT64((u64)(contents.threadLines[0] >= 5 && contents.threadLines[0] <= 7), true, failCount);
+        ASSERT_EQUAL_UINT64(test_log_evaluations, contents.threadLines[0], failCount);
+        ASSERT_EQUAL_UINT64(contents.threadLines[0] + contents.reportedSuppressed, TEST_CONSTANT_10000, failCount);
+        ASSERT_EQUAL_UINT64((u64)(contents.reports >= 1), true, failCount);
+    }
+
+    /* Arrange */
+    ASSERT_EQUAL_UINT64(MC_Log_Init(), 0, failCount);
+
+    /* Act */
+    for (u64 i = 0; i < TEST_CONSTANT_10000; i++)
+    {
+        MC_LOG_SAMPLE(MC_LOG_LEVEL_INFO, 100, "sample %llu", (unsigned long long)i);
+    }
+
+    MC_Log_Close();
+    test_log_read(&contents);
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(contents.lines - contents.reports, TEST_CONSTANT_10000 / 100, failCount);
+    ASSERT_EQUAL_UINT64(contents.reportedSuppressed, TEST_CONSTANT_10000 - TEST_CONSTANT_10000 / 100, failCount);
+    ASSERT_EQUAL_UINT64((u64)(contents.reports >= 2), true, failCount);    // the second sample already reports
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+int main(void)
+{
+    int failCount = 0;
+
+    failCount += Test_MC_Log_Sync();
+    failCount += Test_MC_Log_SyncThreads();
+    failCount += Test_MC_Log_Async();
+    failCount += Test_MC_Log_Flush();
+    failCount += Test_MC_Log_Overflow();
+    failCount += Test_MC_Log_Level();
+    failCount += Test_MC_Log_Timestamp();
+    failCount += Test_MC_Log_Binary();
+    failCount += Test_MC_Log_Mapped();
+    failCount += Test_MC_Log_KV();
+    failCount += Test_MC_Log_RateLimit();
+
+    return failCount;
+}
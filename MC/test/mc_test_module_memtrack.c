@@ -0,0 +1,269 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_test_module_memtrack.c                                                              */
+/* \brief: Source code for testing mc_memtrack                                                   */
+/*                                                                                               */
+/* \Expects: 1. All necessary mc definitions are defined and linked properly                     */
+/*                                                                                               */
+/*           Unit tests should follow a step by step approach and be specific to the             */
+/*           name of the function which they are evoked.                                         */
+/*           1. Arrange - Stage the entities to be tested on                                     */
+/*           2. Act - If necessary, perform any routines that might be necessary                 */
+/*           3. Assert - Determine if expectations are met for the test                          */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#include "mc_test.h"
+#include <stdio.h>      // snprintf
+#include <threads.h>    // thrd_create
+
+#define TEST_MEMTRACK_THREADS 4
+
+static int test_memtrack_worker(void *arg)
+{
+    u64 *failed = (u64*)arg;
+    char key[TEST_CONSTANT_32];
+
+    for (u64 round = 0; round < TEST_CONSTANT_10; round++)
+    {
+        MC_HashMap *map = MC_Hashmap_Init(TEST_CONSTANT_32);
+        MC_Stack *stack = MC_Stack_InitTyped(sizeof(u64));
+
+        for (u64 i = 0; i < TEST_CONSTANT_1000000 / 100; i++)
+        {
+            snprintf(key, sizeof(key), "Index: %05llu", (unsigned long long)i);
+            *failed += !MC_Hashmap_Insert(map, key, NULL, false);
+            *failed += !MC_Stack_Push(stack, &i, false);
+        }
+
+        MC_Hashmap_Free(&map);
+        MC_Stack_Free(&stack);
+    }
+
+    return 0;   // whatever is still batched is published as the thread exits
+}
+
+u32 Test_MC_MemTrack_Disabled(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    MC_MemStats stats = { 1, 1, 1, 1 };
+    MC_HashMap *map = MC_Hashmap_Init(TEST_CONSTANT_10);
+
+    /* Act */
+    u8 tracked = MC_Hashmap_MemStats(map, &stats);
+
+    /* Assert */
+    ASSERT_TRUE(tracked == MC_MemTrack_IsEnabled(), failCount);
+    ASSERT_FALSE(MC_Hashmap_MemStats(NULL, &stats), failCount);
+    ASSERT_FALSE(MC_MemTrack_Module(MC_MEM_MODULE_COUNT, &stats), failCount);
+    ASSERT_STRING_EQUAL(MC_MemTrack_ModuleName(MC_MEM_MODULE_HASH), "hash", 5, failCount);
+    ASSERT_STRING_EQUAL(MC_MemTrack_ModuleName(MC_MEM_MODULE_COUNT), "unknown", 8, failCount);
+
+    if (!tracked)
+    {
+        ASSERT_EQUAL_UINT64(stats.liveBytes, 0, failCount);
+        ASSERT_EQUAL_UINT64(stats.allocCount, 0, failCount);
+        ASSERT_FALSE(MC_MemTrack_Module(MC_MEM_MODULE_HASH, &stats), failCount);
+        ASSERT_EQUAL_UINT64(MC_MemTrack_ReportLeaks(), 0, failCount);
+    }
+
+    MC_Hashmap_Free(&map);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_MemTrack_Instance(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+
+    if (!MC_MemTrack_IsEnabled())
+    {
+        printf("Built without MC_ALLOC_TRACKING, nothing to check.\n");
+        TEST_TEARDOWN(failCount);
+
+        return failCount;
+    }
+
+    MC_HashMap *map = MC_Hashmap_Init(TEST_CONSTANT_10);
+    MC_Stack *stack = MC_Stack_Init();
+    MC_Stack *typed = MC_Stack_InitTyped(sizeof(u64));
+    MC_Arena *arena = MC_Arena_Init(TEST_CONSTANT_10000);
+    MC_MemStats empty, full, after, stackStats, typedStats, arenaStats;
+    char key[TEST_CONSTANT_32];
+
+    MC_Hashmap_MemStats(map, &empty);
+
+    /* Act */
+    for (u64 i = 0; i < TEST_CONSTANT_10000; i++)
+    {
+        snprintf(key, sizeof(key), "Index: %05llu", (unsigned long long)i);
+        MC_Hashmap_Insert(map, key, NULL, false);
+        MC_Stack_Push(stack, NULL, false);
+        MC_Stack_Push(typed, &i, false);
+    }
+
+    MC_Hashmap_MemStats(map, &full);
+
+    for (u64 i = 0; i < TEST_CONSTANT_10000; i++)
+    {
+        snprintf(key, sizeof(key), "Index: %05llu", (unsigned long long)i);
+        MC_Hashmap_RemoveAt(map, key);
+        MC_Stack_Pop(stack);
+    }
+
+    MC_Hashmap_MemStats(map, &after);
+    MC_Stack_MemStats(stack, &stackStats);
+    MC_Stack_MemStats(typed, &typedStats);
+
+    MC_Arena_Alloc(arena, TEST_CONSTANT_10000 * 2);     // too large for a regular chunk
+    MC_Arena_MemStats(arena, &arenaStats);
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(empty.allocCount, 2, failCount);                               // header and buckets
+    ASSERT_EQUAL_UINT64(full.allocCount, 2 + TEST_CONSTANT_10000 * 2, failCount);     // node and key per entry
+    ASSERT_TRUE(full.liveBytes > empty.liveBytes + TEST_CONSTANT_10000 * 12, failCount);
+    ASSERT_EQUAL_UINT64(after.liveBytes, empty.liveBytes, failCount);
+    ASSERT_EQUAL_UINT64(after.peakBytes, full.liveBytes, failCount);
+    ASSERT_EQUAL_UINT64(after.freeCount, TEST_CONSTANT_10000 * 2, failCount);
+    ASSERT_EQUAL_UINT64(stackStats.allocCount, stackStats.freeCount + 1, failCount);  // only the header is left
+    ASSERT_TRUE(stackStats.peakBytes > stackStats.liveBytes, failCount);
+    ASSERT_TRUE(typedStats.liveBytes >= TEST_CONSTANT_10000 * sizeof(u64), failCount);
+    ASSERT_EQUAL_UINT64(arenaStats.allocCount, 3, failCount);                          // header and two chunks
+    ASSERT_TRUE(arenaStats.liveBytes >= TEST_CONSTANT_10000 * 3, failCount);
+
+    MC_Hashmap_Free(&map);
+    MC_Stack_Free(&stack);
+    MC_Stack_Free(&typed);
+    MC_Arena_Free(&arena);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_MemTrack_Concurrent(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+
+    if (!MC_MemTrack_IsEnabled())
+    {
+        printf("Built without MC_ALLOC_TRACKING, nothing to check.\n");
+        TEST_TEARDOWN(failCount);
+
+        return failCount;
+    }
+
+    thrd_t threads[TEST_MEMTRACK_THREADS];
+    u64 failed[TEST_MEMTRACK_THREADS] = { 0 };
+    MC_MemStats hashBefore, hashAfter, stackBefore, stackAfter;
+
+    MC_MemTrack_Module(MC_MEM_MODULE_HASH, &hashBefore);
+    MC_MemTrack_Module(MC_MEM_MODULE_STACK, &stackBefore);
+
+    /* Act */
+    for (u64 i = 0; i < TEST_MEMTRACK_THREADS; i++)
+    {
+        thrd_create(&threads[i], test_memtrack_worker, &failed[i]);
+    }
+
+    for (u64 i = 0; i < TEST_MEMTRACK_THREADS; i++)
+    {
+        thrd_join(threads[i], NULL);
+        ASSERT_EQUAL_UINT64(failed[i], 0, failCount);
+    }
+
+    MC_MemTrack_Module(MC_MEM_MODULE_HASH, &hashAfter);
+    MC_MemTrack_Module(MC_MEM_MODULE_STACK, &stackAfter);
+
+    u64 hashAllocs = hashAfter.allocCount - hashBefore.allocCount;
+    u64 hashFrees = hashAfter.freeCount - hashBefore.freeCount;
+    u64 stackAllocs = stackAfter.allocCount - stackBefore.allocCount;
+    u64 stackFrees = stackAfter.freeCount - stackBefore.freeCount;
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(hashAllocs, TEST_MEMTRACK_THREADS * TEST_CONSTANT_10 * (2 + 2 * TEST_CONSTANT_1000000 / 100), failCount);
+    ASSERT_EQUAL_UINT64(hashAllocs, hashFrees, failCount);
+    ASSERT_EQUAL_UINT64(stackAllocs, stackFrees, failCount);
+    ASSERT_EQUAL_UINT64(hashAfter.liveBytes, hashBefore.liveBytes, failCount);
+    ASSERT_EQUAL_UINT64(stackAfter.liveBytes, stackBefore.liveBytes, failCount);
+    ASSERT_TRUE(hashAfter.peakBytes > hashBefore.liveBytes, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_MemTrack_Leaks(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+
+    if (!MC_MemTrack_IsEnabled())
+    {
+        printf("Built without MC_ALLOC_TRACKING, nothing to check.\n");
+        TEST_TEARDOWN(failCount);
+
+        return failCount;
+    }
+
+    MC_MemStats stats;
+    MC_HashMap *map = MC_Hashmap_Init(TEST_CONSTANT_32);
+    MC_Stack *stack = MC_Stack_Init();
+    MC_Arena *arena = MC_Arena_Init(TEST_CONSTANT_10000);
+    MC_SpscRing *ring = MC_SpscRing_Init(TEST_CONSTANT_32, sizeof(u64));
+
+    MC_Hashmap_Insert(map, "key", NULL, false);     // nodes from the shared Pools, kept after the frees below
+    MC_Stack_Push(stack, NULL, false);
+    MC_Hashmap_Free(&map);
+    MC_Stack_Free(&stack);
+
+    /* Act */
+    u64 leaked = MC_MemTrack_ReportLeaks();
+    MC_MemTrack_PrintSummary();
+
+    MC_Arena_Free(&arena);
+    MC_SpscRing_Free(&ring);
+
+    u64 left = MC_MemTrack_ReportLeaks();
+
+    /* Assert */
+    ASSERT_TRUE(leaked >= TEST_CONSTANT_10000 + TEST_CONSTANT_32 * sizeof(u64), failCount);
+    ASSERT_EQUAL_UINT64(left, 0, failCount);
+
+    for (u64 i = 0; i < MC_MEM_MODULE_COUNT; i++)
+    {
+        ASSERT_TRUE(MC_MemTrack_Module((MC_MemModule)i, &stats), failCount);
+        ASSERT_EQUAL_UINT64(stats.liveBytes, 0, failCount);
+        ASSERT_EQUAL_UINT64(stats.allocCount, stats.freeCount, failCount);
+    }
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+int main(void)
+{
+    int failCount = 0;
+
+    failCount += Test_MC_MemTrack_Disabled();
+    failCount += Test_MC_MemTrack_Instance();
+    failCount += Test_MC_MemTrack_Concurrent();
+    failCount += Test_MC_MemTrack_Leaks();
+
+    return failCount;
+}
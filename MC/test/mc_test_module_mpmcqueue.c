@@ -0,0 +1,258 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_test_module_mpmcqueue.c                                                             */
+/* \brief: Source code for testing mc_mpmcqueue                                                  */
+/*                                                                                               */
+/* \Expects: 1. All necessary mc definitions are defined and linked properly                     */
+/*                                                                                               */
+/*           Unit tests should follow a step by step approach and be specific to the             */
+/*           name of the function which they are evoked.                                         */
+/*           1. Arrange - Stage the entities to be tested on                                     */
+/*           2. Act - If necessary, perform any routines that might be necessary                 */
+/*           3. Assert - Determine if expectations are met for the test                          */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#include "mc_test.h"
+#include <threads.h>    // thrd_create
+#include <stdatomic.h>  // atomic_fetch_add
+
+#define TEST_MPMC_PRODUCERS 3
+#define TEST_MPMC_CONSUMERS 3
+
+typedef struct
+{
+    MC_MpmcQueue *queue;
+    u64 first;
+    atomic_uchar *seen;
+    u64 received;
+    u8 lastResult;
+} TestMpmc;
+
+static int test_producer(void *arg)
+{
+    TestMpmc *test = (TestMpmc*)arg;
+
+    for (u64 i = 0; i < TEST_CONSTANT_10000; i++)
+    {
+        u64 value = test->first + i;
+        MC_MpmcQueue_Enqueue(test->queue, &value);
+    }
+
+    return 0;
+}
+
+static int test_consumer(void *arg)
+{
+    TestMpmc *test = (TestMpmc*)arg;
+    u64 value = 0;
+
+    while (MC_MpmcQueue_Dequeue(test->queue, &value))
+    {
+        atomic_fetch_add(&test->seen[value], 1);
+        test->received++;
+    }
+
+    return 0;
+}
+
+u32 Test_MC_MpmcQueue_InitAndFree(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    MC_MpmcQueue *queue = MC_MpmcQueue_Init(TEST_CONSTANT_10, sizeof(u64));
+
+    ASSERT_NOT_NULL(queue, failCount);
+    ASSERT_NULL(MC_MpmcQueue_Init(TEST_CONSTANT_10, 0), failCount);
+    ASSERT_EQUAL_UINT64(MC_MpmcQueue_Capacity(queue), 16, failCount);
+    ASSERT_TRUE(MC_MpmcQueue_IsEmpty(queue), failCount);
+
+    /* Act */
+    MC_MpmcQueue_Free(&queue);
+
+    /* Assert */
+    ASSERT_NULL(queue, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_MpmcQueue_TryFifo(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    MC_MpmcQueue *queue = MC_MpmcQueue_Init(TEST_CONSTANT_32, sizeof(u32));
+    u64 successfulEnqueues = 0;
+    u64 outOfOrder = 0;
+    u32 value = 0;
+
+    ASSERT_NOT_NULL(queue, failCount);
+    ASSERT_FALSE(MC_MpmcQueue_TryDequeue(queue, &value), failCount);
+
+    /* Act */
+    for (u32 lap = 0; lap < 3; lap++)   // several laps so every slot sequence wraps
+    {
+        for (u32 i = 0; i < TEST_CONSTANT_32; i++)
+        {
+            successfulEnqueues += MC_MpmcQueue_TryEnqueue(queue, &i);
+        }
+
+        outOfOrder += MC_MpmcQueue_TryEnqueue(queue, &value);       // full
+
+        for (u32 i = 0; i < TEST_CONSTANT_32; i++)
+        {
+            if (!MC_MpmcQueue_TryDequeue(queue, &value) || value != i)
+            {
+                outOfOrder++;
+            }
+        }
+    }
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(successfulEnqueues, TEST_CONSTANT_32 * 3, failCount);
+    ASSERT_EQUAL_UINT64(outOfOrder, 0, failCount);
+    ASSERT_TRUE(MC_MpmcQueue_IsEmpty(queue), failCount);
+    ASSERT_FALSE(MC_MpmcQueue_TryDequeue(queue, &value), failCount);
+
+    MC_MpmcQueue_Free(&queue);
+
+    ASSERT_NULL(queue, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_MpmcQueue_Concurrent(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    MC_MpmcQueue *queue = MC_MpmcQueue_Init(TEST_CONSTANT_10, sizeof(u64));    // small, so both sides block
+    static atomic_uchar seen[TEST_MPMC_PRODUCERS * TEST_CONSTANT_10000];
+    TestMpmc producers[TEST_MPMC_PRODUCERS];
+    TestMpmc consumers[TEST_MPMC_CONSUMERS];
+    thrd_t producerThreads[TEST_MPMC_PRODUCERS];
+    thrd_t consumerThreads[TEST_MPMC_CONSUMERS];
+    u64 received = 0;
+    u64 notOnce = 0;
+
+    ASSERT_NOT_NULL(queue, failCount);
+
+    /* Act */
+    for (u64 i = 0; i < TEST_MPMC_CONSUMERS; i++)
+    {
+        consumers[i] = (TestMpmc){ .queue = queue, .seen = seen };
+        thrd_create(&consumerThreads[i], test_consumer, &consumers[i]);
+    }
+
+    for (u64 i = 0; i < TEST_MPMC_PRODUCERS; i++)
+    {
+        producers[i] = (TestMpmc){ .queue = queue, .first = i * TEST_CONSTANT_10000, .seen = seen };
+        thrd_create(&producerThreads[i], test_producer, &producers[i]);
+    }
+
+    for (u64 i = 0; i < TEST_MPMC_PRODUCERS; i++)
+    {
+        thrd_join(producerThreads[i], NULL);
+    }
+
+    MC_MpmcQueue_Close(queue);
+
+    for (u64 i = 0; i < TEST_MPMC_CONSUMERS; i++)
+    {
+        thrd_join(consumerThreads[i], NULL);
+        received += consumers[i].received;
+    }
+
+    /* Assert */
+    for (u64 i = 0; i < TEST_MPMC_PRODUCERS * TEST_CONSTANT_10000; i++)
+    {
+        notOnce += atomic_load(&seen[i]) != 1;
+    }
+
+    ASSERT_EQUAL_UINT64(received, TEST_MPMC_PRODUCERS * TEST_CONSTANT_10000, failCount);
+    ASSERT_EQUAL_UINT64(notOnce, 0, failCount);
+    ASSERT_TRUE(MC_MpmcQueue_IsEmpty(queue), failCount);
+
+    MC_MpmcQueue_Free(&queue);
+
+    ASSERT_NULL(queue, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+static int test_close_consumer(void *arg)
+{
+    TestMpmc *test = (TestMpmc*)arg;
+    u64 value = 0;
+
+    while (MC_MpmcQueue_Dequeue(test->queue, &value))
+    {
+        test->received++;
+    }
+
+    test->lastResult = MC_MpmcQueue_Dequeue(test->queue, &value);
+
+    return 0;
+}
+
+u32 Test_MC_MpmcQueue_Close(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    MC_MpmcQueue *queue = MC_MpmcQueue_Init(TEST_CONSTANT_10, sizeof(u64));
+    TestMpmc consumer = { .queue = queue, .lastResult = true };
+    thrd_t consumerThread;
+    u64 value = TEST_CONSTANT_10;
+
+    ASSERT_NOT_NULL(queue, failCount);
+
+    /* Act */
+    thrd_create(&consumerThread, test_close_consumer, &consumer);
+    thrd_sleep(&(struct timespec){ .tv_nsec = 10000000 }, NULL);    // let the consumer fall asleep
+
+    u8 enqueued = MC_MpmcQueue_Enqueue(queue, &value);
+    MC_MpmcQueue_Close(queue);
+    u8 enqueuedAfterClose = MC_MpmcQueue_Enqueue(queue, &value);
+
+    thrd_join(consumerThread, NULL);
+
+    /* Assert */
+    ASSERT_TRUE(enqueued, failCount);
+    ASSERT_FALSE(enqueuedAfterClose, failCount);
+    ASSERT_EQUAL_UINT64(consumer.received, 1, failCount);
+    ASSERT_FALSE(consumer.lastResult, failCount);
+    ASSERT_TRUE(MC_MpmcQueue_IsEmpty(queue), failCount);
+
+    MC_MpmcQueue_Free(&queue);
+
+    ASSERT_NULL(queue, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+int main(void)
+{
+    int failCount = 0;
+
+    failCount += Test_MC_MpmcQueue_InitAndFree();
+    failCount += Test_MC_MpmcQueue_TryFifo();
+    failCount += Test_MC_MpmcQueue_Concurrent();
+    failCount += Test_MC_MpmcQueue_Close();
+
+    return failCount;
+}
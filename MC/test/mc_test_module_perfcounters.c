@@ -0,0 +1,193 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_test_module_perfcounters.c                                                          */
+/* \brief: Source code for testing mc_perfcounters                                               */
+/*                                                                                               */
+/* \Expects: 1. All necessary mc definitions are defined and linked properly                     */
+/*                                                                                               */
+/*           Unit tests should follow a step by step approach and be specific to the             */
+/*           name of the function which they are evoked.                                         */
+/*           1. Arrange - Stage the entities to be tested on                                     */
+/*           2. Act - If necessary, perform any routines that might be necessary                 */
+/*           3. Assert - Determine if expectations are met for the test                          */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#include "mc_test.h"
+#include <stdlib.h>     // malloc, free
+#include <string.h>     // strcmp
+
+/**
+ * \brief Bytes of fresh memory the measured region touches, so it takes page faults.
+ */
+#define TEST_PERF_BYTES (8 * 1024 * 1024)
+
+#define TEST_PERF_PAGE 4096
+
+/**
+ * \brief Touch every page of a fresh buffer and fold its bytes, work every counter sees.
+ */
+static u64 test_perf_work(void)
+{
+    volatile u8 *bytes = (volatile u8*)malloc(TEST_PERF_BYTES);
+    u64 sum = 0;
+
+    if (!bytes)
+    {
+        return 0;
+    }
+
+    for (u64 i = 0; i < TEST_PERF_BYTES; i += TEST_PERF_PAGE)
+    {
+        bytes[i] = (u8)i;
+    }
+
+    for (u64 i = 0; i < TEST_PERF_BYTES; i += TEST_PERF_PAGE / 64)
+    {
+        sum += bytes[i];
+    }
+
+    free((void*)bytes);
+
+    return sum;
+}
+
+u32 Test_MC_PerfCounters_Unavailable(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    MC_PerfCounters *counters = NULL;
+    MC_PerfSample sample = { { 1, 1, 1, 1, 1, 1 }, 1, 1 };
+
+    /* Act */
+    u8 started = MC_PerfCounters_Start(counters);
+    u8 read = MC_PerfCounters_Read(counters, &sample);
+    u8 stopped = MC_PerfCounters_Stop(counters, NULL);
+
+    MC_PerfCounters_Close(&counters);
+    MC_PerfCounters_Close(NULL);
+    MC_PerfCounters_PrintPerOp(&sample, 1);     // nothing available, prints nothing
+
+    /* Assert */
+    ASSERT_FALSE(started, failCount);
+    ASSERT_FALSE(read, failCount);
+    ASSERT_FALSE(stopped, failCount);
+    ASSERT_FALSE(MC_PerfCounters_Read(counters, NULL), failCount);
+    ASSERT_EQUAL_UINT64(MC_PerfCounters_Available(counters), 0, failCount);
+    ASSERT_EQUAL_UINT64(sample.available, 0, failCount);
+    ASSERT_EQUAL_UINT64(sample.values[MC_PERF_CYCLES], 0, failCount);
+    ASSERT_EQUAL_UINT64(sample.multiplexed, 0, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_PerfCounters_Region(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    MC_PerfCounters *counters = MC_PerfCounters_Open();
+
+    if (!counters)
+    {
+        printf("perf_event_open refused every counter, nothing to check.\n");
+        TEST_TEARDOWN(failCount);
+
+        return failCount;
+    }
+
+    MC_PerfSample first, second, stopped, after, empty;
+    u64 sum = 0;
+
+    /* Act */
+    u8 started = MC_PerfCounters_Start(counters);
+    sum += test_perf_work();
+    u8 readFirst = MC_PerfCounters_Read(counters, &first);
+    sum += test_perf_work();
+    u8 readSecond = MC_PerfCounters_Read(counters, &second);
+    sum += test_perf_work();
+    u8 stop = MC_PerfCounters_Stop(counters, &stopped);
+    sum += test_perf_work();
+    u8 readAfter = MC_PerfCounters_Read(counters, &after);
+
+    u8 restarted = MC_PerfCounters_Start(counters);
+    u8 stopEmpty = MC_PerfCounters_Stop(counters, &empty);
+
+    MC_PerfCounters_PrintPerOp(&stopped, 3);
+
+    /* Assert */
+    ASSERT_TRUE(started && readFirst && readSecond && stop && readAfter && restarted && stopEmpty, failCount);
+    ASSERT_NOT_EQUAL_UINT64(stopped.available, 0, failCount);
+    ASSERT_EQUAL_UINT64(stopped.available, MC_PerfCounters_Available(counters), failCount);
+
+    for (u32 event = 0; event < MC_PERF_EVENT_COUNT; event++)
+    {
+        if (!(stopped.available & (1u << event)))
+        {
+            ASSERT_EQUAL_UINT64(stopped.values[event], 0, failCount);
+            continue;
+        }
+
+        ASSERT_TRUE(second.values[event] >= first.values[event], failCount);
+        ASSERT_TRUE(stopped.values[event] >= second.values[event], failCount);
+        ASSERT_EQUAL_UINT64(after.values[event], stopped.values[event], failCount);
+    }
+
+    if (stopped.available & (1u << MC_PERF_INSTRUCTIONS))
+    {
+        ASSERT_TRUE(stopped.values[MC_PERF_INSTRUCTIONS] >= 3 * TEST_PERF_BYTES / TEST_PERF_PAGE, failCount);
+    }
+
+    if (stopped.available & (1u << MC_PERF_PAGE_FAULTS))
+    {
+        ASSERT_TRUE(first.values[MC_PERF_PAGE_FAULTS] > 0, failCount);
+        ASSERT_TRUE(empty.values[MC_PERF_PAGE_FAULTS] < stopped.values[MC_PERF_PAGE_FAULTS], failCount);
+    }
+
+    MC_PerfCounters_Close(&counters);
+
+    ASSERT_NULL(counters, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_PerfCounters_EventName(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+
+    /* Act */
+    const char *cycles = MC_PerfCounters_EventName(MC_PERF_CYCLES);
+    const char *switches = MC_PerfCounters_EventName(MC_PERF_CONTEXT_SWITCHES);
+    const char *unknown = MC_PerfCounters_EventName(MC_PERF_EVENT_COUNT);
+
+    /* Assert */
+    ASSERT_TRUE(strcmp(cycles, "cycles") == 0, failCount);
+    ASSERT_TRUE(strcmp(switches, "context switches") == 0, failCount);
+    ASSERT_TRUE(strcmp(unknown, "unknown") == 0, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+int main(void)
+{
+    int failCount = 0;
+
+    failCount += Test_MC_PerfCounters_Unavailable();
+    failCount += Test_MC_PerfCounters_Region();
+    failCount += Test_MC_PerfCounters_EventName();
+
+    return failCount;
+}
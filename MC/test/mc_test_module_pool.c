@@ -0,0 +1,254 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_test_module_pool.c                                                                  */
+/* \brief: Source code for testing mc_pool                                                       */
+/*                                                                                               */
+/* \Expects: 1. All necessary mc definitions are defined and linked properly                     */
+/*                                                                                               */
+/*           Unit tests should follow a step by step approach and be specific to the             */
+/*           name of the function which they are evoked.                                         */
+/*           1. Arrange - Stage the entities to be tested on                                     */
+/*           2. Act - If necessary, perform any routines that might be necessary                 */
+/*           3. Assert - Determine if expectations are met for the test                          */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#include "mc_test.h"
+#include <stdlib.h>     // malloc
+#include <string.h>     // memset
+#include <threads.h>    // thrd_create
+
+#define TEST_POOL_THREADS 4
+
+typedef struct
+{
+    MC_Pool *pool;
+    u64 **handoff;      // objects allocated by this thread, released by the next one
+    u64 corrupted;
+} TestPool;
+
+static int test_pool_worker(void *arg)
+{
+    TestPool *test = (TestPool*)arg;
+
+    for (u64 i = 0; i < TEST_CONSTANT_10000; i++)
+    {
+        u64 *object = (u64*)MC_Pool_Alloc(test->pool);
+
+        if (!object)
+        {
+            test->corrupted++;
+            continue;
+        }
+
+        *object = i;
+        test->handoff[i] = object;
+    }
+
+    for (u64 i = 0; i < TEST_CONSTANT_10000; i++)
+    {
+        test->corrupted += test->handoff[i] && *test->handoff[i] != i;
+    }
+
+    return 0;
+}
+
+static int test_pool_releaser(void *arg)
+{
+    TestPool *test = (TestPool*)arg;
+
+    for (u64 i = 0; i < TEST_CONSTANT_10000; i++)
+    {
+        MC_Pool_Release(test->pool, test->handoff[i]);
+    }
+
+    return 0;   // the magazine is flushed back into the Pool as the thread exits
+}
+
+u32 Test_MC_Pool_InitAndFree(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    MC_Pool *pool = MC_Pool_Init(TEST_CONSTANT_10, 1);
+
+    ASSERT_NOT_NULL(pool, failCount);
+    ASSERT_NULL(MC_Pool_Init(0, 1), failCount);
+    ASSERT_EQUAL_UINT64(MC_Pool_ObjectSize(pool), 16, failCount);
+    ASSERT_EQUAL_UINT64(MC_Pool_SlabCount(pool), 0, failCount);
+
+    /* Act */
+    MC_Pool_Free(&pool);
+
+    /* Assert */
+    ASSERT_NULL(pool, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Pool_AllocRelease(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    MC_Pool *pool = MC_Pool_Init(TEST_CONSTANT_32 + 1, 1);
+    u8 **objects = (u8**)malloc(TEST_CONSTANT_10000 * sizeof(u8*));
+    u64 misaligned = 0;
+    u64 corrupted = 0;
+
+    ASSERT_NOT_NULL(pool, failCount);
+
+    /* Act */
+    for (u64 i = 0; i < TEST_CONSTANT_10000; i++)
+    {
+        objects[i] = (u8*)MC_Pool_Alloc(pool);
+        misaligned += objects[i] == NULL || ((uintptr_t)objects[i] & 15) != 0;
+
+        if (objects[i])
+        {
+            memset(objects[i], (int)(i & 0xFF), TEST_CONSTANT_32 + 1);
+        }
+    }
+
+    for (u64 i = 0; i < TEST_CONSTANT_10000; i++)   // overlapping objects would have overwritten each other
+    {
+        corrupted += objects[i] && (objects[i][0] != (u8)i || objects[i][TEST_CONSTANT_32] != (u8)i);
+    }
+
+    u64 slabs = MC_Pool_SlabCount(pool);
+    MC_Pool_Release(pool, objects[0]);
+    u8 *reused = (u8*)MC_Pool_Alloc(pool);
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(misaligned, 0, failCount);
+    ASSERT_EQUAL_UINT64(corrupted, 0, failCount);
+    ASSERT_TRUE(reused == objects[0], failCount);           // straight back out of the magazine
+    ASSERT_EQUAL_UINT64(MC_Pool_SlabCount(pool), slabs, failCount);
+
+    free(objects);
+    MC_Pool_Free(&pool);
+
+    ASSERT_NULL(pool, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Pool_SlabRelease(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    MC_Pool *pool = MC_Pool_Init(TEST_CONSTANT_32, 2);
+    void **objects = (void**)malloc(TEST_CONSTANT_10000 * sizeof(void*));
+
+    ASSERT_NOT_NULL(pool, failCount);
+
+    for (u64 i = 0; i < TEST_CONSTANT_10000; i++)
+    {
+        objects[i] = MC_Pool_Alloc(pool);
+    }
+
+    u64 slabsInUse = MC_Pool_SlabCount(pool);
+
+    /* Act */
+    for (u64 i = 0; i < TEST_CONSTANT_10000; i++)
+    {
+        MC_Pool_Release(pool, objects[i]);
+    }
+
+    MC_Pool_Flush(pool);
+
+    /* Assert */
+    ASSERT_TRUE(slabsInUse > 2, failCount);
+    ASSERT_EQUAL_UINT64(MC_Pool_SlabCount(pool), 2, failCount);
+
+    free(objects);
+    MC_Pool_Free(&pool);
+
+    ASSERT_NULL(pool, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Pool_Concurrent(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    MC_Pool *pool = MC_Pool_Init(sizeof(u64), 0);
+    TestPool tests[TEST_POOL_THREADS];
+    TestPool releasers[TEST_POOL_THREADS];
+    thrd_t threads[TEST_POOL_THREADS];
+    u64 corrupted = 0;
+
+    ASSERT_NOT_NULL(pool, failCount);
+
+    for (u64 t = 0; t < TEST_POOL_THREADS; t++)
+    {
+        tests[t] = (TestPool){ .pool = pool };
+        tests[t].handoff = (u64**)calloc(TEST_CONSTANT_10000, sizeof(u64*));
+    }
+
+    /* Act */
+    for (u64 t = 0; t < TEST_POOL_THREADS; t++)
+    {
+        thrd_create(&threads[t], test_pool_worker, &tests[t]);
+    }
+
+    for (u64 t = 0; t < TEST_POOL_THREADS; t++)
+    {
+        thrd_join(threads[t], NULL);
+        corrupted += tests[t].corrupted;
+    }
+
+    for (u64 t = 0; t < TEST_POOL_THREADS; t++)   // every thread releases what its neighbour allocated
+    {
+        releasers[t] = (TestPool){ .pool = pool, .handoff = tests[(t + 1) % TEST_POOL_THREADS].handoff };
+        thrd_create(&threads[t], test_pool_releaser, &releasers[t]);
+    }
+
+    for (u64 t = 0; t < TEST_POOL_THREADS; t++)
+    {
+        thrd_join(threads[t], NULL);
+    }
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(corrupted, 0, failCount);
+    ASSERT_EQUAL_UINT64(MC_Pool_SlabCount(pool), 0, failCount);     // all returned, none kept
+
+    for (u64 t = 0; t < TEST_POOL_THREADS; t++)
+    {
+        free(tests[t].handoff);
+    }
+
+    MC_Pool_Free(&pool);
+
+    ASSERT_NULL(pool, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+int main(void)
+{
+    int failCount = 0;
+
+    failCount += Test_MC_Pool_InitAndFree();
+    failCount += Test_MC_Pool_AllocRelease();
+    failCount += Test_MC_Pool_SlabRelease();
+    failCount += Test_MC_Pool_Concurrent();
+
+    return failCount;
+}
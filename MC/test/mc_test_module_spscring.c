@@ -0,0 +1,278 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_test_module_spscring.c                                                              */
+/* \brief: Source code for testing mc_spscring                                                   */
+/*                                                                                               */
+/* \Expects: 1. All necessary mc definitions are defined and linked properly                     */
+/*                                                                                               */
+/*           Unit tests should follow a step by step approach and be specific to the             */
+/*           name of the function which they are evoked.                                         */
+/*           1. Arrange - Stage the entities to be tested on                                     */
+/*           2. Act - If necessary, perform any routines that might be necessary                 */
+/*           3. Assert - Determine if expectations are met for the test                          */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#include "mc_test.h"
+#include <threads.h>    // thrd_create
+
+static int test_producer(void *arg)
+{
+    MC_SpscRing *ring = (MC_SpscRing*)arg;
+    u64 batch[TEST_CONSTANT_10];
+    u64 next = 0;
+
+    while (next < TEST_CONSTANT_1000000)
+    {
+        u64 count = 0;
+
+        while (count < TEST_CONSTANT_10 && next + count < TEST_CONSTANT_1000000)
+        {
+            batch[count] = next + count;
+            count++;
+        }
+
+        u64 enqueued = MC_SpscRing_EnqueueN(ring, batch, count);   // whatever did not fit is rebuilt next round
+
+        if (enqueued == 0)
+        {
+            thrd_yield();
+        }
+
+        next += enqueued;
+    }
+
+    return 0;
+}
+
+u32 Test_MC_SpscRing_InitAndFree(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    MC_SpscRing *ring = MC_SpscRing_Init(TEST_CONSTANT_10, sizeof(u64));
+
+    ASSERT_NOT_NULL(ring, failCount);
+    ASSERT_NULL(MC_SpscRing_Init(TEST_CONSTANT_10, 0), failCount);
+    ASSERT_EQUAL_UINT64(MC_SpscRing_Capacity(ring), 16, failCount);
+    ASSERT_TRUE(MC_SpscRing_IsEmpty(ring), failCount);
+
+    /* Act */
+    MC_SpscRing_Free(&ring);
+
+    /* Assert */
+    ASSERT_NULL(ring, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_SpscRing_EnqueueDequeue(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    MC_SpscRing *ring = MC_SpscRing_Init(TEST_CONSTANT_32, sizeof(u64));
+    u64 successfulEnqueues = 0;
+    u64 outOfOrder = 0;
+    u64 value = 0;
+
+    ASSERT_NOT_NULL(ring, failCount);
+    ASSERT_FALSE(MC_SpscRing_Dequeue(ring, &value), failCount);
+
+    /* Act */
+    for (u64 i = 0; i < TEST_CONSTANT_32; i++)
+    {
+        successfulEnqueues += MC_SpscRing_Enqueue(ring, &i);
+    }
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(successfulEnqueues, TEST_CONSTANT_32, failCount);
+    ASSERT_EQUAL_UINT64(MC_SpscRing_Size(ring), TEST_CONSTANT_32, failCount);
+    ASSERT_FALSE(MC_SpscRing_Enqueue(ring, &value), failCount);     // full
+
+    for (u64 i = 0; i < TEST_CONSTANT_32; i++)
+    {
+        if (!MC_SpscRing_Dequeue(ring, &value) || value != i)
+        {
+            outOfOrder++;
+        }
+    }
+
+    ASSERT_EQUAL_UINT64(outOfOrder, 0, failCount);
+    ASSERT_TRUE(MC_SpscRing_IsEmpty(ring), failCount);
+
+    MC_SpscRing_Free(&ring);
+
+    ASSERT_NULL(ring, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_SpscRing_Batch(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    MC_SpscRing *ring = MC_SpscRing_Init(TEST_CONSTANT_32, sizeof(u32));
+    u32 values[TEST_CONSTANT_32 * 2];
+    u32 out[TEST_CONSTANT_32 * 2];
+
+    for (u32 i = 0; i < TEST_CONSTANT_32 * 2; i++)
+    {
+        values[i] = i + 100;
+    }
+
+    ASSERT_NOT_NULL(ring, failCount);
+
+    /* Act */
+    u64 count = MC_SpscRing_EnqueueN(ring, values, TEST_CONSTANT_10);
+    ASSERT_EQUAL_UINT64(count, TEST_CONSTANT_10, failCount);
+
+    count = MC_SpscRing_DequeueN(ring, out, TEST_CONSTANT_10);
+    ASSERT_EQUAL_UINT64(count, TEST_CONSTANT_10, failCount);
+
+    count = MC_SpscRing_EnqueueN(ring, values, TEST_CONSTANT_32 * 2);   // wraps, and only 32 fit
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(count, TEST_CONSTANT_32, failCount);
+
+    count = MC_SpscRing_DequeueN(ring, out, TEST_CONSTANT_32 * 2);
+    ASSERT_EQUAL_UINT64(count, TEST_CONSTANT_32, failCount);
+    ASSERT_ARRAY_EQUAL(out, values, TEST_CONSTANT_32, failCount);
+    ASSERT_TRUE(MC_SpscRing_IsEmpty(ring), failCount);
+
+    MC_SpscRing_Free(&ring);
+
+    ASSERT_NULL(ring, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_SpscRing_ReserveCommit(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    MC_SpscRing *ring = MC_SpscRing_Init(TEST_CONSTANT_32, sizeof(u64));
+    u64 granted = 0;
+    u64 out[TEST_CONSTANT_32];
+
+    ASSERT_NOT_NULL(ring, failCount);
+    ASSERT_NULL(MC_SpscRing_Acquire(ring, 1, &granted), failCount);
+
+    u64 skip[TEST_CONSTANT_10 * 2] = { 0 };
+    MC_SpscRing_EnqueueN(ring, skip, TEST_CONSTANT_10 * 2);    // move the positions near the end
+    MC_SpscRing_DequeueN(ring, skip, TEST_CONSTANT_10 * 2);
+
+    /* Act */
+    u64 *slots = (u64*)MC_SpscRing_Reserve(ring, TEST_CONSTANT_32, &granted);
+
+    /* Assert */
+    ASSERT_NOT_NULL(slots, failCount);
+    ASSERT_EQUAL_UINT64(granted, TEST_CONSTANT_32 - TEST_CONSTANT_10 * 2, failCount);  // stops at the end
+
+    for (u64 i = 0; i < granted; i++)
+    {
+        slots[i] = i;
+    }
+
+    ASSERT_TRUE(MC_SpscRing_IsEmpty(ring), failCount);      // nothing is visible before the commit
+    MC_SpscRing_Commit(ring, granted);
+    ASSERT_EQUAL_UINT64(MC_SpscRing_Size(ring), TEST_CONSTANT_32 - TEST_CONSTANT_10 * 2, failCount);
+
+    slots = (u64*)MC_SpscRing_Reserve(ring, TEST_CONSTANT_32, &granted);   // wrapped to the start
+    ASSERT_NOT_NULL(slots, failCount);
+    ASSERT_EQUAL_UINT64(granted, TEST_CONSTANT_10 * 2, failCount);
+    MC_SpscRing_Commit(ring, 0);
+
+    const u64 *ready = (const u64*)MC_SpscRing_Acquire(ring, TEST_CONSTANT_32, &granted);
+    ASSERT_NOT_NULL(ready, failCount);
+    ASSERT_EQUAL_UINT64(granted, TEST_CONSTANT_32 - TEST_CONSTANT_10 * 2, failCount);
+    ASSERT_EQUAL_UINT64(ready[granted - 1], granted - 1, failCount);
+
+    MC_SpscRing_Release(ring, granted);
+    ASSERT_TRUE(MC_SpscRing_IsEmpty(ring), failCount);
+
+    u64 count = MC_SpscRing_DequeueN(ring, out, TEST_CONSTANT_32);
+    ASSERT_EQUAL_UINT64(count, 0, failCount);
+
+    MC_SpscRing_Free(&ring);
+
+    ASSERT_NULL(ring, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_SpscRing_Concurrent(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    MC_SpscRing *ring = MC_SpscRing_Init(TEST_CONSTANT_32, sizeof(u64));
+    thrd_t producer;
+    u64 expected = 0;
+    u64 outOfOrder = 0;
+    u64 batch[TEST_CONSTANT_32];
+
+    ASSERT_NOT_NULL(ring, failCount);
+
+    /* Act */
+    thrd_create(&producer, test_producer, ring);
+
+    while (expected < TEST_CONSTANT_1000000)
+    {
+        u64 count = MC_SpscRing_DequeueN(ring, batch, TEST_CONSTANT_32);
+
+        for (u64 i = 0; i < count; i++)
+        {
+            outOfOrder += batch[i] != expected++;
+        }
+
+        if (count == 0)
+        {
+            thrd_yield();
+        }
+    }
+
+    thrd_join(producer, NULL);
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(expected, TEST_CONSTANT_1000000, failCount);
+    ASSERT_EQUAL_UINT64(outOfOrder, 0, failCount);
+    ASSERT_TRUE(MC_SpscRing_IsEmpty(ring), failCount);
+
+    MC_SpscRing_Free(&ring);
+
+    ASSERT_NULL(ring, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+int main(void)
+{
+    int failCount = 0;
+
+    failCount += Test_MC_SpscRing_InitAndFree();
+    failCount += Test_MC_SpscRing_EnqueueDequeue();
+    failCount += Test_MC_SpscRing_Batch();
+    failCount += Test_MC_SpscRing_ReserveCommit();
+    failCount += Test_MC_SpscRing_Concurrent();
+
+    return failCount;
+}
@@ -15,6 +15,7 @@
 /* ********************************************************************************************* */
 
 #include "mc_test.h"
+#include <stdlib.h>     // free
 
 u32 Test_MC_Stack_InitAndFree(void)
 {
@@ -54,8 +55,8 @@ u32 Test_MC_Stack_BigSize(void)
     /* Act */
     for (u64 i = 0; i < TEST_CONSTANT_1000000; i++)
     {
-        sprintf_s(temp, sizeof(temp), "Stack push: %lld", i);
-        strncpy_s(value, sizeof(value), temp, sizeof(value) - 1);
+        snprintf(temp, sizeof(temp), "Stack push: %llu", (unsigned long long)i);
+        snprintf(value, sizeof(value), "%s", temp);
 
         successfulPushes += MC_Stack_Push(stack, value, false);
     }
@@ -88,8 +89,8 @@ u32 Test_MC_Stack_DynamicInsertion(void)
     /* Act */
     for (u8 i = 0; i < TEST_CONSTANT_32; i++)
     {
-        sprintf_s(temp, sizeof(temp), "Stack push: %d", i);
-        char *value = _strdup(temp);
+        snprintf(temp, sizeof(temp), "Stack push: %d", i);
+        char *value = MC_StrDup(temp);
 
         successfulPushes += MC_Stack_Push(stack, value, true);
     }
@@ -124,8 +125,8 @@ u32 Test_MC_Stack_PeekAndPop(void)
     /* Assert */
     for (u8 i = 0; i < TEST_CONSTANT_32; i++)
     {
-        sprintf_s(temp, sizeof(temp), "Stack push: %d", i);
-        strncpy_s(value, sizeof(value), temp, sizeof(value) - 1);
+        snprintf(temp, sizeof(temp), "Stack push: %d", i);
+        snprintf(value, sizeof(value), "%s", temp);
 
         successfulPushes += MC_Stack_Push(stack, value, false);
 
@@ -162,8 +163,8 @@ u32 Test_MC_Stack_IsEmpty(void)
     /* Act */
     for (u8 i = 0; i < TEST_CONSTANT_10; i++)
     {
-        sprintf_s(temp, sizeof(temp), "Stack push: %d", i);
-        strncpy_s(value, sizeof(value), temp, sizeof(value) - 1);
+        snprintf(temp, sizeof(temp), "Stack push: %d", i);
+        snprintf(value, sizeof(value), "%s", temp);
 
         successfulPushes += MC_Stack_Push(stack, value, false);
     }
@@ -202,8 +203,8 @@ u32 Test_MC_Stack_GetSize(void)
     /* Assert */
     for (u8 i = 0; i < TEST_CONSTANT_32; i++)
     {
-        sprintf_s(temp, sizeof(temp), "Stack push: %d", i);
-        strncpy_s(value, sizeof(value), temp, sizeof(value) - 1);
+        snprintf(temp, sizeof(temp), "Stack push: %d", i);
+        snprintf(value, sizeof(value), "%s", temp);
 
         successfulPushes += MC_Stack_Push(stack, value, false);
         ASSERT_EQUAL_UINT64(MC_Stack_Size(stack), successfulPushes, failCount);
@@ -229,6 +230,291 @@ u32 Test_MC_Stack_GetSize(void)
     return failCount;
 }
 
+u32 Test_MC_Stack_TypedPushPop(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    typedef struct { u64 node; u32 depth; } Frame;
+
+    u32 failCount = 0;
+    MC_Stack *stack = MC_Stack_InitTyped(sizeof(Frame));
+    u64 successfulPushes = 0;
+
+    ASSERT_NOT_NULL(stack, failCount);
+    ASSERT_NULL(MC_Stack_InitTyped(0), failCount);
+    ASSERT_TRUE(MC_Stack_Reserve(stack, TEST_CONSTANT_10000), failCount);
+
+    /* Act */
+    for (u32 i = 0; i < TEST_CONSTANT_10000; i++)
+    {
+        Frame frame = { i * 2, i };
+
+        successfulPushes += MC_Stack_Push(stack, &frame, false);
+    }
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(successfulPushes, TEST_CONSTANT_10000, failCount);
+    ASSERT_EQUAL_UINT64(MC_Stack_Size(stack), TEST_CONSTANT_10000, failCount);
+    ASSERT_EQUAL_UINT64(((Frame*)MC_Stack_Peek(stack))->depth, TEST_CONSTANT_10000 - 1, failCount);
+
+    u64 outOfOrder = 0;
+
+    for (u32 i = TEST_CONSTANT_10000; i > 0; i--)
+    {
+        Frame *frame = (Frame*)MC_Stack_Pop(stack);
+
+        if (!frame || frame->depth != i - 1 || frame->node != (u64)(i - 1) * 2)
+        {
+            outOfOrder++;
+        }
+    }
+
+    ASSERT_EQUAL_UINT64(outOfOrder, 0, failCount);
+    ASSERT_TRUE(MC_Stack_IsEmpty(stack), failCount);
+    ASSERT_NULL(MC_Stack_Pop(stack), failCount);
+
+    MC_Stack_Free(&stack);
+
+    ASSERT_NULL(stack, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Stack_PushNPopN(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    MC_Stack *typed = MC_Stack_InitTyped(sizeof(u32));
+    MC_Stack *pointers = MC_Stack_Init();
+
+    u32 values[TEST_CONSTANT_32];
+    u32 popped[TEST_CONSTANT_32];
+    void *refs[TEST_CONSTANT_32];
+    void *poppedRefs[TEST_CONSTANT_32];
+
+    for (u32 i = 0; i < TEST_CONSTANT_32; i++)
+    {
+        values[i] = i * 7;
+        refs[i] = &values[i];
+    }
+
+    ASSERT_NOT_NULL(typed, failCount);
+    ASSERT_NOT_NULL(pointers, failCount);
+
+    /* Act */
+    ASSERT_TRUE(MC_Stack_PushN(typed, values, TEST_CONSTANT_32), failCount);
+    ASSERT_TRUE(MC_Stack_PushN(pointers, refs, TEST_CONSTANT_32), failCount);
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(MC_Stack_Size(typed), TEST_CONSTANT_32, failCount);
+    ASSERT_EQUAL_UINT64(*(u32*)MC_Stack_Peek(typed), values[TEST_CONSTANT_32 - 1], failCount);
+    ASSERT_EQUAL_UINT64(MC_Stack_Size(pointers), TEST_CONSTANT_32, failCount);
+    ASSERT_TRUE(MC_Stack_Peek(pointers) == refs[TEST_CONSTANT_32 - 1], failCount);
+
+    u64 poppedCount = MC_Stack_PopN(typed, popped, TEST_CONSTANT_10);
+    ASSERT_EQUAL_UINT64(poppedCount, TEST_CONSTANT_10, failCount);
+    ASSERT_ARRAY_EQUAL(popped, values + TEST_CONSTANT_32 - TEST_CONSTANT_10, TEST_CONSTANT_10, failCount);
+
+    poppedCount = MC_Stack_PopN(typed, popped, TEST_CONSTANT_32);   // asks for more than is left
+    ASSERT_EQUAL_UINT64(poppedCount, TEST_CONSTANT_32 - TEST_CONSTANT_10, failCount);
+    ASSERT_ARRAY_EQUAL(popped, values, TEST_CONSTANT_32 - TEST_CONSTANT_10, failCount);
+    ASSERT_TRUE(MC_Stack_IsEmpty(typed), failCount);
+
+    poppedCount = MC_Stack_PopN(pointers, poppedRefs, TEST_CONSTANT_32);
+    ASSERT_EQUAL_UINT64(poppedCount, TEST_CONSTANT_32, failCount);
+    ASSERT_ARRAY_EQUAL(poppedRefs, refs, TEST_CONSTANT_32, failCount);
+    ASSERT_TRUE(MC_Stack_IsEmpty(pointers), failCount);
+
+    MC_Stack_Free(&typed);
+    MC_Stack_Free(&pointers);
+
+    ASSERT_NULL(typed, failCount);
+    ASSERT_NULL(pointers, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Stack_PopDynamicOwnership(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    MC_Stack *stack = MC_Stack_Init();
+    char *value = MC_StrDup("Stack push: owned");
+
+    ASSERT_NOT_NULL(stack, failCount);
+    ASSERT_TRUE(MC_Stack_Push(stack, value, true), failCount);
+
+    /* Act */
+    char *popped = (char*)MC_Stack_Pop(stack);
+
+    /* Assert */
+    ASSERT_TRUE(popped == value, failCount);
+    ASSERT_STRING_EQUAL(popped, "Stack push: owned", TEST_CONSTANT_32, failCount);    // still readable, not freed
+
+    free(popped);
+    MC_Stack_Free(&stack);
+
+    ASSERT_NULL(stack, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Stack_SmallStackInline(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    u64 successfulPushes = 0;
+    u64 outOfOrder = 0;
+
+    MC_SMALL_STACK(stack, u64, TEST_CONSTANT_32);
+
+    ASSERT_TRUE(MC_SmallStack_IsEmpty(&stack), failCount);
+    ASSERT_TRUE(MC_SmallStack_IsInline(&stack), failCount);
+
+    /* Act */
+    for (u64 i = 0; i < TEST_CONSTANT_32; i++)
+    {
+        successfulPushes += MC_SmallStack_Push(&stack, &i);
+    }
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(successfulPushes, TEST_CONSTANT_32, failCount);
+    ASSERT_EQUAL_UINT64(MC_SmallStack_Size(&stack), TEST_CONSTANT_32, failCount);
+    ASSERT_EQUAL_UINT64(*(u64*)MC_SmallStack_Peek(&stack), TEST_CONSTANT_32 - 1, failCount);
+    ASSERT_TRUE(MC_SmallStack_IsInline(&stack), failCount);
+
+    for (u64 i = TEST_CONSTANT_32; i > 0; i--)
+    {
+        u64 *value = (u64*)MC_SmallStack_Pop(&stack);
+
+        if (!value || *value != i - 1)
+        {
+            outOfOrder++;
+        }
+    }
+
+    ASSERT_EQUAL_UINT64(outOfOrder, 0, failCount);
+    ASSERT_NULL(MC_SmallStack_Pop(&stack), failCount);
+    ASSERT_TRUE(MC_SmallStack_IsEmpty(&stack), failCount);
+
+    MC_SmallStack_Free(&stack);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Stack_SmallStackSpill(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    u32 values[TEST_CONSTANT_10000];
+    u32 popped[TEST_CONSTANT_10000];
+
+    for (u32 i = 0; i < TEST_CONSTANT_10000; i++)
+    {
+        values[i] = i * 3;
+    }
+
+    MC_SMALL_STACK(stack, u32, TEST_CONSTANT_10);
+
+    /* Act */
+    ASSERT_TRUE(MC_SmallStack_PushN(&stack, values, TEST_CONSTANT_10), failCount);
+    ASSERT_TRUE(MC_SmallStack_IsInline(&stack), failCount);
+    ASSERT_TRUE(MC_SmallStack_PushN(&stack, values + TEST_CONSTANT_10, TEST_CONSTANT_10000 - TEST_CONSTANT_10), failCount);
+
+    /* Assert */
+    ASSERT_FALSE(MC_SmallStack_IsInline(&stack), failCount);
+    ASSERT_EQUAL_UINT64(MC_SmallStack_Size(&stack), TEST_CONSTANT_10000, failCount);
+
+    u64 poppedCount = MC_SmallStack_PopN(&stack, popped, TEST_CONSTANT_10000);
+    ASSERT_EQUAL_UINT64(poppedCount, TEST_CONSTANT_10000, failCount);
+    ASSERT_ARRAY_EQUAL(popped, values, TEST_CONSTANT_10000, failCount);
+
+    MC_SmallStack_Free(&stack);
+
+    ASSERT_TRUE(MC_SmallStack_IsInline(&stack), failCount);     // back on the inline storage, and reusable
+    ASSERT_TRUE(MC_SmallStack_Push(&stack, &values[1]), failCount);
+    ASSERT_EQUAL_UINT64(*(u32*)MC_SmallStack_Peek(&stack), values[1], failCount);
+
+    MC_SmallStack_Free(&stack);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Stack_Arena(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    MC_Arena *arena = MC_Arena_Init(0);
+    MC_Stack *stack = MC_Stack_InitArena(arena);
+    MC_Stack *typed = MC_Stack_InitTypedArena(arena, sizeof(u64));
+    u64 successfulPushes = 0;
+    u64 wrongValues = 0;
+
+    ASSERT_NOT_NULL(stack, failCount);
+    ASSERT_NOT_NULL(typed, failCount);
+    ASSERT_NULL(MC_Stack_InitTypedArena(arena, 0), failCount);
+
+    /* Act */
+    for (u64 i = 0; i < TEST_CONSTANT_10000; i++)
+    {
+        successfulPushes += MC_Stack_Push(stack, (void*)(uintptr_t)(i + 1), false);
+        successfulPushes += MC_Stack_Push(typed, &i, false);
+    }
+
+    for (u64 i = TEST_CONSTANT_10000; i > 0; i--)
+    {
+        wrongValues += MC_Stack_Pop(stack) != (void*)(uintptr_t)i;
+        wrongValues += *(u64*)MC_Stack_Pop(typed) != i - 1;
+    }
+
+    u64 usedAfterFirstRound = MC_Arena_Used(arena);
+
+    for (u64 i = 0; i < TEST_CONSTANT_10000; i++)    // served from the recycled nodes
+    {
+        successfulPushes += MC_Stack_Push(stack, (void*)(uintptr_t)(i + 1), false);
+    }
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(successfulPushes, TEST_CONSTANT_10000 * 3, failCount);
+    ASSERT_EQUAL_UINT64(wrongValues, 0, failCount);
+    ASSERT_EQUAL_UINT64(MC_Arena_Used(arena), usedAfterFirstRound, failCount);
+
+    MC_Stack_Free(&stack);
+    MC_Stack_Free(&typed);
+
+    ASSERT_NULL(stack, failCount);
+    ASSERT_NULL(typed, failCount);
+
+    MC_Arena_Free(&arena);
+
+    ASSERT_NULL(arena, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
 int main(void)
 {
     int failCount = 0;
@@ -239,6 +525,12 @@ int main(void)
     failCount += Test_MC_Stack_PeekAndPop();
     failCount += Test_MC_Stack_IsEmpty();
     failCount += Test_MC_Stack_GetSize();
+    failCount += Test_MC_Stack_TypedPushPop();
+    failCount += Test_MC_Stack_PushNPopN();
+    failCount += Test_MC_Stack_PopDynamicOwnership();
+    failCount += Test_MC_Stack_SmallStackInline();
+    failCount += Test_MC_Stack_SmallStackSpill();
+    failCount += Test_MC_Stack_Arena();
 
     return failCount;
 }
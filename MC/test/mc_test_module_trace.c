@@ -0,0 +1,351 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_test_module_trace.c                                                                 */
+/* \brief: Source code for testing mc_trace                                                      */
+/*                                                                                               */
+/* \Expects: 1. All necessary mc definitions are defined and linked properly                     */
+/*                                                                                               */
+/*           Unit tests should follow a step by step approach and be specific to the             */
+/*           name of the function which they are evoked.                                         */
+/*           1. Arrange - Stage the entities to be tested on                                     */
+/*           2. Act - If necessary, perform any routines that might be necessary                 */
+/*           3. Assert - Determine if expectations are met for the test                          */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#include "mc_test.h"
+#include <stdio.h>      // fread
+#include <stdlib.h>     // malloc, strtod
+#include <string.h>     // strstr
+#include <threads.h>    // thrd_create
+
+/**
+ * \brief The file the tests write their traces to.
+ */
+#define TEST_TRACE_FILE "last_run_trace.json"
+
+#define TEST_TRACE_THREADS 4
+
+/**
+ * \brief Read a whole trace file into a null terminated string, NULL if it cannot be read.
+ */
+static char* test_trace_read(const char *path)
+{
+    FILE *in;
+
+    if (MC_FOpen(&in, path, "rb") != 0)
+    {
+        return NULL;
+    }
+
+    fseek(in, 0, SEEK_END);
+    long size = ftell(in);
+    fseek(in, 0, SEEK_SET);
+
+    char *text = size < 0 ? NULL : (char*)malloc((u64)size + 1);
+
+    if (text)
+    {
+        text[fread(text, 1, (u64)size, in)] = '\0';
+    }
+
+    fclose(in);
+
+    return text;
+}
+
+/**
+ * \brief Count the occurrences of needle in text.
+ */
+static u64 test_trace_count(const char *text, const char *needle)
+{
+    u64 count = 0;
+
+    for (const char *at = text; at && (at = strstr(at, needle)) != NULL; at += strlen(needle))
+    {
+        count++;
+    }
+
+    return count;
+}
+
+static int test_trace_worker(void *arg)
+{
+    (void)arg;
+
+    for (u64 i = 0; i < TEST_CONSTANT_1000000 / 100; i++)
+    {
+        MC_TRACE_SCOPE("work")
+        {
+            MC_TRACE_COUNTER("iteration", (i64)i);
+        }
+    }
+
+    return 0;
+}
+
+u32 Test_MC_Trace_Disabled(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    int beforeStart = MC_Trace_Write(TEST_TRACE_FILE);
+    u8 recordedBeforeStart = MC_Trace_Begin("before");
+
+    /* Act */
+    int started = MC_Trace_Start(0);
+    int restarted = MC_Trace_Start(0);
+    MC_Trace_Stop();
+
+    MC_TRACE_SCOPE("stopped")
+    {
+        MC_TRACE_INSTANT("stopped instant");
+    }
+
+    int written = MC_Trace_Write(TEST_TRACE_FILE);
+    char *text = test_trace_read(TEST_TRACE_FILE);
+
+    /* Assert */
+    ASSERT_EQUAL_INT64(beforeStart, -1, failCount);
+    ASSERT_FALSE(recordedBeforeStart, failCount);
+    ASSERT_EQUAL_INT64(started, 0, failCount);
+    ASSERT_EQUAL_INT64(restarted, -1, failCount);
+    ASSERT_EQUAL_INT64(written, 0, failCount);
+    ASSERT_NOT_NULL(text, failCount);
+    ASSERT_EQUAL_UINT64(test_trace_count(text, "\"ph\""), 0, failCount);
+    ASSERT_TRUE(text && strcmp(text, "{\"traceEvents\":[\n],\"displayTimeUnit\":\"ns\"}\n") == 0, failCount);
+
+    free(text);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Trace_Scope(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    u64 inside = 0;
+
+    MC_Trace_Start(0);
+
+    /* Act */
+    MC_TRACE_SCOPE("outer")
+    {
+        MC_TRACE_SCOPE("inner \"quoted\"\n")
+        {
+            inside++;
+        }
+
+        MC_TRACE_INSTANT("mark");
+        MC_TRACE_COUNTER("items", -42);
+        inside++;
+    }
+
+    MC_TRACE_BEGIN("straddle");
+    MC_Trace_Stop();
+    MC_TRACE_BEGIN("skipped");
+    MC_TRACE_END("skipped");    // begun after the session stopped, must not close "straddle"
+    MC_TRACE_END("straddle");   // ends after the session stopped, still recorded
+    MC_TRACE_END("straddle");   // already ended, nothing to record
+
+    int written = MC_Trace_Write(TEST_TRACE_FILE);
+    char *text = test_trace_read(TEST_TRACE_FILE);
+    u8 ordered = text != NULL;
+    double last = 0.0;
+
+    for (const char *at = text; at && (at = strstr(at, "\"ts\":")) != NULL; at += 5)
+    {
+        double ts = strtod(at + 5, NULL);
+        ordered &= ts >= last;
+        last = ts;
+    }
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(inside, 2, failCount);
+    ASSERT_EQUAL_INT64(written, 0, failCount);
+    ASSERT_NOT_NULL(text, failCount);
+    ASSERT_TRUE(text && strncmp(text, "{\"traceEvents\":[\n{", 18) == 0, failCount);
+    ASSERT_NOT_NULL(strstr(text, "\n],\"displayTimeUnit\":\"ns\"}\n"), failCount);
+    ASSERT_NOT_NULL(strstr(text, "{\"name\":\"outer\",\"ph\":\"B\",\"ts\":"), failCount);
+    ASSERT_NOT_NULL(strstr(text, "{\"name\":\"outer\",\"ph\":\"E\",\"ts\":"), failCount);
+    ASSERT_NOT_NULL(strstr(text, "{\"name\":\"inner \\\"quoted\\\"\\u000a\",\"ph\":\"B\""), failCount);
+    ASSERT_NOT_NULL(strstr(text, "{\"name\":\"mark\",\"ph\":\"i\""), failCount);
+    ASSERT_NOT_NULL(strstr(text, ",\"tid\":1,\"s\":\"t\"}"), failCount);
+    ASSERT_NOT_NULL(strstr(text, "{\"name\":\"items\",\"ph\":\"C\""), failCount);
+    ASSERT_NOT_NULL(strstr(text, ",\"args\":{\"value\":-42}}"), failCount);
+    ASSERT_NOT_NULL(strstr(text, "{\"name\":\"straddle\",\"ph\":\"E\""), failCount);
+    ASSERT_NULL(strstr(text, "skipped"), failCount);
+    ASSERT_EQUAL_UINT64(test_trace_count(text, "\"ph\":\"B\""), 3, failCount);
+    ASSERT_EQUAL_UINT64(test_trace_count(text, "\"ph\":\"E\""), 3, failCount);
+    ASSERT_EQUAL_UINT64(test_trace_count(text, "\"ph\""), 8, failCount);
+    ASSERT_TRUE(ordered, failCount);
+    ASSERT_EQUAL_UINT64(MC_Trace_Dropped(), 0, failCount);
+
+    free(text);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Trace_Threads(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    thrd_t threads[TEST_TRACE_THREADS];
+    char tid[TEST_CONSTANT_32];
+
+    MC_Trace_Start(0);
+
+    /* Act */
+    for (u64 i = 0; i < TEST_TRACE_THREADS; i++)
+    {
+        thrd_create(&threads[i], test_trace_worker, NULL);
+    }
+
+    for (u64 i = 0; i < TEST_TRACE_THREADS; i++)
+    {
+        thrd_join(threads[i], NULL);
+    }
+
+    MC_Trace_Stop();
+
+    int written = MC_Trace_Write(TEST_TRACE_FILE);
+    char *text = test_trace_read(TEST_TRACE_FILE);
+
+    /* Assert */
+    ASSERT_EQUAL_INT64(written, 0, failCount);
+    ASSERT_NOT_NULL(text, failCount);
+    ASSERT_EQUAL_UINT64(test_trace_count(text, "\"ph\":\"B\""), TEST_TRACE_THREADS * TEST_CONSTANT_1000000 / 100, failCount);
+    ASSERT_EQUAL_UINT64(test_trace_count(text, "\"ph\":\"E\""), TEST_TRACE_THREADS * TEST_CONSTANT_1000000 / 100, failCount);
+    ASSERT_EQUAL_UINT64(test_trace_count(text, "\"ph\":\"C\""), TEST_TRACE_THREADS * TEST_CONSTANT_1000000 / 100, failCount);
+    ASSERT_EQUAL_UINT64(MC_Trace_Dropped(), 0, failCount);
+
+    for (u64 i = 1; i <= TEST_TRACE_THREADS; i++)
+    {
+        snprintf(tid, sizeof(tid), "\"tid\":%llu}", (unsigned long long)i);
+        ASSERT_EQUAL_UINT64(test_trace_count(text, tid), 2 * TEST_CONSTANT_1000000 / 100, failCount);
+    }
+
+    free(text);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Trace_Dropped(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+
+    MC_Trace_Start(TEST_CONSTANT_32 / 2);
+
+    /* Act */
+    for (u64 i = 0; i < TEST_CONSTANT_10 * TEST_CONSTANT_10; i++)
+    {
+        MC_TRACE_SCOPE("span")
+        {
+        }
+    }
+
+    MC_Trace_Stop();
+
+    u64 dropped = MC_Trace_Dropped();
+    int written = MC_Trace_Write(TEST_TRACE_FILE);
+    char *text = test_trace_read(TEST_TRACE_FILE);
+
+    /* Assert */
+    ASSERT_EQUAL_INT64(written, 0, failCount);
+    ASSERT_NOT_NULL(text, failCount);
+    ASSERT_EQUAL_UINT64(test_trace_count(text, "\"ph\":\"B\""), TEST_CONSTANT_32 / 4, failCount);
+    ASSERT_EQUAL_UINT64(test_trace_count(text, "\"ph\":\"E\""), TEST_CONSTANT_32 / 4, failCount);
+    ASSERT_EQUAL_UINT64(dropped, TEST_CONSTANT_10 * TEST_CONSTANT_10 - TEST_CONSTANT_32 / 4, failCount);
+
+    free(text);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_Trace_Modules(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    char key[TEST_CONSTANT_32];
+    MC_HashMap *map = MC_Hashmap_Init(TEST_CONSTANT_32);
+    MC_HashMap *after = MC_Hashmap_Init(TEST_CONSTANT_32);
+    MC_Stack *stack = MC_Stack_InitTyped(sizeof(u64));
+
+    MC_Hashmap_Insert(after, "Index: 7", NULL, false);
+    MC_Trace_Start(0);
+
+    /* Act */
+    for (u64 i = 0; i < TEST_CONSTANT_32; i++)
+    {
+        snprintf(key, sizeof(key), "Index: %llu", (unsigned long long)i);
+        MC_Hashmap_Insert(map, key, NULL, false);
+        MC_Stack_Push(stack, &i, false);
+    }
+
+    MC_Hashmap_Search(map, "Index: 7");
+    MC_Hashmap_RemoveAt(map, "Index: 7");
+    MC_Hashmap_Free(&map);
+    MC_Stack_Free(&stack);
+
+    MC_Trace_Stop();
+
+    for (u64 i = 0; i < TEST_CONSTANT_10 / 2; i++)
+    {
+        MC_Hashmap_Search(after, "Index: 7");   // begun after the session stopped, no end recorded
+    }
+
+    MC_Hashmap_Free(&after);
+
+    int written = MC_Trace_Write(TEST_TRACE_FILE);
+    char *text = test_trace_read(TEST_TRACE_FILE);
+    u64 spans = MC_Trace_IsEnabled() ? 1 : 0;
+
+    /* Assert */
+    ASSERT_EQUAL_INT64(written, 0, failCount);
+    ASSERT_NOT_NULL(text, failCount);
+    ASSERT_EQUAL_UINT64(test_trace_count(text, "\"name\":\"MC_Hashmap_Insert\",\"ph\":\"B\""), spans * TEST_CONSTANT_32, failCount);
+    ASSERT_EQUAL_UINT64(test_trace_count(text, "\"name\":\"MC_Hashmap_Search\",\"ph\":\"E\""), spans, failCount);
+    ASSERT_EQUAL_UINT64(test_trace_count(text, "\"name\":\"MC_Hashmap_RemoveAt\",\"ph\":\"E\""), spans, failCount);
+    ASSERT_EQUAL_UINT64(test_trace_count(text, "\"name\":\"MC_Hashmap_Free\",\"ph\":\"B\""), spans, failCount);
+    ASSERT_EQUAL_UINT64(test_trace_count(text, "\"name\":\"MC_Stack grow\",\"ph\":\"B\""), spans * 2, failCount);
+    ASSERT_EQUAL_UINT64(test_trace_count(text, "\"name\":\"MC_Stack_Free\",\"ph\":\"E\""), spans, failCount);
+    ASSERT_EQUAL_UINT64(test_trace_count(text, "\"ph\":\"B\""), test_trace_count(text, "\"ph\":\"E\""), failCount);
+
+    free(text);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+int main(void)
+{
+    int failCount = 0;
+
+    failCount += Test_MC_Trace_Disabled();
+    failCount += Test_MC_Trace_Scope();
+    failCount += Test_MC_Trace_Threads();
+    failCount += Test_MC_Trace_Dropped();
+    failCount += Test_MC_Trace_Modules();
+
+    return failCount;
+}
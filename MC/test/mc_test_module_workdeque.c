@@ -0,0 +1,255 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_test_module_workdeque.c                                                             */
+/* \brief: Source code for testing mc_workdeque                                                  */
+/*                                                                                               */
+/* \Expects: 1. All necessary mc definitions are defined and linked properly                     */
+/*                                                                                               */
+/*           Unit tests should follow a step by step approach and be specific to the             */
+/*           name of the function which they are evoked.                                         */
+/*           1. Arrange - Stage the entities to be tested on                                     */
+/*           2. Act - If necessary, perform any routines that might be necessary                 */
+/*           3. Assert - Determine if expectations are met for the test                          */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#include "mc_test.h"
+#include <stdatomic.h>  // atomic_*
+#include <threads.h>    // thrd_create
+
+/**
+ * \brief Number of thief threads used by the concurrent test.
+ */
+#define TEST_THIEVES 3
+
+/**
+ * \brief Shared state between the owner and thieves of the concurrent test.
+ */
+typedef struct
+{
+    MC_WorkDeque *deque;
+    atomic_uchar taken[TEST_CONSTANT_1000000];  // \brief How many times each element was taken
+    atomic_bool done;
+} StealContext;
+
+static StealContext stealContext;
+
+/**
+ * \brief Elements are encoded as index + 1 so no element is ever NULL.
+ */
+static void* test_element(u64 index)
+{
+    return (void*)(uintptr_t)(index + 1);
+}
+
+static int test_thief(void *arg)
+{
+    (void)arg;
+
+    while (!atomic_load(&stealContext.done) || !MC_WorkDeque_IsEmpty(stealContext.deque))
+    {
+        void *value = MC_WorkDeque_Steal(stealContext.deque);
+
+        if (value)
+        {
+            atomic_fetch_add(&stealContext.taken[(uintptr_t)value - 1], 1);
+        }
+    }
+
+    return 0;
+}
+
+u32 Test_MC_WorkDeque_InitAndFree(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    MC_WorkDeque *deque = MC_WorkDeque_Init(TEST_CONSTANT_32);
+
+    ASSERT_NOT_NULL(deque, failCount);
+    ASSERT_TRUE(MC_WorkDeque_IsEmpty(deque), failCount);
+
+    /* Act */
+    MC_WorkDeque_Free(&deque);
+
+    /* Assert */
+    ASSERT_NULL(deque, failCount);
+    ASSERT_TRUE(MC_WorkDeque_IsEmpty(deque), failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_WorkDeque_PushPop(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    MC_WorkDeque *deque = MC_WorkDeque_Init(TEST_CONSTANT_32);
+    u64 successfulPushes = 0;
+    u64 outOfOrder = 0;
+
+    ASSERT_NOT_NULL(deque, failCount);
+    ASSERT_FALSE(MC_WorkDeque_Push(deque, NULL), failCount);
+
+    /* Act */
+    for (u64 i = 0; i < TEST_CONSTANT_32; i++)
+    {
+        successfulPushes += MC_WorkDeque_Push(deque, test_element(i));
+    }
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(successfulPushes, TEST_CONSTANT_32, failCount);
+    ASSERT_EQUAL_UINT64(MC_WorkDeque_Size(deque), TEST_CONSTANT_32, failCount);
+
+    for (u64 i = TEST_CONSTANT_32; i > 0; i--)
+    {
+        if (MC_WorkDeque_Pop(deque) != test_element(i - 1))
+        {
+            outOfOrder++;
+        }
+    }
+
+    ASSERT_EQUAL_UINT64(outOfOrder, 0, failCount);
+    ASSERT_NULL(MC_WorkDeque_Pop(deque), failCount);
+    ASSERT_TRUE(MC_WorkDeque_IsEmpty(deque), failCount);
+
+    MC_WorkDeque_Free(&deque);
+
+    ASSERT_NULL(deque, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_WorkDeque_StealAndGrow(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    MC_WorkDeque *deque = MC_WorkDeque_Init(0);     // minimum capacity, forces several resizes
+    u64 successfulPushes = 0;
+    u64 outOfOrder = 0;
+
+    ASSERT_NOT_NULL(deque, failCount);
+
+    /* Act */
+    for (u64 i = 0; i < TEST_CONSTANT_10000; i++)
+    {
+        successfulPushes += MC_WorkDeque_Push(deque, test_element(i));
+    }
+
+    /* Assert */
+    ASSERT_EQUAL_UINT64(successfulPushes, TEST_CONSTANT_10000, failCount);
+
+    for (u64 i = 0; i < TEST_CONSTANT_10000 / 2; i++)
+    {
+        if (MC_WorkDeque_Steal(deque) != test_element(i))
+        {
+            outOfOrder++;
+        }
+    }
+
+    for (u64 i = TEST_CONSTANT_10000; i > TEST_CONSTANT_10000 / 2; i--)
+    {
+        if (MC_WorkDeque_Pop(deque) != test_element(i - 1))
+        {
+            outOfOrder++;
+        }
+    }
+
+    ASSERT_EQUAL_UINT64(outOfOrder, 0, failCount);
+    ASSERT_NULL(MC_WorkDeque_Steal(deque), failCount);
+    ASSERT_TRUE(MC_WorkDeque_IsEmpty(deque), failCount);
+
+    MC_WorkDeque_Free(&deque);
+
+    ASSERT_NULL(deque, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+u32 Test_MC_WorkDeque_ConcurrentSteal(void)
+{
+    /* Arrange */
+    TEST_INIT();
+
+    u32 failCount = 0;
+    u64 takenOnce = 0;
+    thrd_t thieves[TEST_THIEVES];
+
+    stealContext.deque = MC_WorkDeque_Init(TEST_CONSTANT_32);
+    atomic_init(&stealContext.done, false);
+
+    for (u64 i = 0; i < TEST_CONSTANT_1000000; i++)
+    {
+        atomic_init(&stealContext.taken[i], 0);
+    }
+
+    ASSERT_NOT_NULL(stealContext.deque, failCount);
+
+    for (u32 i = 0; i < TEST_THIEVES; i++)
+    {
+        thrd_create(&thieves[i], test_thief, NULL);
+    }
+
+    /* Act */
+    for (u64 i = 0; i < TEST_CONSTANT_1000000; i++)
+    {
+        MC_WorkDeque_Push(stealContext.deque, test_element(i));
+
+        if (i % 3 == 0)     // the owner keeps working its own end while the thieves steal
+        {
+            void *value = MC_WorkDeque_Pop(stealContext.deque);
+
+            if (value)
+            {
+                atomic_fetch_add(&stealContext.taken[(uintptr_t)value - 1], 1);
+            }
+        }
+    }
+
+    atomic_store(&stealContext.done, true);
+
+    for (u32 i = 0; i < TEST_THIEVES; i++)
+    {
+        thrd_join(thieves[i], NULL);
+    }
+
+    /* Assert */
+    for (u64 i = 0; i < TEST_CONSTANT_1000000; i++)
+    {
+        takenOnce += atomic_load(&stealContext.taken[i]) == 1;
+    }
+
+    ASSERT_EQUAL_UINT64(takenOnce, TEST_CONSTANT_1000000, failCount);
+    ASSERT_TRUE(MC_WorkDeque_IsEmpty(stealContext.deque), failCount);
+
+    MC_WorkDeque_Free(&stealContext.deque);
+
+    ASSERT_NULL(stealContext.deque, failCount);
+
+    TEST_TEARDOWN(failCount);
+
+    return failCount;
+}
+
+int main(void)
+{
+    int failCount = 0;
+
+    failCount += Test_MC_WorkDeque_InitAndFree();
+    failCount += Test_MC_WorkDeque_PushPop();
+    failCount += Test_MC_WorkDeque_StealAndGrow();
+    failCount += Test_MC_WorkDeque_ConcurrentSteal();
+
+    return failCount;
+}
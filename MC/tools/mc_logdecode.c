@@ -0,0 +1,50 @@
+/* ********************************************************************************************* */
+/*                                                                                               */
+/* Author: Mario Migliacio                                                                       */
+/* @file: mc_logdecode.c                                                                         */
+/* \brief: Turn a binary log back into text                                                      */
+/*                                                                                               */
+/* \Expects: 1. The binary log was written by MC_Log_InitBinary on a machine of the same byte    */
+/*              order                                                                            */
+/*                                                                                               */
+/*           Usage: mc_logdecode <binary log> [text output], the text goes to stdout without one */
+/*                                                                                               */
+/* ********************************************************************************************* */
+
+#include "mc_log.h"
+#include "mc_platform.h"
+
+int main(int argc, char **argv)
+{
+    FILE *out = stdout;
+
+    if (argc < 2 || argc > 3)
+    {
+        fprintf(stderr, "usage: %s <binary log> [text output]\n", argc ? argv[0] : "mc_logdecode");
+
+        return EXIT_FAILURE;
+    }
+
+    if (argc == 3 && MC_FOpen(&out, argv[2], "w") != 0)
+    {
+        perror("Failed to open output file");
+
+        return EXIT_FAILURE;
+    }
+
+    int result = MC_Log_Decode(argv[1], out);
+
+    if (out != stdout)
+    {
+        fclose(out);
+    }
+
+    if (result != 0)
+    {
+        fprintf(stderr, "%s: not a binary log, or cut short\n", argv[1]);
+
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,57 @@
+###################################################################################################
+#                                                                                                 #
+# Author: Mario Migliacio                                                                         #
+# @file: bench.ps1                                                                                #
+# \brief: Runs every benchmark executable and collects the results                                #
+#                                                                                                 #
+# \Expects: ..\build folder exists and was generated with CMakeLists.txt                          #
+#           Benchmarks are most meaningful in a Release build                                     #
+#                                                                                                 #
+# \Params: -config [CONFIG] the build configuration to run, Release by default                    #
+#                                                                                                 #
+# \Success: Every mc_bench_module_* executable has run                                            #
+#           The combined output is written to ..\bench_output.txt                                 #
+#                                                                                                 #
+# \Failure: Display that no benchmarks were found in RED prompt                                   #
+#                                                                                                 #
+###################################################################################################
+
+param (
+    [string]$config = "Release"
+)
+
+# Note: The scriptDir, projectRoot, and exeDir allows this script to be invoked from anywhere. 
+#       This allows the use of .\scr\bench.ps1 from even the root directory, or inside the \scr directly.
+
+# Get the directory of the current script
+$scriptDir = Split-Path -Parent -Path $MyInvocation.MyCommand.Definition
+
+# Define the project root and executable directory
+$projectRoot = (Resolve-Path "$scriptDir\..").Path
+$exeDir = "$projectRoot\build\bin\$config"
+$outputFile = "$projectRoot\bench_output.txt"
+
+$benchmarks = Get-ChildItem -Path $exeDir -Filter "mc_bench_module_*.exe" -ErrorAction SilentlyContinue
+
+if (-Not $benchmarks)
+{
+    Write-Host "Unable to locate benchmarks in $exeDir" -ForegroundColor Red
+    exit 1
+}
+
+# Preserve our calling directory, so running this script doesn't change our location in the shell.
+$originalDir = Get-Location
+Set-Location -Path $exeDir
+
+Set-Content -Path $outputFile -Value ""
+
+foreach ($benchmark in $benchmarks)
+{
+    Write-Host "Running $($benchmark.Name)" -ForegroundColor Magenta
+    & $benchmark.FullName | Tee-Object -FilePath $outputFile -Append
+}
+
+# Return to the original directory
+Set-Location -Path $originalDir
+
+Write-Host "See MarCore\bench_output.txt for benchmark results" -ForegroundColor Magenta